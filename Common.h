@@ -9,6 +9,8 @@
 #ifndef COMMON_H_
 #define COMMON_H_
 
+#include "util/Allocator.h"
+
 /* --------------------------------------------------------------------------*/
 /**
  * @Brief  handle_element
@@ -22,6 +24,42 @@
 typedef int (*handle_element)(void *element, void *arg);
 typedef int (*destroy_element)(void *element);
 typedef int (*iterate_handle)(void *element);
+typedef unsigned long (*hash_handle)(void *key);
+typedef void* (*key_handle)(void *element);
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  compare_handle
+ *
+ * @Param element1 : element or key
+ * @Param element2 : element or key
+ *
+ * @Returns   <0 means element1 is before element2; 0 is equal; >0 is after
+ */
+/* ----------------------------------------------------------------------------*/
+typedef int (*compare_handle)(void *element1, void *element2);
+
+/**
+ * Represent a position in the data, a cursor whose node is NULL is off the
+ * data. Only the data that creates the cursor knows the members.
+ */
+typedef struct Cursor{
+    //the node that the cursor stays on
+    void *node;
+    //the prior node, for the data without a backward link
+    void *previous;
+    //the position in the node, for the data that keeps several elements in
+    //one node
+    int index;
+}Cursor;
+
+#define CURSOR_NULL {\
+    .node = NULL,\
+    .previous = NULL,\
+    .index = 0\
+}
+
+#define CURSOR_VALID(cursor) ((cursor)->node != NULL)
 
 typedef struct DataCommon{
     //the data's linked method that user chooses 
@@ -34,6 +72,24 @@ typedef struct DataCommon{
     destroy_element destroy_node;
     iterate_handle handle_iteration;
 
+    //optional key functions, set all of them before creating the list and
+    //search/remove/prior/next take a key and find it through a hash index;
+    //alter takes an element-like argument and finds it by its key
+    hash_handle key_hash;
+    handle_element key_equal;
+    key_handle element_key;
+
+    //optional order function, the ordered data(skip list, B+ tree,
+    //red-black tree) need it with element_key and sort the elements by
+    //comparing the keys that element_key returns, the keys are unique.
+    //search/remove/prior/next take a key; alter takes an element-like
+    //argument and finds it by its key; insert keeps the order, so
+    //insert_after returns -1
+    compare_handle key_compare;
+
+    //where the memory comes from, NULL means libc
+    Allocator *allocator;
+
     //public handle list begin
     int (*insert)(struct DataCommon *common, void *element);
     int (*remove)(struct DataCommon *common, void *element);
@@ -48,14 +104,42 @@ typedef struct DataCommon{
     int (*clear)(struct DataCommon *common);
     //public handle list end
 
+    //cursor handle list begin
+    //begin/end put the cursor on the first/last element, -1 means empty
+    int (*begin)(struct DataCommon *common, Cursor *cursor);
+    int (*end)(struct DataCommon *common, Cursor *cursor);
+    //move the cursor by one element, -1 means it moves off the data
+    int (*advance)(struct DataCommon *common, Cursor *cursor);
+    int (*retreat)(struct DataCommon *common, Cursor *cursor);
+    //the element under the cursor, NULL means off the data
+    void* (*get)(struct DataCommon *common, Cursor *cursor);
+    //remove the element under the cursor, the cursor moves to the next one
+    int (*erase)(struct DataCommon *common, Cursor *cursor);
+    //insert after the cursor(at the front if the cursor is off the data),
+    //the cursor does not move
+    int (*insert_after)(struct DataCommon *common, Cursor *cursor, void *element);
+    //cursor handle list end
+
 }DataCommon;
 
+#define DATA_COMMON_INDEXED(common) ((common)->key_hash \
+	&& (common)->key_equal && (common)->element_key)
+
+#define DATA_COMMON_ORDERED(common) ((common)->key_compare \
+	&& (common)->element_key)
+
 #define DATA_COMMON_NULL {\
     .linked_type = NULL,\
     .remove_match = NULL,\
     .search_match = NULL,\
     .alter_match = NULL,\
     .destroy_node = NULL,\
+    .handle_iteration = NULL,\
+    .key_hash = NULL,\
+    .key_equal = NULL,\
+    .element_key = NULL,\
+    .key_compare = NULL,\
+    .allocator = NULL,\
     .insert = NULL,\
     .remove = NULL,\
     .search = NULL,\
@@ -64,7 +148,14 @@ typedef struct DataCommon{
     .next = NULL,\
     .iterate = NULL,\
     .size = NULL,\
-    .clear = NULL\
+    .clear = NULL,\
+    .begin = NULL,\
+    .end = NULL,\
+    .advance = NULL,\
+    .retreat = NULL,\
+    .get = NULL,\
+    .erase = NULL,\
+    .insert_after = NULL\
 }
 
 #endif
@@ -0,0 +1,124 @@
+/**
+ * @file allocator.c
+ * @Brief  benchmark the cost of the allocator indirection against libc
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-06
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "util/Allocator.h"
+#include "stack/Stack.h"
+#include "queue/Queue.h"
+
+#define ROUNDS 1000
+#define COUNT 10000
+
+/**
+ * an allocator that only forwards to libc, so the difference is the cost
+ * of the indirection itself
+ */
+static void* libc_alloc(void *context, size_t size)
+{
+    return malloc(size);
+}
+
+static void* libc_realloc(void *context, void *address, size_t size)
+{
+    return realloc(address, size);
+}
+
+static void libc_free(void *context, void *address)
+{
+    free(address);
+}
+
+static Allocator forward = {
+    .alloc = libc_alloc,
+    .realloc = libc_realloc,
+    .free = libc_free,
+    .context = NULL
+};
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double bench_raw(Allocator *allocator)
+{
+    static void *blocks[COUNT];
+    int i, j;
+    double start = now();
+
+    for (i=0; i<ROUNDS; i++){
+	for (j=0; j<COUNT; j++)
+	    blocks[j] = mem_alloc(allocator, 32);
+	for (j=0; j<COUNT; j++)
+	    mem_free(allocator, blocks[j]);
+    }
+
+    return now() - start;
+}
+
+static double bench_stack(Allocator *allocator)
+{
+    Stack stack = STACK_NULL;
+    int i, j;
+    double start = now();
+
+    for (i=0; i<ROUNDS; i++){
+	stack_new_allocator(&stack, 1, allocator);
+	for (j=0; j<COUNT; j++)
+	    stack_push(&stack, &stack);
+	stack_delete(&stack, NULL);
+    }
+
+    return now() - start;
+}
+
+static double bench_queue(Allocator *allocator)
+{
+    Queue queue = QUEUE_INIT;
+    int i, j;
+    double start = now();
+
+    for (i=0; i<ROUNDS; i++){
+	queue_new(&queue, allocator);
+	for (j=0; j<COUNT; j++)
+	    queue_in(&queue, &queue);
+	for (j=0; j<COUNT; j++)
+	    queue_out(&queue);
+	queue_delete(&queue, NULL);
+    }
+
+    return now() - start;
+}
+
+int main()
+{
+    double ops = (double)ROUNDS * COUNT;
+    double libc, hook;
+
+    libc = bench_raw(NULL);
+    hook = bench_raw(&forward);
+    printf("alloc/free   libc %6.2f ns/op  hook %6.2f ns/op\n",
+	    libc * 1e9 / ops, hook * 1e9 / ops);
+
+    libc = bench_stack(NULL);
+    hook = bench_stack(&forward);
+    printf("stack_push   libc %6.2f ns/op  hook %6.2f ns/op\n",
+	    libc * 1e9 / ops, hook * 1e9 / ops);
+
+    libc = bench_queue(NULL);
+    hook = bench_queue(&forward);
+    printf("queue_in/out libc %6.2f ns/op  hook %6.2f ns/op\n",
+	    libc * 1e9 / ops, hook * 1e9 / ops);
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file contention.c
+ * @Brief  benchmark the lock-free stack against a mutex-wrapped stack from 1
+ *         to N threads, usage: contention [N]
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-18
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "stack/Stack.h"
+#include "stack/ConcurrentStack.h"
+
+#define OPERATIONS 200000
+#define DEFAULT_THREADS 32
+
+static Stack locked = STACK_NULL;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static ConcurrentStack lockfree;
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * every thread pushes and pops in pairs, so the stack stays short and the
+ * top is always contended
+ */
+static void* locked_worker(void *arg)
+{
+    int i;
+    for (i=0; i<OPERATIONS; i++){
+	pthread_mutex_lock(&lock);
+	stack_push(&locked, arg);
+	pthread_mutex_unlock(&lock);
+
+	pthread_mutex_lock(&lock);
+	stack_pop(&locked);
+	pthread_mutex_unlock(&lock);
+    }
+    return NULL;
+}
+
+static void* lockfree_worker(void *arg)
+{
+    int i;
+    for (i=0; i<OPERATIONS; i++){
+	cstack_push(&lockfree, arg);
+	cstack_pop(&lockfree);
+    }
+    return NULL;
+}
+
+static double run(void* (*worker)(void*), int count)
+{
+    pthread_t *threads = (pthread_t*)malloc(count * sizeof(pthread_t));
+    /**
+     * every thread pushes its own element, apart from its thread handle
+     */
+    int *ids = (int*)malloc(count * sizeof(int));
+    int i;
+
+    double start = now();
+    for (i=0; i<count; i++){
+	ids[i] = i;
+	pthread_create(&threads[i], NULL, worker, &ids[i]);
+    }
+    for (i=0; i<count; i++)
+	pthread_join(threads[i], NULL);
+    double elapsed = now() - start;
+
+    free(ids);
+    free(threads);
+
+    /**
+     * million operations per second, a push and a pop are two operations
+     */
+    return 2.0 * OPERATIONS * count / elapsed / 1e6;
+}
+
+int main(int argc, char *argv[])
+{
+    int max = argc > 1 ? atoi(argv[1]) : DEFAULT_THREADS;
+    int count;
+
+    stack_new(&locked, 0);
+    cstack_new(&lockfree, NULL);
+
+    printf("%-8s %14s %14s\n", "threads", "mutex Mops", "lockfree Mops");
+    for (count=1; count<=max; count*=2)
+	printf("%-8d %14.2f %14.2f\n", count, run(locked_worker, count),
+		run(lockfree_worker, count));
+
+    stack_delete(&locked, NULL);
+    cstack_delete(&lockfree, NULL);
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file fanin.c
+ * @Brief  benchmark the mpmc queue against a mutex-wrapped queue from 1 to N
+ *         threads, usage: fanin [N]
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-22
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "queue/Queue.h"
+#include "queue/MpmcQueue.h"
+
+#define OPERATIONS 100000
+#define CAPACITY 1024
+#define DEFAULT_THREADS 64
+
+static Queue locked = QUEUE_INIT;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static MpmcQueue shared;
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * every thread puts one element and takes one, so the queue never holds
+ * more elements than threads and a take always finds one at last
+ */
+static void* locked_worker(void *arg)
+{
+    void *element = NULL;
+    int i;
+    for (i=0; i<OPERATIONS; i++){
+	pthread_mutex_lock(&lock);
+	queue_in(&locked, arg);
+	pthread_mutex_unlock(&lock);
+
+	do {
+	    pthread_mutex_lock(&lock);
+	    element = QUEUE_EMPTY((&locked)) ? NULL : queue_out(&locked);
+	    pthread_mutex_unlock(&lock);
+	} while (element == NULL);
+    }
+    return NULL;
+}
+
+static void* mpmc_worker(void *arg)
+{
+    int i;
+    for (i=0; i<OPERATIONS; i++){
+	mpmc_in(&shared, arg);
+	mpmc_out(&shared);
+    }
+    return NULL;
+}
+
+static double run(void* (*worker)(void*), int count)
+{
+    pthread_t *threads = (pthread_t*)malloc(count * sizeof(pthread_t));
+    /**
+     * every thread queues its own element, apart from its thread handle
+     */
+    int *ids = (int*)malloc(count * sizeof(int));
+    int i;
+
+    double start = now();
+    for (i=0; i<count; i++){
+	ids[i] = i;
+	pthread_create(&threads[i], NULL, worker, &ids[i]);
+    }
+    for (i=0; i<count; i++)
+	pthread_join(threads[i], NULL);
+    double elapsed = now() - start;
+
+    free(ids);
+    free(threads);
+
+    return 2.0 * OPERATIONS * count / elapsed / 1e6;
+}
+
+int main(int argc, char *argv[])
+{
+    int max = argc > 1 ? atoi(argv[1]) : DEFAULT_THREADS;
+    int count;
+
+    queue_new(&locked, NULL);
+    mpmc_new(&shared, CAPACITY, NULL);
+
+    printf("%-8s %14s %14s\n", "threads", "mutex Mops", "mpmc Mops");
+    for (count=1; count<=max; count*=2)
+	printf("%-8d %14.2f %14.2f\n", count, run(locked_worker, count),
+		run(mpmc_worker, count));
+
+    queue_delete(&locked, NULL);
+    mpmc_delete(&shared, NULL);
+
+    return 0;
+}
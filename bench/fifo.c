@@ -0,0 +1,68 @@
+/**
+ * @file fifo.c
+ * @Brief  benchmark the linked queue against the ring buffer queue
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-20
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "queue/Queue.h"
+#include "queue/RingQueue.h"
+
+#define COUNT 1000000
+#define ROUNDS 20
+
+static long sum = 0;
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main()
+{
+    int *numbers = (int*)malloc(COUNT * sizeof(int));
+    Queue linked = QUEUE_INIT;
+    RingQueue ring = RING_QUEUE_NULL;
+    double start;
+    int i, j;
+
+    for (i=0; i<COUNT; i++)
+	numbers[i] = i;
+    queue_new(&linked, NULL);
+    rqueue_new(&ring, 0, NULL);
+
+    /**
+     * fill the whole queue then drain it, the first round also grows them
+     */
+    start = now();
+    for (j=0; j<ROUNDS; j++){
+	for (i=0; i<COUNT; i++)
+	    queue_in(&linked, &numbers[i]);
+	for (i=0; i<COUNT; i++)
+	    sum += *(int*)queue_out(&linked);
+    }
+    printf("%-8s %6.2f ns/element\n", "queue", (now() - start) * 1e9 / ROUNDS / COUNT);
+
+    start = now();
+    for (j=0; j<ROUNDS; j++){
+	for (i=0; i<COUNT; i++)
+	    rqueue_in(&ring, &numbers[i]);
+	for (i=0; i<COUNT; i++)
+	    sum += *(int*)rqueue_out(&ring);
+    }
+    printf("%-8s %6.2f ns/element\n", "ring", (now() - start) * 1e9 / ROUNDS / COUNT);
+
+    queue_delete(&linked, NULL);
+    rqueue_delete(&ring, NULL);
+    free(numbers);
+    printf("checksum %ld\n", sum);
+
+    return 0;
+}
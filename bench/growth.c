@@ -0,0 +1,66 @@
+/**
+ * @file growth.c
+ * @Brief  benchmark the worst push latency of the array stack against the
+ *         segmented stack while they grow
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-19
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "stack/Stack.h"
+#include "stack/SegmentedStack.h"
+
+#define COUNT 8000000
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void report(const char *name, double total, double worst)
+{
+    printf("%-10s total %8.2f ms  average %6.2f ns  worst push %8.3f ms\n", name,
+	    total * 1e3, total * 1e9 / COUNT, worst * 1e3);
+}
+
+int main()
+{
+    Stack array = STACK_NULL;
+    SegmentedStack segmented = SEGMENTED_STACK_NULL;
+    double start, begin, elapsed, worst;
+    int i;
+
+    stack_new(&array, 0);
+    worst = 0;
+    begin = now();
+    for (i=0; i<COUNT; i++){
+	start = now();
+	stack_push(&array, &array);
+	elapsed = now() - start;
+	if (elapsed > worst)
+	    worst = elapsed;
+    }
+    report("stack", now() - begin, worst);
+    stack_delete(&array, NULL);
+
+    sstack_new(&segmented, 0, NULL);
+    worst = 0;
+    begin = now();
+    for (i=0; i<COUNT; i++){
+	start = now();
+	sstack_push(&segmented, &segmented);
+	elapsed = now() - start;
+	if (elapsed > worst)
+	    worst = elapsed;
+    }
+    report("segmented", now() - begin, worst);
+    sstack_delete(&segmented, NULL);
+
+    return 0;
+}
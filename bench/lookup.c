@@ -0,0 +1,148 @@
+/**
+ * @file lookup.c
+ * @Brief  benchmark a large ordered set, the B+ tree against the skip list
+ *         and the red-black tree; the linked list is left out, a sorted
+ *         insert walks the whole list
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-05-01
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "Common.h"
+#include "slist/Skiplist.h"
+#include "bptree/Bplustree.h"
+#include "rbtree/RBtree.h"
+
+#define COUNT 1000000
+#define SEARCHES 1000000
+#define RANGES 100000
+#define RANGE_WIDTH 100
+#define ROUNDS 10
+
+static long sum = 0;
+
+static int match(void *element, void *arg)
+{
+    return *(int*)element == *(int*)arg ? 0 : -1;
+}
+
+static int destroy(void *element)
+{
+    return 0;
+}
+
+static int iteration(void *element)
+{
+    sum += *(int*)element;
+    return 0;
+}
+
+static int compare(void *key1, void *key2)
+{
+    return *(int*)key1 - *(int*)key2;
+}
+
+static void* key(void *element)
+{
+    return element;
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int *values;
+static int *order;
+static int *keys;
+
+static void bench(const char *name, int (*create)(DataCommon*), \
+	int (*release)(DataCommon*), int (*range)(DataCommon*, void*, void*), int load)
+{
+    DataCommon list = DATA_COMMON_NULL;
+    list.remove_match = match;
+    list.search_match = match;
+    list.alter_match = match;
+    list.destroy_node = destroy;
+    list.handle_iteration = iteration;
+    list.key_compare = compare;
+    list.element_key = key;
+    create(&list);
+
+    int i, high;
+    double start = now();
+    if (load){
+	void **elements = (void**)malloc(COUNT * sizeof(void*));
+	for (i=0; i<COUNT; i++)
+	    elements[i] = &values[i];
+	bptree_load(&list, elements, COUNT);
+	free(elements);
+    }else{
+	for (i=0; i<COUNT; i++)
+	    list.insert(&list, &values[order[i]]);
+    }
+    double build = now() - start;
+
+    start = now();
+    for (i=0; i<SEARCHES; i++)
+	sum += *(int*)list.search(&list, &keys[i]);
+    double search = now() - start;
+
+    start = now();
+    for (i=0; i<ROUNDS; i++)
+	list.iterate(&list);
+    double iterate = now() - start;
+
+    start = now();
+    for (i=0; i<RANGES; i++){
+	high = keys[i] + RANGE_WIDTH;
+	range(&list, &keys[i], &high);
+    }
+    double scan = now() - start;
+
+    printf("%-12s build %7.1f ns/element  search %7.1f ns  iterate %5.2f ns/element"
+	    "  range %8.1f ns\n", name, build * 1e9 / COUNT, search * 1e9 / SEARCHES,
+	    iterate * 1e9 / ROUNDS / COUNT, scan * 1e9 / RANGES);
+    release(&list);
+}
+
+int main()
+{
+    values = (int*)malloc(COUNT * sizeof(int));
+    order = (int*)malloc(COUNT * sizeof(int));
+    keys = (int*)malloc(SEARCHES * sizeof(int));
+    int i, j, temp;
+
+    srand(1);
+    for (i=0; i<COUNT; i++){
+	values[i] = i;
+	order[i] = i;
+    }
+    for (i=COUNT-1; i>0; i--){
+	j = rand() % (i + 1);
+	temp = order[i];
+	order[i] = order[j];
+	order[j] = temp;
+    }
+    for (i=0; i<SEARCHES; i++)
+	keys[i] = rand() % COUNT;
+
+    printf("%d elements, %d random searches, ranges of %d\n", COUNT, SEARCHES, RANGE_WIDTH);
+    bench("slist", slist_new, slist_delete, slist_range_iterate, 0);
+    bench("rbtree", rbtree_new, rbtree_delete, rbtree_range_iterate, 0);
+    bench("bptree", bptree_new, bptree_delete, bptree_range_iterate, 0);
+    bench("bptree load", bptree_new, bptree_delete, bptree_range_iterate, 1);
+    printf("checksum %ld\n", sum);
+
+    free(keys);
+    free(order);
+    free(values);
+
+    return 0;
+}
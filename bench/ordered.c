@@ -0,0 +1,190 @@
+/**
+ * @file ordered.c
+ * @Brief  benchmark keeping the elements sorted, the skip list, the B+ tree
+ *         and the red-black tree against walking a linked list to the place
+ *         of every insert
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-30
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "Common.h"
+#include "llist/Linkedlist.h"
+#include "slist/Skiplist.h"
+#include "bptree/Bplustree.h"
+#include "rbtree/RBtree.h"
+
+#define COUNT 20000
+#define RANGES 10000
+#define RANGE_WIDTH 100
+
+static long sum = 0;
+
+static int match(void *element, void *arg)
+{
+    return *(int*)element == *(int*)arg ? 0 : -1;
+}
+
+static int destroy(void *element)
+{
+    return 0;
+}
+
+static int iteration(void *element)
+{
+    sum += *(int*)element;
+    return 0;
+}
+
+static int compare(void *key1, void *key2)
+{
+    return *(int*)key1 - *(int*)key2;
+}
+
+static void* key(void *element)
+{
+    return element;
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * insert after the last element that is less, a cursor off the list
+ * inserts at the front
+ */
+static void sorted_insert(DataCommon *list, int *value)
+{
+    Cursor cursor = CURSOR_NULL;
+    Cursor previous = CURSOR_NULL;
+    int *element = NULL;
+
+    list->begin(list, &cursor);
+    while ((element = (int*)list->get(list, &cursor)) != NULL && *element < *value){
+	previous = cursor;
+	list->advance(list, &cursor);
+    }
+    list->insert_after(list, &previous, value);
+}
+
+/**
+ * iterate [low, low + RANGE_WIDTH) of the sorted linked list
+ */
+static void sorted_range(DataCommon *list, int low)
+{
+    Cursor cursor = CURSOR_NULL;
+    int *element = NULL;
+
+    list->begin(list, &cursor);
+    while ((element = (int*)list->get(list, &cursor)) != NULL && *element < low)
+	list->advance(list, &cursor);
+    while ((element = (int*)list->get(list, &cursor)) != NULL && *element < low + RANGE_WIDTH){
+	iteration(element);
+	list->advance(list, &cursor);
+    }
+}
+
+int main()
+{
+    int *values = (int*)malloc(COUNT * sizeof(int));
+    int *lows = (int*)malloc(RANGES * sizeof(int));
+    int i, j, temp;
+
+    /**
+     * the numbers in a shuffled order
+     */
+    srand(1);
+    for (i=0; i<COUNT; i++)
+	values[i] = i;
+    for (i=COUNT-1; i>0; i--){
+	j = rand() % (i + 1);
+	temp = values[i];
+	values[i] = values[j];
+	values[j] = temp;
+    }
+    for (i=0; i<RANGES; i++)
+	lows[i] = rand() % COUNT;
+
+    DataCommon list = DATA_COMMON_NULL;
+    list.remove_match = match;
+    list.search_match = match;
+    list.alter_match = match;
+    list.destroy_node = destroy;
+    list.handle_iteration = iteration;
+    list.key_compare = compare;
+    list.element_key = key;
+
+    llist_new(&list);
+    double start = now();
+    for (i=0; i<COUNT; i++)
+	sorted_insert(&list, &values[i]);
+    double linked_insert = now() - start;
+    start = now();
+    for (i=0; i<RANGES; i++)
+	sorted_range(&list, lows[i]);
+    double linked_range = now() - start;
+    llist_delete(&list);
+
+    slist_new(&list);
+    start = now();
+    for (i=0; i<COUNT; i++)
+	list.insert(&list, &values[i]);
+    double skip_insert = now() - start;
+    start = now();
+    for (i=0; i<RANGES; i++){
+	temp = lows[i] + RANGE_WIDTH;
+	slist_range_iterate(&list, &lows[i], &temp);
+    }
+    double skip_range = now() - start;
+    slist_delete(&list);
+
+    bptree_new(&list);
+    start = now();
+    for (i=0; i<COUNT; i++)
+	list.insert(&list, &values[i]);
+    double tree_insert = now() - start;
+    start = now();
+    for (i=0; i<RANGES; i++){
+	temp = lows[i] + RANGE_WIDTH;
+	bptree_range_iterate(&list, &lows[i], &temp);
+    }
+    double tree_range = now() - start;
+    bptree_delete(&list);
+
+    rbtree_new(&list);
+    start = now();
+    for (i=0; i<COUNT; i++)
+	list.insert(&list, &values[i]);
+    double red_insert = now() - start;
+    start = now();
+    for (i=0; i<RANGES; i++){
+	temp = lows[i] + RANGE_WIDTH;
+	rbtree_range_iterate(&list, &lows[i], &temp);
+    }
+    double red_range = now() - start;
+    rbtree_delete(&list);
+
+    printf("%d elements, %d ranges of %d\n", COUNT, RANGES, RANGE_WIDTH);
+    printf("%-8s insert %10.1f ns/element  range %10.1f ns/range\n", "llist",
+	    linked_insert * 1e9 / COUNT, linked_range * 1e9 / RANGES);
+    printf("%-8s insert %10.1f ns/element  range %10.1f ns/range\n", "slist",
+	    skip_insert * 1e9 / COUNT, skip_range * 1e9 / RANGES);
+    printf("%-8s insert %10.1f ns/element  range %10.1f ns/range\n", "bptree",
+	    tree_insert * 1e9 / COUNT, tree_range * 1e9 / RANGES);
+    printf("%-8s insert %10.1f ns/element  range %10.1f ns/range\n", "rbtree",
+	    red_insert * 1e9 / COUNT, red_range * 1e9 / RANGES);
+    printf("checksum %ld\n", sum);
+
+    free(lows);
+    free(values);
+
+    return 0;
+}
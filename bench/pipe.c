@@ -0,0 +1,141 @@
+/**
+ * @file pipe.c
+ * @Brief  benchmark one producer and one consumer thread through a
+ *         mutex-wrapped queue and through the spsc queue
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-21
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+
+#include "queue/Queue.h"
+#include "queue/SpscQueue.h"
+
+#define COUNT 10000000
+#define CAPACITY 4096
+#define BATCH 32
+
+static Queue locked = QUEUE_INIT;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static SpscQueue ring;
+static int value = 0;
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void* locked_producer(void *arg)
+{
+    int i;
+    for (i=0; i<COUNT; i++){
+	pthread_mutex_lock(&lock);
+	queue_in(&locked, &value);
+	pthread_mutex_unlock(&lock);
+    }
+    return NULL;
+}
+
+static void locked_consumer(void)
+{
+    void *element = NULL;
+    int i = 0;
+    while (i < COUNT){
+	pthread_mutex_lock(&lock);
+	element = QUEUE_EMPTY((&locked)) ? NULL : queue_out(&locked);
+	pthread_mutex_unlock(&lock);
+	if (element != NULL)
+	    i++;
+	else
+	    sched_yield();
+    }
+}
+
+static void* spsc_producer(void *arg)
+{
+    int i = 0;
+    while (i < COUNT){
+	if (spsc_in(&ring, &value) == 0)
+	    i++;
+	else
+	    sched_yield();
+    }
+    return NULL;
+}
+
+static void spsc_consumer(void)
+{
+    int i = 0;
+    while (i < COUNT){
+	if (spsc_out(&ring) != NULL)
+	    i++;
+	else
+	    sched_yield();
+    }
+}
+
+static void* batch_producer(void *arg)
+{
+    void *batch[BATCH];
+    unsigned int i, n;
+    for (i=0; i<BATCH; i++)
+	batch[i] = &value;
+
+    i = 0;
+    while (i < COUNT){
+	n = COUNT - i < BATCH ? COUNT - i : BATCH;
+	n = spsc_in_n(&ring, batch, n);
+	if (n != 0)
+	    i += n;
+	else
+	    sched_yield();
+    }
+    return NULL;
+}
+
+static void batch_consumer(void)
+{
+    void *batch[BATCH];
+    unsigned int i = 0, n;
+    while (i < COUNT){
+	n = spsc_out_n(&ring, batch, BATCH);
+	if (n != 0)
+	    i += n;
+	else
+	    sched_yield();
+    }
+}
+
+static void run(const char *name, void* (*producer)(void*), void (*consumer)(void))
+{
+    pthread_t thread;
+    double start = now();
+
+    pthread_create(&thread, NULL, producer, NULL);
+    consumer();
+    pthread_join(thread, NULL);
+
+    printf("%-8s %8.2f Mops/s\n", name, COUNT / (now() - start) / 1e6);
+}
+
+int main()
+{
+    queue_new(&locked, NULL);
+    spsc_new(&ring, CAPACITY, NULL);
+
+    run("mutex", locked_producer, locked_consumer);
+    run("spsc", spsc_producer, spsc_consumer);
+    run("batch", batch_producer, batch_consumer);
+
+    queue_delete(&locked, NULL);
+    spsc_delete(&ring, NULL);
+
+    return 0;
+}
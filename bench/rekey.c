@@ -0,0 +1,133 @@
+/**
+ * @file rekey.c
+ * @Brief  benchmark changing the priority of queued elements, the indexed
+ *         queue against removing and inserting again in a sorted linked list
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-26
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "Common.h"
+#include "llist/Linkedlist.h"
+#include "queue/IndexedQueue.h"
+
+#define COUNT 5000
+#define UPDATES 20000
+
+typedef struct Task{
+    int priority;
+    int id;
+}Task;
+
+static int same(void *element, void *arg)
+{
+    return element == arg ? 0 : -1;
+}
+
+static int destroy(void *element)
+{
+    return 0;
+}
+
+static int iteration(void *element)
+{
+    return 0;
+}
+
+static int compare(void *element1, void *element2)
+{
+    return ((Task*)element1)->priority - ((Task*)element2)->priority;
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * insert after the last element whose priority is not greater, a cursor
+ * off the list inserts at the front
+ */
+static void sorted_insert(DataCommon *list, Task *task)
+{
+    Cursor cursor = CURSOR_NULL;
+    Cursor previous = CURSOR_NULL;
+    Task *element = NULL;
+
+    list->begin(list, &cursor);
+    while ((element = (Task*)list->get(list, &cursor)) != NULL \
+	    && element->priority <= task->priority){
+	previous = cursor;
+	list->advance(list, &cursor);
+    }
+    list->insert_after(list, &previous, task);
+}
+
+int main()
+{
+    Task *tasks = (Task*)malloc(COUNT * sizeof(Task));
+    int *picks = (int*)malloc(UPDATES * sizeof(int));
+    int *priorities = (int*)malloc(UPDATES * sizeof(int));
+    int i;
+
+    srand(1);
+    for (i=0; i<UPDATES; i++){
+	picks[i] = rand() % COUNT;
+	priorities[i] = rand() % (COUNT * 4);
+    }
+
+    DataCommon list = DATA_COMMON_NULL;
+    list.remove_match = same;
+    list.search_match = same;
+    list.alter_match = same;
+    list.destroy_node = destroy;
+    list.handle_iteration = iteration;
+    llist_new(&list);
+    for (i=0; i<COUNT; i++){
+	tasks[i].priority = i * 4;
+	tasks[i].id = i;
+	list.insert(&list, &tasks[i]);
+    }
+
+    double start = now();
+    for (i=0; i<UPDATES; i++){
+	list.remove(&list, &tasks[picks[i]]);
+	tasks[picks[i]].priority = priorities[i];
+	sorted_insert(&list, &tasks[picks[i]]);
+    }
+    double linked = now() - start;
+    llist_delete(&list);
+
+    IndexedQueue queue = INDEXED_QUEUE_NULL;
+    int *handles = (int*)malloc(COUNT * sizeof(int));
+    iqueue_new(&queue, 0, compare, NULL);
+    for (i=0; i<COUNT; i++){
+	tasks[i].priority = i * 4;
+	handles[i] = iqueue_push(&queue, &tasks[i]);
+    }
+
+    start = now();
+    for (i=0; i<UPDATES; i++){
+	tasks[picks[i]].priority = priorities[i];
+	iqueue_update(&queue, handles[picks[i]]);
+    }
+    double indexed = now() - start;
+    iqueue_delete(&queue, NULL);
+
+    printf("%d elements, %d priority changes\n", COUNT, UPDATES);
+    printf("%-14s %10.1f ns/change\n", "llist", linked * 1e9 / UPDATES);
+    printf("%-14s %10.1f ns/change\n", "indexed queue", indexed * 1e9 / UPDATES);
+
+    free(handles);
+    free(priorities);
+    free(picks);
+    free(tasks);
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file scan.c
+ * @Brief  benchmark search/iterate of the linked list, the unrolled list,
+ *         the hash indexed linked list, the intrusive list and the hash table
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-08
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <time.h>
+
+#include "Common.h"
+#include "llist/Linkedlist.h"
+#include "ulist/Unrolledlist.h"
+#include "ilist/Intrusivelist.h"
+#include "htable/Hashtable.h"
+
+#define COUNT 1000000
+#define ROUNDS 20
+
+static long sum = 0;
+
+/**
+ * element of the intrusive list, the value is the first member so the same
+ * match functions work for all the lists
+ */
+typedef struct Item{
+    int value;
+    ILink link;
+}Item;
+
+static int match(void *element, void *arg)
+{
+    return *(int*)element == *(int*)arg ? 0 : -1;
+}
+
+static int destroy(void *element)
+{
+    return 0;
+}
+
+static int iteration(void *element)
+{
+    sum += *(int*)element;
+    return 0;
+}
+
+static unsigned long hash(void *key)
+{
+    return (unsigned long)*(int*)key;
+}
+
+static void* key(void *element)
+{
+    return element;
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int ilist_create(DataCommon *common)
+{
+    return ilist_new(common, offsetof(Item, link));
+}
+
+static void bench(const char *name, int (*create)(DataCommon*), \
+	int (*release)(DataCommon*), char *elements, size_t stride, int indexed)
+{
+    DataCommon list = DATA_COMMON_NULL;
+    list.remove_match = match;
+    list.search_match = match;
+    list.alter_match = match;
+    list.destroy_node = destroy;
+    list.handle_iteration = iteration;
+    if (indexed){
+	list.key_hash = hash;
+	list.key_equal = match;
+	list.element_key = key;
+    }
+    create(&list);
+
+    int i;
+    for (i=0; i<COUNT; i++)
+	list.insert(&list, elements + i * stride);
+
+    double start = now();
+    for (i=0; i<ROUNDS; i++)
+	list.iterate(&list);
+    double iterate = now() - start;
+
+    /**
+     * search the last element, the whole list is scanned
+     */
+    start = now();
+    for (i=0; i<ROUNDS; i++)
+	list.search(&list, elements + (COUNT - 1) * stride);
+    double search = now() - start;
+
+    printf("%-8s iterate %6.2f ns/element  search %6.2f ns/element\n", name,
+	    iterate * 1e9 / ROUNDS / COUNT, search * 1e9 / ROUNDS / COUNT);
+    release(&list);
+}
+
+int main()
+{
+    int *numbers = (int*)malloc(COUNT * sizeof(int));
+    int i;
+    for (i=0; i<COUNT; i++)
+	numbers[i] = i;
+
+    Item *items = (Item*)malloc(COUNT * sizeof(Item));
+    for (i=0; i<COUNT; i++)
+	items[i].value = i;
+
+    bench("llist", llist_new, llist_delete, (char*)numbers, sizeof(int), 0);
+    bench("ulist", ulist_new, ulist_delete, (char*)numbers, sizeof(int), 0);
+    bench("indexed", llist_new, llist_delete, (char*)numbers, sizeof(int), 1);
+    bench("ilist", ilist_create, ilist_delete, (char*)items, sizeof(Item), 0);
+    bench("htable", htable_new, htable_delete, (char*)numbers, sizeof(int), 1);
+
+    free(numbers);
+    free(items);
+    printf("checksum %ld\n", sum);
+
+    return 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file timers.c
+ * @Brief  benchmark the cost of a tick, scanning a double linked list of
+ *         deadlines against the timer wheel, usage: timers [timers]
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-28
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "Common.h"
+#include "dllist/DLinkedlist.h"
+#include "timer/TimerWheel.h"
+
+#define DEFAULT_TIMERS 200000
+#define SPAN 60000
+#define TICKS 1000
+
+typedef struct Connection{
+    unsigned long deadline;
+    Timer timer;
+}Connection;
+
+static unsigned long current = 0;
+static long expired = 0;
+
+static int same(void *element, void *arg)
+{
+    return element == arg ? 0 : -1;
+}
+
+static int destroy(void *element)
+{
+    return 0;
+}
+
+/**
+ * what the tick does for every deadline in the list
+ */
+static int check(void *element)
+{
+    if (((Connection*)element)->deadline == current)
+	expired++;
+    return 0;
+}
+
+static void fire(Timer *timer)
+{
+    expired++;
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[])
+{
+    int count = argc > 1 ? atoi(argv[1]) : DEFAULT_TIMERS;
+    Connection *connections = (Connection*)malloc(count * sizeof(Connection));
+    int i;
+
+    srand(1);
+    for (i=0; i<count; i++)
+	connections[i].deadline = 1 + rand() % SPAN;
+
+    DataCommon list = DATA_COMMON_NULL;
+    list.remove_match = same;
+    list.search_match = same;
+    list.alter_match = same;
+    list.destroy_node = destroy;
+    list.handle_iteration = check;
+    dllist_new(&list);
+    for (i=0; i<count; i++)
+	list.insert(&list, &connections[i]);
+
+    double start = now();
+    for (current=1; current<=TICKS; current++)
+	list.iterate(&list);
+    double scan = now() - start;
+    long scanned = expired;
+    dllist_delete(&list);
+
+    TimerWheel wheel;
+    twheel_new(&wheel, 0);
+    for (i=0; i<count; i++){
+	connections[i].timer.link.previous = NULL;
+	connections[i].timer.link.next = NULL;
+	connections[i].timer.callback = fire;
+	twheel_schedule(&wheel, &connections[i].timer, connections[i].deadline);
+    }
+
+    expired = 0;
+    start = now();
+    for (current=1; current<=TICKS; current++)
+	twheel_advance(&wheel, current);
+    double wheeled = now() - start;
+    twheel_clear(&wheel);
+
+    printf("%d timers, %d ticks, %ld expired\n", count, TICKS, scanned);
+    printf("%-8s %12.1f us/tick\n", "dllist", scan * 1e6 / TICKS);
+    printf("%-8s %12.1f us/tick (%ld expired)\n", "wheel", wheeled * 1e6 / TICKS, expired);
+
+    free(connections);
+
+    return 0;
+}
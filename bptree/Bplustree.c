@@ -0,0 +1,1450 @@
+/**
+ * @file Bplustree.c
+ * @Brief  B+ tree implementation. The elements live in the leaves, an
+ *         inner node only routes a lookup by the keys of the first elements
+ *         of its subtrees. A full node splits in two halves and a node
+ *         under half full borrows from a sibling or merges with it
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-05-01
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Bplustree.h"
+#include "util/Log.h"
+
+#define BPTREE_INNER_MIN (BPTREE_INNER / 2)
+#define BPTREE_LEAF_MIN (BPTREE_LEAF / 2)
+
+/**
+ * a node of either kind fits in one, so the spare nodes serve both
+ */
+#define BPTREE_NODE_SIZE (sizeof(BPlusInner) > sizeof(BPlusLeaf) \
+	? sizeof(BPlusInner) : sizeof(BPlusLeaf))
+
+#define BPTREE_KEY(common, element) ((common)->element_key(element))
+#define BPTREE_COMPARE(common, element, key) ((common)->key_compare(BPTREE_KEY(common, element), key))
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_bound binary search in the elements of a node, each probe
+ *         calls element_key on an element out of the node, which is one
+ *         more miss when it is cold
+ *
+ * @Param common data common struct
+ * @Param elements the elements or the keys of the node
+ * @Param count the number of them
+ * @Param key the key
+ * @Param inclusive 0 means skip the elements less than the key; other
+ *        means skip the elements not greater than the key
+ *
+ * @Returns   the index of the first element that is not skipped
+ */
+/* ----------------------------------------------------------------------------*/
+static int bptree_bound(DataCommon *common, void **elements, int count, void *key, \
+	int inclusive)
+{
+    int low = 0, high = count, middle;
+
+    while (low < high){
+	middle = (low + high) / 2;
+	if (BPTREE_COMPARE(common, elements[middle], key) < inclusive)
+	    low = middle + 1;
+	else
+	    high = middle;
+    }
+
+    return low;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_leaf find the leaf where a key is or would be
+ *
+ * @Param common data common struct
+ * @Param key the key
+ * @Param index where the index of the first element not less than the key
+ *        is put
+ *
+ * @Returns   the leaf
+ */
+/* ----------------------------------------------------------------------------*/
+static BPlusLeaf* bptree_leaf(DataCommon *common, void *key, int *index)
+{
+    BPlusTree *tree = (BPlusTree*)(common->linked_type);
+    void *node = tree->root;
+    BPlusInner *inner = NULL;
+    int level;
+
+    for (level=tree->height; level>1; level--){
+	inner = (BPlusInner*)node;
+	node = inner->children[bptree_bound(common, inner->keys, inner->count, key, 1)];
+    }
+
+    BPlusLeaf *leaf = (BPlusLeaf*)node;
+    *index = bptree_bound(common, leaf->elements, leaf->count, key, 0);
+
+    return leaf;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_find find the place of a key
+ *
+ * @Param common data common struct
+ * @Param key the key
+ * @Param index where the index in the leaf is put
+ *
+ * @Returns   NULL means no one; other is the leaf
+ */
+/* ----------------------------------------------------------------------------*/
+static BPlusLeaf* bptree_find(DataCommon *common, void *key, int *index)
+{
+    BPlusLeaf *leaf = bptree_leaf(common, key, index);
+
+    if (*index == leaf->count || BPTREE_COMPARE(common, leaf->elements[*index], key) != 0)
+	return NULL;
+
+    return leaf;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_first get the first element of a subtree
+ *
+ * @Param node the root of the subtree
+ * @Param level the height of the subtree
+ *
+ * @Returns   the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* bptree_first(void *node, int level)
+{
+    for (; level>1; level--)
+	node = ((BPlusInner*)node)->children[0];
+
+    return ((BPlusLeaf*)node)->elements[0];
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_node get a node from the spare ones or the allocator
+ *
+ * @Param common data common struct
+ *
+ * @Returns   NULL is failed; other is the node
+ */
+/* ----------------------------------------------------------------------------*/
+static void* bptree_node(DataCommon *common)
+{
+    BPlusTree *tree = (BPlusTree*)(common->linked_type);
+    void *node = tree->spare;
+
+    if (node){
+	tree->spare = *(void**)node;
+	tree->spare_count--;
+	return node;
+    }
+
+    node = mem_alloc(common->allocator, BPTREE_NODE_SIZE);
+    if (node == NULL)
+	ERROR("malloc error!");
+
+    return node;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_release give a node back, it is kept while the spare ones
+ *         are not enough for an insert
+ *
+ * @Param common data common struct
+ * @Param node the node
+ */
+/* ----------------------------------------------------------------------------*/
+static void bptree_release(DataCommon *common, void *node)
+{
+    BPlusTree *tree = (BPlusTree*)(common->linked_type);
+
+    if (tree->spare_count > tree->height){
+	mem_free(common->allocator, node);
+	return;
+    }
+    *(void**)node = tree->spare;
+    tree->spare = node;
+    tree->spare_count++;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_reserve make the spare nodes enough
+ *
+ * @Param common data common struct
+ * @Param count the number of nodes
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int bptree_reserve(DataCommon *common, int count)
+{
+    BPlusTree *tree = (BPlusTree*)(common->linked_type);
+    void *node = NULL;
+
+    while (tree->spare_count < count){
+	node = mem_alloc(common->allocator, BPTREE_NODE_SIZE);
+	if (node == NULL){
+	    ERROR("malloc error!");
+	    return -1;
+	}
+	*(void**)node = tree->spare;
+	tree->spare = node;
+	tree->spare_count++;
+    }
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_free free a subtree
+ *
+ * @Param common data common struct
+ * @Param node the root of the subtree
+ * @Param level the height of the subtree
+ * @Param destroy 0 means keep the elements; other means destroy them
+ */
+/* ----------------------------------------------------------------------------*/
+static void bptree_free(DataCommon *common, void *node, int level, int destroy)
+{
+    int i;
+
+    if (level == 1){
+	BPlusLeaf *leaf = (BPlusLeaf*)node;
+	for (i=0; destroy && i<leaf->count; i++)
+	    common->destroy_node(leaf->elements[i]);
+    }else{
+	BPlusInner *inner = (BPlusInner*)node;
+	for (i=0; i<=inner->count; i++)
+	    bptree_free(common, inner->children[i], level - 1, destroy);
+    }
+    bptree_release(common, node);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_new_leaf create an empty leaf
+ *
+ * @Param common data common struct
+ *
+ * @Returns   NULL is failed; other is the leaf
+ */
+/* ----------------------------------------------------------------------------*/
+static BPlusLeaf* bptree_new_leaf(DataCommon *common)
+{
+    BPlusLeaf *leaf = (BPlusLeaf*)bptree_node(common);
+    if (leaf == NULL)
+	return NULL;
+    leaf->count = 0;
+    leaf->previous = NULL;
+    leaf->next = NULL;
+
+    return leaf;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_new_inner create an empty inner node
+ *
+ * @Param common data common struct
+ *
+ * @Returns   NULL is failed; other is the node
+ */
+/* ----------------------------------------------------------------------------*/
+static BPlusInner* bptree_new_inner(DataCommon *common)
+{
+    BPlusInner *inner = (BPlusInner*)bptree_node(common);
+    if (inner == NULL)
+	return NULL;
+    inner->count = 0;
+
+    return inner;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_split_leaf put an element in a full leaf, the upper half
+ *         moves to a new leaf on its right
+ *
+ * @Param common data common struct
+ * @Param leaf the leaf
+ * @Param index the place of the element
+ * @Param element the element
+ *
+ * @Returns   NULL is failed; other is the new leaf
+ */
+/* ----------------------------------------------------------------------------*/
+static BPlusLeaf* bptree_split_leaf(DataCommon *common, BPlusLeaf *leaf, int index, \
+	void *element)
+{
+    BPlusTree *tree = (BPlusTree*)(common->linked_type);
+    BPlusLeaf *right = bptree_new_leaf(common);
+    if (right == NULL)
+	return NULL;
+
+    void *elements[BPTREE_LEAF + 1];
+    memcpy(elements, leaf->elements, index * sizeof(void*));
+    elements[index] = element;
+    memcpy(elements + index + 1, leaf->elements + index, (leaf->count - index) * sizeof(void*));
+
+    int left = (BPTREE_LEAF + 1) / 2;
+    memcpy(leaf->elements, elements, left * sizeof(void*));
+    memcpy(right->elements, elements + left, (BPTREE_LEAF + 1 - left) * sizeof(void*));
+    leaf->count = left;
+    right->count = BPTREE_LEAF + 1 - left;
+
+    right->previous = leaf;
+    right->next = leaf->next;
+    if (leaf->next)
+	leaf->next->previous = right;
+    else
+	tree->last = right;
+    leaf->next = right;
+
+    return right;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_split_inner put a key and the child on its right in a full
+ *         inner node, the middle key goes up and the keys after it move to
+ *         a new node
+ *
+ * @Param common data common struct
+ * @Param inner the node
+ * @Param index the place of the key
+ * @Param key the key
+ * @Param child the child
+ * @Param up where the key that goes up is put
+ *
+ * @Returns   NULL is failed; other is the new node
+ */
+/* ----------------------------------------------------------------------------*/
+static BPlusInner* bptree_split_inner(DataCommon *common, BPlusInner *inner, int index, \
+	void *key, void *child, void **up)
+{
+    BPlusInner *right = bptree_new_inner(common);
+    if (right == NULL)
+	return NULL;
+
+    void *keys[BPTREE_INNER + 1];
+    void *children[BPTREE_INNER + 2];
+    memcpy(keys, inner->keys, index * sizeof(void*));
+    keys[index] = key;
+    memcpy(keys + index + 1, inner->keys + index, (inner->count - index) * sizeof(void*));
+    memcpy(children, inner->children, (index + 1) * sizeof(void*));
+    children[index + 1] = child;
+    memcpy(children + index + 2, inner->children + index + 1, \
+	    (inner->count - index) * sizeof(void*));
+
+    int left = (BPTREE_INNER + 1) / 2;
+    memcpy(inner->keys, keys, left * sizeof(void*));
+    memcpy(inner->children, children, (left + 1) * sizeof(void*));
+    inner->count = left;
+    *up = keys[left];
+    memcpy(right->keys, keys + left + 1, (BPTREE_INNER - left) * sizeof(void*));
+    memcpy(right->children, children + left + 1, (BPTREE_INNER - left + 1) * sizeof(void*));
+    right->count = BPTREE_INNER - left;
+
+    return right;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_insert_node insert an element in a subtree
+ *
+ * @Param common data common struct
+ * @Param node the root of the subtree
+ * @Param level the height of the subtree
+ * @Param element the element
+ * @Param key the key of the element
+ * @Param up where the key is put when the root of the subtree splits
+ * @Param split where the new node on its right is put
+ *
+ * @Returns   0 is OK; 1 means the root splits; -1 is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int bptree_insert_node(DataCommon *common, void *node, int level, void *element, \
+	void *key, void **up, void **split)
+{
+    int index, ret;
+
+    if (level == 1){
+	BPlusLeaf *leaf = (BPlusLeaf*)node;
+	index = bptree_bound(common, leaf->elements, leaf->count, key, 0);
+	if (index < leaf->count && BPTREE_COMPARE(common, leaf->elements[index], key) == 0){
+	    INFO("the key is in the tree!");
+	    return -1;
+	}
+	if (leaf->count < BPTREE_LEAF){
+	    memmove(leaf->elements + index + 1, leaf->elements + index, \
+		    (leaf->count - index) * sizeof(void*));
+	    leaf->elements[index] = element;
+	    leaf->count++;
+	    return 0;
+	}
+	BPlusLeaf *right = bptree_split_leaf(common, leaf, index, element);
+	if (right == NULL)
+	    return -1;
+	*up = right->elements[0];
+	*split = right;
+	return 1;
+    }
+
+    BPlusInner *inner = (BPlusInner*)node;
+    void *child_key = NULL;
+    void *child = NULL;
+    index = bptree_bound(common, inner->keys, inner->count, key, 1);
+    ret = bptree_insert_node(common, inner->children[index], level - 1, element, key, \
+	    &child_key, &child);
+    if (ret != 1)
+	return ret;
+
+    if (inner->count < BPTREE_INNER){
+	memmove(inner->keys + index + 1, inner->keys + index, \
+		(inner->count - index) * sizeof(void*));
+	memmove(inner->children + index + 2, inner->children + index + 1, \
+		(inner->count - index) * sizeof(void*));
+	inner->keys[index] = child_key;
+	inner->children[index + 1] = child;
+	inner->count++;
+	return 0;
+    }
+    *split = bptree_split_inner(common, inner, index, child_key, child, up);
+
+    return 1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_fix_leaf make the leaf children[index] at least half full,
+ *         by a sibling
+ *
+ * @Param common data common struct
+ * @Param parent the parent of the leaf
+ * @Param index the index of the leaf
+ */
+/* ----------------------------------------------------------------------------*/
+static void bptree_fix_leaf(DataCommon *common, BPlusInner *parent, int index)
+{
+    BPlusTree *tree = (BPlusTree*)(common->linked_type);
+    BPlusLeaf *leaf = (BPlusLeaf*)(parent->children[index]);
+    BPlusLeaf *left = index > 0 ? (BPlusLeaf*)(parent->children[index - 1]) : NULL;
+    BPlusLeaf *right = index < parent->count ? (BPlusLeaf*)(parent->children[index + 1]) : NULL;
+
+    if (left && left->count > BPTREE_LEAF_MIN){
+	memmove(leaf->elements + 1, leaf->elements, leaf->count * sizeof(void*));
+	leaf->elements[0] = left->elements[--left->count];
+	leaf->count++;
+	parent->keys[index - 1] = leaf->elements[0];
+	return;
+    }
+    if (right && right->count > BPTREE_LEAF_MIN){
+	leaf->elements[leaf->count++] = right->elements[0];
+	memmove(right->elements, right->elements + 1, --right->count * sizeof(void*));
+	parent->keys[index] = right->elements[0];
+	return;
+    }
+
+    /**
+     * merge into the left one of the two, the key between them goes away
+     */
+    if (left == NULL){
+	left = leaf;
+	leaf = right;
+	index++;
+    }
+    memcpy(left->elements + left->count, leaf->elements, leaf->count * sizeof(void*));
+    left->count += leaf->count;
+    left->next = leaf->next;
+    if (leaf->next)
+	leaf->next->previous = left;
+    else
+	tree->last = left;
+    bptree_release(common, leaf);
+
+    memmove(parent->keys + index - 1, parent->keys + index, \
+	    (parent->count - index) * sizeof(void*));
+    memmove(parent->children + index, parent->children + index + 1, \
+	    (parent->count - index) * sizeof(void*));
+    parent->count--;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_fix_inner make the inner node children[index] at least
+ *         half full, by a sibling
+ *
+ * @Param common data common struct
+ * @Param parent the parent of the node
+ * @Param index the index of the node
+ */
+/* ----------------------------------------------------------------------------*/
+static void bptree_fix_inner(DataCommon *common, BPlusInner *parent, int index)
+{
+    BPlusInner *inner = (BPlusInner*)(parent->children[index]);
+    BPlusInner *left = index > 0 ? (BPlusInner*)(parent->children[index - 1]) : NULL;
+    BPlusInner *right = index < parent->count ? (BPlusInner*)(parent->children[index + 1]) : NULL;
+
+    /**
+     * the key in the parent comes down and the key of the sibling goes up
+     */
+    if (left && left->count > BPTREE_INNER_MIN){
+	memmove(inner->keys + 1, inner->keys, inner->count * sizeof(void*));
+	memmove(inner->children + 1, inner->children, (inner->count + 1) * sizeof(void*));
+	inner->keys[0] = parent->keys[index - 1];
+	inner->children[0] = left->children[left->count];
+	inner->count++;
+	parent->keys[index - 1] = left->keys[--left->count];
+	return;
+    }
+    if (right && right->count > BPTREE_INNER_MIN){
+	inner->keys[inner->count] = parent->keys[index];
+	inner->children[inner->count + 1] = right->children[0];
+	inner->count++;
+	parent->keys[index] = right->keys[0];
+	memmove(right->keys, right->keys + 1, (right->count - 1) * sizeof(void*));
+	memmove(right->children, right->children + 1, right->count * sizeof(void*));
+	right->count--;
+	return;
+    }
+
+    if (left == NULL){
+	left = inner;
+	inner = right;
+	index++;
+    }
+    left->keys[left->count] = parent->keys[index - 1];
+    memcpy(left->keys + left->count + 1, inner->keys, inner->count * sizeof(void*));
+    memcpy(left->children + left->count + 1, inner->children, \
+	    (inner->count + 1) * sizeof(void*));
+    left->count += inner->count + 1;
+    bptree_release(common, inner);
+
+    memmove(parent->keys + index - 1, parent->keys + index, \
+	    (parent->count - index) * sizeof(void*));
+    memmove(parent->children + index, parent->children + index + 1, \
+	    (parent->count - index) * sizeof(void*));
+    parent->count--;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_remove_node take the element of a key out of a subtree,
+ *         the element is not destroyed
+ *
+ * @Param common data common struct
+ * @Param node the root of the subtree
+ * @Param level the height of the subtree
+ * @Param key the key
+ *
+ * @Returns   NULL means no one; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* bptree_remove_node(DataCommon *common, void *node, int level, void *key)
+{
+    int index;
+    void *element = NULL;
+
+    if (level == 1){
+	BPlusLeaf *leaf = (BPlusLeaf*)node;
+	index = bptree_bound(common, leaf->elements, leaf->count, key, 0);
+	if (index == leaf->count || BPTREE_COMPARE(common, leaf->elements[index], key) != 0)
+	    return NULL;
+	element = leaf->elements[index];
+	memmove(leaf->elements + index, leaf->elements + index + 1, \
+		(leaf->count - index - 1) * sizeof(void*));
+	leaf->count--;
+	return element;
+    }
+
+    BPlusInner *inner = (BPlusInner*)node;
+    index = bptree_bound(common, inner->keys, inner->count, key, 1);
+    element = bptree_remove_node(common, inner->children[index], level - 1, key);
+    if (element == NULL)
+	return NULL;
+
+    if (level == 2 && ((BPlusLeaf*)(inner->children[index]))->count < BPTREE_LEAF_MIN)
+	bptree_fix_leaf(common, inner, index);
+    else if (level > 2 && ((BPlusInner*)(inner->children[index]))->count < BPTREE_INNER_MIN)
+	bptree_fix_inner(common, inner, index);
+
+    return element;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_take take the element of a key out of the tree, the
+ *         element is not destroyed
+ *
+ * @Param common data common struct
+ * @Param key the key
+ *
+ * @Returns   NULL means no one; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* bptree_take(DataCommon *common, void *key)
+{
+    BPlusTree *tree = (BPlusTree*)(common->linked_type);
+    void *element = bptree_remove_node(common, tree->root, tree->height, key);
+    if (element == NULL)
+	return NULL;
+    tree->size--;
+
+    if (tree->height > 1 && ((BPlusInner*)(tree->root))->count == 0){
+	void *root = ((BPlusInner*)(tree->root))->children[0];
+	bptree_release(common, tree->root);
+	tree->root = root;
+	tree->height--;
+    }
+
+    /**
+     * an inner node may still route by the element, it is replaced by the
+     * element after it before the element is gone
+     */
+    void *node = tree->root;
+    BPlusInner *inner = NULL;
+    int level, index;
+    for (level=tree->height; level>1; level--){
+	inner = (BPlusInner*)node;
+	index = bptree_bound(common, inner->keys, inner->count, key, 0);
+	if (index < inner->count && inner->keys[index] == element){
+	    inner->keys[index] = bptree_first(inner->children[index + 1], level - 1);
+	    break;
+	}
+	node = inner->children[index];
+    }
+
+    return element;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_insert insert an element at its place, its key must not be
+ *         in the tree
+ *
+ * @Param common data common struct
+ * @Param element the element
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int bptree_insert(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    BPlusTree *tree = (BPlusTree*)(common->linked_type);
+    void *key = BPTREE_KEY(common, element);
+    void *up = NULL;
+    void *split = NULL;
+    BPlusInner *root = NULL;
+
+    /**
+     * every level may split and a new root may be needed
+     */
+    if (bptree_reserve(common, tree->height + 1) != 0)
+	return -1;
+
+    int ret = bptree_insert_node(common, tree->root, tree->height, element, key, &up, &split);
+    if (ret < 0)
+	return -1;
+    if (ret == 1){
+	root = bptree_new_inner(common);
+	root->keys[0] = up;
+	root->children[0] = tree->root;
+	root->children[1] = split;
+	root->count = 1;
+	tree->root = root;
+	tree->height++;
+    }
+    tree->size++;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_remove remove the element of a key and destroy it
+ *
+ * @Param common data common struct
+ * @Param element the key
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int bptree_remove(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    void *removed = bptree_take(common, element);
+    if (removed == NULL)
+	return -1;
+    common->destroy_node(removed);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_search get the element of a key
+ *
+ * @Param common data common struct
+ * @Param element the key
+ *
+ * @Returns   NULL means no one; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* bptree_search(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return NULL;
+    }
+
+    int index;
+    BPlusLeaf *leaf = bptree_find(common, element, &index);
+
+    return leaf == NULL ? NULL : leaf->elements[index];
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_alter alter the element that has the same key, by the
+ *         alter_match function; the function must not change the key
+ *
+ * @Param common data common struct
+ * @Param element the element-like argument
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int bptree_alter(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    int index;
+    BPlusLeaf *leaf = bptree_find(common, BPTREE_KEY(common, element), &index);
+    if (leaf == NULL)
+	return -1;
+
+    return (common->alter_match)(leaf->elements[index], element);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_prior get the element before the one of a key
+ *
+ * @Param common data common struct
+ * @Param element the key
+ *
+ * @Returns   NULL means no one; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* bptree_prior(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return NULL;
+    }
+
+    int index;
+    BPlusLeaf *leaf = bptree_find(common, element, &index);
+    if (leaf == NULL)
+	return NULL;
+    if (index > 0)
+	return leaf->elements[index - 1];
+    if (leaf->previous)
+	return leaf->previous->elements[leaf->previous->count - 1];
+
+    return NULL;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_next get the element after the one of a key
+ *
+ * @Param common data common struct
+ * @Param element the key
+ *
+ * @Returns   NULL means no one; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* bptree_next(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return NULL;
+    }
+
+    int index;
+    BPlusLeaf *leaf = bptree_find(common, element, &index);
+    if (leaf == NULL)
+	return NULL;
+    if (index + 1 < leaf->count)
+	return leaf->elements[index + 1];
+    if (leaf->next)
+	return leaf->next->elements[0];
+
+    return NULL;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_iterate iterate the tree in the order of the keys, leaf
+ *         by leaf
+ *
+ * @Param common data common struct
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int bptree_iterate(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    BPlusLeaf *leaf = ((BPlusTree*)(common->linked_type))->first;
+    int i;
+
+    for (; leaf; leaf=leaf->next)
+	for (i=0; i<leaf->count; i++)
+	    if ((common->handle_iteration)(leaf->elements[i]) != 0){
+		ERROR("handle_iteration function error!");
+		return -1;
+	    }
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_size get the number of elements
+ *
+ * @Param common data common struct
+ *
+ * @Returns   -1 is failed; other is the size
+ */
+/* ----------------------------------------------------------------------------*/
+static int bptree_size(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    return ((BPlusTree*)(common->linked_type))->size;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_clear destroy all the elements, one empty leaf is kept
+ *
+ * @Param common data common struct
+ *
+ * @Returns   -1 is failed; other is the number of elements
+ */
+/* ----------------------------------------------------------------------------*/
+static int bptree_clear(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    BPlusTree *tree = (BPlusTree*)(common->linked_type);
+    void *node = tree->root;
+    BPlusInner *inner = NULL;
+    int level, i;
+
+    /**
+     * the first leaf is the leftmost node of every level, it stays
+     */
+    for (level=tree->height; level>1; level--){
+	inner = (BPlusInner*)node;
+	for (i=1; i<=inner->count; i++)
+	    bptree_free(common, inner->children[i], level - 1, 1);
+	node = inner->children[0];
+	bptree_release(common, inner);
+    }
+    BPlusLeaf *leaf = (BPlusLeaf*)node;
+    for (i=0; i<leaf->count; i++)
+	common->destroy_node(leaf->elements[i]);
+    leaf->count = 0;
+    leaf->next = NULL;
+    tree->root = leaf;
+    tree->height = 1;
+    tree->last = leaf;
+
+    int ret = tree->size;
+    tree->size = 0;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_begin put the cursor on the first element
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means the tree is empty
+ */
+/* ----------------------------------------------------------------------------*/
+static int bptree_begin(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    BPlusLeaf *leaf = ((BPlusTree*)(common->linked_type))->first;
+    cursor->node = leaf->count ? leaf : NULL;
+    cursor->previous = NULL;
+    cursor->index = 0;
+
+    return cursor->node ? 0 : -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_end put the cursor on the last element
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means the tree is empty
+ */
+/* ----------------------------------------------------------------------------*/
+static int bptree_end(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    BPlusLeaf *leaf = ((BPlusTree*)(common->linked_type))->last;
+    cursor->node = leaf->count ? leaf : NULL;
+    cursor->previous = NULL;
+    cursor->index = leaf->count - 1;
+
+    return cursor->node ? 0 : -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_advance move the cursor to the next element
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means the cursor is off the tree
+ */
+/* ----------------------------------------------------------------------------*/
+static int bptree_advance(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+    if (cursor->node == NULL)
+	return -1;
+
+    BPlusLeaf *leaf = (BPlusLeaf*)(cursor->node);
+    if (++cursor->index < leaf->count)
+	return 0;
+    cursor->node = leaf->next;
+    cursor->index = 0;
+
+    return cursor->node ? 0 : -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_retreat move the cursor to the prior element
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means the cursor is off the tree
+ */
+/* ----------------------------------------------------------------------------*/
+static int bptree_retreat(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+    if (cursor->node == NULL)
+	return -1;
+
+    BPlusLeaf *leaf = (BPlusLeaf*)(cursor->node);
+    if (--cursor->index >= 0)
+	return 0;
+    cursor->node = leaf->previous;
+    cursor->index = leaf->previous ? leaf->previous->count - 1 : 0;
+
+    return cursor->node ? 0 : -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_get return the element under the cursor
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   NULL means the cursor is off the tree; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* bptree_get(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return NULL;
+    }
+
+    BPlusLeaf *leaf = (BPlusLeaf*)(cursor->node);
+
+    return leaf == NULL ? NULL : leaf->elements[cursor->index];
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_erase remove the element under the cursor, the cursor
+ *         moves to the next one
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int bptree_erase(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+    if (cursor->node == NULL)
+	return -1;
+
+    BPlusLeaf *leaf = (BPlusLeaf*)(cursor->node);
+    void *element = leaf->elements[cursor->index];
+    void *next = NULL;
+    if (cursor->index + 1 < leaf->count)
+	next = leaf->elements[cursor->index + 1];
+    else if (leaf->next)
+	next = leaf->next->elements[0];
+
+    /**
+     * a merge may move the next element to another leaf, it is found
+     * again by its key
+     */
+    bptree_take(common, BPTREE_KEY(common, element));
+    common->destroy_node(element);
+    if (next)
+	cursor->node = bptree_leaf(common, BPTREE_KEY(common, next), &cursor->index);
+    else
+	cursor->node = NULL;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_insert_after refused as in all the ordered data
+ */
+/* ----------------------------------------------------------------------------*/
+static int bptree_insert_after(DataCommon *common, Cursor *cursor, void *element)
+{
+    (void)common;
+    (void)cursor;
+    (void)element;
+    ERROR("the B+ tree keeps the order, use insert!");
+    return -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_bound_cursor put the cursor on the first element that a
+ *         bound does not skip
+ *
+ * @Param common data common struct
+ * @Param key the key
+ * @Param cursor the cursor
+ * @Param inclusive the same as bptree_bound
+ *
+ * @Returns   0 is OK; -1 means no one
+ */
+/* ----------------------------------------------------------------------------*/
+static int bptree_bound_cursor(DataCommon *common, void *key, Cursor *cursor, int inclusive)
+{
+    BPlusLeaf *leaf = bptree_leaf(common, key, &cursor->index);
+
+    if (inclusive){
+	while (cursor->index < leaf->count \
+		&& BPTREE_COMPARE(common, leaf->elements[cursor->index], key) == 0)
+	    cursor->index++;
+    }
+    /**
+     * the key is after the last element of the leaf
+     */
+    if (cursor->index == leaf->count){
+	leaf = leaf->next;
+	cursor->index = 0;
+    }
+    cursor->node = leaf;
+    cursor->previous = NULL;
+
+    return cursor->node ? 0 : -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_lower_bound put the cursor on the first element whose key
+ *         is not less than a key
+ *
+ * @Param common data common struct
+ * @Param key the key
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means no one
+ */
+/* ----------------------------------------------------------------------------*/
+int bptree_lower_bound(DataCommon *common, void *key, Cursor *cursor)
+{
+    if ((common == NULL) || (key == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    return bptree_bound_cursor(common, key, cursor, 0);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_upper_bound put the cursor on the first element whose key
+ *         is greater than a key
+ *
+ * @Param common data common struct
+ * @Param key the key
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means no one
+ */
+/* ----------------------------------------------------------------------------*/
+int bptree_upper_bound(DataCommon *common, void *key, Cursor *cursor)
+{
+    if ((common == NULL) || (key == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    return bptree_bound_cursor(common, key, cursor, 1);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_range_iterate iterate the elements whose keys are in
+ *         [low, high), by the handle_iteration function
+ *
+ * @Param common data common struct
+ * @Param low the first key, NULL means from the first element
+ * @Param high the key after the last, NULL means to the last element
+ *
+ * @Returns   -1 is failed; other is the number of elements
+ */
+/* ----------------------------------------------------------------------------*/
+int bptree_range_iterate(DataCommon *common, void *low, void *high)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    BPlusLeaf *leaf = ((BPlusTree*)(common->linked_type))->first;
+    int index = 0;
+    int ret = 0;
+
+    if (low)
+	leaf = bptree_leaf(common, low, &index);
+
+    for (; leaf; leaf=leaf->next, index=0)
+	for (; index<leaf->count; index++){
+	    if (high && BPTREE_COMPARE(common, leaf->elements[index], high) >= 0)
+		return ret;
+	    if ((common->handle_iteration)(leaf->elements[index]) != 0){
+		ERROR("handle_iteration function error!");
+		return -1;
+	    }
+	    ret++;
+	}
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_load build the tree from sorted elements at once, the
+ *         nodes are filled evenly and nearly full
+ *
+ * @Param common data common struct
+ * @Param elements The elements in the order of their keys, no two keys are
+ *        the same
+ * @Param count The number of elements
+ *
+ * @Returns   0 is OK; other is failed, the tree is left empty
+ */
+/* ----------------------------------------------------------------------------*/
+int bptree_load(DataCommon *common, void **elements, int count)
+{
+    if ((common == NULL) || (elements == NULL && count > 0)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    BPlusTree *tree = (BPlusTree*)(common->linked_type);
+    if (tree->size != 0){
+	ERROR("the tree is not empty!");
+	return -1;
+    }
+
+    int i, j;
+    for (i=1; i<count; i++)
+	if (BPTREE_COMPARE(common, elements[i-1], BPTREE_KEY(common, elements[i])) >= 0){
+	    ERROR("the elements are not sorted!");
+	    return -1;
+	}
+    if (count == 0)
+	return 0;
+
+    /**
+     * all the nodes are taken before the tree is changed, the first leaf
+     * is there already
+     */
+    int leaves = (count + BPTREE_LEAF - 1) / BPTREE_LEAF;
+    int nodes_count = leaves - 1;
+    int n;
+    for (n=leaves; n>1; ){
+	n = (n + BPTREE_INNER) / (BPTREE_INNER + 1);
+	nodes_count += n;
+    }
+    void **nodes = (void**)mem_alloc(common->allocator, leaves * sizeof(void*));
+    if (nodes == NULL){
+	ERROR("malloc error!");
+	return -1;
+    }
+    if (bptree_reserve(common, nodes_count) != 0){
+	while (tree->spare_count > tree->height + 1)
+	    mem_free(common->allocator, bptree_node(common));
+	mem_free(common->allocator, nodes);
+	return -1;
+    }
+
+    BPlusLeaf *leaf = NULL;
+    BPlusLeaf *previous = NULL;
+    int per, k = 0;
+    for (i=0; i<leaves; i++){
+	leaf = i == 0 ? tree->first : bptree_new_leaf(common);
+	per = count / leaves + (i < count % leaves);
+	memcpy(leaf->elements, elements + k, per * sizeof(void*));
+	leaf->count = per;
+	k += per;
+	leaf->previous = previous;
+	if (previous)
+	    previous->next = leaf;
+	previous = leaf;
+	nodes[i] = leaf;
+    }
+    leaf->next = NULL;
+    tree->last = leaf;
+
+    /**
+     * every level groups the nodes below it, the parents are put at the
+     * front of the same array
+     */
+    BPlusInner *inner = NULL;
+    int level = 1, parents;
+    for (n=leaves; n>1; n=parents, level++){
+	parents = (n + BPTREE_INNER) / (BPTREE_INNER + 1);
+	for (i=0, k=0; i<parents; i++){
+	    per = n / parents + (i < n % parents);
+	    inner = bptree_new_inner(common);
+	    inner->count = per - 1;
+	    for (j=0; j<per; j++){
+		inner->children[j] = nodes[k + j];
+		if (j > 0)
+		    inner->keys[j - 1] = bptree_first(nodes[k + j], level);
+	    }
+	    k += per;
+	    nodes[i] = inner;
+	}
+    }
+    tree->root = nodes[0];
+    tree->height = level;
+    tree->size = count;
+    mem_free(common->allocator, nodes);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_new create a B+ tree, initial datacommon struct
+ *
+ * @Param common data common struct
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int bptree_new(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    /**
+     * check the user-defined functhion
+     */
+    int handle_check = DATA_COMMON_ORDERED(common) \
+		       &&common->alter_match \
+		       &&common->destroy_node \
+		       &&common->handle_iteration \
+		       &&ALLOCATOR_CHECK(common->allocator);
+    if (handle_check == 0){
+	ERROR("missed user defined function!");
+	return -1;
+    }
+
+    BPlusTree *tree = (BPlusTree*)mem_alloc(common->allocator, sizeof(BPlusTree));
+    if (tree == NULL){
+	ERROR("malloc error!");
+	return -1;
+    }
+    tree->height = 1;
+    tree->size = 0;
+    tree->spare = NULL;
+    tree->spare_count = 0;
+    common->linked_type = tree;
+
+    BPlusLeaf *leaf = bptree_new_leaf(common);
+    if (leaf == NULL){
+	mem_free(common->allocator, tree);
+	common->linked_type = NULL;
+	return -1;
+    }
+    tree->root = leaf;
+    tree->first = leaf;
+    tree->last = leaf;
+
+    common->insert = bptree_insert;
+    common->remove = bptree_remove;
+    common->search = bptree_search;
+    common->alter = bptree_alter;
+    common->prior = bptree_prior;
+    common->next = bptree_next;
+    common->iterate = bptree_iterate;
+    common->size = bptree_size;
+    common->clear = bptree_clear;
+    common->begin = bptree_begin;
+    common->end = bptree_end;
+    common->advance = bptree_advance;
+    common->retreat = bptree_retreat;
+    common->get = bptree_get;
+    common->erase = bptree_erase;
+    common->insert_after = bptree_insert_after;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bptree_delete destroy all the elements and the tree
+ *
+ * @Param common data common struct
+ *
+ * @Returns   -1 is failed; other is the number of elements
+ */
+/* ----------------------------------------------------------------------------*/
+int bptree_delete(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    int ret = bptree_clear(common);
+
+    BPlusTree *tree = (BPlusTree*)(common->linked_type);
+    mem_free(common->allocator, tree->root);
+    while (tree->spare)
+	mem_free(common->allocator, bptree_node(common));
+    mem_free(common->allocator, tree);
+    common->linked_type = NULL;
+
+    return ret;
+}
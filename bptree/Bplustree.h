@@ -0,0 +1,80 @@
+/**
+ * @file Bplustree.h
+ * @Brief  B+ tree header, the elements are kept in the order of their keys
+ *         in leaves that are linked for the scans
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-05-01
+ */
+
+#ifndef BPLUS_TREE_H_
+#define BPLUS_TREE_H_
+
+#include "Common.h"
+
+/**
+ * both kinds of node fill 4 cache lines of 64 bytes with 8 byte pointers.
+ * The keys stay in the elements, so every probe of the binary search in a
+ * node also reads an element elsewhere: a level costs about 4 dependent
+ * misses on the elements besides the node lines. The gain is the height,
+ * about log16(n) levels instead of the log2(n) nodes of a binary tree
+ */
+#define BPTREE_INNER 15
+#define BPTREE_LEAF 29
+
+/**
+ * Represent an inner node, the keys of children[i] are less than the key
+ * of keys[i] and the keys of children[i+1] are not
+ */
+typedef struct BPlusInner{
+    /**
+     * the number of keys, there is one more child
+     */
+    int count;
+    /**
+     * the first element of the subtree on the right, its key separates
+     * the children
+     */
+    void *keys[BPTREE_INNER];
+    void *children[BPTREE_INNER + 1];
+}BPlusInner;
+
+/**
+ * Represent a leaf, all the leaves are linked in the order of the keys
+ */
+typedef struct BPlusLeaf{
+    int count;
+    struct BPlusLeaf *previous;
+    struct BPlusLeaf *next;
+    void *elements[BPTREE_LEAF];
+}BPlusLeaf;
+
+typedef struct BPlusTree{
+    /**
+     * a leaf when the height is 1, an inner node when it is higher
+     */
+    void *root;
+    int height;
+    BPlusLeaf *first;
+    BPlusLeaf *last;
+    int size;
+    /**
+     * free nodes, an insert takes enough of them before it changes the
+     * tree so a split never fails half way
+     */
+    void *spare;
+    int spare_count;
+}BPlusTree;
+
+/**
+ * an ordered data, see key_compare in Common.h
+ */
+int bptree_new(DataCommon *common);
+int bptree_delete(DataCommon *common);
+int bptree_load(DataCommon *common, void **elements, int count);
+
+int bptree_lower_bound(DataCommon *common, void *key, Cursor *cursor);
+int bptree_upper_bound(DataCommon *common, void *key, Cursor *cursor);
+int bptree_range_iterate(DataCommon *common, void *low, void *high);
+
+#endif
@@ -0,0 +1,520 @@
+/**
+ * @file test.c
+ * @Brief  test B+ tree
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-05-01
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+/**
+ * Cunit headers
+ */ 
+#include "CUnit.h"
+#include "Automated.h"
+#include "Basic.h"
+#include "Console.h"
+
+/**
+ * Test file headers
+ */ 
+#include "Common.h"
+#include "bptree/Bplustree.h"
+#include "util/Log.h"
+
+
+/*************Test Case Begin*******************/
+
+#define TREE_COUNT 5000
+
+DataCommon numbers = DATA_COMMON_NULL;
+int values[TREE_COUNT];
+int destroyed = 0;
+int visited = 0;
+int last = -1;
+int ordered = 1;
+
+int number_alter(void *element, void *arg)
+{
+    return *(int*)element == *(int*)arg ? 0 : -1;
+}
+
+int number_destroy(void *element)
+{
+    *(int*)element = -1;
+    destroyed++;
+    return 0;
+}
+
+/**
+ * checks that the elements come in the order of the keys
+ */
+int number_iteration(void *element)
+{
+    if (*(int*)element <= last)
+	ordered = 0;
+    last = *(int*)element;
+    visited++;
+    return 0;
+}
+
+int number_compare(void *key1, void *key2)
+{
+    return *(int*)key1 - *(int*)key2;
+}
+
+void* number_key(void *element)
+{
+    return element;
+}
+
+void number_common(DataCommon *common)
+{
+    common->alter_match = number_alter;
+    common->destroy_node = number_destroy;
+    common->handle_iteration = number_iteration;
+    common->key_compare = number_compare;
+    common->element_key = number_key;
+}
+
+void iterate_reset()
+{
+    visited = 0;
+    last = -1;
+    ordered = 1;
+}
+
+/**
+ * the first element of a subtree, and the number of its elements in count
+ */
+void* check_node(void *node, int level, int root, int *count)
+{
+    int i, size = 0;
+    void *first = NULL;
+
+    if (level == 1){
+	BPlusLeaf *leaf = (BPlusLeaf*)node;
+	CU_ASSERT_TRUE_FATAL(root || leaf->count >= BPTREE_LEAF / 2);
+	CU_ASSERT_TRUE_FATAL(leaf->count <= BPTREE_LEAF);
+	for (i=1; i<leaf->count; i++)
+	    CU_ASSERT_TRUE_FATAL(*(int*)leaf->elements[i-1] < *(int*)leaf->elements[i]);
+	*count = leaf->count;
+	return leaf->count ? leaf->elements[0] : NULL;
+    }
+
+    BPlusInner *inner = (BPlusInner*)node;
+    CU_ASSERT_TRUE_FATAL(inner->count >= (root ? 1 : BPTREE_INNER / 2));
+    CU_ASSERT_TRUE_FATAL(inner->count <= BPTREE_INNER);
+    for (i=0; i<=inner->count; i++){
+	void *child = check_node(inner->children[i], level - 1, 0, count);
+	size += *count;
+	if (i == 0)
+	    first = child;
+	else
+	    CU_ASSERT_PTR_EQUAL_FATAL(inner->keys[i-1], child);
+    }
+    *count = size;
+
+    return first;
+}
+
+void check_tree(DataCommon *common)
+{
+    BPlusTree *tree = (BPlusTree*)common->linked_type;
+    int count = 0;
+    check_node(tree->root, tree->height, 1, &count);
+    CU_ASSERT_EQUAL_FATAL(count, tree->size);
+
+    iterate_reset();
+    CU_ASSERT_EQUAL_FATAL(common->iterate(common), 0);
+    CU_ASSERT_EQUAL_FATAL(visited, tree->size);
+    CU_ASSERT_EQUAL_FATAL(ordered, 1);
+}
+
+void shuffle(int *order, int count)
+{
+    int i, j, temp;
+    for (i=0; i<count; i++)
+	order[i] = i;
+    for (i=count-1; i>0; i--){
+	j = rand() % (i + 1);
+	temp = order[i];
+	order[i] = order[j];
+	order[j] = temp;
+    }
+}
+
+void test_bptree_new()
+{
+    DataCommon common = DATA_COMMON_NULL;
+    CU_ASSERT_EQUAL(bptree_new(&common), -1);
+
+    number_common(&common);
+    CU_ASSERT_EQUAL(bptree_new(&common), 0);
+    CU_ASSERT_EQUAL(common.size(&common), 0);
+    Cursor cursor = CURSOR_NULL;
+    CU_ASSERT_EQUAL(common.begin(&common, &cursor), -1);
+    CU_ASSERT_EQUAL(common.end(&common, &cursor), -1);
+    CU_ASSERT_EQUAL(bptree_delete(&common), 0);
+}
+
+void test_bptree_insert()
+{
+    number_common(&numbers);
+    CU_ASSERT_EQUAL_FATAL(bptree_new(&numbers), 0);
+
+    /**
+     * the even numbers in a shuffled order
+     */
+    int order[TREE_COUNT];
+    int i;
+    srand(1);
+    shuffle(order, TREE_COUNT);
+    for (i=0; i<TREE_COUNT; i++){
+	values[order[i]] = order[i] * 2;
+	CU_ASSERT_EQUAL_FATAL(numbers.insert(&numbers, &values[order[i]]), 0);
+	if (i % 500 == 0)
+	    check_tree(&numbers);
+    }
+    CU_ASSERT_EQUAL(numbers.size(&numbers), TREE_COUNT);
+    CU_ASSERT_TRUE(((BPlusTree*)numbers.linked_type)->height > 2);
+    check_tree(&numbers);
+
+    int key = 10;
+    CU_ASSERT_EQUAL(numbers.insert(&numbers, &key), -1);
+    CU_ASSERT_EQUAL(numbers.size(&numbers), TREE_COUNT);
+}
+
+void test_bptree_search()
+{
+    int i, key;
+    for (i=0; i<TREE_COUNT; i++){
+	key = i * 2;
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), &values[i]);
+	CU_ASSERT_EQUAL_FATAL(numbers.alter(&numbers, &key), 0);
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.prior(&numbers, &key), i ? &values[i-1] : NULL);
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.next(&numbers, &key), \
+		i < TREE_COUNT - 1 ? &values[i+1] : NULL);
+	key = i * 2 + 1;
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), NULL);
+    }
+    CU_ASSERT_EQUAL(numbers.alter(&numbers, &key), -1);
+    CU_ASSERT_EQUAL(numbers.remove(&numbers, &key), -1);
+    CU_ASSERT_PTR_EQUAL(numbers.prior(&numbers, &key), NULL);
+}
+
+void test_bptree_bound()
+{
+    Cursor cursor = CURSOR_NULL;
+    int i, key;
+    for (i=0; i<TREE_COUNT; i++){
+	key = i * 2;
+	CU_ASSERT_EQUAL_FATAL(bptree_lower_bound(&numbers, &key, &cursor), 0);
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.get(&numbers, &cursor), &values[i]);
+	key = i * 2 - 1;
+	CU_ASSERT_EQUAL_FATAL(bptree_upper_bound(&numbers, &key, &cursor), 0);
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.get(&numbers, &cursor), &values[i]);
+	key = i * 2;
+	if (i < TREE_COUNT - 1){
+	    CU_ASSERT_EQUAL_FATAL(bptree_upper_bound(&numbers, &key, &cursor), 0);
+	    CU_ASSERT_PTR_EQUAL_FATAL(numbers.get(&numbers, &cursor), &values[i+1]);
+	}
+    }
+    CU_ASSERT_EQUAL(bptree_upper_bound(&numbers, &key, &cursor), -1);
+    CU_ASSERT_PTR_EQUAL(cursor.node, NULL);
+    key = TREE_COUNT * 2;
+    CU_ASSERT_EQUAL(bptree_lower_bound(&numbers, &key, &cursor), -1);
+
+    int low = 101, high = 2001;
+    iterate_reset();
+    CU_ASSERT_EQUAL(bptree_range_iterate(&numbers, &low, &high), 950);
+    CU_ASSERT_EQUAL(ordered, 1);
+    CU_ASSERT_EQUAL(last, 2000);
+
+    low = 99, high = 99;
+    CU_ASSERT_EQUAL(bptree_range_iterate(&numbers, &low, &high), 0);
+    iterate_reset();
+    CU_ASSERT_EQUAL(bptree_range_iterate(&numbers, NULL, &high), 50);
+    iterate_reset();
+    CU_ASSERT_EQUAL(bptree_range_iterate(&numbers, &low, NULL), TREE_COUNT - 50);
+}
+
+void test_bptree_cursor()
+{
+    Cursor cursor = CURSOR_NULL;
+    int count = 0;
+
+    CU_ASSERT_EQUAL_FATAL(numbers.begin(&numbers, &cursor), 0);
+    for (; CURSOR_VALID(&cursor); numbers.advance(&numbers, &cursor)){
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.get(&numbers, &cursor), &values[count]);
+	count++;
+    }
+    CU_ASSERT_EQUAL(count, TREE_COUNT);
+
+    count = 0;
+    CU_ASSERT_EQUAL_FATAL(numbers.end(&numbers, &cursor), 0);
+    for (; CURSOR_VALID(&cursor); numbers.retreat(&numbers, &cursor)){
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.get(&numbers, &cursor), &values[TREE_COUNT-1-count]);
+	count++;
+    }
+    CU_ASSERT_EQUAL(count, TREE_COUNT);
+    CU_ASSERT_EQUAL(numbers.insert_after(&numbers, &cursor, &values[0]), -1);
+
+    /**
+     * erase the multiples of 4 by the cursor
+     */
+    destroyed = 0;
+    count = 0;
+    numbers.begin(&numbers, &cursor);
+    while (CURSOR_VALID(&cursor)){
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.get(&numbers, &cursor), &values[count]);
+	if (count % 2 == 0){
+	    CU_ASSERT_EQUAL_FATAL(numbers.erase(&numbers, &cursor), 0);
+	}else{
+	    numbers.advance(&numbers, &cursor);
+	}
+	count++;
+    }
+    CU_ASSERT_EQUAL(count, TREE_COUNT);
+    CU_ASSERT_EQUAL(destroyed, TREE_COUNT / 2);
+    CU_ASSERT_EQUAL(numbers.size(&numbers), TREE_COUNT / 2);
+    check_tree(&numbers);
+}
+
+void test_bptree_remove()
+{
+    int order[TREE_COUNT];
+    int i, key;
+
+    /**
+     * put the even indexes back, then remove everything in a shuffled
+     * order
+     */
+    for (i=0; i<TREE_COUNT; i+=2){
+	values[i] = i * 2;
+	CU_ASSERT_EQUAL_FATAL(numbers.insert(&numbers, &values[i]), 0);
+    }
+    check_tree(&numbers);
+
+    shuffle(order, TREE_COUNT);
+    for (i=0; i<TREE_COUNT; i++){
+	key = order[i] * 2;
+	CU_ASSERT_EQUAL_FATAL(numbers.remove(&numbers, &key), 0);
+	CU_ASSERT_EQUAL_FATAL(values[order[i]], -1);
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), NULL);
+	if (i % 250 == 0)
+	    check_tree(&numbers);
+    }
+    CU_ASSERT_EQUAL(numbers.size(&numbers), 0);
+    CU_ASSERT_EQUAL(((BPlusTree*)numbers.linked_type)->height, 1);
+    check_tree(&numbers);
+
+    Cursor cursor = CURSOR_NULL;
+    CU_ASSERT_EQUAL(numbers.begin(&numbers, &cursor), -1);
+    CU_ASSERT_EQUAL(numbers.end(&numbers, &cursor), -1);
+}
+
+void test_bptree_load()
+{
+    void *elements[TREE_COUNT];
+    int i, count, key;
+
+    elements[0] = &values[1];
+    elements[1] = &values[0];
+    values[0] = 0;
+    values[1] = 1;
+    CU_ASSERT_EQUAL(bptree_load(&numbers, elements, 2), -1);
+    CU_ASSERT_EQUAL(bptree_load(&numbers, elements, 0), 0);
+
+    /**
+     * every size from one leaf to several levels
+     */
+    for (count=1; count<=TREE_COUNT; count=count*3+1){
+	for (i=0; i<count; i++){
+	    values[i] = i * 2;
+	    elements[i] = &values[i];
+	}
+	CU_ASSERT_EQUAL_FATAL(bptree_load(&numbers, elements, count), 0);
+	CU_ASSERT_EQUAL_FATAL(numbers.size(&numbers), count);
+	check_tree(&numbers);
+	CU_ASSERT_EQUAL_FATAL(bptree_load(&numbers, elements, count), -1);
+
+	for (i=0; i<count; i++){
+	    key = i * 2;
+	    CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), &values[i]);
+	}
+	key = 1;
+	values[count] = 1;
+	CU_ASSERT_EQUAL_FATAL(numbers.insert(&numbers, &values[count]), 0);
+	CU_ASSERT_EQUAL_FATAL(numbers.remove(&numbers, &key), 0);
+	check_tree(&numbers);
+
+	destroyed = 0;
+	CU_ASSERT_EQUAL_FATAL(numbers.clear(&numbers), count);
+	CU_ASSERT_EQUAL_FATAL(destroyed, count);
+	check_tree(&numbers);
+    }
+}
+
+void test_bptree_delete()
+{
+    int i;
+    for (i=0; i<100; i++){
+	values[i] = i;
+	CU_ASSERT_EQUAL_FATAL(numbers.insert(&numbers, &values[i]), 0);
+    }
+    destroyed = 0;
+    CU_ASSERT_EQUAL(bptree_delete(&numbers), 100);
+    CU_ASSERT_EQUAL(destroyed, 100);
+    CU_ASSERT_PTR_EQUAL(numbers.linked_type, NULL);
+}
+
+/*************Test Case End*********************/
+
+
+
+/**
+ * add testcase, similar function in the same testcase
+ * 
+ * typedef struct CU_TestInfo {
+ * 	const char  *pName;
+ *	CU_TestFunc pTestFunc;
+ *	} CU_TestInfo;
+ *
+ * Example:
+ *
+ * static CU_TestInfo testcase1[] = {
+ * 	{ "test_function_name", test_function},
+ * 	{ "test_function_name2", test_function2},
+ * 	CU_TEST_INFO_NULL
+ * };
+ *
+ * static CU_TestInfo testcase2[] = {
+ * 	...
+ * 	CU_TEST_INFO_NULL
+ * };
+ *
+ */ 
+
+static CU_TestInfo testcase1[] = {
+    { "test_bptree_new", test_bptree_new},
+    { "test_bptree_insert", test_bptree_insert},
+    { "test_bptree_search", test_bptree_search},
+    { "test_bptree_bound", test_bptree_bound},
+    { "test_bptree_cursor", test_bptree_cursor},
+    { "test_bptree_remove", test_bptree_remove},
+    { "test_bptree_load", test_bptree_load},
+    { "test_bptree_delete", test_bptree_delete},
+    CU_TEST_INFO_NULL
+};
+
+/**
+ * add testcase to the suites
+ * 
+ * typedef struct CU_SuiteInfo {
+ *     const char       *pName;         
+ *     CU_InitializeFunc pInitFunc;     
+ *     CU_CleanupFunc    pCleanupFunc;  
+ *     CU_SetUpFunc      pSetUpFunc;    
+ *     CU_TearDownFunc   pTearDownFunc; 
+ *     CU_TestInfo      *pTests;        
+ * } CU_SuiteInfo;
+ *
+ * Example:
+ *
+ * static CU_SuiteInfo suites[] = {
+ * 	{"suite name", suite_success_init, suite_success_clean, NULL, NULL, testcase},
+ * 	...
+ * 	CU_SUITE_INFO_NULL
+ * }
+ *
+ */
+
+static int suite_success_init(void) 
+{
+    return 0; 
+}
+static int suite_success_clean(void) 
+{
+    return 0; 
+}
+
+
+static CU_SuiteInfo suites[] = {
+    {"suite1", suite_success_init, NULL, NULL, NULL, testcase1},
+    CU_SUITE_INFO_NULL
+};
+
+
+
+/**
+ * add tests to the test framework
+ *
+ */ 
+void AddTests(void)
+{
+    assert(NULL != CU_get_registry());
+    assert(!CU_is_test_running());
+
+    /* Register suites. */
+    if (CU_register_suites(suites) != CUE_SUCCESS) {
+	fprintf(stderr, "suite registration failed - %s\n",
+		CU_get_error_msg());
+	exit(EXIT_FAILURE);
+    }
+
+}
+
+
+int main()
+{
+    if (CU_initialize_registry()) {
+	printf("\nInitialization of Test Registry failed.");
+    }else{
+
+	LOG_FILE_OPEN("log.txt");
+
+	AddTests();
+
+	/*******Automated Mode(best)*********************
+	 * CU_set_output_filename("TestAutomated");
+	 * CU_list_tests_to_file();
+	 * CU_automated_run_tests();
+	 ******************************************/
+
+	 CU_set_output_filename("TestAutomated");
+	 CU_list_tests_to_file();
+	 CU_automated_run_tests();
+	/*******Basic Mode*********************
+	 * mode can choose:
+	 * typedef enum {
+	 *   CU_BRM_NORMAL = 0, Normal mode - failures and run summary are printed [default].
+	 *   CU_BRM_SILENT,     Silent mode - no output is printed except framework error messages.
+	 *   CU_BRM_VERBOSE     Verbose mode - maximum output of run details.
+	 * } CU_BasicRunMode;
+	 ****************************************
+	 *
+	 * CU_basic_set_mode(CU_BRM_NORMAL);
+	 * CU_basic_run_tests();
+	 ******************************************/
+
+	/*******Console Mode*********************
+	 * CU_console_run_tests();
+	 ******************************************/
+
+	/*******Curses Mode*********************
+	 * CU_curses_run_tests();
+	 ******************************************/ 
+
+
+	CU_cleanup_registry();
+    }
+
+    LOG_FILE_CLOSE();
+    return 0;
+}
+
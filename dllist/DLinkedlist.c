@@ -13,52 +13,204 @@
 #include "util/Log.h"
 
 
+/**
+ * The hash of an element's key
+ */
+#define DLLIST_HASH(common, element) \
+    ((common)->key_hash((common)->element_key(element)))
+
+
 /* --------------------------------------------------------------------------*/
 /**
- * @Brief  dllist_insert Insert a node to the list
+ * @Brief  dllist_index_find Find the node of a key through the hash index
  *
  * @Param common Data common struct
- * @Param element The node's value
+ * @Param key The key
  *
- * @Returns   0 is OK;other is failed
+ * @Returns   NULL is failed; other is the link to the node's entry
  */
 /* ----------------------------------------------------------------------------*/
-static int dllist_insert(DataCommon *common, void *element)
+static HashEntry** dllist_index_find(DataCommon *common, void *key)
 {
-    if ((common == NULL) || (element == NULL)){
-	ERROR("null pointer!");
-	return -1;
+    DLinkedList *list = (DLinkedList*)(common->linked_type);
+    unsigned long hash = common->key_hash(key);
+    HashEntry **link = hindex_bucket(&list->index, hash);
+    DLinkedNode *node = NULL;
+
+    while (*link){
+	node = (DLinkedNode*)((*link)->node);
+	if (((*link)->hash == hash) && (common->key_equal(node->element, key) == 0))
+	    return link;
+	link = &(*link)->next;
     }
 
+    return NULL;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  dllist_detach Take a node out of the chain, the node is kept
+ *
+ * @Param list Double linked list
+ * @Param node The node
+ */
+/* ----------------------------------------------------------------------------*/
+static void dllist_detach(DLinkedList *list, DLinkedNode *node)
+{
+    /**
+     * Remove the middle node
+     */ 
+    if ((node != list->first) && (node != list->last)){
+	node->previous->next = node->next;
+	node->next->previous = node->previous;
+    }
+
+    /**
+     * Remove the first node
+     */ 
+    if (node == list->first){
+	if (node->next != NULL)
+	    node->next->previous = NULL;
+	list->first = node->next;
+    }
+
+    /**
+     * Remove the last node
+     */ 
+    if (node == list->last){
+	if (node->previous != NULL)
+	    node->previous->next = NULL;
+	list->last = node->previous;
+    }
+
+    node->previous = NULL;
+    node->next = NULL;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  dllist_unlink Remove a node from the list and destroy it
+ *
+ * @Param common Data common struct
+ * @Param node The node
+ * @Param link The link to the node's entry, NULL means looking it up
+ */
+/* ----------------------------------------------------------------------------*/
+static void dllist_unlink(DataCommon *common, DLinkedNode *node, HashEntry **link)
+{
+    DLinkedList *list = (DLinkedList*)(common->linked_type);
+
+    if (list->indexed){
+	if (link == NULL)
+	    link = hindex_find_node(&list->index, DLLIST_HASH(common, node->element), node);
+	hindex_remove(&list->index, link);
+    }
+
+    dllist_detach(list, node);
+
+    /**
+     * Destroy node
+     */ 
+    common->destroy_node(node->element);
+    node->element = NULL;
+    slab_free(&list->node_pool, node);
+
+    list->size--;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  dllist_attach Link a node after another one
+ *
+ * @Param list Double linked list
+ * @Param pre The node that the new one follows, NULL means the front
+ * @Param node The node
+ */
+/* ----------------------------------------------------------------------------*/
+static void dllist_attach(DLinkedList *list, DLinkedNode *pre, DLinkedNode *node)
+{
+    node->previous = pre;
+    node->next = (pre == NULL) ? list->first : pre->next;
+
+    if (node->next != NULL)
+	node->next->previous = node;
+    else
+	list->last = node;
+
+    if (pre != NULL)
+	pre->next = node;
+    else
+	list->first = node;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  dllist_link Create a node for the element and link it after a node
+ *
+ * @Param common Data common struct
+ * @Param pre The node that the new one follows, NULL means the front
+ * @Param element The node's value
+ *
+ * @Returns   NULL is failed; other is the new node
+ */
+/* ----------------------------------------------------------------------------*/
+static DLinkedNode* dllist_link(DataCommon *common, DLinkedNode *pre, void *element)
+{
     /**
      * Create a new linked node and initial it
      */
     DLinkedList *list = (DLinkedList*)(common->linked_type);
-    DLinkedNode *node = (DLinkedNode*)malloc(sizeof(DLinkedNode));
+    DLinkedNode *node = (DLinkedNode*)slab_alloc(&list->node_pool);
     if (node == NULL){
-	ERROR("malloc failed!");
-	return -1;
+	ERROR("slab alloc failed!");
+	return NULL;
     }
     node->element = element;
     node->previous = NULL;
     node->next = NULL;
 
-    if (list->first != NULL){
-	/**
-	 * Add a new linked node to the end of the list
-	 */
-	list->last->next = node;
-	node->previous = list->last;
-	list->last = node;
-    }else{
-	/**
-	 * Add the first node to the list
-	 */
-	list->first = node;
-	list->last = node;
+    if (list->indexed){
+	if (hindex_insert(&list->index, DLLIST_HASH(common, element), node) == NULL){
+	    slab_free(&list->node_pool, node);
+	    return NULL;
+	}
     }
 
+    dllist_attach(list, pre, node);
     list->size++;
+
+    return node;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  dllist_insert Insert a node to the list
+ *
+ * @Param common Data common struct
+ * @Param element The node's value
+ *
+ * @Returns   0 is OK;other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int dllist_insert(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    /**
+     * Add a new linked node to the end of the list
+     */
+    DLinkedList *list = (DLinkedList*)(common->linked_type);
+    if (dllist_link(common, list->last, element) == NULL)
+	return -1;
+
     return 0;
 }
 
@@ -83,47 +235,22 @@ static int dllist_remove(DataCommon *common, void *element)
     DLinkedList *list = (DLinkedList*)(common->linked_type);
     DLinkedNode *node = list->first;
 
+    if (list->indexed){
+	HashEntry **link = dllist_index_find(common, element);
+	if (link == NULL){
+	    INFO("no matched node!");
+	    return -1;
+	}
+	dllist_unlink(common, (DLinkedNode*)(*link)->node, link);
+	return 0;
+    }
+
     while (node){
 	/**
 	 * Match the node
 	 */ 
 	if (common->remove_match(node->element, element) == 0){
-	    /**
-	     * Remove the middle node
-	     */ 
-	    if ((node != list->first) && (node != list->last)){
-		node->previous->next = node->next;
-		node->next->previous = node->previous;
-	    }
-
-	    /**
-	     * Remove the first node
-	     */ 
-	    if (node == list->first){
-		if (node->next != NULL)
-		    node->next->previous = NULL;
-		list->first = node->next;
-	    }
-
-	    /**
-	     * Remove the last node
-	     */ 
-	    if (node == list->last){
-		if (node->previous != NULL)
-		    node->previous->next = NULL;
-		list->last = node->previous;
-	    }
-
-	    /**
-	     * Destroy node
-	     */ 
-	    common->destroy_node(node->element);
-	    node->element = NULL;
-	    node->previous = NULL;
-	    node->next = NULL;
-	    free(node);
-
-	    list->size--;
+	    dllist_unlink(common, node, NULL);
 	    return 0;
 	}
 
@@ -155,6 +282,16 @@ static void* dllist_search(DataCommon *common, void *element)
     DLinkedList *list = (DLinkedList*)(common->linked_type);
     DLinkedNode *node = list->first;
 
+    if (list->indexed){
+	HashEntry **link = dllist_index_find(common, element);
+	if (link == NULL){
+	    INFO("no matched node!");
+	    return NULL;
+	}
+	node = (DLinkedNode*)(*link)->node;
+	return node->element;
+    }
+
     while (node){
 	if (common->search_match(node->element, element) == 0)
 	    return node->element;
@@ -186,6 +323,16 @@ static int dllist_alter(DataCommon *common, void *element)
     DLinkedList *list = (DLinkedList*)(common->linked_type);
     DLinkedNode *node = list->first;
 
+    if (list->indexed){
+	HashEntry **link = dllist_index_find(common, common->element_key(element));
+	if (link == NULL){
+	    INFO("no matched node!");
+	    return -1;
+	}
+	node = (DLinkedNode*)(*link)->node;
+	return common->alter_match(node->element, element);
+    }
+
     while (node){
 	if (common->alter_match(node->element, element) == 0)
 	    return 0;
@@ -218,6 +365,16 @@ static void* dllist_prior(DataCommon *common, void *element)
     DLinkedList *list = (DLinkedList*)(common->linked_type);
     DLinkedNode *node = list->first;
 
+    if (list->indexed){
+	HashEntry **link = dllist_index_find(common, element);
+	if (link == NULL){
+	    INFO("no matched node!");
+	    return NULL;
+	}
+	node = (DLinkedNode*)(*link)->node;
+	return node->previous == NULL ? NULL : node->previous->element;
+    }
+
     while (node){
 	if (common->search_match(node->element, element) == 0){
 	    if (node->previous != NULL)
@@ -253,6 +410,16 @@ static void* dllist_next(DataCommon *common, void *element)
     DLinkedList *list = (DLinkedList*)(common->linked_type);
     DLinkedNode *node = list->first;
 
+    if (list->indexed){
+	HashEntry **link = dllist_index_find(common, element);
+	if (link == NULL){
+	    INFO("no matched node!");
+	    return NULL;
+	}
+	node = (DLinkedNode*)(*link)->node;
+	return node->next == NULL ? NULL : node->next->element;
+    }
+
     while (node){
 	if (common->search_match(node->element, element) == 0){
 	    if (node->next != NULL)
@@ -350,7 +517,7 @@ static int dllist_clear(DataCommon *common)
 	temp->element = NULL;
 	temp->previous = NULL;
 	temp->next = NULL;
-	free(temp);
+	slab_free(&list->node_pool, temp);
 
 	ret++;
     }
@@ -358,11 +525,195 @@ static int dllist_clear(DataCommon *common)
     list->first = NULL;
     list->last = NULL;
     list->size = 0;
+    hindex_clear(&list->index);
 
     return ret;
 }
 
 
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  dllist_begin Put the cursor on the first node
+ *
+ * @Param common Data common struct
+ * @Param cursor The cursor
+ *
+ * @Returns   0 is OK; -1 means the list is empty
+ */
+/* ----------------------------------------------------------------------------*/
+static int dllist_begin(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    DLinkedList *list = (DLinkedList*)(common->linked_type);
+    cursor->node = list->first;
+    cursor->previous = NULL;
+    cursor->index = 0;
+
+    return cursor->node == NULL ? -1 : 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  dllist_end Put the cursor on the last node
+ *
+ * @Param common Data common struct
+ * @Param cursor The cursor
+ *
+ * @Returns   0 is OK; -1 means the list is empty
+ */
+/* ----------------------------------------------------------------------------*/
+static int dllist_end(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    DLinkedList *list = (DLinkedList*)(common->linked_type);
+    cursor->node = list->last;
+    cursor->previous = NULL;
+    cursor->index = 0;
+
+    return cursor->node == NULL ? -1 : 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  dllist_advance Move the cursor to the next node
+ *
+ * @Param common Data common struct
+ * @Param cursor The cursor
+ *
+ * @Returns   0 is OK; -1 means the cursor is off the list
+ */
+/* ----------------------------------------------------------------------------*/
+static int dllist_advance(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    DLinkedNode *node = (DLinkedNode*)(cursor->node);
+    if (node == NULL)
+	return -1;
+    cursor->node = node->next;
+
+    return cursor->node == NULL ? -1 : 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  dllist_retreat Move the cursor to the prior node
+ *
+ * @Param common Data common struct
+ * @Param cursor The cursor
+ *
+ * @Returns   0 is OK; -1 means the cursor is off the list
+ */
+/* ----------------------------------------------------------------------------*/
+static int dllist_retreat(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    DLinkedNode *node = (DLinkedNode*)(cursor->node);
+    if (node == NULL)
+	return -1;
+    cursor->node = node->previous;
+
+    return cursor->node == NULL ? -1 : 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  dllist_get Return the element under the cursor
+ *
+ * @Param common Data common struct
+ * @Param cursor The cursor
+ *
+ * @Returns   NULL means the cursor is off the list; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* dllist_get(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("null pointer!");
+	return NULL;
+    }
+
+    DLinkedNode *node = (DLinkedNode*)(cursor->node);
+
+    return node == NULL ? NULL : node->element;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  dllist_erase Remove the node under the cursor, the cursor moves to
+ *         the next node
+ *
+ * @Param common Data common struct
+ * @Param cursor The cursor
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int dllist_erase(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    DLinkedNode *node = (DLinkedNode*)(cursor->node);
+    if (node == NULL){
+	INFO("cursor is off the list!");
+	return -1;
+    }
+
+    cursor->node = node->next;
+    dllist_unlink(common, node, NULL);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  dllist_insert_after Insert an element after the cursor
+ *
+ * @Param common Data common struct
+ * @Param cursor The cursor, off the list means inserting at the front
+ * @Param element The element
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int dllist_insert_after(DataCommon *common, Cursor *cursor, void *element)
+{
+    if ((common == NULL) || (cursor == NULL) || (element == NULL)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    if (dllist_link(common, (DLinkedNode*)(cursor->node), element) == NULL)
+	return -1;
+
+    return 0;
+}
+
+
 /* --------------------------------------------------------------------------*/
 /**
  * @Brief  dllist_new Create a double linked list and initial it
@@ -386,7 +737,8 @@ int dllist_new(DataCommon *common)
 		       &&common->search_match \
 		       &&common->alter_match \
 		       &&common->destroy_node \
-		       &&common->handle_iteration;
+		       &&common->handle_iteration \
+		       &&ALLOCATOR_CHECK(common->allocator);
     if (handle_check == 0){ 
 	ERROR("missed user defined function!");
 	return -1; 
@@ -395,7 +747,7 @@ int dllist_new(DataCommon *common)
     /**
      * create a double linked list struct and initial it
      */ 
-    DLinkedList *list = (DLinkedList*)malloc(sizeof(DLinkedList));
+    DLinkedList *list = (DLinkedList*)mem_alloc(common->allocator, sizeof(DLinkedList));
     if (list == NULL){
 	ERROR("malloc error!");
 	return -1;
@@ -404,6 +756,20 @@ int dllist_new(DataCommon *common)
     list->last = NULL;
     list->size = 0;
 
+    /**
+     * nodes of the list come from its own slab
+     */
+    if (slab_new(&list->node_pool, sizeof(DLinkedNode), 0, common->allocator) != 0){
+	mem_free(common->allocator, list);
+	return -1;
+    }
+
+    /**
+     * the key functions decide whether the list keeps a hash index
+     */
+    list->indexed = DATA_COMMON_INDEXED(common);
+    hindex_new(&list->index, common->allocator);
+
     /**
      * initial DataCommon struct
      */ 
@@ -417,6 +783,13 @@ int dllist_new(DataCommon *common)
     common->iterate = dllist_iterate;
     common->size = dllist_size;
     common->clear = dllist_clear;
+    common->begin = dllist_begin;
+    common->end = dllist_end;
+    common->advance = dllist_advance;
+    common->retreat = dllist_retreat;
+    common->get = dllist_get;
+    common->erase = dllist_erase;
+    common->insert_after = dllist_insert_after;
 
     return 0;
 }
@@ -443,8 +816,130 @@ int dllist_delete(DataCommon *common)
     list->first = NULL;
     list->last = NULL;
     list->size = 0;
-    free(list);
+    slab_delete(&list->node_pool);
+    hindex_delete(&list->index);
+    mem_free(common->allocator, list);
 
     return ret;
 }
 
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  dllist_insert_handle Insert a node to the end of the list, and
+ *         return its handle
+ *
+ * @Param common Data common struct
+ * @Param element The node's value
+ *
+ * @Returns   NULL is failed; other is the handle of the node
+ */
+/* ----------------------------------------------------------------------------*/
+DLinkedHandle dllist_insert_handle(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("null pointer!");
+	return NULL;
+    }
+
+    DLinkedList *list = (DLinkedList*)(common->linked_type);
+
+    return dllist_link(common, list->last, element);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  dllist_handle_element Return the value of a handle's node
+ *
+ * @Param handle The handle of the node
+ *
+ * @Returns   NULL is failed; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+void* dllist_handle_element(DLinkedHandle handle)
+{
+    if (handle == NULL){
+	ERROR("null pointer!");
+	return NULL;
+    }
+
+    return handle->element;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  dllist_remove_handle Remove the node of a handle without searching
+ *
+ * @Param common Data common struct
+ * @Param handle The handle of the node
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int dllist_remove_handle(DataCommon *common, DLinkedHandle handle)
+{
+    if ((common == NULL) || (handle == NULL)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    dllist_unlink(common, handle, NULL);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  dllist_move_to_front_handle Move the node of a handle to the front
+ *
+ * @Param common Data common struct
+ * @Param handle The handle of the node
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int dllist_move_to_front_handle(DataCommon *common, DLinkedHandle handle)
+{
+    if ((common == NULL) || (handle == NULL)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    DLinkedList *list = (DLinkedList*)(common->linked_type);
+    if (list->first != handle){
+	dllist_detach(list, handle);
+	dllist_attach(list, NULL, handle);
+    }
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  dllist_move_to_back_handle Move the node of a handle to the end
+ *
+ * @Param common Data common struct
+ * @Param handle The handle of the node
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int dllist_move_to_back_handle(DataCommon *common, DLinkedHandle handle)
+{
+    if ((common == NULL) || (handle == NULL)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    DLinkedList *list = (DLinkedList*)(common->linked_type);
+    if (list->last != handle){
+	dllist_detach(list, handle);
+	dllist_attach(list, list->last, handle);
+    }
+
+    return 0;
+}
@@ -10,6 +10,8 @@
 #define DLINKED_LIST_H_
 
 #include "Common.h"
+#include "util/Slab.h"
+#include "util/HashIndex.h"
 
 typedef struct DLinkedNode{
     void *element;
@@ -21,9 +23,23 @@ typedef struct DLinkedList{
     DLinkedNode *first;
     DLinkedNode *last;
     int size;
+    Slab node_pool;
+    HashIndex index;
+    int indexed;
 }DLinkedList;
 
 int dllist_new(DataCommon *common);
 int dllist_delete(DataCommon *common);
 
+/**
+ * handle of a node, it stays valid until the node is removed
+ */
+typedef DLinkedNode* DLinkedHandle;
+
+DLinkedHandle dllist_insert_handle(DataCommon *common, void *element);
+void* dllist_handle_element(DLinkedHandle handle);
+int dllist_remove_handle(DataCommon *common, DLinkedHandle handle);
+int dllist_move_to_front_handle(DataCommon *common, DLinkedHandle handle);
+int dllist_move_to_back_handle(DataCommon *common, DLinkedHandle handle);
+
 #endif
@@ -175,6 +175,257 @@ void test_clear()
 
 
 
+/**
+ * a list with the key functions, found through the hash index
+ */
+#define INDEXED_COUNT 1000
+DataCommon numbers = DATA_COMMON_NULL;
+int values[INDEXED_COUNT];
+
+int number_match(void *element, void *key)
+{
+    return *(int*)element == *(int*)key ? 0 : -1;
+}
+
+int number_alter(void *element, void *arg)
+{
+    return *(int*)element == *(int*)arg ? 0 : -1;
+}
+
+int number_destroy(void *element)
+{
+    *(int*)element = -1;
+    return 0;
+}
+
+int number_iteration(void *element)
+{
+    return 0;
+}
+
+unsigned long number_hash(void *key)
+{
+    return (unsigned long)*(int*)key;
+}
+
+void* number_key(void *element)
+{
+    return element;
+}
+
+void test_indexed_insert()
+{
+    numbers.remove_match = number_match;
+    numbers.search_match = number_match;
+    numbers.alter_match = number_alter;
+    numbers.destroy_node = number_destroy;
+    numbers.handle_iteration = number_iteration;
+    numbers.key_hash = number_hash;
+    numbers.key_equal = number_match;
+    numbers.element_key = number_key;
+    CU_ASSERT_EQUAL_FATAL(dllist_new(&numbers), 0);
+
+    int i;
+    for (i=0; i<INDEXED_COUNT; i++){
+	values[i] = i;
+	CU_ASSERT_EQUAL_FATAL(numbers.insert(&numbers, &values[i]), 0);
+    }
+    CU_ASSERT_EQUAL_FATAL(numbers.size(&numbers), INDEXED_COUNT);
+}
+
+void test_indexed_search()
+{
+    int i, key;
+    for (i=0; i<INDEXED_COUNT; i++){
+	key = i;
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), &values[i]);
+	CU_ASSERT_EQUAL_FATAL(numbers.alter(&numbers, &key), 0);
+    }
+    key = INDEXED_COUNT;
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), NULL);
+    CU_ASSERT_EQUAL_FATAL(numbers.remove(&numbers, &key), -1);
+
+    key = 0;
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.prior(&numbers, &key), NULL);
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.next(&numbers, &key), &values[1]);
+    key = INDEXED_COUNT - 1;
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.prior(&numbers, &key), &values[key-1]);
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.next(&numbers, &key), NULL);
+}
+
+void test_indexed_remove()
+{
+    int key = 500;
+    CU_ASSERT_EQUAL_FATAL(numbers.remove(&numbers, &key), 0);
+    key = 0;
+    CU_ASSERT_EQUAL_FATAL(numbers.remove(&numbers, &key), 0);
+    key = INDEXED_COUNT - 1;
+    CU_ASSERT_EQUAL_FATAL(numbers.remove(&numbers, &key), 0);
+    CU_ASSERT_EQUAL_FATAL(numbers.size(&numbers), INDEXED_COUNT - 3);
+
+    /**
+     * the neighbours of the removed nodes are linked again
+     */
+    key = 501;
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.prior(&numbers, &key), &values[499]);
+    key = 499;
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.next(&numbers, &key), &values[501]);
+    key = 1;
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.prior(&numbers, &key), NULL);
+    key = INDEXED_COUNT - 2;
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.next(&numbers, &key), NULL);
+    key = 500;
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), NULL);
+
+    /**
+     * insert again, the order is the insertion order
+     */
+    values[500] = 500;
+    CU_ASSERT_EQUAL_FATAL(numbers.insert(&numbers, &values[500]), 0);
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.prior(&numbers, &key), &values[INDEXED_COUNT-2]);
+
+    CU_ASSERT_EQUAL_FATAL(dllist_delete(&numbers), INDEXED_COUNT - 2);
+}
+
+/**
+ * walk, erase and insert through a cursor
+ */
+#define CURSOR_COUNT 100
+int slots[CURSOR_COUNT];
+
+void check_cursor(DataCommon *list)
+{
+    Cursor cursor = CURSOR_NULL;
+    int i;
+
+    CU_ASSERT_EQUAL_FATAL(list->begin(list, &cursor), -1);
+    for (i=0; i<CURSOR_COUNT; i++){
+	slots[i] = i;
+	CU_ASSERT_EQUAL_FATAL(list->insert(list, &slots[i]), 0);
+    }
+
+    /**
+     * forward and backward
+     */
+    CU_ASSERT_EQUAL_FATAL(list->begin(list, &cursor), 0);
+    for (i=0; i<CURSOR_COUNT; i++){
+	CU_ASSERT_PTR_EQUAL_FATAL(list->get(list, &cursor), &slots[i]);
+	CU_ASSERT_EQUAL_FATAL(list->advance(list, &cursor), i == CURSOR_COUNT-1 ? -1 : 0);
+    }
+    CU_ASSERT_PTR_EQUAL_FATAL(list->get(list, &cursor), NULL);
+    CU_ASSERT_EQUAL_FATAL(list->end(list, &cursor), 0);
+    for (i=CURSOR_COUNT-1; i>=0; i--){
+	CU_ASSERT_PTR_EQUAL_FATAL(list->get(list, &cursor), &slots[i]);
+	CU_ASSERT_EQUAL_FATAL(list->retreat(list, &cursor), i == 0 ? -1 : 0);
+    }
+
+    /**
+     * erase the even ones, the cursor moves to the next one
+     */
+    list->begin(list, &cursor);
+    for (i=0; i<CURSOR_COUNT; i+=2){
+	CU_ASSERT_EQUAL_FATAL(list->erase(list, &cursor), 0);
+	CU_ASSERT_PTR_EQUAL_FATAL(list->get(list, &cursor), &slots[i+1]);
+	list->advance(list, &cursor);
+    }
+    CU_ASSERT_EQUAL_FATAL(list->size(list), CURSOR_COUNT/2);
+
+    /**
+     * put the even ones back after the odd ones, and one at the front
+     */
+    list->begin(list, &cursor);
+    for (i=1; i<CURSOR_COUNT; i+=2){
+	slots[i-1] = i-1;
+	CU_ASSERT_EQUAL_FATAL(list->insert_after(list, &cursor, &slots[i-1]), 0);
+	CU_ASSERT_PTR_EQUAL_FATAL(list->get(list, &cursor), &slots[i]);
+	list->advance(list, &cursor);
+	list->advance(list, &cursor);
+    }
+    CU_ASSERT_EQUAL_FATAL(list->insert_after(list, &cursor, &slots[CURSOR_COUNT-2]), 0);
+    CU_ASSERT_EQUAL_FATAL(list->size(list), CURSOR_COUNT + 1);
+    list->begin(list, &cursor);
+    CU_ASSERT_PTR_EQUAL_FATAL(list->get(list, &cursor), &slots[CURSOR_COUNT-2]);
+    CU_ASSERT_EQUAL_FATAL(list->erase(list, &cursor), 0);
+    for (i=0; i<CURSOR_COUNT; i++){
+	CU_ASSERT_PTR_EQUAL_FATAL(list->get(list, &cursor), &slots[i ^ 1]);
+	list->advance(list, &cursor);
+    }
+}
+
+void test_cursor()
+{
+    DataCommon list = DATA_COMMON_NULL;
+    list.remove_match = number_match;
+    list.search_match = number_match;
+    list.alter_match = number_alter;
+    list.destroy_node = number_destroy;
+    list.handle_iteration = number_iteration;
+    CU_ASSERT_EQUAL_FATAL(dllist_new(&list), 0);
+    check_cursor(&list);
+    CU_ASSERT_EQUAL_FATAL(dllist_delete(&list), CURSOR_COUNT);
+
+    list.key_hash = number_hash;
+    list.key_equal = number_match;
+    list.element_key = number_key;
+    CU_ASSERT_EQUAL_FATAL(dllist_new(&list), 0);
+    check_cursor(&list);
+    CU_ASSERT_EQUAL_FATAL(dllist_delete(&list), CURSOR_COUNT);
+}
+
+void test_handle()
+{
+    DataCommon list = DATA_COMMON_NULL;
+    DLinkedHandle handles[CURSOR_COUNT];
+    Cursor cursor = CURSOR_NULL;
+    int i;
+
+    list.remove_match = number_match;
+    list.search_match = number_match;
+    list.alter_match = number_alter;
+    list.destroy_node = number_destroy;
+    list.handle_iteration = number_iteration;
+    CU_ASSERT_EQUAL_FATAL(dllist_new(&list), 0);
+
+    for (i=0; i<CURSOR_COUNT; i++){
+	slots[i] = i;
+	handles[i] = dllist_insert_handle(&list, &slots[i]);
+	CU_ASSERT_PTR_NOT_EQUAL_FATAL(handles[i], NULL);
+	CU_ASSERT_PTR_EQUAL_FATAL(dllist_handle_element(handles[i]), &slots[i]);
+    }
+
+    /**
+     * move the last to the front and the first to the end, twice is no change
+     */
+    CU_ASSERT_EQUAL_FATAL(dllist_move_to_front_handle(&list, handles[CURSOR_COUNT-1]), 0);
+    CU_ASSERT_EQUAL_FATAL(dllist_move_to_front_handle(&list, handles[CURSOR_COUNT-1]), 0);
+    CU_ASSERT_EQUAL_FATAL(dllist_move_to_back_handle(&list, handles[0]), 0);
+    CU_ASSERT_EQUAL_FATAL(dllist_move_to_back_handle(&list, handles[0]), 0);
+    CU_ASSERT_EQUAL_FATAL(dllist_move_to_front_handle(&list, handles[50]), 0);
+    list.begin(&list, &cursor);
+    CU_ASSERT_PTR_EQUAL_FATAL(list.get(&list, &cursor), &slots[50]);
+    list.advance(&list, &cursor);
+    CU_ASSERT_PTR_EQUAL_FATAL(list.get(&list, &cursor), &slots[CURSOR_COUNT-1]);
+    list.end(&list, &cursor);
+    CU_ASSERT_PTR_EQUAL_FATAL(list.get(&list, &cursor), &slots[0]);
+    list.retreat(&list, &cursor);
+    CU_ASSERT_PTR_EQUAL_FATAL(list.get(&list, &cursor), &slots[CURSOR_COUNT-2]);
+
+    /**
+     * remove by handle, the neighbours are linked again
+     */
+    CU_ASSERT_EQUAL_FATAL(dllist_remove_handle(&list, handles[50]), 0);
+    CU_ASSERT_EQUAL_FATAL(dllist_remove_handle(&list, handles[0]), 0);
+    CU_ASSERT_EQUAL_FATAL(dllist_remove_handle(&list, handles[2]), 0);
+    CU_ASSERT_EQUAL_FATAL(slots[50], -1);
+    CU_ASSERT_EQUAL_FATAL(list.size(&list), CURSOR_COUNT - 3);
+    i = 3;
+    CU_ASSERT_PTR_EQUAL_FATAL(list.prior(&list, &i), &slots[1]);
+    list.end(&list, &cursor);
+    CU_ASSERT_PTR_EQUAL_FATAL(list.get(&list, &cursor), &slots[CURSOR_COUNT-2]);
+
+    CU_ASSERT_EQUAL_FATAL(dllist_delete(&list), CURSOR_COUNT - 3);
+}
+
 /*************Test Case End*********************/
 
 
@@ -220,6 +471,15 @@ static CU_TestInfo testcase2[] = {
     CU_TEST_INFO_NULL
 };
 
+static CU_TestInfo testcase4[] = {
+    { "test_indexed_insert", test_indexed_insert},
+    { "test_indexed_search", test_indexed_search},
+    { "test_indexed_remove", test_indexed_remove},
+    { "test_cursor", test_cursor},
+    { "test_handle", test_handle},
+    CU_TEST_INFO_NULL
+};
+
 static CU_TestInfo testcase3[] = {
     { "test_remove", test_remove},
     { "test_insert", test_insert},
@@ -272,6 +532,7 @@ static CU_SuiteInfo suites[] = {
     {"suite1", suite_success_init, NULL, NULL, NULL, testcase1},
     {"suite2", NULL, NULL, NULL, NULL, testcase2},
     {"suite3", NULL, suite_success_clean, NULL, NULL, testcase3},
+    {"suite4", NULL, NULL, NULL, NULL, testcase4},
     CU_SUITE_INFO_NULL
 };
 
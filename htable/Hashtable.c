@@ -0,0 +1,942 @@
+/**
+ * @file Hashtable.c
+ * @Brief  open addressing hash table implementation. Robin Hood probing
+ *         keeps the elements of a cluster sorted by their distance from
+ *         home, so a miss stops early and a removal shifts the cluster back
+ *         without tombstones
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-29
+ */
+
+#include <stdlib.h>
+
+#include "Hashtable.h"
+#include "util/HashIndex.h"
+#include "util/Log.h"
+
+#define HTABLE_MIN_CAPACITY 16
+#define HTABLE_DEFAULT_LOAD 80
+/**
+ * slots of the old array that an insert moves at most
+ */
+#define HTABLE_MIGRATE 16
+
+#define HTABLE_HASH(common, key) hindex_mix((common)->key_hash(key))
+#define HTABLE_DISTANCE(slot, index, mask) (((index) - ((slot)->hash & (mask))) & (mask))
+
+/**
+ * positions of the cursor, the old array comes first
+ */
+#define HTABLE_POSITIONS(table) ((table)->old_capacity + (table)->capacity)
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_find find the slot of a key in one array
+ *
+ * @Param common data common struct
+ * @Param slots the array
+ * @Param capacity the size of the array
+ * @Param hash the mixed hash of the key
+ * @Param key the key
+ *
+ * @Returns   -1 means no one; other is the index of the slot
+ */
+/* ----------------------------------------------------------------------------*/
+static long htable_find(DataCommon *common, HashSlot *slots, unsigned int capacity, \
+	unsigned long hash, void *key)
+{
+    if (slots == NULL)
+	return -1;
+
+    unsigned int mask = capacity - 1;
+    unsigned int index = hash & mask;
+    unsigned int distance = 0;
+
+    /**
+     * every element in the way is closer to its home than the key would be,
+     * otherwise the key is not here
+     */
+    while (slots[index].element != NULL \
+	    && HTABLE_DISTANCE(&slots[index], index, mask) >= distance){
+	if (slots[index].hash == hash && common->key_equal(slots[index].element, key) == 0)
+	    return index;
+	index = (index + 1) & mask;
+	distance++;
+    }
+
+    return -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_place put an element in one array, the element that is
+ *         closer to its home gives its slot to the one that is farther
+ *
+ * @Param slots the array
+ * @Param capacity the size of the array
+ * @Param hash the mixed hash
+ * @Param element the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void htable_place(HashSlot *slots, unsigned int capacity, unsigned long hash, \
+	void *element)
+{
+    unsigned int mask = capacity - 1;
+    unsigned int index = hash & mask;
+    unsigned int distance = 0;
+    unsigned int other;
+    HashSlot carried = {.hash = hash, .element = element};
+    HashSlot temp;
+
+    while (slots[index].element != NULL){
+	other = HTABLE_DISTANCE(&slots[index], index, mask);
+	if (other < distance){
+	    temp = slots[index];
+	    slots[index] = carried;
+	    carried = temp;
+	    distance = other;
+	}
+	index = (index + 1) & mask;
+	distance++;
+    }
+    slots[index] = carried;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_unplace take the element out of a slot, the rest of the
+ *         cluster moves one slot back
+ *
+ * @Param slots the array
+ * @Param capacity the size of the array
+ * @Param index the index of the slot
+ *
+ * @Returns   1 means the element of the first slot moves to the last one;
+ *            0 is not
+ */
+/* ----------------------------------------------------------------------------*/
+static int htable_unplace(HashSlot *slots, unsigned int capacity, unsigned int index)
+{
+    unsigned int mask = capacity - 1;
+    unsigned int next = (index + 1) & mask;
+    int wrapped = 0;
+
+    while (slots[next].element != NULL && HTABLE_DISTANCE(&slots[next], next, mask) > 0){
+	if (next == 0)
+	    wrapped = 1;
+	slots[index] = slots[next];
+	index = next;
+	next = (next + 1) & mask;
+    }
+    slots[index].element = NULL;
+    slots[index].hash = 0;
+
+    return wrapped;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_array create an array of free slots
+ *
+ * @Param common data common struct
+ * @Param capacity the size of the array
+ *
+ * @Returns   NULL is failed; other is the array
+ */
+/* ----------------------------------------------------------------------------*/
+static HashSlot* htable_array(DataCommon *common, unsigned int capacity)
+{
+    HashSlot *slots = (HashSlot*)mem_alloc(common->allocator, capacity * sizeof(HashSlot));
+    if (slots == NULL){
+	ERROR("malloc error!");
+	return NULL;
+    }
+
+    unsigned int i;
+    for (i=0; i<capacity; i++){
+	slots[i].hash = 0;
+	slots[i].element = NULL;
+    }
+
+    return slots;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_migrate move some elements of the old array to the new one
+ *
+ * @Param common data common struct
+ * @Param budget the max number of old slots to visit
+ */
+/* ----------------------------------------------------------------------------*/
+static void htable_migrate(DataCommon *common, unsigned int budget)
+{
+    HashTable *table = (HashTable*)(common->linked_type);
+    HashSlot *slot = NULL;
+
+    while (table->old_slots != NULL && budget > 0){
+	if (table->old_size == 0){
+	    mem_free(common->allocator, table->old_slots);
+	    table->old_slots = NULL;
+	    table->old_capacity = 0;
+	    table->migrate = 0;
+	    break;
+	}
+
+	/**
+	 * removing with the back shift keeps the old array a valid table,
+	 * the slot may get the next element of its cluster
+	 */
+	slot = &table->old_slots[table->migrate];
+	if (slot->element != NULL){
+	    htable_place(table->slots, table->capacity, slot->hash, slot->element);
+	    htable_unplace(table->old_slots, table->old_capacity, table->migrate);
+	    table->old_size--;
+	}else{
+	    table->migrate++;
+	}
+	budget--;
+    }
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_grow start to move the elements to an array twice as large
+ *
+ * @Param common data common struct
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int htable_grow(DataCommon *common)
+{
+    HashTable *table = (HashTable*)(common->linked_type);
+
+    /**
+     * the last growth is not done yet, finish it first
+     */
+    if (table->old_slots != NULL)
+	htable_migrate(common, (unsigned int)-1);
+
+    HashSlot *slots = htable_array(common, table->capacity * 2);
+    if (slots == NULL)
+	return -1;
+
+    table->old_slots = table->slots;
+    table->old_capacity = table->capacity;
+    table->old_size = table->size;
+    table->migrate = 0;
+    table->slots = slots;
+    table->capacity *= 2;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_slot find the slot of a key in both arrays
+ *
+ * @Param common data common struct
+ * @Param key the key
+ * @Param position where the position of the slot is put, may be NULL
+ *
+ * @Returns   NULL means no one; other is the slot
+ */
+/* ----------------------------------------------------------------------------*/
+static HashSlot* htable_slot(DataCommon *common, void *key, unsigned int *position)
+{
+    HashTable *table = (HashTable*)(common->linked_type);
+    unsigned long hash = HTABLE_HASH(common, key);
+    long index;
+
+    index = htable_find(common, table->slots, table->capacity, hash, key);
+    if (index >= 0){
+	if (position)
+	    *position = table->old_capacity + index;
+	return &table->slots[index];
+    }
+
+    index = htable_find(common, table->old_slots, table->old_capacity, hash, key);
+    if (index >= 0){
+	if (position)
+	    *position = index;
+	return &table->old_slots[index];
+    }
+
+    return NULL;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_at get the slot at a position
+ *
+ * @Param table hash table
+ * @Param position the position, the old array comes first
+ *
+ * @Returns   the slot
+ */
+/* ----------------------------------------------------------------------------*/
+static HashSlot* htable_at(HashTable *table, unsigned int position)
+{
+    if (position < table->old_capacity)
+	return &table->old_slots[position];
+    return &table->slots[position - table->old_capacity];
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_erase_at remove the element at a position and destroy it
+ *
+ * @Param common data common struct
+ * @Param position the position
+ *
+ * @Returns   1 means the back shift moves the element of the first slot of
+ *            the array to the last one; 0 is not
+ */
+/* ----------------------------------------------------------------------------*/
+static int htable_erase_at(DataCommon *common, unsigned int position)
+{
+    HashTable *table = (HashTable*)(common->linked_type);
+    int wrapped;
+
+    common->destroy_node(htable_at(table, position)->element);
+    if (position < table->old_capacity){
+	wrapped = htable_unplace(table->old_slots, table->old_capacity, position);
+	table->old_size--;
+    }else{
+	wrapped = htable_unplace(table->slots, table->capacity, position - table->old_capacity);
+    }
+    table->size--;
+
+    return wrapped;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_occupied find the nearest position that holds an element
+ *
+ * @Param table hash table
+ * @Param position the position to start from
+ * @Param step 1 is forward; -1 is backward
+ *
+ * @Returns   -1 means no one; other is the position
+ */
+/* ----------------------------------------------------------------------------*/
+static long htable_occupied(HashTable *table, long position, int step)
+{
+    while (position >= 0 && position < HTABLE_POSITIONS(table)){
+	if (htable_at(table, position)->element != NULL)
+	    return position;
+	position += step;
+    }
+
+    return -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_insert insert an element, its key must not be in the table
+ *
+ * @Param common data common struct
+ * @Param element the element
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int htable_insert(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    HashTable *table = (HashTable*)(common->linked_type);
+    void *key = common->element_key(element);
+    if (htable_slot(common, key, NULL) != NULL){
+	INFO("the key is in the table!");
+	return -1;
+    }
+
+    htable_migrate(common, HTABLE_MIGRATE);
+    if ((unsigned long)(table->size + 1 - table->old_size) * 100 \
+	    > (unsigned long)table->capacity * table->load){
+	if (htable_grow(common) != 0)
+	    return -1;
+	htable_migrate(common, HTABLE_MIGRATE);
+    }
+
+    htable_place(table->slots, table->capacity, HTABLE_HASH(common, key), element);
+    table->size++;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_remove remove the element of a key and destroy it
+ *
+ * @Param common data common struct
+ * @Param element the key
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int htable_remove(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    unsigned int position;
+    if (htable_slot(common, element, &position) == NULL)
+	return -1;
+    htable_erase_at(common, position);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_search get the element of a key
+ *
+ * @Param common data common struct
+ * @Param element the key
+ *
+ * @Returns   NULL means no one; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* htable_search(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return NULL;
+    }
+
+    HashSlot *slot = htable_slot(common, element, NULL);
+
+    return slot == NULL ? NULL : slot->element;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_alter alter the element that has the same key, by the
+ *         alter_match function
+ *
+ * @Param common data common struct
+ * @Param element the element-like argument
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int htable_alter(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    HashSlot *slot = htable_slot(common, common->element_key(element), NULL);
+    if (slot == NULL)
+	return -1;
+
+    return (common->alter_match)(slot->element, element);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_prior get the element before the one of a key, in the
+ *         order of the slots
+ *
+ * @Param common data common struct
+ * @Param element the key
+ *
+ * @Returns   NULL means no one; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* htable_prior(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return NULL;
+    }
+
+    HashTable *table = (HashTable*)(common->linked_type);
+    unsigned int position;
+    if (htable_slot(common, element, &position) == NULL)
+	return NULL;
+
+    long prior = htable_occupied(table, (long)position - 1, -1);
+
+    return prior < 0 ? NULL : htable_at(table, prior)->element;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_next get the element after the one of a key, in the order
+ *         of the slots
+ *
+ * @Param common data common struct
+ * @Param element the key
+ *
+ * @Returns   NULL means no one; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* htable_next(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return NULL;
+    }
+
+    HashTable *table = (HashTable*)(common->linked_type);
+    unsigned int position;
+    if (htable_slot(common, element, &position) == NULL)
+	return NULL;
+
+    long next = htable_occupied(table, (long)position + 1, 1);
+
+    return next < 0 ? NULL : htable_at(table, next)->element;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_iterate iterate the table in the order of the slots
+ *
+ * @Param common data common struct
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int htable_iterate(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    HashTable *table = (HashTable*)(common->linked_type);
+    HashSlot *slot = NULL;
+    unsigned int i;
+
+    for (i=0; i<HTABLE_POSITIONS(table); i++){
+	slot = htable_at(table, i);
+	if (slot->element != NULL && (common->handle_iteration)(slot->element) != 0){
+	    ERROR("handle_iteration function error!");
+	    return -1;
+	}
+    }
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_size get the number of elements
+ *
+ * @Param common data common struct
+ *
+ * @Returns   -1 is failed; other is the size
+ */
+/* ----------------------------------------------------------------------------*/
+static int htable_size(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    return ((HashTable*)(common->linked_type))->size;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_clear destroy all the elements, the array is kept
+ *
+ * @Param common data common struct
+ *
+ * @Returns   -1 is failed; other is the number of elements
+ */
+/* ----------------------------------------------------------------------------*/
+static int htable_clear(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    HashTable *table = (HashTable*)(common->linked_type);
+    HashSlot *slot = NULL;
+    unsigned int i;
+
+    for (i=0; i<HTABLE_POSITIONS(table); i++){
+	slot = htable_at(table, i);
+	if (slot->element != NULL){
+	    common->destroy_node(slot->element);
+	    slot->element = NULL;
+	    slot->hash = 0;
+	}
+    }
+
+    if (table->old_slots != NULL)
+	mem_free(common->allocator, table->old_slots);
+    table->old_slots = NULL;
+    table->old_capacity = 0;
+    table->old_size = 0;
+    table->migrate = 0;
+
+    int ret = table->size;
+    table->size = 0;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_begin put the cursor on the first element in the order of
+ *         the slots
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means the table is empty
+ */
+/* ----------------------------------------------------------------------------*/
+static int htable_begin(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    HashTable *table = (HashTable*)(common->linked_type);
+    long position = htable_occupied(table, 0, 1);
+
+    cursor->previous = NULL;
+    cursor->index = position;
+    cursor->node = position < 0 ? NULL : htable_at(table, position);
+
+    return position < 0 ? -1 : 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_end put the cursor on the last element
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means the table is empty
+ */
+/* ----------------------------------------------------------------------------*/
+static int htable_end(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    HashTable *table = (HashTable*)(common->linked_type);
+    long position = htable_occupied(table, (long)HTABLE_POSITIONS(table) - 1, -1);
+
+    cursor->previous = NULL;
+    cursor->index = position;
+    cursor->node = position < 0 ? NULL : htable_at(table, position);
+
+    return position < 0 ? -1 : 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_walk put the cursor on the nearest element from a position.
+ *         cursor->previous is the first element that an erase moves from
+ *         the first slot of the array to the last one: it and the ones
+ *         after it in the array have been visited, so going forward the
+ *         cursor leaves the array there
+ *
+ * @Param table hash table
+ * @Param cursor the cursor
+ * @Param position the position to start from
+ * @Param step 1 is forward; -1 is backward
+ *
+ * @Returns   0 is OK; -1 means the cursor is off the table
+ */
+/* ----------------------------------------------------------------------------*/
+static int htable_walk(HashTable *table, Cursor *cursor, long position, int step)
+{
+    int old = cursor->index < (long)table->old_capacity;
+
+    position = htable_occupied(table, position, step);
+    if (step > 0 && position >= 0 && cursor->previous != NULL \
+	    && htable_at(table, position)->element == cursor->previous){
+	if (position < (long)table->old_capacity)
+	    position = htable_occupied(table, table->old_capacity, 1);
+	else
+	    position = -1;
+    }
+    if (step < 0 || position < 0 || (position < (long)table->old_capacity) != old)
+	cursor->previous = NULL;
+
+    cursor->index = position;
+    cursor->node = position < 0 ? NULL : htable_at(table, position);
+
+    return position < 0 ? -1 : 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_move move the cursor to the nearest element
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ * @Param step 1 is forward; -1 is backward
+ *
+ * @Returns   0 is OK; -1 means the cursor is off the table
+ */
+/* ----------------------------------------------------------------------------*/
+static int htable_move(DataCommon *common, Cursor *cursor, int step)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+    if (cursor->node == NULL)
+	return -1;
+
+    HashTable *table = (HashTable*)(common->linked_type);
+
+    return htable_walk(table, cursor, (long)cursor->index + step, step);
+}
+
+static int htable_advance(DataCommon *common, Cursor *cursor)
+{
+    return htable_move(common, cursor, 1);
+}
+
+static int htable_retreat(DataCommon *common, Cursor *cursor)
+{
+    return htable_move(common, cursor, -1);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_get return the element under the cursor
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   NULL means the cursor is off the table; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* htable_get(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return NULL;
+    }
+
+    HashSlot *slot = (HashSlot*)(cursor->node);
+
+    return slot == NULL ? NULL : slot->element;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_erase remove the element under the cursor, the cursor
+ *         moves to the next one
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int htable_erase(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+    if (cursor->node == NULL)
+	return -1;
+
+    HashTable *table = (HashTable*)(common->linked_type);
+    unsigned int position = cursor->index;
+    unsigned int end = position < table->old_capacity ? table->old_capacity \
+		       : HTABLE_POSITIONS(table);
+
+    /**
+     * the back shift pulls the rest of the cluster one slot back, when it
+     * wraps around the array an element that the cursor has passed comes
+     * to the last slot
+     */
+    if (htable_erase_at(common, position) && cursor->previous == NULL)
+	cursor->previous = htable_at(table, end - 1)->element;
+
+    htable_walk(table, cursor, position, 1);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_insert_after the table keeps no order, use insert
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ * @Param element the element
+ *
+ * @Returns   -1
+ */
+/* ----------------------------------------------------------------------------*/
+static int htable_insert_after(DataCommon *common, Cursor *cursor, void *element)
+{
+    (void)common;
+    (void)cursor;
+    (void)element;
+    ERROR("the hash table keeps no order, use insert!");
+    return -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_new create a table whose max load factor is 80 percent
+ *
+ * @Param common data common struct
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int htable_new(DataCommon *common)
+{
+    return htable_new_load(common, HTABLE_DEFAULT_LOAD);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_new_load create a table, initial datacommon struct
+ *
+ * @Param common data common struct
+ * @Param load The max load factor in percent, from 10 to 95
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int htable_new_load(DataCommon *common, unsigned int load)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    /**
+     * check the user-defined functhion
+     */
+    int handle_check = DATA_COMMON_INDEXED(common) \
+		       &&common->alter_match \
+		       &&common->destroy_node \
+		       &&common->handle_iteration \
+		       &&ALLOCATOR_CHECK(common->allocator);
+    if (handle_check == 0){
+	ERROR("missed user defined function!");
+	return -1;
+    }
+    if (load < 10 || load > 95){
+	ERROR("load factor is out of range!");
+	return -1;
+    }
+
+    HashTable *table = (HashTable*)mem_alloc(common->allocator, sizeof(HashTable));
+    if (table == NULL){
+	ERROR("malloc error!");
+	return -1;
+    }
+    table->slots = htable_array(common, HTABLE_MIN_CAPACITY);
+    if (table->slots == NULL){
+	mem_free(common->allocator, table);
+	return -1;
+    }
+    table->capacity = HTABLE_MIN_CAPACITY;
+    table->size = 0;
+    table->old_slots = NULL;
+    table->old_capacity = 0;
+    table->old_size = 0;
+    table->migrate = 0;
+    table->load = load;
+
+    common->linked_type = table;
+    common->insert = htable_insert;
+    common->remove = htable_remove;
+    common->search = htable_search;
+    common->alter = htable_alter;
+    common->prior = htable_prior;
+    common->next = htable_next;
+    common->iterate = htable_iterate;
+    common->size = htable_size;
+    common->clear = htable_clear;
+    common->begin = htable_begin;
+    common->end = htable_end;
+    common->advance = htable_advance;
+    common->retreat = htable_retreat;
+    common->get = htable_get;
+    common->erase = htable_erase;
+    common->insert_after = htable_insert_after;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  htable_delete destroy all the elements and the table
+ *
+ * @Param common data common struct
+ *
+ * @Returns   -1 is failed; other is the number of elements
+ */
+/* ----------------------------------------------------------------------------*/
+int htable_delete(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    int ret = htable_clear(common);
+
+    HashTable *table = (HashTable*)(common->linked_type);
+    mem_free(common->allocator, table->slots);
+    mem_free(common->allocator, table);
+    common->linked_type = NULL;
+
+    return ret;
+}
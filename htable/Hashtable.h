@@ -0,0 +1,62 @@
+/**
+ * @file Hashtable.h
+ * @Brief  open addressing hash table header, the elements are found by
+ *         their keys and kept in no order
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-29
+ */
+
+#ifndef HASH_TABLE_H_
+#define HASH_TABLE_H_
+
+#include "Common.h"
+
+/**
+ * Represent a slot, element is NULL when the slot is free
+ */
+typedef struct HashSlot{
+    /**
+     * the mixed hash of the key, its low bits are the home slot
+     */
+    unsigned long hash;
+    void *element;
+}HashSlot;
+
+/**
+ * Represent a Robin Hood hash table. When it grows, the elements move to
+ * the larger array a few at a time on every insert, until then a key is
+ * looked up in both arrays
+ */
+typedef struct HashTable{
+    HashSlot *slots;
+    unsigned int capacity;
+    /**
+     * the number of elements in both arrays
+     */
+    int size;
+    /**
+     * the array that is being moved, NULL when the table does not grow
+     */
+    HashSlot *old_slots;
+    unsigned int old_capacity;
+    int old_size;
+    /**
+     * the next slot of the old array to move
+     */
+    unsigned int migrate;
+    /**
+     * the max load factor in percent
+     */
+    unsigned int load;
+}HashTable;
+
+/**
+ * the key functions of the DataCommon must be set, search/remove/prior/next
+ * take a key and alter takes an element-like argument
+ */
+int htable_new(DataCommon *common);
+int htable_new_load(DataCommon *common, unsigned int load);
+int htable_delete(DataCommon *common);
+
+#endif
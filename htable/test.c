@@ -0,0 +1,442 @@
+/**
+ * @file test.c
+ * @Brief  test hash table
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-29
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+/**
+ * Cunit headers
+ */ 
+#include "CUnit.h"
+#include "Automated.h"
+#include "Basic.h"
+#include "Console.h"
+
+/**
+ * Test file headers
+ */ 
+#include "Common.h"
+#include "htable/Hashtable.h"
+#include "util/Log.h"
+#include "util/HashIndex.h"
+
+
+/*************Test Case Begin*******************/
+
+#define TABLE_COUNT 5000
+
+DataCommon numbers = DATA_COMMON_NULL;
+int values[TABLE_COUNT];
+int destroyed = 0;
+int visited = 0;
+
+int number_match(void *element, void *key)
+{
+    return *(int*)element == *(int*)key ? 0 : -1;
+}
+
+int number_alter(void *element, void *arg)
+{
+    return *(int*)element == *(int*)arg ? 0 : -1;
+}
+
+int number_destroy(void *element)
+{
+    *(int*)element = -1;
+    destroyed++;
+    return 0;
+}
+
+int number_iteration(void *element)
+{
+    visited++;
+    return 0;
+}
+
+unsigned long number_hash(void *key)
+{
+    return (unsigned long)*(int*)key;
+}
+
+void* number_key(void *element)
+{
+    return element;
+}
+
+void number_common(DataCommon *common)
+{
+    common->alter_match = number_alter;
+    common->destroy_node = number_destroy;
+    common->handle_iteration = number_iteration;
+    common->key_hash = number_hash;
+    common->key_equal = number_match;
+    common->element_key = number_key;
+}
+
+void test_htable_new()
+{
+    DataCommon common = DATA_COMMON_NULL;
+    CU_ASSERT_EQUAL(htable_new(&common), -1);
+
+    number_common(&common);
+    CU_ASSERT_EQUAL(htable_new_load(&common, 5), -1);
+    CU_ASSERT_EQUAL(htable_new_load(&common, 100), -1);
+    CU_ASSERT_EQUAL(htable_new_load(&common, 50), 0);
+    CU_ASSERT_EQUAL(common.size(&common), 0);
+    CU_ASSERT_EQUAL(htable_delete(&common), 0);
+}
+
+void test_htable_insert()
+{
+    number_common(&numbers);
+    CU_ASSERT_EQUAL_FATAL(htable_new(&numbers), 0);
+
+    HashTable *table = (HashTable*)numbers.linked_type;
+    int i, key, grown = 0;
+    for (i=0; i<TABLE_COUNT; i++){
+	values[i] = i;
+	CU_ASSERT_EQUAL_FATAL(numbers.insert(&numbers, &values[i]), 0);
+	CU_ASSERT_TRUE_FATAL(table->size * 100 <= (int)(table->capacity * table->load));
+
+	/**
+	 * the old array is still moving, every key is found in one of them
+	 */
+	if (table->old_slots != NULL && table->old_size > 0 && grown == 0){
+	    grown = 1;
+	    for (key=0; key<=i; key++)
+		CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), &values[key]);
+	    visited = 0;
+	    CU_ASSERT_EQUAL_FATAL(numbers.iterate(&numbers), 0);
+	    CU_ASSERT_EQUAL_FATAL(visited, i + 1);
+	}
+    }
+    CU_ASSERT_EQUAL(grown, 1);
+    CU_ASSERT_EQUAL(numbers.size(&numbers), TABLE_COUNT);
+
+    key = 7;
+    CU_ASSERT_EQUAL(numbers.insert(&numbers, &key), -1);
+    CU_ASSERT_EQUAL(numbers.size(&numbers), TABLE_COUNT);
+}
+
+void test_htable_search()
+{
+    int i, key;
+    for (i=0; i<TABLE_COUNT; i++){
+	key = i;
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), &values[i]);
+	CU_ASSERT_EQUAL_FATAL(numbers.alter(&numbers, &key), 0);
+    }
+    key = TABLE_COUNT;
+    CU_ASSERT_PTR_EQUAL(numbers.search(&numbers, &key), NULL);
+    CU_ASSERT_EQUAL(numbers.alter(&numbers, &key), -1);
+    CU_ASSERT_EQUAL(numbers.remove(&numbers, &key), -1);
+
+    visited = 0;
+    CU_ASSERT_EQUAL(numbers.iterate(&numbers), 0);
+    CU_ASSERT_EQUAL(visited, TABLE_COUNT);
+}
+
+void test_htable_cursor()
+{
+    Cursor cursor = CURSOR_NULL;
+    int count = 0;
+    int *value = NULL;
+    int *last = NULL;
+
+    CU_ASSERT_EQUAL_FATAL(numbers.begin(&numbers, &cursor), 0);
+    for (; CURSOR_VALID(&cursor); numbers.advance(&numbers, &cursor)){
+	value = (int*)numbers.get(&numbers, &cursor);
+	if (last != NULL)
+	    CU_ASSERT_PTR_EQUAL_FATAL(numbers.next(&numbers, last), value);
+	last = value;
+	count++;
+    }
+    CU_ASSERT_EQUAL(count, TABLE_COUNT);
+
+    CU_ASSERT_EQUAL_FATAL(numbers.end(&numbers, &cursor), 0);
+    CU_ASSERT_PTR_EQUAL(numbers.get(&numbers, &cursor), last);
+    CU_ASSERT_PTR_EQUAL(numbers.next(&numbers, last), NULL);
+    CU_ASSERT_EQUAL(numbers.retreat(&numbers, &cursor), 0);
+    CU_ASSERT_PTR_EQUAL(numbers.prior(&numbers, last), numbers.get(&numbers, &cursor));
+    CU_ASSERT_EQUAL(numbers.insert_after(&numbers, &cursor, &values[0]), -1);
+
+    /**
+     * erase the even numbers by the cursor, the back shift must not make
+     * it skip an element
+     */
+    int i, key;
+    count = 0;
+    destroyed = 0;
+    numbers.begin(&numbers, &cursor);
+    while (CURSOR_VALID(&cursor)){
+	value = (int*)numbers.get(&numbers, &cursor);
+	count++;
+	if (*value % 2 == 0){
+	    CU_ASSERT_EQUAL_FATAL(numbers.erase(&numbers, &cursor), 0);
+	}else{
+	    numbers.advance(&numbers, &cursor);
+	}
+    }
+    CU_ASSERT_EQUAL(count, TABLE_COUNT);
+    CU_ASSERT_EQUAL(destroyed, TABLE_COUNT / 2);
+    CU_ASSERT_EQUAL(numbers.size(&numbers), TABLE_COUNT / 2);
+    for (i=0; i<TABLE_COUNT; i++){
+	key = i;
+	if (i % 2 == 0){
+	    CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), NULL);
+	}else{
+	    CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), &values[i]);
+	}
+    }
+}
+
+void test_htable_wrap()
+{
+    /**
+     * four keys whose home is slot 14 of the 16 slots, the cluster wraps
+     * to the slots 0 and 1; an erase in the middle of it moves the
+     * element of slot 0, which the cursor has passed, to slot 15
+     */
+    DataCommon cluster = DATA_COMMON_NULL;
+    Cursor cursor = CURSOR_NULL;
+    int keys[4], elements[4], visits[4];
+    int i, j, key, mask, count;
+
+    for (i=0, key=0; i<4; key++){
+	if ((hindex_mix((unsigned long)key) & 15) == 14)
+	    keys[i++] = key;
+    }
+
+    for (mask=0; mask<16; mask++){
+	number_common(&cluster);
+	CU_ASSERT_EQUAL_FATAL(htable_new(&cluster), 0);
+	for (i=0; i<4; i++){
+	    elements[i] = keys[i];
+	    visits[i] = 0;
+	    CU_ASSERT_EQUAL_FATAL(cluster.insert(&cluster, &elements[i]), 0);
+	}
+
+	/**
+	 * erase the keys in the mask by the cursor, every element is
+	 * visited once
+	 */
+	count = 0;
+	cluster.begin(&cluster, &cursor);
+	while (CURSOR_VALID(&cursor)){
+	    i = (int*)cluster.get(&cluster, &cursor) - elements;
+	    CU_ASSERT_TRUE_FATAL(i >= 0 && i < 4);
+	    visits[i]++;
+	    count++;
+	    if (mask & (1 << i)){
+		CU_ASSERT_EQUAL_FATAL(cluster.erase(&cluster, &cursor), 0);
+	    }else{
+		cluster.advance(&cluster, &cursor);
+	    }
+	}
+	CU_ASSERT_EQUAL(count, 4);
+	for (i=0; i<4; i++){
+	    CU_ASSERT_EQUAL(visits[i], 1);
+	    key = keys[i];
+	    if (mask & (1 << i)){
+		CU_ASSERT_PTR_EQUAL(cluster.search(&cluster, &key), NULL);
+	    }else{
+		CU_ASSERT_PTR_EQUAL(cluster.search(&cluster, &key), &elements[i]);
+	    }
+	}
+	for (i=0, j=0; i<4; i++)
+	    j += (mask & (1 << i)) ? 0 : 1;
+	CU_ASSERT_EQUAL(cluster.size(&cluster), j);
+	htable_delete(&cluster);
+    }
+}
+
+void test_htable_remove()
+{
+    int i, key;
+    for (i=1; i<TABLE_COUNT; i+=4){
+	key = i;
+	CU_ASSERT_EQUAL_FATAL(numbers.remove(&numbers, &key), 0);
+	CU_ASSERT_EQUAL_FATAL(values[i], -1);
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), NULL);
+    }
+    for (i=3; i<TABLE_COUNT; i+=4){
+	key = i;
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), &values[i]);
+    }
+
+    /**
+     * the removed keys can come back
+     */
+    for (i=0; i<TABLE_COUNT; i+=4){
+	values[i] = i;
+	CU_ASSERT_EQUAL_FATAL(numbers.insert(&numbers, &values[i]), 0);
+    }
+    CU_ASSERT_EQUAL(numbers.size(&numbers), TABLE_COUNT / 2);
+}
+
+void test_htable_delete()
+{
+    destroyed = 0;
+    CU_ASSERT_EQUAL(numbers.clear(&numbers), TABLE_COUNT / 2);
+    CU_ASSERT_EQUAL(destroyed, TABLE_COUNT / 2);
+    CU_ASSERT_EQUAL(numbers.size(&numbers), 0);
+
+    int key = 3;
+    values[3] = 3;
+    CU_ASSERT_EQUAL(numbers.insert(&numbers, &values[3]), 0);
+    CU_ASSERT_PTR_EQUAL(numbers.search(&numbers, &key), &values[3]);
+    CU_ASSERT_EQUAL(htable_delete(&numbers), 1);
+    CU_ASSERT_PTR_EQUAL(numbers.linked_type, NULL);
+}
+
+/*************Test Case End*********************/
+
+
+
+/**
+ * add testcase, similar function in the same testcase
+ * 
+ * typedef struct CU_TestInfo {
+ * 	const char  *pName;
+ *	CU_TestFunc pTestFunc;
+ *	} CU_TestInfo;
+ *
+ * Example:
+ *
+ * static CU_TestInfo testcase1[] = {
+ * 	{ "test_function_name", test_function},
+ * 	{ "test_function_name2", test_function2},
+ * 	CU_TEST_INFO_NULL
+ * };
+ *
+ * static CU_TestInfo testcase2[] = {
+ * 	...
+ * 	CU_TEST_INFO_NULL
+ * };
+ *
+ */ 
+
+static CU_TestInfo testcase1[] = {
+    { "test_htable_new", test_htable_new},
+    { "test_htable_insert", test_htable_insert},
+    { "test_htable_search", test_htable_search},
+    { "test_htable_cursor", test_htable_cursor},
+    { "test_htable_wrap", test_htable_wrap},
+    { "test_htable_remove", test_htable_remove},
+    { "test_htable_delete", test_htable_delete},
+    CU_TEST_INFO_NULL
+};
+
+/**
+ * add testcase to the suites
+ * 
+ * typedef struct CU_SuiteInfo {
+ *     const char       *pName;         
+ *     CU_InitializeFunc pInitFunc;     
+ *     CU_CleanupFunc    pCleanupFunc;  
+ *     CU_SetUpFunc      pSetUpFunc;    
+ *     CU_TearDownFunc   pTearDownFunc; 
+ *     CU_TestInfo      *pTests;        
+ * } CU_SuiteInfo;
+ *
+ * Example:
+ *
+ * static CU_SuiteInfo suites[] = {
+ * 	{"suite name", suite_success_init, suite_success_clean, NULL, NULL, testcase},
+ * 	...
+ * 	CU_SUITE_INFO_NULL
+ * }
+ *
+ */
+
+static int suite_success_init(void) 
+{
+    return 0; 
+}
+static int suite_success_clean(void) 
+{
+    return 0; 
+}
+
+
+static CU_SuiteInfo suites[] = {
+    {"suite1", suite_success_init, NULL, NULL, NULL, testcase1},
+    CU_SUITE_INFO_NULL
+};
+
+
+
+/**
+ * add tests to the test framework
+ *
+ */ 
+void AddTests(void)
+{
+    assert(NULL != CU_get_registry());
+    assert(!CU_is_test_running());
+
+    /* Register suites. */
+    if (CU_register_suites(suites) != CUE_SUCCESS) {
+	fprintf(stderr, "suite registration failed - %s\n",
+		CU_get_error_msg());
+	exit(EXIT_FAILURE);
+    }
+
+}
+
+
+int main()
+{
+    if (CU_initialize_registry()) {
+	printf("\nInitialization of Test Registry failed.");
+    }else{
+
+	LOG_FILE_OPEN("log.txt");
+
+	AddTests();
+
+	/*******Automated Mode(best)*********************
+	 * CU_set_output_filename("TestAutomated");
+	 * CU_list_tests_to_file();
+	 * CU_automated_run_tests();
+	 ******************************************/
+
+	 CU_set_output_filename("TestAutomated");
+	 CU_list_tests_to_file();
+	 CU_automated_run_tests();
+	/*******Basic Mode*********************
+	 * mode can choose:
+	 * typedef enum {
+	 *   CU_BRM_NORMAL = 0, Normal mode - failures and run summary are printed [default].
+	 *   CU_BRM_SILENT,     Silent mode - no output is printed except framework error messages.
+	 *   CU_BRM_VERBOSE     Verbose mode - maximum output of run details.
+	 * } CU_BasicRunMode;
+	 ****************************************
+	 *
+	 * CU_basic_set_mode(CU_BRM_NORMAL);
+	 * CU_basic_run_tests();
+	 ******************************************/
+
+	/*******Console Mode*********************
+	 * CU_console_run_tests();
+	 ******************************************/
+
+	/*******Curses Mode*********************
+	 * CU_curses_run_tests();
+	 ******************************************/ 
+
+
+	CU_cleanup_registry();
+    }
+
+    LOG_FILE_CLOSE();
+    return 0;
+}
+
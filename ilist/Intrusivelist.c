@@ -0,0 +1,736 @@
+/**
+ * @file Intrusivelist.c
+ * @Brief  Intrusive double linked list implementation.
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-16
+ */
+
+#include <stdlib.h>
+
+#include "Intrusivelist.h"
+#include "Common.h"
+#include "util/Log.h"
+
+
+/**
+ * Convert between an element and its link
+ */
+#define ILIST_LINK(list, element) \
+    ((ILink*)((char*)(element) + (list)->offset))
+#define ILIST_ELEMENT(list, link) \
+    ((void*)((char*)(link) - (list)->offset))
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_detach Take a link out of the chain
+ *
+ * @Param list Intrusive list
+ * @Param link The link
+ */
+/* ----------------------------------------------------------------------------*/
+static void ilist_detach(IntrusiveList *list, ILink *link)
+{
+    if (link->previous != NULL)
+	link->previous->next = link->next;
+    else
+	list->first = link->next;
+
+    if (link->next != NULL)
+	link->next->previous = link->previous;
+    else
+	list->last = link->previous;
+
+    link->previous = NULL;
+    link->next = NULL;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_attach Link a link after another one
+ *
+ * @Param list Intrusive list
+ * @Param pre The link that the new one follows, NULL means the front
+ * @Param link The link
+ */
+/* ----------------------------------------------------------------------------*/
+static void ilist_attach(IntrusiveList *list, ILink *pre, ILink *link)
+{
+    link->previous = pre;
+    link->next = (pre == NULL) ? list->first : pre->next;
+
+    if (link->next != NULL)
+	link->next->previous = link;
+    else
+	list->last = link;
+
+    if (pre != NULL)
+	pre->next = link;
+    else
+	list->first = link;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_unlink Remove a link from the list and destroy its element
+ *
+ * @Param common Data common struct
+ * @Param link The link
+ */
+/* ----------------------------------------------------------------------------*/
+static void ilist_unlink(DataCommon *common, ILink *link)
+{
+    IntrusiveList *list = (IntrusiveList*)(common->linked_type);
+
+    ilist_detach(list, link);
+    list->size--;
+
+    /**
+     * the link is a part of the element, it is not used after this
+     */
+    common->destroy_node(ILIST_ELEMENT(list, link));
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_find Find the link of the first matched element
+ *
+ * @Param common Data common struct
+ * @Param match The match function
+ * @Param arg The user's arg of the match function
+ *
+ * @Returns   NULL is failed; other is the link
+ */
+/* ----------------------------------------------------------------------------*/
+static ILink* ilist_find(DataCommon *common, handle_element match, void *arg)
+{
+    IntrusiveList *list = (IntrusiveList*)(common->linked_type);
+    ILink *link = list->first;
+
+    while (link){
+	if (match(ILIST_ELEMENT(list, link), arg) == 0)
+	    return link;
+	link = link->next;
+    }
+
+    return NULL;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_insert Insert an element to the end of the list
+ *
+ * @Param common Data common struct
+ * @Param element The element, its link must not be in any list
+ *
+ * @Returns   0 is OK;other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int ilist_insert(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    IntrusiveList *list = (IntrusiveList*)(common->linked_type);
+    ilist_attach(list, list->last, ILIST_LINK(list, element));
+    list->size++;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_remove Remove an element from the list
+ *
+ * @Param common Data common struct
+ * @Param element The element's information that need to be removed
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int ilist_remove(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    ILink *link = ilist_find(common, common->remove_match, element);
+    if (link == NULL){
+	INFO("no matched node!");
+	return -1;
+    }
+    ilist_unlink(common, link);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_search Search an element from the list
+ *
+ * @Param common Data common struct
+ * @Param element The element's information
+ *
+ * @Returns   NULL is failed; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* ilist_search(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("null pointer!");
+	return NULL;
+    }
+
+    IntrusiveList *list = (IntrusiveList*)(common->linked_type);
+    ILink *link = ilist_find(common, common->search_match, element);
+    if (link == NULL){
+	INFO("no matched node!");
+	return NULL;
+    }
+
+    return ILIST_ELEMENT(list, link);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_alter Alter an element
+ *
+ * @Param common Data common struct
+ * @Param element the element's information
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int ilist_alter(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    if (ilist_find(common, common->alter_match, element) == NULL){
+	INFO("no matched node!");
+	return -1;
+    }
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_prior Find the element's previous element
+ *
+ * @Param common Data common struct
+ * @Param element the element's information
+ *
+ * @Returns   NULL is failed; other is the previous element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* ilist_prior(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("null pointer!");
+	return NULL;
+    }
+
+    IntrusiveList *list = (IntrusiveList*)(common->linked_type);
+    ILink *link = ilist_find(common, common->search_match, element);
+    if (link == NULL){
+	INFO("no matched node!");
+	return NULL;
+    }
+
+    return link->previous == NULL ? NULL : ILIST_ELEMENT(list, link->previous);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_next Find the element's next element
+ *
+ * @Param common Data common struct
+ * @Param element The element's information
+ *
+ * @Returns   NULL is failed; other is the next element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* ilist_next(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("null pointer!");
+	return NULL;
+    }
+
+    IntrusiveList *list = (IntrusiveList*)(common->linked_type);
+    ILink *link = ilist_find(common, common->search_match, element);
+    if (link == NULL){
+	INFO("no matched node!");
+	return NULL;
+    }
+
+    return link->next == NULL ? NULL : ILIST_ELEMENT(list, link->next);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_iterate Iterate the list
+ *
+ * @Param common Data common struct
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int ilist_iterate(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    IntrusiveList *list = (IntrusiveList*)(common->linked_type);
+    ILink *link = list->first;
+
+    while (link){
+	if (common->handle_iteration(ILIST_ELEMENT(list, link)) == 0)
+	    link = link->next;
+	else{
+	    ERROR("handle iteration error!");
+	    return -1;
+	}
+    }
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_size Return the list's size
+ *
+ * @Param common Data common struct
+ *
+ * @Returns   -1 is failed; >=0 is the number of list
+ */
+/* ----------------------------------------------------------------------------*/
+static int ilist_size(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    IntrusiveList *list = (IntrusiveList*)(common->linked_type);
+
+    return list->size;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_clear Destroy all the elements in the list
+ *
+ * @Param common Data common struct
+ *
+ * @Returns -1 is failed; >=0 is the number of element that is destroyed
+ */
+/* ----------------------------------------------------------------------------*/
+static int ilist_clear(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    IntrusiveList *list = (IntrusiveList*)(common->linked_type);
+    ILink *link = list->first;
+    ILink *temp = NULL;
+    int ret = 0;
+
+    while (link){
+	temp = link;
+	link = link->next;
+
+	temp->previous = NULL;
+	temp->next = NULL;
+	common->destroy_node(ILIST_ELEMENT(list, temp));
+
+	ret++;
+    }
+
+    list->first = NULL;
+    list->last = NULL;
+    list->size = 0;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_begin Put the cursor on the first element
+ *
+ * @Param common Data common struct
+ * @Param cursor The cursor
+ *
+ * @Returns   0 is OK; -1 means the list is empty
+ */
+/* ----------------------------------------------------------------------------*/
+static int ilist_begin(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    IntrusiveList *list = (IntrusiveList*)(common->linked_type);
+    cursor->node = list->first;
+    cursor->previous = NULL;
+    cursor->index = 0;
+
+    return cursor->node == NULL ? -1 : 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_end Put the cursor on the last element
+ *
+ * @Param common Data common struct
+ * @Param cursor The cursor
+ *
+ * @Returns   0 is OK; -1 means the list is empty
+ */
+/* ----------------------------------------------------------------------------*/
+static int ilist_end(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    IntrusiveList *list = (IntrusiveList*)(common->linked_type);
+    cursor->node = list->last;
+    cursor->previous = NULL;
+    cursor->index = 0;
+
+    return cursor->node == NULL ? -1 : 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_advance Move the cursor to the next element
+ *
+ * @Param common Data common struct
+ * @Param cursor The cursor
+ *
+ * @Returns   0 is OK; -1 means the cursor is off the list
+ */
+/* ----------------------------------------------------------------------------*/
+static int ilist_advance(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    ILink *link = (ILink*)(cursor->node);
+    if (link == NULL)
+	return -1;
+    cursor->node = link->next;
+
+    return cursor->node == NULL ? -1 : 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_retreat Move the cursor to the prior element
+ *
+ * @Param common Data common struct
+ * @Param cursor The cursor
+ *
+ * @Returns   0 is OK; -1 means the cursor is off the list
+ */
+/* ----------------------------------------------------------------------------*/
+static int ilist_retreat(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    ILink *link = (ILink*)(cursor->node);
+    if (link == NULL)
+	return -1;
+    cursor->node = link->previous;
+
+    return cursor->node == NULL ? -1 : 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_get Return the element under the cursor
+ *
+ * @Param common Data common struct
+ * @Param cursor The cursor
+ *
+ * @Returns   NULL means the cursor is off the list; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* ilist_get(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("null pointer!");
+	return NULL;
+    }
+
+    IntrusiveList *list = (IntrusiveList*)(common->linked_type);
+    ILink *link = (ILink*)(cursor->node);
+
+    return link == NULL ? NULL : ILIST_ELEMENT(list, link);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_erase Remove the element under the cursor, the cursor moves
+ *         to the next element
+ *
+ * @Param common Data common struct
+ * @Param cursor The cursor
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int ilist_erase(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    ILink *link = (ILink*)(cursor->node);
+    if (link == NULL){
+	INFO("cursor is off the list!");
+	return -1;
+    }
+
+    cursor->node = link->next;
+    ilist_unlink(common, link);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_insert_after Insert an element after the cursor
+ *
+ * @Param common Data common struct
+ * @Param cursor The cursor, off the list means inserting at the front
+ * @Param element The element, its link must not be in any list
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int ilist_insert_after(DataCommon *common, Cursor *cursor, void *element)
+{
+    if ((common == NULL) || (cursor == NULL) || (element == NULL)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    IntrusiveList *list = (IntrusiveList*)(common->linked_type);
+    ilist_attach(list, (ILink*)(cursor->node), ILIST_LINK(list, element));
+    list->size++;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_new Create an intrusive list and initial it
+ *
+ * @Param common Data common struct
+ * @Param offset The offset of the ILink in the element, offsetof(type, member)
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int ilist_new(DataCommon *common, size_t offset)
+{
+    if (common == NULL){
+	ERROR("NULL pointer!");
+	return -1;
+    }
+
+    /**
+     * check the user-defined function
+     */
+    int handle_check = common->remove_match \
+		       &&common->search_match \
+		       &&common->alter_match \
+		       &&common->destroy_node \
+		       &&common->handle_iteration \
+		       &&ALLOCATOR_CHECK(common->allocator);
+    if (handle_check == 0){
+	ERROR("missed user defined function!");
+	return -1;
+    }
+
+    /**
+     * the list struct is the only memory that the list allocates
+     */
+    IntrusiveList *list = (IntrusiveList*)mem_alloc(common->allocator, sizeof(IntrusiveList));
+    if (list == NULL){
+	ERROR("malloc error!");
+	return -1;
+    }
+    list->first = NULL;
+    list->last = NULL;
+    list->size = 0;
+    list->offset = offset;
+
+    /**
+     * initial DataCommon struct
+     */
+    common->linked_type = list;
+    common->insert = ilist_insert;
+    common->remove = ilist_remove;
+    common->search = ilist_search;
+    common->alter = ilist_alter;
+    common->prior = ilist_prior;
+    common->next = ilist_next;
+    common->iterate = ilist_iterate;
+    common->size = ilist_size;
+    common->clear = ilist_clear;
+    common->begin = ilist_begin;
+    common->end = ilist_end;
+    common->advance = ilist_advance;
+    common->retreat = ilist_retreat;
+    common->get = ilist_get;
+    common->erase = ilist_erase;
+    common->insert_after = ilist_insert_after;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_delete Delete the list, all the elements are destroyed
+ *
+ * @Param common Data common struct
+ *
+ * @Returns   -1 is failed; >=0 is the number of element
+ */
+/* ----------------------------------------------------------------------------*/
+int ilist_delete(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("NULL pointer!");
+	return -1;
+    }
+
+    int ret = ilist_clear(common);
+    mem_free(common->allocator, common->linked_type);
+    common->linked_type = NULL;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_remove_element Remove an element in the list without
+ *         searching, and destroy it
+ *
+ * @Param common Data common struct
+ * @Param element The element that is in the list
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int ilist_remove_element(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    IntrusiveList *list = (IntrusiveList*)(common->linked_type);
+    ilist_unlink(common, ILIST_LINK(list, element));
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_move_to_front Move an element in the list to the front
+ *
+ * @Param common Data common struct
+ * @Param element The element that is in the list
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int ilist_move_to_front(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    IntrusiveList *list = (IntrusiveList*)(common->linked_type);
+    ILink *link = ILIST_LINK(list, element);
+    if (list->first != link){
+	ilist_detach(list, link);
+	ilist_attach(list, NULL, link);
+    }
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ilist_move_to_back Move an element in the list to the end
+ *
+ * @Param common Data common struct
+ * @Param element The element that is in the list
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int ilist_move_to_back(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    IntrusiveList *list = (IntrusiveList*)(common->linked_type);
+    ILink *link = ILIST_LINK(list, element);
+    if (list->last != link){
+	ilist_detach(list, link);
+	ilist_attach(list, list->last, link);
+    }
+
+    return 0;
+}
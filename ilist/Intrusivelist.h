@@ -0,0 +1,54 @@
+/**
+ * @file Intrusivelist.h
+ * @Brief  intrusive double linked list header, the user's element carries
+ *         the link, so the list never allocates a node
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-16
+ */
+
+#ifndef INTRUSIVE_LIST_H_
+#define INTRUSIVE_LIST_H_
+
+#include <stddef.h>
+
+#include "Common.h"
+
+/**
+ * Represent the link that the user embeds in the element, an element is in
+ * one list at a time through one link
+ */
+typedef struct ILink{
+    struct ILink *previous;
+    struct ILink *next;
+}ILink;
+
+#define ILINK_NULL {\
+    .previous = NULL,\
+    .next = NULL\
+}
+
+/**
+ * get the element that embeds the link, like container_of
+ */
+#define ILIST_ENTRY(link, type, member) \
+    ((type*)((char*)(link) - offsetof(type, member)))
+
+typedef struct IntrusiveList{
+    ILink *first;
+    ILink *last;
+    int size;
+    /**
+     * the offset of the link in the element
+     */
+    size_t offset;
+}IntrusiveList;
+
+int ilist_new(DataCommon *common, size_t offset);
+int ilist_delete(DataCommon *common);
+
+int ilist_remove_element(DataCommon *common, void *element);
+int ilist_move_to_front(DataCommon *common, void *element);
+int ilist_move_to_back(DataCommon *common, void *element);
+
+#endif
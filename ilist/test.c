@@ -0,0 +1,495 @@
+/**
+ * @file test.c
+ * @Brief  test intrusive list
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-16
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+/**
+ * Cunit headers
+ */ 
+#include "CUnit.h"
+#include "Automated.h"
+#include "Basic.h"
+#include "Console.h"
+
+/**
+ * Test file headers
+ */ 
+#include "Common.h"
+#include "ilist/Intrusivelist.h"
+#include "util/Log.h"
+
+
+/*************Test Case Begin*******************/
+
+/**
+ * the link is a member of the element
+ */
+typedef struct Person{
+    char *name;
+    int age;
+    ILink link;
+}Person;
+
+DataCommon persons = DATA_COMMON_NULL;
+
+Person *p1, *p2, *p3, *p4;
+
+int destroyed = 0;
+
+int match(void *person, void *name)
+{
+    if (strcmp(((Person*)person)->name, (char*)name) == 0)
+	return 0;
+    else
+	return -1;
+}
+
+int alter_match(void *element, void *arg)
+{
+    Person *person = (Person*)element;
+    Person *temp = (Person*)arg;
+
+    if (strcmp(person->name, temp->name) == 0){
+	person->age = temp->age;
+	return 0;
+    }else{
+	return -1;
+    }
+}
+
+int destroy_node(void *person)
+{
+    Person *p = (Person*)person;
+    free(p->name);
+    p->name = NULL;
+    p->age = 0;
+    free(p);
+    destroyed++;
+
+    return 0;
+}
+
+int handle_iteration(void *person)
+{
+    Person  *p = (Person*)person;
+    INFO("name:%s age:%d", p->name, p->age);
+
+    return 0;
+}
+
+/**
+ * allocator that counts the live blocks
+ */
+int live_blocks = 0;
+
+void* count_alloc(void *context, size_t size)
+{
+    (*(int*)context)++;
+    return malloc(size);
+}
+
+void* count_realloc(void *context, void *address, size_t size)
+{
+    return realloc(address, size);
+}
+
+void count_free(void *context, void *address)
+{
+    (*(int*)context)--;
+    free(address);
+}
+
+Allocator counter = {
+    .alloc = count_alloc,
+    .realloc = count_realloc,
+    .free = count_free,
+    .context = &live_blocks
+};
+
+Person* new_person(const char *name, int age)
+{
+    Person *p = (Person*)malloc(sizeof(Person));
+    p->name = (char*)malloc(16);
+    strcpy(p->name, name);
+    p->age = age;
+
+    return p;
+}
+
+void test_insert()
+{
+    p1 = new_person("tom", 22);
+    p2 = new_person("jack", 23);
+    p3 = new_person("jim", 24);
+    p4 = new_person("fitz", 25);
+
+    CU_ASSERT_EQUAL_FATAL(persons.insert(&persons, p1), 0);
+    CU_ASSERT_EQUAL_FATAL(persons.insert(&persons, p2), 0);
+    CU_ASSERT_EQUAL_FATAL(persons.insert(&persons, p3), 0);
+    CU_ASSERT_EQUAL_FATAL(persons.insert(&persons, p4), 0);
+
+    /**
+     * only the list struct is allocated
+     */
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 1);
+    CU_ASSERT_PTR_EQUAL_FATAL(ILIST_ENTRY(p1->link.next, Person, link), p2);
+}
+
+void test_iterate()
+{
+    CU_ASSERT_EQUAL_FATAL(persons.iterate(&persons), 0);
+}
+
+void test_alter()
+{
+    Person temp1 = {"tom", 32};
+    Person temp2 = {"jack", 33};
+    Person temp3 = {"bob", 34};
+    CU_ASSERT_EQUAL_FATAL(persons.alter(&persons, &temp1), 0);
+    CU_ASSERT_EQUAL_FATAL(persons.alter(&persons, &temp2), 0);
+    CU_ASSERT_EQUAL_FATAL(persons.alter(&persons, &temp3), -1);
+    CU_ASSERT_EQUAL_FATAL(p1->age, 32);
+    CU_ASSERT_EQUAL_FATAL(p2->age, 33);
+}
+
+void test_size()
+{
+    CU_ASSERT_EQUAL_FATAL(persons.size(&persons), 4);
+}
+
+void test_prior()
+{
+    CU_ASSERT_PTR_EQUAL_FATAL(persons.prior(&persons, "tom"), NULL);
+    CU_ASSERT_PTR_EQUAL_FATAL(persons.prior(&persons, "jack"), p1);
+    CU_ASSERT_PTR_EQUAL_FATAL(persons.prior(&persons, "jim"), p2);
+    CU_ASSERT_PTR_EQUAL_FATAL(persons.prior(&persons, "fitz"), p3);
+}
+
+void test_next()
+{
+    CU_ASSERT_PTR_EQUAL_FATAL(persons.next(&persons, "tom"), p2);
+    CU_ASSERT_PTR_EQUAL_FATAL(persons.next(&persons, "jack"), p3);
+    CU_ASSERT_PTR_EQUAL_FATAL(persons.next(&persons, "jim"), p4);
+    CU_ASSERT_PTR_EQUAL_FATAL(persons.next(&persons, "fitz"), NULL);
+}
+
+void test_search()
+{
+    CU_ASSERT_PTR_EQUAL_FATAL(persons.search(&persons, "tom"), p1);
+    CU_ASSERT_PTR_EQUAL_FATAL(persons.search(&persons, "jack"), p2);
+    CU_ASSERT_PTR_EQUAL_FATAL(persons.search(&persons, "jim"), p3);
+    CU_ASSERT_PTR_EQUAL_FATAL(persons.search(&persons, "fitz"), p4);
+    CU_ASSERT_PTR_EQUAL_FATAL(persons.search(&persons, "bob"), NULL);
+}
+
+void test_move()
+{
+    /**
+     * fitz tom jack jim
+     */
+    CU_ASSERT_EQUAL_FATAL(ilist_move_to_front(&persons, p4), 0);
+    CU_ASSERT_PTR_EQUAL_FATAL(persons.prior(&persons, "tom"), p4);
+    CU_ASSERT_PTR_EQUAL_FATAL(persons.next(&persons, "jim"), NULL);
+
+    /**
+     * tom jack jim fitz
+     */
+    CU_ASSERT_EQUAL_FATAL(ilist_move_to_back(&persons, p4), 0);
+    CU_ASSERT_EQUAL_FATAL(ilist_move_to_back(&persons, p4), 0);
+    CU_ASSERT_PTR_EQUAL_FATAL(persons.prior(&persons, "tom"), NULL);
+    CU_ASSERT_PTR_EQUAL_FATAL(persons.next(&persons, "jim"), p4);
+}
+
+void test_remove()
+{
+    CU_ASSERT_EQUAL_FATAL(persons.remove(&persons, "jack"), 0);
+    CU_ASSERT_EQUAL_FATAL(persons.remove(&persons, "jack"), -1);
+    CU_ASSERT_EQUAL_FATAL(ilist_remove_element(&persons, p3), 0);
+    CU_ASSERT_EQUAL_FATAL(persons.size(&persons), 2);
+    CU_ASSERT_EQUAL_FATAL(destroyed, 2);
+    CU_ASSERT_PTR_EQUAL_FATAL(persons.next(&persons, "tom"), p4);
+    CU_ASSERT_PTR_EQUAL_FATAL(persons.prior(&persons, "fitz"), p1);
+}
+
+void test_clear()
+{
+    CU_ASSERT_EQUAL_FATAL(persons.clear(&persons), 2);
+    CU_ASSERT_EQUAL_FATAL(persons.size(&persons), 0);
+    CU_ASSERT_EQUAL_FATAL(destroyed, 4);
+}
+
+/**
+ * walk, erase and insert through a cursor
+ */
+#define CURSOR_COUNT 100
+
+typedef struct Number{
+    ILink link;
+    int value;
+}Number;
+
+Number slots[CURSOR_COUNT];
+
+int number_match(void *element, void *key)
+{
+    return ((Number*)element)->value == *(int*)key ? 0 : -1;
+}
+
+int number_destroy(void *element)
+{
+    ((Number*)element)->value = -1;
+    return 0;
+}
+
+int number_iteration(void *element)
+{
+    return 0;
+}
+
+void test_cursor()
+{
+    DataCommon list = DATA_COMMON_NULL;
+    Cursor cursor = CURSOR_NULL;
+    int i;
+
+    list.remove_match = number_match;
+    list.search_match = number_match;
+    list.alter_match = number_match;
+    list.destroy_node = number_destroy;
+    list.handle_iteration = number_iteration;
+    CU_ASSERT_EQUAL_FATAL(ilist_new(&list, offsetof(Number, link)), 0);
+
+    CU_ASSERT_EQUAL_FATAL(list.begin(&list, &cursor), -1);
+    for (i=0; i<CURSOR_COUNT; i++){
+	slots[i].value = i;
+	CU_ASSERT_EQUAL_FATAL(list.insert(&list, &slots[i]), 0);
+    }
+
+    /**
+     * forward and backward
+     */
+    CU_ASSERT_EQUAL_FATAL(list.begin(&list, &cursor), 0);
+    for (i=0; i<CURSOR_COUNT; i++){
+	CU_ASSERT_PTR_EQUAL_FATAL(list.get(&list, &cursor), &slots[i]);
+	CU_ASSERT_EQUAL_FATAL(list.advance(&list, &cursor), i == CURSOR_COUNT-1 ? -1 : 0);
+    }
+    CU_ASSERT_PTR_EQUAL_FATAL(list.get(&list, &cursor), NULL);
+    CU_ASSERT_EQUAL_FATAL(list.end(&list, &cursor), 0);
+    for (i=CURSOR_COUNT-1; i>=0; i--){
+	CU_ASSERT_PTR_EQUAL_FATAL(list.get(&list, &cursor), &slots[i]);
+	CU_ASSERT_EQUAL_FATAL(list.retreat(&list, &cursor), i == 0 ? -1 : 0);
+    }
+
+    /**
+     * erase the even ones, the cursor moves to the next one
+     */
+    list.begin(&list, &cursor);
+    for (i=0; i<CURSOR_COUNT; i+=2){
+	CU_ASSERT_EQUAL_FATAL(list.erase(&list, &cursor), 0);
+	CU_ASSERT_EQUAL_FATAL(slots[i].value, -1);
+	CU_ASSERT_PTR_EQUAL_FATAL(list.get(&list, &cursor), &slots[i+1]);
+	list.advance(&list, &cursor);
+    }
+    CU_ASSERT_EQUAL_FATAL(list.size(&list), CURSOR_COUNT/2);
+
+    /**
+     * put the even ones back after the odd ones
+     */
+    list.begin(&list, &cursor);
+    for (i=1; i<CURSOR_COUNT; i+=2){
+	slots[i-1].value = i-1;
+	CU_ASSERT_EQUAL_FATAL(list.insert_after(&list, &cursor, &slots[i-1]), 0);
+	list.advance(&list, &cursor);
+	list.advance(&list, &cursor);
+    }
+    list.begin(&list, &cursor);
+    for (i=0; i<CURSOR_COUNT; i++){
+	CU_ASSERT_PTR_EQUAL_FATAL(list.get(&list, &cursor), &slots[i ^ 1]);
+	list.advance(&list, &cursor);
+    }
+
+    CU_ASSERT_EQUAL_FATAL(ilist_delete(&list), CURSOR_COUNT);
+}
+
+/*************Test Case End*********************/
+
+
+
+/**
+ * add testcase, similar function in the same testcase
+ * 
+ * typedef struct CU_TestInfo {
+ * 	const char  *pName;
+ *	CU_TestFunc pTestFunc;
+ *	} CU_TestInfo;
+ *
+ * Example:
+ *
+ * static CU_TestInfo testcase1[] = {
+ * 	{ "test_function_name", test_function},
+ * 	{ "test_function_name2", test_function2},
+ * 	CU_TEST_INFO_NULL
+ * };
+ *
+ * static CU_TestInfo testcase2[] = {
+ * 	...
+ * 	CU_TEST_INFO_NULL
+ * };
+ *
+ */ 
+
+static CU_TestInfo testcase1[] = {
+    { "test_insert", test_insert},
+    { "test_iterate", test_iterate},
+    { "test_search", test_search},
+    { "test_size", test_size},
+    CU_TEST_INFO_NULL
+};
+
+static CU_TestInfo testcase2[] = {
+    { "test_alter", test_alter},
+    { "test_iterate2", test_iterate},
+    { "test_prior", test_prior},
+    { "test_next", test_next},
+    { "test_move", test_move},
+    CU_TEST_INFO_NULL
+};
+
+static CU_TestInfo testcase3[] = {
+    { "test_remove", test_remove},
+    { "test_iterate3", test_iterate},
+    { "test_clear", test_clear},
+    CU_TEST_INFO_NULL
+};
+
+static CU_TestInfo testcase4[] = {
+    { "test_cursor", test_cursor},
+    CU_TEST_INFO_NULL
+};
+/**
+ * add testcase to the suites
+ * 
+ * typedef struct CU_SuiteInfo {
+ *     const char       *pName;         
+ *     CU_InitializeFunc pInitFunc;     
+ *     CU_CleanupFunc    pCleanupFunc;  
+ *     CU_SetUpFunc      pSetUpFunc;    
+ *     CU_TearDownFunc   pTearDownFunc; 
+ *     CU_TestInfo      *pTests;        
+ * } CU_SuiteInfo;
+ *
+ * Example:
+ *
+ * static CU_SuiteInfo suites[] = {
+ * 	{"suite name", suite_success_init, suite_success_clean, NULL, NULL, testcase},
+ * 	...
+ * 	CU_SUITE_INFO_NULL
+ * }
+ *
+ */
+
+static int suite_success_init(void) 
+{
+    persons.remove_match = match;
+    persons.search_match = match;
+    persons.alter_match = alter_match;
+    persons.destroy_node = destroy_node;
+    persons.handle_iteration = handle_iteration;
+    persons.allocator = &counter;
+
+    ilist_new(&persons, offsetof(Person, link));
+
+    return 0; 
+}
+static int suite_success_clean(void) 
+{
+    ilist_delete(&persons);
+    return 0; 
+}
+
+
+static CU_SuiteInfo suites[] = {
+    {"suite1", suite_success_init, NULL, NULL, NULL, testcase1},
+    {"suite2", NULL, NULL, NULL, NULL, testcase2},
+    {"suite3", NULL, suite_success_clean, NULL, NULL, testcase3},
+    {"suite4", NULL, NULL, NULL, NULL, testcase4},
+    CU_SUITE_INFO_NULL
+};
+
+
+
+/**
+ * add tests to the test framework
+ *
+ */ 
+void AddTests(void)
+{
+    assert(NULL != CU_get_registry());
+    assert(!CU_is_test_running());
+
+    /* Register suites. */
+    if (CU_register_suites(suites) != CUE_SUCCESS) {
+	fprintf(stderr, "suite registration failed - %s\n",
+		CU_get_error_msg());
+	exit(EXIT_FAILURE);
+    }
+
+}
+
+
+int main()
+{
+    if (CU_initialize_registry()) {
+	printf("\nInitialization of Test Registry failed.");
+    }else{
+
+	LOG_FILE_OPEN("log.txt");
+
+	AddTests();
+
+	/*******Automated Mode(best)*********************
+	 * CU_set_output_filename("TestAutomated");
+	 * CU_list_tests_to_file();
+	 * CU_automated_run_tests();
+	 ******************************************/
+
+	 CU_set_output_filename("TestAutomated");
+	 CU_list_tests_to_file();
+	 CU_automated_run_tests();
+	/*******Basic Mode*********************
+	 * mode can choose:
+	 * typedef enum {
+	 *   CU_BRM_NORMAL = 0, Normal mode - failures and run summary are printed [default].
+	 *   CU_BRM_SILENT,     Silent mode - no output is printed except framework error messages.
+	 *   CU_BRM_VERBOSE     Verbose mode - maximum output of run details.
+	 * } CU_BasicRunMode;
+	 ****************************************
+	 *
+	 * CU_basic_set_mode(CU_BRM_NORMAL);
+	 * CU_basic_run_tests();
+	 ******************************************/
+
+	/*******Console Mode*********************
+	 * CU_console_run_tests();
+	 ******************************************/
+
+	/*******Curses Mode*********************
+	 * CU_curses_run_tests();
+	 ******************************************/ 
+
+
+	CU_cleanup_registry();
+    }
+
+    LOG_FILE_CLOSE();
+    return 0;
+}
+
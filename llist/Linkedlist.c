@@ -13,50 +13,225 @@
 #include "util/Log.h"
 
 
+/**
+ * the hash of an element's key
+ */
+#define LLIST_HASH(common, element) \
+    ((common)->key_hash((common)->element_key(element)))
+
+
 /* --------------------------------------------------------------------------*/
 /**
- * @Brief  llist_insert insert node to the list
+ * @Brief  llist_index_find find the node of a key through the hash index
  *
- * @Param common data commont struct
- * @Param element the node that need to be inserted
+ * @Param common data common struct
+ * @Param key the key
  *
- * @Returns   0 is OK;other is failed
+ * @Returns   NULL means no one; other is the link to the node's entry
  */
 /* ----------------------------------------------------------------------------*/
-static int llist_insert(DataCommon *common, void *element)
+static HashEntry** llist_index_find(DataCommon *common, void *key)
 {
-    if ((common == NULL) || (element == NULL)){
-	ERROR("pointer is null!");
-	return -1;
+    LinkedList *list = (LinkedList*)(common->linked_type);
+    unsigned long hash = common->key_hash(key);
+    HashEntry **link = hindex_bucket(&list->index, hash);
+    LinkedNode *node = NULL;
+
+    while (*link){
+	node = (LinkedNode*)((*link)->node);
+	if (((*link)->hash == hash) && (common->key_equal(node->element, key) == 0))
+	    return link;
+	link = &(*link)->next;
+    }
+
+    return NULL;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  llist_index_node find the entry of a node, every node of an indexed
+ *         list has one, so missing it means the index is broken
+ *
+ * @Param common data common struct
+ * @Param node the node
+ *
+ * @Returns   NULL means the index is broken; other is the link to the entry
+ */
+/* ----------------------------------------------------------------------------*/
+static HashEntry** llist_index_node(DataCommon *common, LinkedNode *node)
+{
+    LinkedList *list = (LinkedList*)(common->linked_type);
+    HashEntry **link = hindex_find_node(&list->index, \
+	    LLIST_HASH(common, node->element), node);
+
+    if (link == NULL)
+	ERROR("the node is not in the index!");
+    return link;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  llist_unlink take a node out of the list, destroy its element
+ *
+ * @Param common data common struct
+ * @Param cur the node
+ * @Param pre the prior node of the node
+ * @Param link the link to the node's entry, NULL means looking it up
+ */
+/* ----------------------------------------------------------------------------*/
+static void llist_unlink(DataCommon *common, LinkedNode *cur, LinkedNode *pre,
+	HashEntry **link)
+{
+    LinkedList *list = (LinkedList*)(common->linked_type);
+
+    if (list->indexed){
+	if (link == NULL)
+	    link = llist_index_node(common, cur);
+
+	/**
+	 *the next node gets a new prior node
+	 */
+	if (cur->next != NULL){
+	    HashEntry **next = llist_index_node(common, cur->next);
+	    if (next != NULL)
+		(*next)->previous = pre;
+	}
+	if (link != NULL)
+	    hindex_remove(&list->index, link);
     }
 
+    if (pre == NULL)
+	list->first = cur->next;
+    else
+	pre->next = cur->next;
+
+    if (cur == list->last)
+	list->last = pre;
+
+    common->destroy_node(cur->element);
+    cur->element = NULL;
+    cur->next = NULL;
+    slab_free(&list->node_pool, cur);
+    list->size--;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  llist_link create a node for the element and link it after a node
+ *
+ * @Param common data common struct
+ * @Param pre the node that the new one follows, NULL means the front
+ * @Param element the element
+ *
+ * @Returns   NULL is failed; other is the new node
+ */
+/* ----------------------------------------------------------------------------*/
+static LinkedNode* llist_link(DataCommon *common, LinkedNode *pre, void *element)
+{
     /**
      *create a linked node and add element to it
      */ 
     LinkedList *list = (LinkedList*)(common->linked_type);
-    LinkedNode *node = (LinkedNode*)malloc(sizeof(LinkedNode));
+    LinkedNode *node = (LinkedNode*)slab_alloc(&list->node_pool);
     if (node == NULL){
 	ERROR("pointer is null!");
-	return -1;
+	return NULL;
     }
     node->element = element;
-    node->next = NULL;
+    node->next = (pre == NULL) ? list->first : pre->next;
 
-    if (list->first != NULL){
-	/**
-	 *add a new node to the end of list
-	 */ 
-	list->last->next = node;
-	list->last = node;
-    }else{
-	/**
-	 *add first node to the list
-	 */ 
+    /**
+     *index the node, and the next node gets a new prior node
+     */
+    if (list->indexed){
+	HashEntry *entry = hindex_insert(&list->index, LLIST_HASH(common, element), node);
+	if (entry == NULL){
+	    slab_free(&list->node_pool, node);
+	    return NULL;
+	}
+	entry->previous = pre;
+
+	if (node->next != NULL){
+	    HashEntry **next = llist_index_node(common, node->next);
+	    if (next != NULL)
+		(*next)->previous = node;
+	}
+    }
+
+    if (pre == NULL)
 	list->first = node;
+    else
+	pre->next = node;
+
+    if (pre == list->last)
 	list->last = node;
-    }
     list->size++;
 
+    return node;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  llist_prior_node find the prior node of a node
+ *
+ * @Param common data common struct
+ * @Param node the node
+ *
+ * @Returns   NULL means the node is the first one; other is the prior node
+ */
+/* ----------------------------------------------------------------------------*/
+static LinkedNode* llist_prior_node(DataCommon *common, LinkedNode *node)
+{
+    LinkedList *list = (LinkedList*)(common->linked_type);
+
+    /**
+     *the index knows the prior node, or walk from the first node
+     */
+    if (list->indexed){
+	HashEntry **link = llist_index_node(common, node);
+	if (link != NULL)
+	    return (LinkedNode*)(*link)->previous;
+    }
+
+    LinkedNode *pre = NULL;
+    LinkedNode *cur = list->first;
+    while (cur != node){
+	pre = cur;
+	cur = cur->next;
+    }
+
+    return pre;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  llist_insert insert node to the list
+ *
+ * @Param common data commont struct
+ * @Param element the node that need to be inserted
+ *
+ * @Returns   0 is OK;other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int llist_insert(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    /**
+     *add a new node to the end of list
+     */ 
+    LinkedList *list = (LinkedList*)(common->linked_type);
+    if (llist_link(common, list->last, element) == NULL)
+	return -1;
+
     return 0;
 }
 
@@ -82,39 +257,23 @@ static int llist_remove(DataCommon *common, void *element)
     LinkedNode *cur = list->first;
     LinkedNode *pre = NULL;
 
+    if (list->indexed){
+	HashEntry **link = llist_index_find(common, element);
+	if (link == NULL){
+	    INFO("can not match a node!");
+	    return -1;
+	}
+	llist_unlink(common, (LinkedNode*)(*link)->node, \
+		(LinkedNode*)(*link)->previous, link);
+	return 0;
+    }
+
     while(cur){
 	/**
 	 *match the node 
 	 */ 
 	if ((common->remove_match)(cur->element, element) == 0){
-	    /**
-	     *remove the middle node 
-	     */ 
-	    if ((cur != list->first) && (cur != list->last)){
-		pre->next = cur->next;
-	    }
-
-	    /**
-	     *remove the first node 
-	     */ 
-	    if (cur == list->first){
-		list->first = cur->next;
-	    }
-
-	    /**
-	     *remove the last node 
-	     */ 
-	    if (cur == list->last){
-		if (pre != NULL)
-		    pre->next = NULL;
-		list->last = pre;
-	    }
-
-	    common->destroy_node(cur->element);
-	    cur->element = NULL;
-	    cur->next = NULL;
-	    free(cur);
-	    list->size--;
+	    llist_unlink(common, cur, pre, NULL);
 	    return 0;
 	}
 
@@ -147,6 +306,15 @@ static void* llist_search(DataCommon *common, void *element)
     LinkedList *list = (LinkedList*)(common->linked_type);
     LinkedNode *node = list->first;
 
+    if (list->indexed){
+	HashEntry **link = llist_index_find(common, element);
+	if (link == NULL){
+	    INFO("no matched node!");
+	    return NULL;
+	}
+	return ((LinkedNode*)(*link)->node)->element;
+    }
+
     while(node){
 	if((common->search_match)(node->element, element) == 0)
 	    return node->element;
@@ -161,7 +329,8 @@ static void* llist_search(DataCommon *common, void *element)
 
 /* --------------------------------------------------------------------------*/
 /**
- * @Brief  llist_alter alter the matched node
+ * @Brief  llist_alter alter the matched node, an indexed list indexes the
+ *         node again when the alteration changes its key
  *
  * @Param common data common struct
  * @Param element the searched node's information
@@ -179,6 +348,29 @@ static int llist_alter(DataCommon *common, void *element)
     LinkedList *list = (LinkedList*)(common->linked_type);
     LinkedNode *node = list->first;
 
+    if (list->indexed){
+	HashEntry **link = llist_index_find(common, common->element_key(element));
+	if (link == NULL){
+	    INFO("no matched node!");
+	    return -1;
+	}
+	node = (LinkedNode*)(*link)->node;
+	int ret = (common->alter_match)(node->element, element);
+
+	unsigned long hash = LLIST_HASH(common, node->element);
+	if (hash != (*link)->hash){
+	    LinkedNode *pre = (LinkedNode*)(*link)->previous;
+	    hindex_remove(&list->index, link);
+	    HashEntry *entry = hindex_insert(&list->index, hash, node);
+	    if (entry == NULL){
+		ERROR("can not index the altered node!");
+		return -1;
+	    }
+	    entry->previous = pre;
+	}
+	return ret;
+    }
+
     while(node){
 	if ((common->alter_match)(node->element, element) == 0)
 	    return 0;
@@ -213,6 +405,16 @@ static void* llist_prior(DataCommon *common, void *element)
     LinkedNode *cur = list->first;
     LinkedNode *pre = NULL;
 
+    if (list->indexed){
+	HashEntry **link = llist_index_find(common, element);
+	if (link == NULL){
+	    INFO("no matched one!");
+	    return NULL;
+	}
+	pre = (LinkedNode*)(*link)->previous;
+	return pre == NULL ? NULL : pre->element;
+    }
+
     while(cur){
 	if((common->search_match)(cur->element, element) == 0)
 	{
@@ -252,6 +454,16 @@ static void* llist_next(DataCommon *common, void * element)
     LinkedList *list = (LinkedList*)(common->linked_type);
     LinkedNode *cur = list->first;
 
+    if (list->indexed){
+	HashEntry **link = llist_index_find(common, element);
+	if (link == NULL){
+	    INFO("no matched one!");
+	    return NULL;
+	}
+	cur = (LinkedNode*)(*link)->node;
+	return cur->next == NULL ? NULL : cur->next->element;
+    }
+
     while(cur){
 	if((common->search_match)(cur->element, element) == 0){
 	    if (cur->next == NULL)
@@ -350,7 +562,7 @@ static int llist_clear(DataCommon *common)
 	common->destroy_node(temp->element);
 	temp->element = NULL;
 	temp->next = NULL;
-	free(temp);
+	slab_free(&list->node_pool, temp);
 
 	ret++;
     }
@@ -358,11 +570,208 @@ static int llist_clear(DataCommon *common)
     list->first = NULL;
     list->last = NULL;
     list->size = 0;
+    hindex_clear(&list->index);
 
     return ret;
 }
 
 
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  llist_begin put the cursor on the first node
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means the list is empty
+ */
+/* ----------------------------------------------------------------------------*/
+static int llist_begin(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    LinkedList *list = (LinkedList*)(common->linked_type);
+    cursor->node = list->first;
+    cursor->previous = NULL;
+    cursor->index = 0;
+
+    return cursor->node == NULL ? -1 : 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  llist_end put the cursor on the last node, the prior node is found
+ *         by llist_prior_node
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means the list is empty
+ */
+/* ----------------------------------------------------------------------------*/
+static int llist_end(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    LinkedList *list = (LinkedList*)(common->linked_type);
+    cursor->node = list->last;
+    cursor->previous = NULL;
+    cursor->index = 0;
+    if (cursor->node == NULL)
+	return -1;
+
+    cursor->previous = llist_prior_node(common, list->last);
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  llist_advance move the cursor to the next node
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means the cursor is off the list
+ */
+/* ----------------------------------------------------------------------------*/
+static int llist_advance(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    LinkedNode *node = (LinkedNode*)(cursor->node);
+    if (node == NULL)
+	return -1;
+
+    cursor->previous = node;
+    cursor->node = node->next;
+
+    return cursor->node == NULL ? -1 : 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  llist_retreat move the cursor to the prior node, O(1) with the
+ *         hash index, or it walks from the first node
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means the cursor is off the list
+ */
+/* ----------------------------------------------------------------------------*/
+static int llist_retreat(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    LinkedNode *pre = (LinkedNode*)(cursor->previous);
+    if ((cursor->node == NULL) || (pre == NULL)){
+	cursor->node = NULL;
+	cursor->previous = NULL;
+	return -1;
+    }
+
+    cursor->node = pre;
+    cursor->previous = llist_prior_node(common, pre);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  llist_get return the element under the cursor
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   NULL means the cursor is off the list; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* llist_get(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return NULL;
+    }
+
+    LinkedNode *node = (LinkedNode*)(cursor->node);
+
+    return node == NULL ? NULL : node->element;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  llist_erase remove the node under the cursor, the cursor moves to
+ *         the next node
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int llist_erase(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    LinkedNode *node = (LinkedNode*)(cursor->node);
+    if (node == NULL){
+	INFO("cursor is off the list!");
+	return -1;
+    }
+
+    cursor->node = node->next;
+    llist_unlink(common, node, (LinkedNode*)(cursor->previous), NULL);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  llist_insert_after insert an element after the cursor
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor, off the list means inserting at the front
+ * @Param element the element
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int llist_insert_after(DataCommon *common, Cursor *cursor, void *element)
+{
+    if ((common == NULL) || (cursor == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    LinkedNode *node = llist_link(common, (LinkedNode*)(cursor->node), element);
+    if (node == NULL)
+	return -1;
+
+    return 0;
+}
+
+
 /* --------------------------------------------------------------------------*/
 /**
  * @Brief  llist_new create a list, initial datacommon struct
@@ -386,13 +795,14 @@ int llist_new(DataCommon *common)
 		       &&common->search_match \
 		       &&common->alter_match \
 		       &&common->destroy_node \
-		       &&common->handle_iteration;
+		       &&common->handle_iteration \
+		       &&ALLOCATOR_CHECK(common->allocator);
     if (handle_check == 0){
 	ERROR("missed user defined function!");
 	return -1;
     }
 
-    LinkedList *list = (LinkedList*)malloc(sizeof(LinkedList));
+    LinkedList *list = (LinkedList*)mem_alloc(common->allocator, sizeof(LinkedList));
     if (list == NULL){
 	ERROR("malloc error!");
 	return -1;
@@ -401,6 +811,20 @@ int llist_new(DataCommon *common)
     list->last = NULL;
     list->size = 0;
 
+    /**
+     * nodes of the list come from its own slab
+     */
+    if (slab_new(&list->node_pool, sizeof(LinkedNode), 0, common->allocator) != 0){
+	mem_free(common->allocator, list);
+	return -1;
+    }
+
+    /**
+     * the key functions decide whether the list keeps a hash index
+     */
+    list->indexed = DATA_COMMON_INDEXED(common);
+    hindex_new(&list->index, common->allocator);
+
     common->linked_type = list;
     common->insert = llist_insert;
     common->remove = llist_remove;
@@ -411,6 +835,13 @@ int llist_new(DataCommon *common)
     common->iterate = llist_iterate;
     common->size = llist_size;
     common->clear = llist_clear;
+    common->begin = llist_begin;
+    common->end = llist_end;
+    common->advance = llist_advance;
+    common->retreat = llist_retreat;
+    common->get = llist_get;
+    common->erase = llist_erase;
+    common->insert_after = llist_insert_after;
 
     return 0;
 }
@@ -438,7 +869,9 @@ int llist_delete(DataCommon *common)
     list->first = NULL;
     list->last = NULL;
     list->size = 0;
-    free(list);
+    slab_delete(&list->node_pool);
+    hindex_delete(&list->index);
+    mem_free(common->allocator, list);
 
     return ret;
 }
@@ -10,6 +10,8 @@
 #define LINKED_LIST_H_
 
 #include "Common.h"
+#include "util/Slab.h"
+#include "util/HashIndex.h"
 
 /**
  * Represent a node
@@ -44,6 +46,17 @@ typedef struct LinkedList{
      * the number of node in the list
      */
     int size;
+
+    /**
+     * the slab that all the nodes come from
+     */
+    Slab node_pool;
+
+    /**
+     * the hash index of the keys, used only when indexed is not 0
+     */
+    HashIndex index;
+    int indexed;
 }LinkedList;
 
 int llist_new(DataCommon *common);
@@ -159,7 +159,251 @@ void test_clear()
     CU_ASSERT_EQUAL_FATAL(persons.clear(&persons), 3);
 }
 
+void test_node_reuse()
+{
+    LinkedList *list = (LinkedList*)(persons.linked_type);
+    unsigned int pages = list->node_pool.page_count;
+    int i;
+
+    /**
+     * removed nodes go back to the slab, so churn never adds a page
+     */
+    for (i=0; i<1000; i++){
+	test_insert();
+	test_remove();
+    }
+    CU_ASSERT_EQUAL_FATAL(list->node_pool.page_count, pages);
+    CU_ASSERT_EQUAL_FATAL(persons.size(&persons), 0);
+}
+
+
 
+/**
+ * a list with the key functions, found through the hash index
+ */
+#define INDEXED_COUNT 1000
+DataCommon numbers = DATA_COMMON_NULL;
+int values[INDEXED_COUNT];
+
+int number_match(void *element, void *key)
+{
+    return *(int*)element == *(int*)key ? 0 : -1;
+}
+
+int number_alter(void *element, void *arg)
+{
+    return *(int*)element == *(int*)arg ? 0 : -1;
+}
+
+int number_destroy(void *element)
+{
+    *(int*)element = -1;
+    return 0;
+}
+
+int number_iteration(void *element)
+{
+    return 0;
+}
+
+unsigned long number_hash(void *key)
+{
+    return (unsigned long)*(int*)key;
+}
+
+void* number_key(void *element)
+{
+    return element;
+}
+
+void test_indexed_insert()
+{
+    numbers.remove_match = number_match;
+    numbers.search_match = number_match;
+    numbers.alter_match = number_alter;
+    numbers.destroy_node = number_destroy;
+    numbers.handle_iteration = number_iteration;
+    numbers.key_hash = number_hash;
+    numbers.key_equal = number_match;
+    numbers.element_key = number_key;
+    CU_ASSERT_EQUAL_FATAL(llist_new(&numbers), 0);
+
+    int i;
+    for (i=0; i<INDEXED_COUNT; i++){
+	values[i] = i;
+	CU_ASSERT_EQUAL_FATAL(numbers.insert(&numbers, &values[i]), 0);
+    }
+    CU_ASSERT_EQUAL_FATAL(numbers.size(&numbers), INDEXED_COUNT);
+}
+
+void test_indexed_search()
+{
+    int i, key;
+    for (i=0; i<INDEXED_COUNT; i++){
+	key = i;
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), &values[i]);
+	CU_ASSERT_EQUAL_FATAL(numbers.alter(&numbers, &key), 0);
+    }
+    key = INDEXED_COUNT;
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), NULL);
+    CU_ASSERT_EQUAL_FATAL(numbers.remove(&numbers, &key), -1);
+
+    key = 0;
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.prior(&numbers, &key), NULL);
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.next(&numbers, &key), &values[1]);
+    key = INDEXED_COUNT - 1;
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.prior(&numbers, &key), &values[key-1]);
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.next(&numbers, &key), NULL);
+}
+
+/**
+ * the argument is {old key, new key}, the key of the argument is the old one
+ */
+int number_rekey(void *element, void *arg)
+{
+    *(int*)element = ((int*)arg)[1];
+    return 0;
+}
+
+void test_indexed_remove()
+{
+    int key = 500;
+    CU_ASSERT_EQUAL_FATAL(numbers.remove(&numbers, &key), 0);
+    key = 0;
+    CU_ASSERT_EQUAL_FATAL(numbers.remove(&numbers, &key), 0);
+    key = INDEXED_COUNT - 1;
+    CU_ASSERT_EQUAL_FATAL(numbers.remove(&numbers, &key), 0);
+    CU_ASSERT_EQUAL_FATAL(numbers.size(&numbers), INDEXED_COUNT - 3);
+
+    /**
+     * the neighbours of the removed nodes are linked again
+     */
+    key = 501;
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.prior(&numbers, &key), &values[499]);
+    key = 499;
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.next(&numbers, &key), &values[501]);
+    key = 1;
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.prior(&numbers, &key), NULL);
+    key = INDEXED_COUNT - 2;
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.next(&numbers, &key), NULL);
+    key = 500;
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), NULL);
+
+    /**
+     * insert again, the order is the insertion order
+     */
+    values[500] = 500;
+    CU_ASSERT_EQUAL_FATAL(numbers.insert(&numbers, &values[500]), 0);
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.prior(&numbers, &key), &values[INDEXED_COUNT-2]);
+
+    /**
+     * an alteration that changes the key indexes the node again, its
+     * neighbours still find it
+     */
+    int rekey[2] = {250, 2 * INDEXED_COUNT};
+    numbers.alter_match = number_rekey;
+    CU_ASSERT_EQUAL_FATAL(numbers.alter(&numbers, rekey), 0);
+    numbers.alter_match = number_alter;
+    key = 250;
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), NULL);
+    key = 2 * INDEXED_COUNT;
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), &values[250]);
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.prior(&numbers, &key), &values[249]);
+    key = 249;
+    CU_ASSERT_EQUAL_FATAL(numbers.remove(&numbers, &key), 0);
+    key = 2 * INDEXED_COUNT;
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.prior(&numbers, &key), &values[248]);
+    CU_ASSERT_EQUAL_FATAL(numbers.remove(&numbers, &key), 0);
+    key = 251;
+    CU_ASSERT_PTR_EQUAL_FATAL(numbers.prior(&numbers, &key), &values[248]);
+
+    CU_ASSERT_EQUAL_FATAL(llist_delete(&numbers), INDEXED_COUNT - 4);
+}
+
+/**
+ * walk, erase and insert through a cursor
+ */
+#define CURSOR_COUNT 100
+int slots[CURSOR_COUNT];
+
+void check_cursor(DataCommon *list)
+{
+    Cursor cursor = CURSOR_NULL;
+    int i;
+
+    CU_ASSERT_EQUAL_FATAL(list->begin(list, &cursor), -1);
+    for (i=0; i<CURSOR_COUNT; i++){
+	slots[i] = i;
+	CU_ASSERT_EQUAL_FATAL(list->insert(list, &slots[i]), 0);
+    }
+
+    /**
+     * forward and backward
+     */
+    CU_ASSERT_EQUAL_FATAL(list->begin(list, &cursor), 0);
+    for (i=0; i<CURSOR_COUNT; i++){
+	CU_ASSERT_PTR_EQUAL_FATAL(list->get(list, &cursor), &slots[i]);
+	CU_ASSERT_EQUAL_FATAL(list->advance(list, &cursor), i == CURSOR_COUNT-1 ? -1 : 0);
+    }
+    CU_ASSERT_PTR_EQUAL_FATAL(list->get(list, &cursor), NULL);
+    CU_ASSERT_EQUAL_FATAL(list->end(list, &cursor), 0);
+    for (i=CURSOR_COUNT-1; i>=0; i--){
+	CU_ASSERT_PTR_EQUAL_FATAL(list->get(list, &cursor), &slots[i]);
+	CU_ASSERT_EQUAL_FATAL(list->retreat(list, &cursor), i == 0 ? -1 : 0);
+    }
+
+    /**
+     * erase the even ones, the cursor moves to the next one
+     */
+    list->begin(list, &cursor);
+    for (i=0; i<CURSOR_COUNT; i+=2){
+	CU_ASSERT_EQUAL_FATAL(list->erase(list, &cursor), 0);
+	CU_ASSERT_PTR_EQUAL_FATAL(list->get(list, &cursor), &slots[i+1]);
+	list->advance(list, &cursor);
+    }
+    CU_ASSERT_EQUAL_FATAL(list->size(list), CURSOR_COUNT/2);
+
+    /**
+     * put the even ones back after the odd ones, and one at the front
+     */
+    list->begin(list, &cursor);
+    for (i=1; i<CURSOR_COUNT; i+=2){
+	slots[i-1] = i-1;
+	CU_ASSERT_EQUAL_FATAL(list->insert_after(list, &cursor, &slots[i-1]), 0);
+	CU_ASSERT_PTR_EQUAL_FATAL(list->get(list, &cursor), &slots[i]);
+	list->advance(list, &cursor);
+	list->advance(list, &cursor);
+    }
+    CU_ASSERT_EQUAL_FATAL(list->insert_after(list, &cursor, &slots[CURSOR_COUNT-2]), 0);
+    CU_ASSERT_EQUAL_FATAL(list->size(list), CURSOR_COUNT + 1);
+    list->begin(list, &cursor);
+    CU_ASSERT_PTR_EQUAL_FATAL(list->get(list, &cursor), &slots[CURSOR_COUNT-2]);
+    CU_ASSERT_EQUAL_FATAL(list->erase(list, &cursor), 0);
+    for (i=0; i<CURSOR_COUNT; i++){
+	CU_ASSERT_PTR_EQUAL_FATAL(list->get(list, &cursor), &slots[i ^ 1]);
+	list->advance(list, &cursor);
+    }
+}
+
+void test_cursor()
+{
+    DataCommon list = DATA_COMMON_NULL;
+    list.remove_match = number_match;
+    list.search_match = number_match;
+    list.alter_match = number_alter;
+    list.destroy_node = number_destroy;
+    list.handle_iteration = number_iteration;
+    CU_ASSERT_EQUAL_FATAL(llist_new(&list), 0);
+    check_cursor(&list);
+    CU_ASSERT_EQUAL_FATAL(llist_delete(&list), CURSOR_COUNT);
+
+    list.key_hash = number_hash;
+    list.key_equal = number_match;
+    list.element_key = number_key;
+    CU_ASSERT_EQUAL_FATAL(llist_new(&list), 0);
+    check_cursor(&list);
+    CU_ASSERT_EQUAL_FATAL(llist_delete(&list), CURSOR_COUNT);
+}
 
 /*************Test Case End*********************/
 
@@ -205,11 +449,20 @@ static CU_TestInfo testcase2[] = {
     CU_TEST_INFO_NULL
 };
 
+static CU_TestInfo testcase4[] = {
+    { "test_indexed_insert", test_indexed_insert},
+    { "test_indexed_search", test_indexed_search},
+    { "test_indexed_remove", test_indexed_remove},
+    { "test_cursor", test_cursor},
+    CU_TEST_INFO_NULL
+};
+
 static CU_TestInfo testcase3[] = {
     { "test_remove", test_remove},
     { "test_insert", test_insert},
     { "test_iterate3", test_iterate},
     { "test_clear", test_clear},
+    { "test_node_reuse", test_node_reuse},
     CU_TEST_INFO_NULL
 };
 /**
@@ -257,6 +510,7 @@ static CU_SuiteInfo suites[] = {
     {"suite1", suite_success_init, NULL, NULL, NULL, testcase1},
     {"suite2", NULL, NULL, NULL, NULL, testcase2},
     {"suite3", NULL, suite_success_clean, NULL, NULL, testcase3},
+    {"suite4", NULL, NULL, NULL, NULL, testcase4},
     CU_SUITE_INFO_NULL
 };
 
@@ -0,0 +1,422 @@
+/**
+ * @file LRUCache.c
+ * @Brief  least recently used cache implementation
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-15
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "LRUCache.h"
+#include "util/HashIndex.h"
+#include "util/Log.h"
+
+#define LRU_BUCKET(cache, hash) \
+    ((cache)->buckets[hindex_mix(hash) & ((cache)->bucket_count - 1)])
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  lru_find Find the entry of a key
+ *
+ * @Param cache LRUCache struct
+ * @Param key The key
+ * @Param hash The hash of the key
+ *
+ * @Returns   NULL is failed; other is the link to the entry in its bucket
+ */
+/* ----------------------------------------------------------------------------*/
+static LRUEntry** lru_find(LRUCache *cache, void *key, unsigned long hash)
+{
+    LRUEntry **link = &LRU_BUCKET(cache, hash);
+
+    while (*link){
+	if (((*link)->hash == hash) && (cache->equal((*link)->key, key) == 0))
+	    return link;
+	link = &(*link)->hash_next;
+    }
+
+    return NULL;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  lru_detach Take an entry out of the recency list
+ *
+ * @Param cache LRUCache struct
+ * @Param entry The entry
+ */
+/* ----------------------------------------------------------------------------*/
+static void lru_detach(LRUCache *cache, LRUEntry *entry)
+{
+    if (entry->previous != NULL)
+	entry->previous->next = entry->next;
+    else
+	cache->first = entry->next;
+
+    if (entry->next != NULL)
+	entry->next->previous = entry->previous;
+    else
+	cache->last = entry->previous;
+
+    entry->previous = NULL;
+    entry->next = NULL;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  lru_attach Put an entry at the front of the recency list
+ *
+ * @Param cache LRUCache struct
+ * @Param entry The entry
+ */
+/* ----------------------------------------------------------------------------*/
+static void lru_attach(LRUCache *cache, LRUEntry *entry)
+{
+    entry->previous = NULL;
+    entry->next = cache->first;
+
+    if (cache->first != NULL)
+	cache->first->previous = entry;
+    else
+	cache->last = entry;
+    cache->first = entry;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  lru_remove Remove an entry and destroy its element
+ *
+ * @Param cache LRUCache struct
+ * @Param link The link to the entry in its bucket
+ */
+/* ----------------------------------------------------------------------------*/
+static void lru_remove(LRUCache *cache, LRUEntry **link)
+{
+    LRUEntry *entry = *link;
+
+    *link = entry->hash_next;
+    lru_detach(cache, entry);
+
+    cache->destroy(entry->element);
+    entry->key = NULL;
+    entry->element = NULL;
+    entry->hash_next = NULL;
+    slab_free(&cache->entry_pool, entry);
+    cache->size--;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  lru_new Initial the cache, the memory comes from libc
+ *
+ * @Param cache LRUCache struct
+ * @Param capacity The max number of entries, at most LRU_MAX_CAPACITY
+ * @Param hash Hash function of the key
+ * @Param equal Compare two keys, 0 means the same
+ * @Param destroy Destroy an element that is evicted, erased or replaced
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int lru_new(LRUCache *cache, unsigned int capacity, hash_handle hash,
+	handle_element equal, destroy_element destroy)
+{
+    return lru_new_allocator(cache, capacity, hash, equal, destroy, NULL);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  lru_new_allocator Initial the cache with an allocator
+ *
+ * @Param cache LRUCache struct
+ * @Param capacity The max number of entries, at most LRU_MAX_CAPACITY
+ * @Param hash Hash function of the key
+ * @Param equal Compare two keys, 0 means the same
+ * @Param destroy Destroy an element that is evicted, erased or replaced
+ * @Param allocator Where the buckets and the entries come from, NULL is libc
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int lru_new_allocator(LRUCache *cache, unsigned int capacity, hash_handle hash,
+	handle_element equal, destroy_element destroy, Allocator *allocator)
+{
+    if (cache == NULL || hash == NULL || equal == NULL || destroy == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+    if (!ALLOCATOR_CHECK(allocator)){
+	ERROR("allocator is incomplete!");
+	return -1;
+    }
+    if (capacity == 0){
+	ERROR("capacity is 0!");
+	return -1;
+    }
+    if (capacity > LRU_MAX_CAPACITY){
+	ERROR("capacity is too large!");
+	return -1;
+    }
+
+    /**
+     * the cache never holds more than capacity entries, so the buckets
+     * are sized once and never grow
+     */
+    size_t count = 1;
+    while (count < capacity)
+	count <<= 1;
+
+    if (slab_new(&cache->entry_pool, sizeof(LRUEntry), 0, allocator) != 0)
+	return -1;
+
+    cache->buckets = (LRUEntry**)mem_alloc(allocator, count * sizeof(LRUEntry*));
+    if (cache->buckets == NULL){
+	ERROR("malloc error!");
+	slab_delete(&cache->entry_pool);
+	return -1;
+    }
+    memset(cache->buckets, 0, count * sizeof(LRUEntry*));
+
+    cache->bucket_count = count;
+    cache->first = NULL;
+    cache->last = NULL;
+    cache->capacity = capacity;
+    cache->size = 0;
+    cache->hash = hash;
+    cache->equal = equal;
+    cache->destroy = destroy;
+    cache->hits = 0;
+    cache->misses = 0;
+    cache->evictions = 0;
+    cache->allocator = allocator;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  lru_clear Destroy all the entries
+ *
+ * @Param cache LRUCache struct
+ *
+ * @Returns   -1 is failed; >=0 is the number of entries
+ */
+/* ----------------------------------------------------------------------------*/
+int lru_clear(LRUCache *cache)
+{
+    if (cache == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    int ret = cache->size;
+    LRUEntry *entry = cache->first;
+    LRUEntry *temp = NULL;
+    while (entry){
+	temp = entry;
+	entry = entry->next;
+
+	cache->destroy(temp->element);
+	slab_free(&cache->entry_pool, temp);
+    }
+
+    memset(cache->buckets, 0, cache->bucket_count * sizeof(LRUEntry*));
+    cache->first = NULL;
+    cache->last = NULL;
+    cache->size = 0;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  lru_delete Delete the cache
+ *
+ * @Param cache LRUCache struct
+ *
+ * @Returns   -1 is failed; >=0 is the number of entries
+ */
+/* ----------------------------------------------------------------------------*/
+int lru_delete(LRUCache *cache)
+{
+    if (cache == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    int ret = lru_clear(cache);
+    mem_free(cache->allocator, cache->buckets);
+    slab_delete(&cache->entry_pool);
+    cache->buckets = NULL;
+    cache->bucket_count = 0;
+    cache->capacity = 0;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  lru_put Add or replace an entry, it becomes the most recently used;
+ *         a full cache evicts the least recently used one
+ *
+ * @Param cache LRUCache struct
+ * @Param key The key, it must be valid while the entry is in the cache
+ * @Param element The element
+ *
+ * @Returns   0 is OK; other is failed and the cache does not change
+ */
+/* ----------------------------------------------------------------------------*/
+int lru_put(LRUCache *cache, void *key, void *element)
+{
+    if (cache == NULL || key == NULL || element == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    unsigned long hash = cache->hash(key);
+    LRUEntry **link = lru_find(cache, key, hash);
+    LRUEntry *entry = NULL;
+
+    /**
+     * replace the element of the key
+     */
+    if (link != NULL){
+	entry = *link;
+	if (entry->element != element)
+	    cache->destroy(entry->element);
+	entry->key = key;
+	entry->element = element;
+	lru_detach(cache, entry);
+	lru_attach(cache, entry);
+	return 0;
+    }
+
+    /**
+     * allocate before the eviction, a failed put must not lose an entry
+     */
+    entry = (LRUEntry*)slab_alloc(&cache->entry_pool);
+    if (entry == NULL){
+	ERROR("slab alloc failed!");
+	return -1;
+    }
+
+    /**
+     * evict the least recently used one
+     */
+    if (cache->size == cache->capacity){
+	LRUEntry *last = cache->last;
+	link = &LRU_BUCKET(cache, last->hash);
+	while (*link != last)
+	    link = &(*link)->hash_next;
+	lru_remove(cache, link);
+	cache->evictions++;
+    }
+
+    entry->key = key;
+    entry->element = element;
+    entry->hash = hash;
+
+    link = &LRU_BUCKET(cache, hash);
+    entry->hash_next = *link;
+    *link = entry;
+    lru_attach(cache, entry);
+    cache->size++;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  lru_get Get the element of a key, it becomes the most recently used
+ *
+ * @Param cache LRUCache struct
+ * @Param key The key
+ *
+ * @Returns   NULL is missed; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+void* lru_get(LRUCache *cache, void *key)
+{
+    if (cache == NULL || key == NULL){
+	ERROR("null pointer!");
+	return NULL;
+    }
+
+    LRUEntry **link = lru_find(cache, key, cache->hash(key));
+    if (link == NULL){
+	cache->misses++;
+	return NULL;
+    }
+
+    LRUEntry *entry = *link;
+    if (cache->first != entry){
+	lru_detach(cache, entry);
+	lru_attach(cache, entry);
+    }
+    cache->hits++;
+
+    return entry->element;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  lru_peek Get the element of a key, the recency and the counters
+ *         do not change
+ *
+ * @Param cache LRUCache struct
+ * @Param key The key
+ *
+ * @Returns   NULL is missed; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+void* lru_peek(LRUCache *cache, void *key)
+{
+    if (cache == NULL || key == NULL){
+	ERROR("null pointer!");
+	return NULL;
+    }
+
+    LRUEntry **link = lru_find(cache, key, cache->hash(key));
+
+    return link == NULL ? NULL : (*link)->element;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  lru_erase Remove the entry of a key and destroy its element
+ *
+ * @Param cache LRUCache struct
+ * @Param key The key
+ *
+ * @Returns   0 is OK; -1 means no such key
+ */
+/* ----------------------------------------------------------------------------*/
+int lru_erase(LRUCache *cache, void *key)
+{
+    if (cache == NULL || key == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    LRUEntry **link = lru_find(cache, key, cache->hash(key));
+    if (link == NULL)
+	return -1;
+
+    lru_remove(cache, link);
+
+    return 0;
+}
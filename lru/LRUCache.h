@@ -0,0 +1,85 @@
+/**
+ * @file LRUCache.h
+ * @Brief  least recently used cache interfaces
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-15
+ */
+
+#ifndef LRU_CACHE_H_
+#define LRU_CACHE_H_
+
+#include "Common.h"
+#include "util/Slab.h"
+
+/**
+ * the buckets are a power of two not less than the capacity, so the
+ * capacity can not be larger than the highest one an unsigned int holds
+ */
+#define LRU_MAX_CAPACITY (1U << 31)
+
+/**
+ * Represent an entry, it is in the recency list and in a hash bucket
+ */
+typedef struct LRUEntry{
+    void *key;
+    void *element;
+    unsigned long hash;
+    /**
+     * recency list, the first one is the most recently used
+     */
+    struct LRUEntry *previous;
+    struct LRUEntry *next;
+    /**
+     * the next entry in the same bucket
+     */
+    struct LRUEntry *hash_next;
+}LRUEntry;
+
+typedef struct LRUCache{
+    /**
+     * hash buckets, the number of buckets is fixed by the capacity
+     */
+    LRUEntry **buckets;
+    unsigned int bucket_count;
+    /**
+     * most and least recently used entry
+     */
+    LRUEntry *first;
+    LRUEntry *last;
+    unsigned int capacity;
+    unsigned int size;
+    /**
+     * user-defined functions, equal returns 0 when two keys are the same
+     */
+    hash_handle hash;
+    handle_element equal;
+    destroy_element destroy;
+    /**
+     * counters of lru_get
+     */
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long evictions;
+    Slab entry_pool;
+    /**
+     * where the buckets and the entries come from, NULL means libc
+     */
+    Allocator *allocator;
+}LRUCache;
+
+int lru_new(LRUCache *cache, unsigned int capacity, hash_handle hash,
+	handle_element equal, destroy_element destroy);
+int lru_new_allocator(LRUCache *cache, unsigned int capacity, hash_handle hash,
+	handle_element equal, destroy_element destroy, Allocator *allocator);
+int lru_delete(LRUCache *cache);
+int lru_clear(LRUCache *cache);
+
+int lru_put(LRUCache *cache, void *key, void *element);
+void* lru_get(LRUCache *cache, void *key);
+void* lru_peek(LRUCache *cache, void *key);
+int lru_erase(LRUCache *cache, void *key);
+
+#define LRU_SIZE(cache) ((cache)->size)
+
+#endif
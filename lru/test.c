@@ -0,0 +1,377 @@
+/**
+ * @file test.c
+ * @Brief  test lru cache
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-15
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+/**
+ * Cunit headers
+ */ 
+#include "CUnit.h"
+#include "Automated.h"
+#include "Basic.h"
+#include "Console.h"
+
+/**
+ * Test file headers
+ */ 
+#include "Common.h"
+#include "lru/LRUCache.h"
+#include "util/Log.h"
+
+
+/*************Test Case Begin*******************/
+
+typedef struct Person{
+    char *name;
+    int age;
+}Person;
+
+LRUCache cache;
+
+int destroyed = 0;
+
+unsigned long name_hash(void *key)
+{
+    unsigned long hash = 5381;
+    char *name = (char*)key;
+
+    while (*name)
+	hash = hash * 33 + *name++;
+    return hash;
+}
+
+int name_equal(void *key1, void *key2)
+{
+    return strcmp((char*)key1, (char*)key2);
+}
+
+int destroy_node(void *person)
+{
+    Person *p = (Person*)person;
+    free(p->name);
+    p->name = NULL;
+    p->age = 0;
+    free(p);
+    destroyed++;
+
+    return 0;
+}
+
+Person* new_person(const char *name, int age)
+{
+    Person *p = (Person*)malloc(sizeof(Person));
+    p->name = (char*)malloc(16);
+    strcpy(p->name, name);
+    p->age = age;
+
+    return p;
+}
+
+int put_person(const char *name, int age)
+{
+    Person *p = new_person(name, age);
+    return lru_put(&cache, p->name, p);
+}
+
+void test_lru_new()
+{
+    CU_ASSERT_EQUAL_FATAL(lru_new(&cache, 0, name_hash, name_equal, destroy_node), -1);
+    CU_ASSERT_EQUAL_FATAL(lru_new(&cache, LRU_MAX_CAPACITY + 1, name_hash, name_equal, \
+		destroy_node), -1);
+    CU_ASSERT_EQUAL_FATAL(lru_new(&cache, 3, name_hash, name_equal, destroy_node), 0);
+    CU_ASSERT_EQUAL_FATAL(cache.bucket_count, 4);
+}
+
+void test_lru_put()
+{
+    CU_ASSERT_EQUAL_FATAL(put_person("tom", 22), 0);
+    CU_ASSERT_EQUAL_FATAL(put_person("jack", 23), 0);
+    CU_ASSERT_EQUAL_FATAL(put_person("jim", 24), 0);
+    CU_ASSERT_EQUAL_FATAL(LRU_SIZE(&cache), 3);
+    CU_ASSERT_EQUAL_FATAL(destroyed, 0);
+}
+
+void test_lru_get()
+{
+    /**
+     * tom becomes the most recently used, jack is the least
+     */
+    Person *p = (Person*)lru_get(&cache, "tom");
+    CU_ASSERT_PTR_NOT_EQUAL_FATAL(p, NULL);
+    CU_ASSERT_EQUAL_FATAL(p->age, 22);
+    CU_ASSERT_PTR_EQUAL_FATAL(lru_get(&cache, "fitz"), NULL);
+    CU_ASSERT_EQUAL_FATAL(cache.hits, 1);
+    CU_ASSERT_EQUAL_FATAL(cache.misses, 1);
+
+    /**
+     * peek does not change the recency
+     */
+    CU_ASSERT_PTR_NOT_EQUAL_FATAL(lru_peek(&cache, "jack"), NULL);
+    CU_ASSERT_EQUAL_FATAL(cache.hits, 1);
+}
+
+void test_lru_evict()
+{
+    CU_ASSERT_EQUAL_FATAL(put_person("fitz", 25), 0);
+    CU_ASSERT_EQUAL_FATAL(LRU_SIZE(&cache), 3);
+    CU_ASSERT_EQUAL_FATAL(destroyed, 1);
+    CU_ASSERT_EQUAL_FATAL(cache.evictions, 1);
+    CU_ASSERT_PTR_EQUAL_FATAL(lru_peek(&cache, "jack"), NULL);
+    CU_ASSERT_PTR_NOT_EQUAL_FATAL(lru_peek(&cache, "tom"), NULL);
+
+    /**
+     * replace jim, the old element is destroyed and jim becomes the most
+     * recently used, so tom is evicted next
+     */
+    CU_ASSERT_EQUAL_FATAL(put_person("jim", 34), 0);
+    CU_ASSERT_EQUAL_FATAL(destroyed, 2);
+    CU_ASSERT_EQUAL_FATAL(((Person*)lru_peek(&cache, "jim"))->age, 34);
+    CU_ASSERT_EQUAL_FATAL(put_person("jack", 33), 0);
+    CU_ASSERT_PTR_EQUAL_FATAL(lru_peek(&cache, "tom"), NULL);
+    CU_ASSERT_EQUAL_FATAL(destroyed, 3);
+}
+
+void test_lru_erase()
+{
+    CU_ASSERT_EQUAL_FATAL(lru_erase(&cache, "jim"), 0);
+    CU_ASSERT_EQUAL_FATAL(lru_erase(&cache, "jim"), -1);
+    CU_ASSERT_EQUAL_FATAL(LRU_SIZE(&cache), 2);
+    CU_ASSERT_EQUAL_FATAL(destroyed, 4);
+}
+
+void test_lru_delete()
+{
+    CU_ASSERT_EQUAL_FATAL(lru_delete(&cache), 2);
+    CU_ASSERT_EQUAL_FATAL(destroyed, 6);
+}
+
+/**
+ * allocator that counts the live blocks, it fails while failing is set
+ */
+int live_blocks = 0;
+int failing = 0;
+
+void* count_alloc(void *context, size_t size)
+{
+    if (failing)
+	return NULL;
+    (*(int*)context)++;
+    return malloc(size);
+}
+
+void* count_realloc(void *context, void *address, size_t size)
+{
+    return realloc(address, size);
+}
+
+void count_free(void *context, void *address)
+{
+    (*(int*)context)--;
+    free(address);
+}
+
+Allocator counter = {
+    .alloc = count_alloc,
+    .realloc = count_realloc,
+    .free = count_free,
+    .context = &live_blocks
+};
+
+void test_lru_allocator()
+{
+    failing = 1;
+    CU_ASSERT_EQUAL_FATAL(lru_new_allocator(&cache, 4, name_hash, name_equal, \
+		destroy_node, &counter), -1);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 0);
+    failing = 0;
+
+    /**
+     * fill a whole slab page, so the next entry needs a new page
+     */
+    Slab probe;
+    CU_ASSERT_EQUAL_FATAL(slab_new(&probe, sizeof(LRUEntry), 0, NULL), 0);
+    unsigned int capacity = probe.page_objects;
+    slab_delete(&probe);
+
+    CU_ASSERT_EQUAL_FATAL(lru_new_allocator(&cache, capacity, name_hash, name_equal, \
+		destroy_node, &counter), 0);
+    char name[16];
+    unsigned int i;
+    for (i=0; i<capacity; i++){
+	sprintf(name, "p%u", i);
+	CU_ASSERT_EQUAL_FATAL(put_person(name, i), 0);
+    }
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 2);
+
+    /**
+     * a failed put evicts nothing
+     */
+    destroyed = 0;
+    failing = 1;
+    Person *p = new_person("fitz", 25);
+    CU_ASSERT_EQUAL_FATAL(lru_put(&cache, p->name, p), -1);
+    failing = 0;
+    CU_ASSERT_EQUAL_FATAL(destroyed, 0);
+    CU_ASSERT_EQUAL_FATAL(cache.evictions, 0);
+    CU_ASSERT_EQUAL_FATAL(LRU_SIZE(&cache), capacity);
+    CU_ASSERT_PTR_NOT_EQUAL_FATAL(lru_peek(&cache, "p0"), NULL);
+
+    CU_ASSERT_EQUAL_FATAL(lru_put(&cache, p->name, p), 0);
+    CU_ASSERT_EQUAL_FATAL(cache.evictions, 1);
+    CU_ASSERT_PTR_EQUAL_FATAL(lru_peek(&cache, "p0"), NULL);
+    CU_ASSERT_EQUAL_FATAL(lru_delete(&cache), capacity);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 0);
+}
+
+/*************Test Case End*********************/
+
+
+
+/**
+ * add testcase, similar function in the same testcase
+ * 
+ * typedef struct CU_TestInfo {
+ * 	const char  *pName;
+ *	CU_TestFunc pTestFunc;
+ *	} CU_TestInfo;
+ *
+ * Example:
+ *
+ * static CU_TestInfo testcase1[] = {
+ * 	{ "test_function_name", test_function},
+ * 	{ "test_function_name2", test_function2},
+ * 	CU_TEST_INFO_NULL
+ * };
+ *
+ * static CU_TestInfo testcase2[] = {
+ * 	...
+ * 	CU_TEST_INFO_NULL
+ * };
+ *
+ */ 
+
+static CU_TestInfo testcase1[] = {
+    { "test_lru_new", test_lru_new},
+    { "test_lru_put", test_lru_put},
+    { "test_lru_get", test_lru_get},
+    { "test_lru_evict", test_lru_evict},
+    { "test_lru_erase", test_lru_erase},
+    { "test_lru_delete", test_lru_delete},
+    { "test_lru_allocator", test_lru_allocator},
+    CU_TEST_INFO_NULL
+};
+
+/**
+ * add testcase to the suites
+ * 
+ * typedef struct CU_SuiteInfo {
+ *     const char       *pName;         
+ *     CU_InitializeFunc pInitFunc;     
+ *     CU_CleanupFunc    pCleanupFunc;  
+ *     CU_SetUpFunc      pSetUpFunc;    
+ *     CU_TearDownFunc   pTearDownFunc; 
+ *     CU_TestInfo      *pTests;        
+ * } CU_SuiteInfo;
+ *
+ * Example:
+ *
+ * static CU_SuiteInfo suites[] = {
+ * 	{"suite name", suite_success_init, suite_success_clean, NULL, NULL, testcase},
+ * 	...
+ * 	CU_SUITE_INFO_NULL
+ * }
+ *
+ */
+
+static int suite_success_init(void) 
+{
+    return 0; 
+}
+static int suite_success_clean(void) 
+{
+    return 0; 
+}
+
+
+static CU_SuiteInfo suites[] = {
+    {"suite1", suite_success_init, NULL, NULL, NULL, testcase1},
+    CU_SUITE_INFO_NULL
+};
+
+
+
+/**
+ * add tests to the test framework
+ *
+ */ 
+void AddTests(void)
+{
+    assert(NULL != CU_get_registry());
+    assert(!CU_is_test_running());
+
+    /* Register suites. */
+    if (CU_register_suites(suites) != CUE_SUCCESS) {
+	fprintf(stderr, "suite registration failed - %s\n",
+		CU_get_error_msg());
+	exit(EXIT_FAILURE);
+    }
+
+}
+
+
+int main()
+{
+    if (CU_initialize_registry()) {
+	printf("\nInitialization of Test Registry failed.");
+    }else{
+
+	LOG_FILE_OPEN("log.txt");
+
+	AddTests();
+
+	/*******Automated Mode(best)*********************
+	 * CU_set_output_filename("TestAutomated");
+	 * CU_list_tests_to_file();
+	 * CU_automated_run_tests();
+	 ******************************************/
+
+	 CU_set_output_filename("TestAutomated");
+	 CU_list_tests_to_file();
+	 CU_automated_run_tests();
+	/*******Basic Mode*********************
+	 * mode can choose:
+	 * typedef enum {
+	 *   CU_BRM_NORMAL = 0, Normal mode - failures and run summary are printed [default].
+	 *   CU_BRM_SILENT,     Silent mode - no output is printed except framework error messages.
+	 *   CU_BRM_VERBOSE     Verbose mode - maximum output of run details.
+	 * } CU_BasicRunMode;
+	 ****************************************
+	 *
+	 * CU_basic_set_mode(CU_BRM_NORMAL);
+	 * CU_basic_run_tests();
+	 ******************************************/
+
+	/*******Console Mode*********************
+	 * CU_console_run_tests();
+	 ******************************************/
+
+	/*******Curses Mode*********************
+	 * CU_curses_run_tests();
+	 ******************************************/ 
+
+
+	CU_cleanup_registry();
+    }
+
+    LOG_FILE_CLOSE();
+    return 0;
+}
+
@@ -0,0 +1,326 @@
+/**
+ * @file BlockingQueue.c
+ * @Brief  blocking queue implementation, a Queue under a lock with two
+ *         conditions. A waiter spins for a while on the copy of the state
+ *         before it sleeps, so a short wait never sleeps in the kernel
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-24
+ */
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+
+#include "BlockingQueue.h"
+#include "util/Log.h"
+
+/**
+ * times that a waiter reads the state before it sleeps, every read is
+ * followed by a pause, so the spin lasts a few microseconds at most
+ */
+#define BQUEUE_SPIN 128
+
+/**
+ * the pause of a spin, it hints the core that this is a busy wait, so the
+ * other hyper-thread runs and leaving the loop does not flush the pipeline
+ */
+#if defined(__x86_64__) || defined(__i386__)
+#define BQUEUE_PAUSE() __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define BQUEUE_PAUSE() __asm__ __volatile__("yield" ::: "memory")
+#else
+#define BQUEUE_PAUSE() atomic_signal_fence(memory_order_seq_cst)
+#endif
+
+#define BQUEUE_FULL(queue) \
+    ((queue)->capacity != 0 && (unsigned int)(queue)->queue.queue_size >= (queue)->capacity)
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bqueue_sync_new Initial the lock and the conditions, nothing is
+ *         left initialized when one of them fails
+ *
+ * @Param queue BlockingQueue struct
+ *
+ * @Returns   0 is OK; other is the error number
+ */
+/* ----------------------------------------------------------------------------*/
+static int bqueue_sync_new(BlockingQueue *queue)
+{
+    /**
+     * the deadlines are on the monotonic clock, changing the time of the
+     * system does not change a timeout
+     */
+    pthread_condattr_t attr;
+    int ret = pthread_condattr_init(&attr);
+    if (ret != 0)
+	return ret;
+
+    ret = pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    if (ret == 0 && (ret = pthread_cond_init(&queue->not_full, &attr)) == 0){
+	if ((ret = pthread_cond_init(&queue->not_empty, &attr)) == 0){
+	    if ((ret = pthread_mutex_init(&queue->lock, NULL)) != 0)
+		pthread_cond_destroy(&queue->not_empty);
+	}
+	if (ret != 0)
+	    pthread_cond_destroy(&queue->not_full);
+    }
+    pthread_condattr_destroy(&attr);
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bqueue_new Initial the queue
+ *
+ * @Param queue BlockingQueue struct
+ * @Param capacity The max number of elements, 0 means unbounded
+ * @Param allocator Where the nodes come from, NULL is libc
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int bqueue_new(BlockingQueue *queue, unsigned int capacity, Allocator *allocator)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    if (queue_new(&queue->queue, allocator) != 0)
+	return -1;
+
+    int ret = bqueue_sync_new(queue);
+    if (ret != 0){
+	ERROR("lock or condition init error: %d!", ret);
+	queue_delete(&queue->queue, NULL);
+	return -1;
+    }
+
+    queue->capacity = capacity;
+    queue->producers_waiting = 0;
+    queue->consumers_waiting = 0;
+    atomic_init(&queue->size, 0);
+    atomic_init(&queue->closed, 0);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bqueue_delete Delete the queue, no thread may use or wait on it
+ *
+ * @Param queue BlockingQueue struct
+ * @Param destroy_node Destroy funcion
+ *
+ * @Returns   -1 is failed; other is the count of the element in the queue
+ */
+/* ----------------------------------------------------------------------------*/
+int bqueue_delete(BlockingQueue *queue, handle destroy_node)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    int ret = queue->queue.queue_size;
+    queue_delete(&queue->queue, destroy_node);
+    atomic_store_explicit(&queue->size, 0, memory_order_relaxed);
+
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->not_full);
+    pthread_cond_destroy(&queue->not_empty);
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bqueue_close Close the queue and wake all the waiters. Nothing can
+ *         be appended after that, the elements left can still be taken out
+ *
+ * @Param queue BlockingQueue struct
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int bqueue_close(BlockingQueue *queue)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    pthread_mutex_lock(&queue->lock);
+    atomic_store_explicit(&queue->closed, 1, memory_order_relaxed);
+    pthread_cond_broadcast(&queue->not_full);
+    pthread_cond_broadcast(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bqueue_deadline Get the time that a wait ends
+ *
+ * @Param deadline The deadline on the monotonic clock
+ * @Param timeout Milliseconds from now
+ */
+/* ----------------------------------------------------------------------------*/
+static void bqueue_deadline(struct timespec *deadline, long timeout)
+{
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += timeout / 1000;
+    deadline->tv_nsec += (timeout % 1000) * 1000000;
+    if (deadline->tv_nsec >= 1000000000){
+	deadline->tv_sec++;
+	deadline->tv_nsec -= 1000000000;
+    }
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bqueue_sleep Sleep on a condition with the lock held
+ *
+ * @Param queue BlockingQueue struct
+ * @Param condition The condition
+ * @Param waiting The number of threads that sleep on the condition
+ * @Param deadline The time that the wait ends, NULL means never
+ *
+ * @Returns   0 is woken; other means the deadline is passed
+ */
+/* ----------------------------------------------------------------------------*/
+static int bqueue_sleep(BlockingQueue *queue, pthread_cond_t *condition, int *waiting, \
+	struct timespec *deadline)
+{
+    int ret = 0;
+
+    (*waiting)++;
+    if (deadline == NULL)
+	pthread_cond_wait(condition, &queue->lock);
+    else
+	ret = pthread_cond_timedwait(condition, &queue->lock, deadline) == ETIMEDOUT;
+    (*waiting)--;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bqueue_in_wait Append an element, wait while the queue is full
+ *
+ * @Param queue BlockingQueue struct
+ * @Param element The element
+ * @Param timeout Milliseconds to wait at most, 0 does not wait,
+ *        BQUEUE_FOREVER waits until there is room or the queue is closed
+ *
+ * @Returns   0 is OK; 1 means timeout; -1 means failed or closed
+ */
+/* ----------------------------------------------------------------------------*/
+int bqueue_in_wait(BlockingQueue *queue, void *element, long timeout)
+{
+    if (queue == NULL || element == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    int i;
+    if (timeout != 0 && queue->capacity != 0)
+	for (i=0; i<BQUEUE_SPIN && !BQUEUE_CLOSED(queue) \
+		&& (unsigned int)BQUEUE_SIZE(queue) >= queue->capacity; i++)
+	    BQUEUE_PAUSE();
+
+    struct timespec deadline;
+    if (timeout > 0)
+	bqueue_deadline(&deadline, timeout);
+
+    int ret = 0;
+    pthread_mutex_lock(&queue->lock);
+    while (!BQUEUE_CLOSED(queue) && BQUEUE_FULL(queue)){
+	if (timeout == 0 || bqueue_sleep(queue, &queue->not_full, &queue->producers_waiting, \
+		    timeout < 0 ? NULL : &deadline) != 0){
+	    ret = BQUEUE_FULL(queue) ? 1 : 0;
+	    break;
+	}
+    }
+
+    if (BQUEUE_CLOSED(queue))
+	ret = -1;
+    else if (ret == 0 && (ret = queue_in(&queue->queue, element)) == 0){
+	atomic_store_explicit(&queue->size, queue->queue.queue_size, memory_order_relaxed);
+	if (queue->consumers_waiting)
+	    pthread_cond_signal(&queue->not_empty);
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  bqueue_out_wait Out an element, wait while the queue is empty
+ *
+ * @Param queue BlockingQueue struct
+ * @Param element Where the element is put
+ * @Param timeout Milliseconds to wait at most, 0 does not wait,
+ *        BQUEUE_FOREVER waits until there is an element or the queue is closed
+ *
+ * @Returns   0 is OK; 1 means timeout; -1 means failed, or the queue is
+ *            closed and empty
+ */
+/* ----------------------------------------------------------------------------*/
+int bqueue_out_wait(BlockingQueue *queue, void **element, long timeout)
+{
+    if (queue == NULL || element == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    int i;
+    if (timeout != 0)
+	for (i=0; i<BQUEUE_SPIN && !BQUEUE_CLOSED(queue) && BQUEUE_SIZE(queue) == 0; i++)
+	    BQUEUE_PAUSE();
+
+    struct timespec deadline;
+    if (timeout > 0)
+	bqueue_deadline(&deadline, timeout);
+
+    int ret = 0;
+    Queue *elements = &queue->queue;
+    pthread_mutex_lock(&queue->lock);
+    while (!BQUEUE_CLOSED(queue) && QUEUE_EMPTY(elements)){
+	if (timeout == 0 || bqueue_sleep(queue, &queue->not_empty, &queue->consumers_waiting, \
+		    timeout < 0 ? NULL : &deadline) != 0){
+	    ret = QUEUE_EMPTY(elements) ? 1 : 0;
+	    break;
+	}
+    }
+
+    /**
+     * test empty before queue_out, it logs every time the queue is empty
+     */
+    *element = NULL;
+    if (QUEUE_EMPTY(elements)){
+	if (BQUEUE_CLOSED(queue))
+	    ret = -1;
+    }else{
+	*element = queue_out(elements);
+	ret = 0;
+	atomic_store_explicit(&queue->size, elements->queue_size, memory_order_relaxed);
+	if (queue->producers_waiting)
+	    pthread_cond_signal(&queue->not_full);
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return ret;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file BlockingQueue.h
+ * @Brief  blocking queue interfaces, consumers sleep while the queue is
+ *         empty and producers sleep while it is full
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-24
+ */
+
+#ifndef BLOCKING_QUEUE_H_
+#define BLOCKING_QUEUE_H_
+
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "queue/Queue.h"
+
+/**
+ * timeout that waits until the queue is ready or closed
+ */
+#define BQUEUE_FOREVER -1
+
+typedef struct BlockingQueue{
+    /**
+     * the elements, only used with the lock held
+     */
+    Queue queue;
+    /**
+     * the max number of elements, 0 means unbounded
+     */
+    unsigned int capacity;
+    /**
+     * copies of the state that the waiters read without the lock while they
+     * spin, they are only changed with the lock held
+     */
+    _Atomic int size;
+    _Atomic int closed;
+    /**
+     * the number of threads that sleep on the conditions, only used with
+     * the lock held, nobody is signaled when they are 0
+     */
+    int producers_waiting;
+    int consumers_waiting;
+    pthread_mutex_t lock;
+    pthread_cond_t not_full;
+    pthread_cond_t not_empty;
+}BlockingQueue;
+
+#define BQUEUE_SIZE(queue) atomic_load_explicit(&(queue)->size, memory_order_relaxed)
+#define BQUEUE_CLOSED(queue) atomic_load_explicit(&(queue)->closed, memory_order_relaxed)
+
+int bqueue_new(BlockingQueue *queue, unsigned int capacity, Allocator *allocator);
+int bqueue_delete(BlockingQueue *queue, handle destroy_node);
+int bqueue_close(BlockingQueue *queue);
+
+int bqueue_in_wait(BlockingQueue *queue, void *element, long timeout);
+int bqueue_out_wait(BlockingQueue *queue, void **element, long timeout);
+
+#endif
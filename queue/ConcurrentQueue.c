@@ -0,0 +1,205 @@
+/**
+ * @file ConcurrentQueue.c
+ * @Brief  unbounded lock-free queue implementation. The nodes come from an
+ *         AtomicPool, they are never given back to the system before the
+ *         queue is deleted, so reading a node that another thread has just
+ *         recycled is safe, and the tags of the references make the stale
+ *         CAS fail.
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-23
+ */
+#include <stdlib.h>
+
+#include "ConcurrentQueue.h"
+#include "util/Log.h"
+
+#define CQUEUE_NODE(queue, ref) apool_node(&(queue)->pool, APOOL_INDEX(ref))
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  cqueue_new Initial the queue
+ *
+ * @Param queue ConcurrentQueue struct
+ * @Param allocator Where the nodes come from, NULL is libc
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int cqueue_new(ConcurrentQueue *queue, Allocator *allocator)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    if (apool_new(&queue->pool, allocator) != 0)
+	return -1;
+
+    /**
+     * the first dummy node
+     */
+    uint32_t index = apool_alloc(&queue->pool);
+    if (index == 0){
+	apool_delete(&queue->pool);
+	return -1;
+    }
+    atomic_store_explicit(&apool_node(&queue->pool, index)->next, APOOL_REF(0, 0), \
+	    memory_order_relaxed);
+
+    atomic_init(&queue->head, APOOL_REF(index, 0));
+    atomic_init(&queue->tail, APOOL_REF(index, 0));
+    atomic_init(&queue->count, 0);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  cqueue_delete Delete the queue, no thread may use it
+ *
+ * @Param queue ConcurrentQueue struct
+ * @Param destroy_node Destroy funcion
+ *
+ * @Returns   -1 is failed; other is the count of the element in the queue
+ */
+/* ----------------------------------------------------------------------------*/
+int cqueue_delete(ConcurrentQueue *queue, handle destroy_node)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    int ret = 0;
+    void *element = NULL;
+    while ((element = cqueue_out(queue)) != NULL){
+	if (destroy_node)
+	    destroy_node(element);
+	ret++;
+    }
+    apool_delete(&queue->pool);
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  cqueue_in Append an element to the tail
+ *
+ * @Param queue ConcurrentQueue struct
+ * @Param element The element, NULL is not allowed
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int cqueue_in(ConcurrentQueue *queue, void *element)
+{
+    if (queue == NULL || element == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    uint32_t index = apool_alloc(&queue->pool);
+    if (index == 0)
+	return -1;
+
+    AtomicNode *node = apool_node(&queue->pool, index);
+    uint64_t next = atomic_load_explicit(&node->next, memory_order_relaxed);
+    atomic_store_explicit(&node->element, element, memory_order_relaxed);
+    atomic_store_explicit(&node->next, APOOL_REF(0, APOOL_TAG(next) + 1), memory_order_relaxed);
+
+    uint64_t tail;
+    AtomicNode *last = NULL;
+    for (;;){
+	tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+	last = CQUEUE_NODE(queue, tail);
+	next = atomic_load_explicit(&last->next, memory_order_acquire);
+	if (tail != atomic_load_explicit(&queue->tail, memory_order_acquire))
+	    continue;
+
+	if (APOOL_INDEX(next) == 0){
+	    /**
+	     * link the node after the last one
+	     */
+	    if (atomic_compare_exchange_weak_explicit(&last->next, &next, \
+			APOOL_REF(index, APOOL_TAG(next) + 1), \
+			memory_order_release, memory_order_relaxed))
+		break;
+	}else{
+	    /**
+	     * the tail falls behind, help the other enqueuer to move it
+	     */
+	    atomic_compare_exchange_strong_explicit(&queue->tail, &tail, \
+		    APOOL_REF(APOOL_INDEX(next), APOOL_TAG(tail) + 1), \
+		    memory_order_release, memory_order_relaxed);
+	}
+    }
+
+    /**
+     * another thread may have moved the tail already
+     */
+    atomic_compare_exchange_strong_explicit(&queue->tail, &tail, \
+	    APOOL_REF(index, APOOL_TAG(tail) + 1), \
+	    memory_order_release, memory_order_relaxed);
+    atomic_fetch_add_explicit(&queue->count, 1, memory_order_relaxed);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  cqueue_out Out an element from the head
+ *
+ * @Param queue ConcurrentQueue struct
+ *
+ * @Returns   NULL means the queue is empty; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+void* cqueue_out(ConcurrentQueue *queue)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return NULL;
+    }
+
+    uint64_t head, tail, next;
+    void *ret = NULL;
+    for (;;){
+	head = atomic_load_explicit(&queue->head, memory_order_acquire);
+	tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+	next = atomic_load_explicit(&CQUEUE_NODE(queue, head)->next, memory_order_acquire);
+	if (head != atomic_load_explicit(&queue->head, memory_order_acquire))
+	    continue;
+
+	if (APOOL_INDEX(head) == APOOL_INDEX(tail)){
+	    if (APOOL_INDEX(next) == 0)
+		return NULL;
+	    atomic_compare_exchange_strong_explicit(&queue->tail, &tail, \
+		    APOOL_REF(APOOL_INDEX(next), APOOL_TAG(tail) + 1), \
+		    memory_order_release, memory_order_relaxed);
+	}else{
+	    /**
+	     * read the element before the node becomes the dummy, after that
+	     * another dequeuer may recycle it
+	     */
+	    ret = atomic_load_explicit(&CQUEUE_NODE(queue, next)->element, memory_order_relaxed);
+	    if (atomic_compare_exchange_weak_explicit(&queue->head, &head, \
+			APOOL_REF(APOOL_INDEX(next), APOOL_TAG(head) + 1), \
+			memory_order_acq_rel, memory_order_relaxed))
+		break;
+	}
+    }
+
+    /**
+     * the old dummy goes to the free list
+     */
+    apool_free(&queue->pool, APOOL_INDEX(head));
+    atomic_fetch_sub_explicit(&queue->count, 1, memory_order_relaxed);
+
+    return ret;
+}
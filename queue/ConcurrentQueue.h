@@ -0,0 +1,47 @@
+/**
+ * @file ConcurrentQueue.h
+ * @Brief  unbounded lock-free queue interfaces
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-23
+ */
+
+#ifndef CONCURRENT_QUEUE_H_
+#define CONCURRENT_QUEUE_H_
+
+#include "queue/Queue.h"
+#include "util/AtomicPool.h"
+
+#define CQUEUE_CACHE_LINE 64
+
+/**
+ * Represent a Michael-Scott queue, all the functions except new and delete
+ * may be called by any threads at the same time. The head node is a dummy,
+ * the elements are in the nodes after it.
+ */
+typedef struct ConcurrentQueue{
+    /**
+     * tagged references, dequeuers race on head and enqueuers on tail
+     */
+    _Alignas(CQUEUE_CACHE_LINE) _Atomic uint64_t head;
+    _Alignas(CQUEUE_CACHE_LINE) _Atomic uint64_t tail;
+    /**
+     * the number of elements, it is exact when no thread changes the queue
+     */
+    _Alignas(CQUEUE_CACHE_LINE) _Atomic int count;
+    /**
+     * the nodes and the free list that they are recycled through, like the
+     * spare list of Queue
+     */
+    AtomicPool pool;
+}ConcurrentQueue;
+
+int cqueue_new(ConcurrentQueue *queue, Allocator *allocator);
+int cqueue_delete(ConcurrentQueue *queue, handle destroy_node);
+
+int cqueue_in(ConcurrentQueue *queue, void *element);
+void* cqueue_out(ConcurrentQueue *queue);
+
+#define CQUEUE_SIZE(queue) atomic_load_explicit(&(queue)->count, memory_order_relaxed)
+
+#endif
@@ -0,0 +1,445 @@
+/**
+ * @file IndexedQueue.c
+ * @Brief  indexed priority queue implementation, the heap holds handles and
+ *         every move in the heap writes the new position back to the slot
+ *         of the handle
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-26
+ */
+#include <stdlib.h>
+
+#include "IndexedQueue.h"
+#include "util/Log.h"
+
+#define IQUEUE_DEFAULT_ARITY 4
+#define IQUEUE_DEFAULT_CAPACITY 16
+
+#define IQUEUE_ELEMENT(queue, position) ((queue)->entries[(queue)->heap[position]].element)
+#define IQUEUE_VALID(queue, id) \
+    ((id) >= 0 && (unsigned int)(id) < (queue)->capacity && (queue)->entries[id].element != NULL)
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  iqueue_new Initial the queue
+ *
+ * @Param queue IndexedQueue struct
+ * @Param arity Children of a node, if arity=0, select default(4)
+ * @Param compare Compare function, the least element goes out first
+ * @Param allocator Where the arrays come from, NULL is libc
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int iqueue_new(IndexedQueue *queue, unsigned int arity, compare_handle compare, \
+	Allocator *allocator)
+{
+    if (queue == NULL || compare == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+    if (!ALLOCATOR_CHECK(allocator)){
+	ERROR("missed allocator function!");
+	return -1;
+    }
+
+    if (arity == 0)
+	arity = IQUEUE_DEFAULT_ARITY;
+    if (arity < 2){
+	ERROR("arity is less than 2!");
+	return -1;
+    }
+
+    queue->heap = (unsigned int*)mem_alloc(allocator, \
+	    IQUEUE_DEFAULT_CAPACITY * sizeof(unsigned int));
+    queue->entries = (IndexedEntry*)mem_alloc(allocator, \
+	    IQUEUE_DEFAULT_CAPACITY * sizeof(IndexedEntry));
+    if (queue->heap == NULL || queue->entries == NULL){
+	ERROR("malloc error!");
+	if (queue->heap != NULL)
+	    mem_free(allocator, queue->heap);
+	if (queue->entries != NULL)
+	    mem_free(allocator, queue->entries);
+	return -1;
+    }
+    queue->size = 0;
+    queue->capacity = IQUEUE_DEFAULT_CAPACITY;
+    queue->arity = arity;
+    queue->compare = compare;
+    queue->allocator = allocator;
+
+    /**
+     * all the slots are free
+     */
+    iqueue_clear(queue, NULL);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  iqueue_clear Clear the queue, all the handles become invalid
+ *
+ * @Param queue IndexedQueue struct
+ * @Param destroy_node Destroy node function
+ *
+ * @Returns   -1 is failed; other is the count of the element in the queue
+ */
+/* ----------------------------------------------------------------------------*/
+int iqueue_clear(IndexedQueue *queue, handle destroy_node)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    /**
+     * all the slots go to the free list in order
+     */
+    unsigned int i;
+    for (i=0; i<queue->capacity; i++){
+	if (destroy_node && queue->entries[i].element != NULL)
+	    destroy_node(queue->entries[i].element);
+	queue->entries[i].element = NULL;
+	queue->entries[i].position = i + 1 < queue->capacity ? i + 1 : IQUEUE_NONE;
+    }
+    queue->free_handle = queue->capacity > 0 ? 0 : IQUEUE_NONE;
+
+    int ret = queue->size;
+    queue->size = 0;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  iqueue_delete Delete the queue
+ *
+ * @Param queue IndexedQueue struct
+ * @Param destroy_node Destroy funcion
+ *
+ * @Returns   -1 is failed; other is the count of the element in the queue
+ */
+/* ----------------------------------------------------------------------------*/
+int iqueue_delete(IndexedQueue *queue, handle destroy_node)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    int ret = iqueue_clear(queue, destroy_node);
+    mem_free(queue->allocator, queue->heap);
+    mem_free(queue->allocator, queue->entries);
+    queue->heap = NULL;
+    queue->entries = NULL;
+    queue->capacity = 0;
+    queue->free_handle = IQUEUE_NONE;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  iqueue_grow Double the arrays, the new slots go to the free list
+ *
+ * @Param queue IndexedQueue struct
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int iqueue_grow(IndexedQueue *queue)
+{
+    unsigned int capacity = queue->capacity * 2;
+    if (capacity >= IQUEUE_NONE / 2 || capacity <= queue->capacity){
+	ERROR("too many elements!");
+	return -1;
+    }
+
+    unsigned int *heap = (unsigned int*)mem_realloc(queue->allocator, queue->heap, \
+	    capacity * sizeof(unsigned int));
+    if (heap == NULL){
+	ERROR("realloc error!");
+	return -1;
+    }
+    queue->heap = heap;
+
+    IndexedEntry *entries = (IndexedEntry*)mem_realloc(queue->allocator, queue->entries, \
+	    capacity * sizeof(IndexedEntry));
+    if (entries == NULL){
+	ERROR("realloc error!");
+	return -1;
+    }
+    queue->entries = entries;
+
+    unsigned int i;
+    for (i=queue->capacity; i<capacity; i++){
+	entries[i].element = NULL;
+	entries[i].position = i + 1 < capacity ? i + 1 : queue->free_handle;
+    }
+    queue->free_handle = queue->capacity;
+    queue->capacity = capacity;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  iqueue_sift_up Move the handle at a position up to its place
+ *
+ * @Param queue IndexedQueue struct
+ * @Param position The position in the heap
+ */
+/* ----------------------------------------------------------------------------*/
+static void iqueue_sift_up(IndexedQueue *queue, unsigned int position)
+{
+    unsigned int id = queue->heap[position];
+    void *element = queue->entries[id].element;
+    unsigned int parent;
+
+    while (position > 0){
+	parent = (position - 1) / queue->arity;
+	if (queue->compare(element, IQUEUE_ELEMENT(queue, parent)) >= 0)
+	    break;
+	queue->heap[position] = queue->heap[parent];
+	queue->entries[queue->heap[position]].position = position;
+	position = parent;
+    }
+    queue->heap[position] = id;
+    queue->entries[id].position = position;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  iqueue_sift_down Move the handle at a position down to its place
+ *
+ * @Param queue IndexedQueue struct
+ * @Param position The position in the heap
+ */
+/* ----------------------------------------------------------------------------*/
+static void iqueue_sift_down(IndexedQueue *queue, unsigned int position)
+{
+    unsigned int id = queue->heap[position];
+    void *element = queue->entries[id].element;
+    unsigned int child, last, least;
+
+    for (;;){
+	child = position * queue->arity + 1;
+	if (child >= queue->size)
+	    break;
+
+	last = child + queue->arity;
+	if (last > queue->size)
+	    last = queue->size;
+	least = child;
+	for (child++; child<last; child++)
+	    if (queue->compare(IQUEUE_ELEMENT(queue, child), IQUEUE_ELEMENT(queue, least)) < 0)
+		least = child;
+
+	if (queue->compare(IQUEUE_ELEMENT(queue, least), element) >= 0)
+	    break;
+	queue->heap[position] = queue->heap[least];
+	queue->entries[queue->heap[position]].position = position;
+	position = least;
+    }
+    queue->heap[position] = id;
+    queue->entries[id].position = position;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  iqueue_push Insert an element
+ *
+ * @Param queue IndexedQueue struct
+ * @Param element The element
+ *
+ * @Returns   -1 is failed; other is the handle of the element, it is valid
+ *            until the element goes out
+ */
+/* ----------------------------------------------------------------------------*/
+int iqueue_push(IndexedQueue *queue, void *element)
+{
+    if (queue == NULL || element == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    if (queue->free_handle == IQUEUE_NONE && iqueue_grow(queue) != 0)
+	return -1;
+
+    unsigned int id = queue->free_handle;
+    queue->free_handle = queue->entries[id].position;
+    queue->entries[id].element = element;
+
+    queue->heap[queue->size] = id;
+    queue->size++;
+    iqueue_sift_up(queue, queue->size - 1);
+
+    return id;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  iqueue_remove Take the element at a position out of the heap and
+ *         free its handle
+ *
+ * @Param queue IndexedQueue struct
+ * @Param position The position in the heap
+ *
+ * @Returns   the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* iqueue_remove(IndexedQueue *queue, unsigned int position)
+{
+    unsigned int id = queue->heap[position];
+    void *ret = queue->entries[id].element;
+
+    /**
+     * the last handle fills the hole, it may go either way
+     */
+    unsigned int moved;
+    queue->size--;
+    if (position < queue->size){
+	moved = queue->heap[queue->size];
+	queue->heap[position] = moved;
+	queue->entries[moved].position = position;
+	iqueue_sift_up(queue, position);
+	if (queue->entries[moved].position == position)
+	    iqueue_sift_down(queue, position);
+    }
+
+    queue->entries[id].element = NULL;
+    queue->entries[id].position = queue->free_handle;
+    queue->free_handle = id;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  iqueue_pop Take the least element out
+ *
+ * @Param queue IndexedQueue struct
+ *
+ * @Returns   NULL means failed or empty; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+void* iqueue_pop(IndexedQueue *queue)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return NULL;
+    }
+    if (IQUEUE_EMPTY(queue))
+	return NULL;
+
+    return iqueue_remove(queue, 0);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  iqueue_peek Get the least element, it stays in the queue
+ *
+ * @Param queue IndexedQueue struct
+ *
+ * @Returns   NULL means failed or empty; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+void* iqueue_peek(IndexedQueue *queue)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return NULL;
+    }
+
+    return IQUEUE_EMPTY(queue) ? NULL : IQUEUE_ELEMENT(queue, 0);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  iqueue_get Get the element of a handle
+ *
+ * @Param queue IndexedQueue struct
+ * @Param id The handle
+ *
+ * @Returns   NULL means the handle is invalid; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+void* iqueue_get(IndexedQueue *queue, int id)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return NULL;
+    }
+    if (!IQUEUE_VALID(queue, id))
+	return NULL;
+
+    return queue->entries[id].element;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  iqueue_update Move an element to its place after the user changed
+ *         its priority, it may go up or down
+ *
+ * @Param queue IndexedQueue struct
+ * @Param id The handle
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int iqueue_update(IndexedQueue *queue, int id)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+    if (!IQUEUE_VALID(queue, id)){
+	ERROR("invalid handle %d!", id);
+	return -1;
+    }
+
+    unsigned int position = queue->entries[id].position;
+    iqueue_sift_up(queue, position);
+    if (queue->entries[id].position == position)
+	iqueue_sift_down(queue, position);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  iqueue_erase Take an element out by its handle
+ *
+ * @Param queue IndexedQueue struct
+ * @Param id The handle
+ *
+ * @Returns   NULL means the handle is invalid; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+void* iqueue_erase(IndexedQueue *queue, int id)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return NULL;
+    }
+    if (!IQUEUE_VALID(queue, id)){
+	ERROR("invalid handle %d!", id);
+	return NULL;
+    }
+
+    return iqueue_remove(queue, queue->entries[id].position);
+}
@@ -0,0 +1,78 @@
+/**
+ * @file IndexedQueue.h
+ * @Brief  indexed priority queue interfaces, every element gets a handle
+ *         that finds it in the heap, so its priority can be changed and it
+ *         can be erased in O(log n)
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-26
+ */
+
+#ifndef INDEXED_QUEUE_H_
+#define INDEXED_QUEUE_H_
+
+#include "queue/PriorityQueue.h"
+
+/**
+ * Represent the slot of a handle, position is the place of the element in
+ * the heap; when the handle is free, element is NULL and position is the
+ * next free handle
+ */
+typedef struct IndexedEntry{
+    void *element;
+    unsigned int position;
+}IndexedEntry;
+
+typedef struct IndexedQueue{
+    /**
+     * the d-ary heap of handles
+     */
+    unsigned int *heap;
+    /**
+     * the slots, a handle is the index of its slot
+     */
+    IndexedEntry *entries;
+    unsigned int size;
+    unsigned int capacity;
+    /**
+     * the first free handle, IQUEUE_NONE means all the slots are used
+     */
+    unsigned int free_handle;
+    unsigned int arity;
+    compare_handle compare;
+    /**
+     * where the arrays come from, NULL means libc
+     */
+    Allocator *allocator;
+}IndexedQueue;
+
+#define IQUEUE_NONE ((unsigned int)-1)
+
+#define IQUEUE_SIZE(queue) ((queue)->size)
+#define IQUEUE_EMPTY(queue) ((queue)->size == 0)
+
+#define INDEXED_QUEUE_NULL {\
+    .heap = NULL, \
+    .entries = NULL, \
+    .size = 0, \
+    .capacity = 0, \
+    .free_handle = IQUEUE_NONE, \
+    .arity = 0, \
+    .compare = NULL, \
+    .allocator = NULL \
+}
+
+int iqueue_new(IndexedQueue *queue, unsigned int arity, compare_handle compare, \
+	Allocator *allocator);
+int iqueue_clear(IndexedQueue *queue, handle destroy_node);
+int iqueue_delete(IndexedQueue *queue, handle destroy_node);
+
+int iqueue_push(IndexedQueue *queue, void *element);
+void* iqueue_pop(IndexedQueue *queue);
+void* iqueue_peek(IndexedQueue *queue);
+
+void* iqueue_get(IndexedQueue *queue, int id);
+int iqueue_update(IndexedQueue *queue, int id);
+void* iqueue_erase(IndexedQueue *queue, int id);
+
+#endif
@@ -0,0 +1,372 @@
+/**
+ * @file MpmcQueue.c
+ * @Brief  multi producer multi consumer queue implementation, every slot has
+ *         a sequence number, so producers and consumers only race on the
+ *         positions
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-22
+ */
+#include <stdlib.h>
+
+#include "MpmcQueue.h"
+#include "util/Log.h"
+
+/**
+ * times that a blocking function tries before it sleeps
+ */
+#define MPMC_SPIN 64
+
+#define MPMC_CELL(queue, position) (&(queue)->cells[(position) & ((queue)->capacity - 1)])
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  mpmc_new Initial the queue, the capacity never changes
+ *
+ * @Param queue MpmcQueue struct
+ * @Param capacity The max number of elements, it is rounded up to power of
+ *        two and at least 2
+ * @Param allocator Where the ring comes from, NULL is libc
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int mpmc_new(MpmcQueue *queue, unsigned int capacity, Allocator *allocator)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+    if (capacity == 0){
+	ERROR("capacity is 0!");
+	return -1;
+    }
+    if (!ALLOCATOR_CHECK(allocator)){
+	ERROR("missed allocator function!");
+	return -1;
+    }
+
+    unsigned int size = 2;
+    while (size < capacity)
+	size <<= 1;
+
+    queue->cells = (MpmcCell*)mem_alloc(allocator, size * sizeof(MpmcCell));
+    if (queue->cells == NULL){
+	ERROR("malloc error!");
+	return -1;
+    }
+
+    /**
+     * every slot waits for the producer of its first turn
+     */
+    unsigned int i;
+    for (i=0; i<size; i++){
+	atomic_init(&queue->cells[i].sequence, i);
+	queue->cells[i].element = NULL;
+    }
+    queue->capacity = size;
+    queue->allocator = allocator;
+    atomic_init(&queue->tail, 0);
+    atomic_init(&queue->head, 0);
+
+    atomic_init(&queue->producers_waiting, 0);
+    atomic_init(&queue->consumers_waiting, 0);
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->not_full, NULL);
+    pthread_cond_init(&queue->not_empty, NULL);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  mpmc_clear Take all the elements out of the queue, the queue may
+ *         be used by other threads at the same time
+ *
+ * @Param queue MpmcQueue struct
+ * @Param destroy_node Destroy node function
+ *
+ * @Returns   -1 is failed; other is the count of the element that is taken
+ */
+/* ----------------------------------------------------------------------------*/
+int mpmc_clear(MpmcQueue *queue, handle destroy_node)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    int ret = 0;
+    void *element = NULL;
+    while ((element = mpmc_try_out(queue)) != NULL){
+	if (destroy_node)
+	    destroy_node(element);
+	ret++;
+    }
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  mpmc_delete Delete the queue, no thread may use it
+ *
+ * @Param queue MpmcQueue struct
+ * @Param destroy_node Destroy funcion
+ *
+ * @Returns   -1 is failed; other is the count of the element in the queue
+ */
+/* ----------------------------------------------------------------------------*/
+int mpmc_delete(MpmcQueue *queue, handle destroy_node)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    int ret = mpmc_clear(queue, destroy_node);
+    mem_free(queue->allocator, queue->cells);
+    queue->cells = NULL;
+    queue->capacity = 0;
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->not_full);
+    pthread_cond_destroy(&queue->not_empty);
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  mpmc_wake Wake the threads that sleep on a condition, if any
+ *
+ * @Param queue MpmcQueue struct
+ * @Param waiting The number of threads that sleep on the condition
+ * @Param condition The condition
+ */
+/* ----------------------------------------------------------------------------*/
+static void mpmc_wake(MpmcQueue *queue, _Atomic int *waiting, pthread_cond_t *condition)
+{
+    /**
+     * the slot is published before the waiter count is read, and a waiter
+     * counts itself before it tries again, so one of them sees the other
+     */
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(waiting, memory_order_relaxed) == 0)
+	return;
+
+    pthread_mutex_lock(&queue->lock);
+    pthread_cond_signal(condition);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  mpmc_push Fill a slot if there is a free one, nobody is woken
+ *
+ * @Param queue MpmcQueue struct
+ * @Param element The element
+ *
+ * @Returns   0 is OK; -1 means the queue is full
+ */
+/* ----------------------------------------------------------------------------*/
+static int mpmc_push(MpmcQueue *queue, void *element)
+{
+    unsigned long position = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    MpmcCell *cell = NULL;
+    long diff;
+
+    for (;;){
+	cell = MPMC_CELL(queue, position);
+	diff = (long)(atomic_load_explicit(&cell->sequence, memory_order_acquire) - position);
+	if (diff == 0){
+	    if (atomic_compare_exchange_weak_explicit(&queue->tail, &position, \
+			position + 1, memory_order_relaxed, memory_order_relaxed))
+		break;
+	}else if (diff < 0){
+	    /**
+	     * the slot still holds the element of the last turn
+	     */
+	    return -1;
+	}else{
+	    position = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+	}
+    }
+
+    cell->element = element;
+    atomic_store_explicit(&cell->sequence, position + 1, memory_order_release);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  mpmc_pop Take a slot if there is a filled one, nobody is woken
+ *
+ * @Param queue MpmcQueue struct
+ *
+ * @Returns   NULL means the queue is empty; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* mpmc_pop(MpmcQueue *queue)
+{
+    unsigned long position = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    MpmcCell *cell = NULL;
+    long diff;
+
+    for (;;){
+	cell = MPMC_CELL(queue, position);
+	diff = (long)(atomic_load_explicit(&cell->sequence, memory_order_acquire) - (position + 1));
+	if (diff == 0){
+	    if (atomic_compare_exchange_weak_explicit(&queue->head, &position, \
+			position + 1, memory_order_relaxed, memory_order_relaxed))
+		break;
+	}else if (diff < 0){
+	    /**
+	     * the producer of this turn has not filled the slot
+	     */
+	    return NULL;
+	}else{
+	    position = atomic_load_explicit(&queue->head, memory_order_relaxed);
+	}
+    }
+
+    void *ret = cell->element;
+    cell->element = NULL;
+
+    /**
+     * the slot waits for the producer of its next turn
+     */
+    atomic_store_explicit(&cell->sequence, position + queue->capacity, memory_order_release);
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  mpmc_try_in Append an element if there is a free slot
+ *
+ * @Param queue MpmcQueue struct
+ * @Param element The element
+ *
+ * @Returns   0 is OK; -1 means the queue is full
+ */
+/* ----------------------------------------------------------------------------*/
+int mpmc_try_in(MpmcQueue *queue, void *element)
+{
+    if (queue == NULL || element == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    if (mpmc_push(queue, element) != 0)
+	return -1;
+    mpmc_wake(queue, &queue->consumers_waiting, &queue->not_empty);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  mpmc_try_out Out an element if there is one
+ *
+ * @Param queue MpmcQueue struct
+ *
+ * @Returns   NULL means the queue is empty; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+void* mpmc_try_out(MpmcQueue *queue)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return NULL;
+    }
+
+    void *ret = mpmc_pop(queue);
+    if (ret != NULL)
+	mpmc_wake(queue, &queue->producers_waiting, &queue->not_full);
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  mpmc_in Append an element, wait while the queue is full
+ *
+ * @Param queue MpmcQueue struct
+ * @Param element The element
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int mpmc_in(MpmcQueue *queue, void *element)
+{
+    if (queue == NULL || element == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    int i;
+    for (i=0; i<MPMC_SPIN; i++)
+	if (mpmc_try_in(queue, element) == 0)
+	    return 0;
+
+    /**
+     * count itself before trying again, see mpmc_wake
+     */
+    pthread_mutex_lock(&queue->lock);
+    atomic_fetch_add_explicit(&queue->producers_waiting, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    while (mpmc_push(queue, element) != 0)
+	pthread_cond_wait(&queue->not_full, &queue->lock);
+    atomic_fetch_sub_explicit(&queue->producers_waiting, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&queue->lock);
+
+    mpmc_wake(queue, &queue->consumers_waiting, &queue->not_empty);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  mpmc_out Out an element, wait while the queue is empty
+ *
+ * @Param queue MpmcQueue struct
+ *
+ * @Returns   NULL is failed; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+void* mpmc_out(MpmcQueue *queue)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return NULL;
+    }
+
+    void *ret = NULL;
+    int i;
+    for (i=0; i<MPMC_SPIN; i++)
+	if ((ret = mpmc_try_out(queue)) != NULL)
+	    return ret;
+
+    pthread_mutex_lock(&queue->lock);
+    atomic_fetch_add_explicit(&queue->consumers_waiting, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    while ((ret = mpmc_pop(queue)) == NULL)
+	pthread_cond_wait(&queue->not_empty, &queue->lock);
+    atomic_fetch_sub_explicit(&queue->consumers_waiting, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&queue->lock);
+
+    mpmc_wake(queue, &queue->producers_waiting, &queue->not_full);
+
+    return ret;
+}
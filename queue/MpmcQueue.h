@@ -0,0 +1,74 @@
+/**
+ * @file MpmcQueue.h
+ * @Brief  bounded lock-free queue interfaces for many producer threads and
+ *         many consumer threads
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-22
+ */
+
+#ifndef MPMC_QUEUE_H_
+#define MPMC_QUEUE_H_
+
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "queue/Queue.h"
+
+#define MPMC_CACHE_LINE 64
+
+/**
+ * Represent a slot of the ring, its sequence tells the turn of the slot:
+ * sequence == position means a producer at the position may fill it,
+ * sequence == position + 1 means a consumer at the position may take it
+ */
+typedef struct MpmcCell{
+    _Atomic unsigned long sequence;
+    void *element;
+}MpmcCell;
+
+typedef struct MpmcQueue{
+    /**
+     * read only after mpmc_new
+     */
+    MpmcCell *cells;
+    unsigned int capacity;
+    Allocator *allocator;
+
+    /**
+     * the next position to fill, producers race on it
+     */
+    _Alignas(MPMC_CACHE_LINE) _Atomic unsigned long tail;
+    /**
+     * the next position to take, consumers race on it
+     */
+    _Alignas(MPMC_CACHE_LINE) _Atomic unsigned long head;
+
+    /**
+     * only the blocking functions use the lock, after they spin for a while
+     */
+    _Alignas(MPMC_CACHE_LINE) _Atomic int producers_waiting;
+    _Atomic int consumers_waiting;
+    pthread_mutex_t lock;
+    pthread_cond_t not_full;
+    pthread_cond_t not_empty;
+}MpmcQueue;
+
+/**
+ * exact only when no thread is working on the queue
+ */
+#define MPMC_SIZE(queue) \
+    (atomic_load_explicit(&(queue)->tail, memory_order_relaxed) \
+     - atomic_load_explicit(&(queue)->head, memory_order_relaxed))
+
+int mpmc_new(MpmcQueue *queue, unsigned int capacity, Allocator *allocator);
+int mpmc_clear(MpmcQueue *queue, handle destroy_node);
+int mpmc_delete(MpmcQueue *queue, handle destroy_node);
+
+int mpmc_try_in(MpmcQueue *queue, void *element);
+void* mpmc_try_out(MpmcQueue *queue);
+
+int mpmc_in(MpmcQueue *queue, void *element);
+void* mpmc_out(MpmcQueue *queue);
+
+#endif
@@ -0,0 +1,388 @@
+/**
+ * @file PriorityQueue.c
+ * @Brief  priority queue implementation
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-25
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "PriorityQueue.h"
+#include "util/Log.h"
+
+#define PQUEUE_DEFAULT_ARITY 4
+#define PQUEUE_DEFAULT_CAPACITY 16
+
+#define PQUEUE_PARENT(queue, i) (((i) - 1) / (queue)->arity)
+#define PQUEUE_CHILD(queue, i) ((i) * (queue)->arity + 1)
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  pqueue_new Initial the queue
+ *
+ * @Param queue PriorityQueue struct
+ * @Param arity Children of a node, if arity=0, select default(4)
+ * @Param compare Compare function, the least element goes out first
+ * @Param allocator Where the array comes from, NULL is libc
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int pqueue_new(PriorityQueue *queue, unsigned int arity, compare_handle compare, \
+	Allocator *allocator)
+{
+    if (queue == NULL || compare == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+    if (!ALLOCATOR_CHECK(allocator)){
+	ERROR("missed allocator function!");
+	return -1;
+    }
+
+    if (arity == 0)
+	arity = PQUEUE_DEFAULT_ARITY;
+    if (arity < 2){
+	ERROR("arity is less than 2!");
+	return -1;
+    }
+
+    queue->elements = (void**)mem_alloc(allocator, PQUEUE_DEFAULT_CAPACITY * sizeof(void*));
+    if (queue->elements == NULL){
+	ERROR("malloc error!");
+	return -1;
+    }
+    queue->size = 0;
+    queue->capacity = PQUEUE_DEFAULT_CAPACITY;
+    queue->arity = arity;
+    queue->compare = compare;
+    queue->allocator = allocator;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  pqueue_clear Clear the queue, the array is kept
+ *
+ * @Param queue PriorityQueue struct
+ * @Param destroy_node Destroy node function
+ *
+ * @Returns   -1 is failed; other is the count of the element in the queue
+ */
+/* ----------------------------------------------------------------------------*/
+int pqueue_clear(PriorityQueue *queue, handle destroy_node)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    unsigned int i;
+    if (destroy_node)
+	for (i=0; i<queue->size; i++)
+	    destroy_node(queue->elements[i]);
+
+    int ret = queue->size;
+    queue->size = 0;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  pqueue_delete Delete the queue
+ *
+ * @Param queue PriorityQueue struct
+ * @Param destroy_node Destroy funcion
+ *
+ * @Returns   -1 is failed; other is the count of the element in the queue
+ */
+/* ----------------------------------------------------------------------------*/
+int pqueue_delete(PriorityQueue *queue, handle destroy_node)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    int ret = pqueue_clear(queue, destroy_node);
+    mem_free(queue->allocator, queue->elements);
+    queue->elements = NULL;
+    queue->capacity = 0;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  pqueue_iterate Iterate the queue in the order of the array, not
+ *         the order of priority
+ *
+ * @Param queue PriorityQueue struct
+ * @Param handle_iteration iterate function
+ *
+ * @Returns   -1 is failed; other is the number of element in the queue
+ */
+/* ----------------------------------------------------------------------------*/
+int pqueue_iterate(PriorityQueue *queue, handle handle_iteration)
+{
+    if (queue == NULL || handle_iteration == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    unsigned int i;
+    for (i=0; i<queue->size; i++)
+	handle_iteration(queue->elements[i]);
+
+    return queue->size;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  pqueue_reserve Make the array hold at least size elements, it at
+ *         least doubles
+ *
+ * @Param queue PriorityQueue struct
+ * @Param size The number of elements
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int pqueue_reserve(PriorityQueue *queue, unsigned int size)
+{
+    if (size <= queue->capacity)
+	return 0;
+
+    unsigned int capacity = queue->capacity * 2;
+    if (capacity < size)
+	capacity = size;
+
+    void **elements = (void**)mem_realloc(queue->allocator, queue->elements, \
+	    capacity * sizeof(void*));
+    if (elements == NULL){
+	ERROR("realloc error!");
+	return -1;
+    }
+    queue->elements = elements;
+    queue->capacity = capacity;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  pqueue_sift_up Move the element at i up to its place, the
+ *         parents move down into the hole instead of swapping
+ *
+ * @Param queue PriorityQueue struct
+ * @Param i The position
+ */
+/* ----------------------------------------------------------------------------*/
+static void pqueue_sift_up(PriorityQueue *queue, unsigned int i)
+{
+    void **elements = queue->elements;
+    void *element = elements[i];
+    unsigned int parent;
+
+    while (i > 0){
+	parent = PQUEUE_PARENT(queue, i);
+	if (queue->compare(element, elements[parent]) >= 0)
+	    break;
+	elements[i] = elements[parent];
+	i = parent;
+    }
+    elements[i] = element;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  pqueue_sift_down Move the element at i down to its place
+ *
+ * @Param queue PriorityQueue struct
+ * @Param i The position
+ */
+/* ----------------------------------------------------------------------------*/
+static void pqueue_sift_down(PriorityQueue *queue, unsigned int i)
+{
+    void **elements = queue->elements;
+    void *element = elements[i];
+    unsigned int child, last, least;
+
+    for (;;){
+	child = PQUEUE_CHILD(queue, i);
+	if (child >= queue->size)
+	    break;
+
+	/**
+	 * the children are next to each other, find the least one
+	 */
+	last = child + queue->arity;
+	if (last > queue->size)
+	    last = queue->size;
+	least = child;
+	for (child++; child<last; child++)
+	    if (queue->compare(elements[child], elements[least]) < 0)
+		least = child;
+
+	if (queue->compare(elements[least], element) >= 0)
+	    break;
+	elements[i] = elements[least];
+	i = least;
+    }
+    elements[i] = element;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  pqueue_push Insert an element
+ *
+ * @Param queue PriorityQueue struct
+ * @Param element The element
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int pqueue_push(PriorityQueue *queue, void *element)
+{
+    if (queue == NULL || element == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    if (pqueue_reserve(queue, queue->size + 1) != 0)
+	return -1;
+
+    queue->elements[queue->size] = element;
+    queue->size++;
+    pqueue_sift_up(queue, queue->size - 1);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  pqueue_push_n Insert elements. When the batch is large against the
+ *         queue, the whole heap is built again in O(n) instead of sifting
+ *         every element up
+ *
+ * @Param queue PriorityQueue struct
+ * @Param elements The elements, none of them may be NULL
+ * @Param count The number of the elements
+ *
+ * @Returns   -1 is failed and nothing is inserted; other is the number of
+ *            inserted elements
+ */
+/* ----------------------------------------------------------------------------*/
+int pqueue_push_n(PriorityQueue *queue, void **elements, unsigned int count)
+{
+    if (queue == NULL || (elements == NULL && count != 0)){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    if (pqueue_reserve(queue, queue->size + count) != 0)
+	return -1;
+
+    unsigned int old = queue->size;
+    memcpy(queue->elements + old, elements, count * sizeof(void*));
+    queue->size += count;
+
+    unsigned int i;
+    if (count > old / 2){
+	for (i=queue->size/queue->arity + 1; i>0; i--)
+	    pqueue_sift_down(queue, i - 1);
+    }else{
+	for (i=old; i<queue->size; i++)
+	    pqueue_sift_up(queue, i);
+    }
+
+    return count;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  pqueue_heapify Replace the elements of the queue by an array and
+ *         build the heap in O(n)
+ *
+ * @Param queue PriorityQueue struct
+ * @Param elements The elements, none of them may be NULL
+ * @Param count The number of the elements
+ *
+ * @Returns   -1 is failed; other is the number of elements in the queue
+ */
+/* ----------------------------------------------------------------------------*/
+int pqueue_heapify(PriorityQueue *queue, void **elements, unsigned int count)
+{
+    if (queue == NULL || (elements == NULL && count != 0)){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    if (pqueue_reserve(queue, count) != 0)
+	return -1;
+
+    queue->size = 0;
+    return pqueue_push_n(queue, elements, count);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  pqueue_pop Take the least element out
+ *
+ * @Param queue PriorityQueue struct
+ *
+ * @Returns   NULL means failed or empty; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+void* pqueue_pop(PriorityQueue *queue)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return NULL;
+    }
+    if (PQUEUE_EMPTY(queue))
+	return NULL;
+
+    void *ret = queue->elements[0];
+    queue->size--;
+    if (queue->size > 0){
+	queue->elements[0] = queue->elements[queue->size];
+	pqueue_sift_down(queue, 0);
+    }
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  pqueue_peek Get the least element, it stays in the queue
+ *
+ * @Param queue PriorityQueue struct
+ *
+ * @Returns   NULL means failed or empty; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+void* pqueue_peek(PriorityQueue *queue)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return NULL;
+    }
+
+    return PQUEUE_EMPTY(queue) ? NULL : queue->elements[0];
+}
@@ -0,0 +1,61 @@
+/**
+ * @file PriorityQueue.h
+ * @Brief  priority queue interfaces, a d-ary heap in one array
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-25
+ */
+
+#ifndef PRIORITY_QUEUE_H_
+#define PRIORITY_QUEUE_H_
+
+#include "Common.h"
+#include "queue/Queue.h"
+
+typedef struct PriorityQueue{
+    /**
+     * the heap array, the children of i are [i*arity+1, i*arity+arity]
+     */
+    void **elements;
+    unsigned int size;
+    unsigned int capacity;
+    /**
+     * children of a node, a wider heap is lower and its children share
+     * cache lines
+     */
+    unsigned int arity;
+    /**
+     * the element that is before the other goes out first
+     */
+    compare_handle compare;
+    /**
+     * where the array comes from, NULL means libc
+     */
+    Allocator *allocator;
+}PriorityQueue;
+
+#define PQUEUE_SIZE(queue) ((queue)->size)
+#define PQUEUE_EMPTY(queue) ((queue)->size == 0)
+
+#define PRIORITY_QUEUE_NULL {\
+    .elements = NULL, \
+    .size = 0, \
+    .capacity = 0, \
+    .arity = 0, \
+    .compare = NULL, \
+    .allocator = NULL \
+}
+
+int pqueue_new(PriorityQueue *queue, unsigned int arity, compare_handle compare, \
+	Allocator *allocator);
+int pqueue_clear(PriorityQueue *queue, handle destroy_node);
+int pqueue_delete(PriorityQueue *queue, handle destroy_node);
+int pqueue_iterate(PriorityQueue *queue, handle handle_iteration);
+
+int pqueue_push(PriorityQueue *queue, void *element);
+int pqueue_push_n(PriorityQueue *queue, void **elements, unsigned int count);
+int pqueue_heapify(PriorityQueue *queue, void **elements, unsigned int count);
+void* pqueue_pop(PriorityQueue *queue);
+void* pqueue_peek(PriorityQueue *queue);
+
+#endif
@@ -10,6 +10,260 @@
 #include "Queue.h"
 #include "util/Log.h"
 
+/**
+ * trim the spare list when it passes the high watermark over the reserved
+ * nodes and the pinned ones
+ */
+#define QUEUE_WATERMARK(queue) {\
+    if ((queue)->spare_high != 0 && (unsigned long)QUEUE_SPARE(queue) > \
+	    (unsigned long)(queue)->reserved + (queue)->spare_high + (queue)->spare_pinned) \
+	queue_release(queue, (unsigned long)(queue)->reserved + (queue)->spare_low, \
+		(queue)->reserved); \
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  queue_sort Sort a node list in the order of the addresses
+ *
+ * @Param list The first node
+ *
+ * @Returns   the first node of the sorted list
+ */
+/* ----------------------------------------------------------------------------*/
+static QueueNode* queue_sort(QueueNode *list)
+{
+    if (list == NULL || list->next == NULL)
+	return list;
+
+    /**
+     * cut the list in the middle, sort the halves and merge them
+     */
+    QueueNode *middle = list;
+    QueueNode *fast = list->next;
+    while (fast && fast->next){
+	middle = middle->next;
+	fast = fast->next->next;
+    }
+    QueueNode *right = queue_sort(middle->next);
+    middle->next = NULL;
+    QueueNode *left = queue_sort(list);
+
+    QueueNode head;
+    QueueNode *tail = &head;
+    while (left && right){
+	if (left < right){
+	    tail->next = left;
+	    left = left->next;
+	}else{
+	    tail->next = right;
+	    right = right->next;
+	}
+	tail = tail->next;
+    }
+    tail->next = left ? left : right;
+
+    return head.next;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  queue_release Release spare nodes until at most keep are left, the
+ *         nodes created alone go first, then the blocks whose nodes are all
+ *         spare. The nodes of a block go together, so a block goes only if
+ *         at least floor nodes are still left
+ *
+ * @Param queue Queue struct
+ * @Param keep The max number of spare nodes to keep
+ * @Param floor The min number of spare nodes to keep
+ *
+ * @Returns   the number of released nodes
+ */
+/* ----------------------------------------------------------------------------*/
+static int queue_release(Queue *queue, unsigned long keep, unsigned long floor)
+{
+    unsigned long spare = QUEUE_SPARE(queue);
+    int ret = 0;
+    QueueBlock *block = NULL;
+    QueueBlock **block_link = NULL;
+    QueueNode *node = NULL;
+    QueueNode **link = NULL;
+
+    queue->spare_pinned = 0;
+    if (spare <= keep)
+	return 0;
+
+    /**
+     * without blocks every node is created alone
+     */
+    if (queue->blocks == NULL){
+	while (spare > keep){
+	    node = queue->spare;
+	    queue->spare = node->next;
+	    mem_free(queue->allocator, node);
+	    queue->node_count--;
+	    spare--;
+	    ret++;
+	}
+	return ret;
+    }
+
+    /**
+     * in the order of the addresses the nodes of a block are together, so
+     * one walk along the sorted blocks finds the block of every node
+     */
+    queue->spare = queue_sort(queue->spare);
+    for (block=queue->blocks; block; block=block->next)
+	block->idle = 0;
+    block = queue->blocks;
+    link = &queue->spare;
+    while ((node = *link) != NULL){
+	while (block && node >= block->nodes + block->count)
+	    block = block->next;
+	if (block && node >= block->nodes){
+	    block->idle++;
+	    link = &node->next;
+	}else if (spare > keep){
+	    *link = node->next;
+	    mem_free(queue->allocator, node);
+	    queue->node_count--;
+	    spare--;
+	    ret++;
+	}else{
+	    link = &node->next;
+	}
+    }
+
+    /**
+     * choose the idle blocks, the idle count of the others is cleared
+     */
+    int chosen = 0;
+    for (block=queue->blocks; block; block=block->next){
+	if (block->idle == block->count && spare > keep && spare - block->count >= floor){
+	    spare -= block->count;
+	    chosen = 1;
+	}else{
+	    block->idle = 0;
+	}
+    }
+
+    if (chosen){
+	block = queue->blocks;
+	link = &queue->spare;
+	while ((node = *link) != NULL){
+	    while (block && node >= block->nodes + block->count)
+		block = block->next;
+	    if (block && node >= block->nodes && block->idle != 0)
+		*link = node->next;
+	    else
+		link = &node->next;
+	}
+
+	block_link = &queue->blocks;
+	while ((block = *block_link) != NULL){
+	    if (block->idle == 0){
+		block_link = &block->next;
+		continue;
+	    }
+	    *block_link = block->next;
+	    queue->node_count -= block->count;
+	    ret += block->count;
+	    mem_free(queue->allocator, block);
+	}
+    }
+
+    if (spare > keep)
+	queue->spare_pinned = spare - keep;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  queue_grow Create nodes in one block and put them in the spare
+ *         list
+ *
+ * @Param queue Queue struct
+ * @Param count The number of nodes
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int queue_grow(Queue *queue, unsigned int count)
+{
+    if (count > (unsigned int)(QUEUE_MAX_NODES - queue->node_count)){
+	ERROR("too many nodes!");
+	return -1;
+    }
+
+    QueueBlock *block = (QueueBlock*)mem_alloc(queue->allocator, \
+	    sizeof(QueueBlock) + (size_t)count * sizeof(QueueNode));
+    if (block == NULL){
+	ERROR("malloc error!");
+	return -1;
+    }
+    block->count = count;
+    block->idle = 0;
+
+    QueueBlock **link = &queue->blocks;
+    while (*link && *link < block)
+	link = &(*link)->next;
+    block->next = *link;
+    *link = block;
+
+    /**
+     * link the nodes in order, so the queue walks the block forward
+     */
+    unsigned int i;
+    for (i=0; i<count; i++){
+	block->nodes[i].element = NULL;
+	block->nodes[i].next = i + 1 < count ? &block->nodes[i + 1] : queue->spare;
+    }
+    queue->spare = block->nodes;
+    queue->node_count += count;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  queue_new Initial the queue with a user's allocator
+ *
+ * @Param queue Queue struct
+ * @Param allocator Where the nodes come from, NULL is libc
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int queue_new(Queue *queue, Allocator *allocator)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+    if (!ALLOCATOR_CHECK(allocator)){
+	ERROR("missed allocator function!");
+	return -1;
+    }
+
+    queue->head = NULL;
+    queue->tail = NULL;
+    queue->spare = NULL;
+    queue->queue_size = 0;
+    queue->node_count = 0;
+    queue->blocks = NULL;
+    queue->reserved = 0;
+    queue->spare_low = 0;
+    queue->spare_high = 0;
+    queue->spare_pinned = 0;
+    queue->allocator = allocator;
+
+    return 0;
+}
+
 
 /* --------------------------------------------------------------------------*/
 /**
@@ -34,7 +288,7 @@ int queue_in(Queue *queue, void *element)
      */ 
     QueueNode *node = NULL;
     if (queue->spare == NULL){
-	node = (QueueNode*)malloc(sizeof(QueueNode));
+	node = (QueueNode*)mem_alloc(queue->allocator, sizeof(QueueNode));
 	if (node == NULL){
 	    ERROR("malloc error!");
 	    return -1;
@@ -109,6 +363,7 @@ void* queue_out(Queue *queue)
     node->element = NULL;
     node->next = queue->spare;
     queue->spare = node;
+    QUEUE_WATERMARK(queue);
 
     return ret;
 }
@@ -161,6 +416,7 @@ int queue_clear(Queue *queue, handle destroy_node)
 
     ret = ret != 0 ? ret : queue->queue_size;
     queue->queue_size = 0;
+    QUEUE_WATERMARK(queue);
 
     return ret;
 }
@@ -188,20 +444,13 @@ int queue_delete(Queue *queue, handle destroy_node)
 	queue_clear(queue, destroy_node);
 
     /**
-     * free spare list
+     * free spare list, all the nodes and the blocks are spare now
      */ 
-    QueueNode *node = queue->spare;
-    QueueNode *temp;
-    while (node){
-	temp = node;
-	node = node->next;
-	temp->next = NULL;
-	free(temp);
-    }
-
     ret = queue->node_count;
-    queue->spare = NULL;
-    queue->node_count = 0;
+    queue_release(queue, 0, 0);
+
+    queue->reserved = 0;
+    queue->spare_pinned = 0;
 
     return ret;
 }
@@ -234,3 +483,208 @@ int queue_iterate(Queue *queue, handle handle_iteration)
 
     return ret;
 }
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  queue_in_n Append elements to the queue, the first one goes in
+ *         first. All the nodes are made ready before any element goes in,
+ *         the lacking ones are created in one block that is trimmed like
+ *         the other spare nodes
+ *
+ * @Param queue Queue struct
+ * @Param elements The elements, none of them may be NULL
+ * @Param count The number of the elements, at most QUEUE_MAX_NODES
+ *
+ * @Returns   -1 is failed and nothing goes in; other is the number of
+ *            elements that go in
+ */
+/* ----------------------------------------------------------------------------*/
+int queue_in_n(Queue *queue, void **elements, unsigned int count)
+{
+    if (queue == NULL || (elements == NULL && count != 0)){
+	ERROR("Null pointer!");
+	return -1;
+    }
+    if (count == 0)
+	return 0;
+    if (count > QUEUE_MAX_NODES){
+	ERROR("count is too large!");
+	return -1;
+    }
+
+    unsigned int i;
+    for (i=0; i<count; i++){
+	if (elements[i] == NULL){
+	    ERROR("null element!");
+	    return -1;
+	}
+    }
+
+    if ((int)count > QUEUE_SPARE(queue) && queue_grow(queue, count - QUEUE_SPARE(queue)) != 0)
+	return -1;
+
+    /**
+     * fill the first count spare nodes, then cut them off the spare list
+     * and link them after the tail
+     */
+    QueueNode *first = queue->spare;
+    QueueNode *last = NULL;
+    QueueNode *node = first;
+    for (i=0; i<count; i++){
+	node->element = elements[i];
+	last = node;
+	node = node->next;
+    }
+    queue->spare = node;
+    last->next = NULL;
+
+    if (QUEUE_EMPTY(queue))
+	queue->head = first;
+    else
+	queue->tail->next = first;
+    queue->tail = last;
+    queue->queue_size += count;
+
+    return count;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  queue_out_n Out elements from the head of the queue
+ *
+ * @Param queue Queue struct
+ * @Param elements Where the elements are put, the head one first
+ * @Param count The max number of elements
+ *
+ * @Returns   -1 is failed; other is the number of elements that go out, it
+ *            is less than count when the queue runs out
+ */
+/* ----------------------------------------------------------------------------*/
+int queue_out_n(Queue *queue, void **elements, unsigned int count)
+{
+    if (queue == NULL || (elements == NULL && count != 0)){
+	ERROR("Null pointer!");
+	return -1;
+    }
+    if (count > (unsigned int)queue->queue_size)
+	count = queue->queue_size;
+    if (count == 0)
+	return 0;
+
+    QueueNode *first = queue->head;
+    QueueNode *last = NULL;
+    QueueNode *node = first;
+    unsigned int i;
+    for (i=0; i<count; i++){
+	elements[i] = node->element;
+	node->element = NULL;
+	last = node;
+	node = node->next;
+    }
+
+    /**
+     * the taken nodes go to the head of the spare list at once
+     */
+    queue->head = node;
+    if (node == NULL)
+	queue->tail = NULL;
+    last->next = queue->spare;
+    queue->spare = first;
+    queue->queue_size -= count;
+    QUEUE_WATERMARK(queue);
+
+    return count;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  queue_reserve Make the spare list hold at least count nodes, the
+ *         lacking nodes are created in one block, so a burst of queue_in
+ *         does not call malloc. The watermarks keep count spare nodes more
+ *
+ * @Param queue Queue struct
+ * @Param count The number of spare nodes, at most QUEUE_MAX_NODES
+ *
+ * @Returns   -1 is failed; other is the number of spare nodes
+ */
+/* ----------------------------------------------------------------------------*/
+int queue_reserve(Queue *queue, unsigned int count)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+    if (count > QUEUE_MAX_NODES){
+	ERROR("count is too large!");
+	return -1;
+    }
+
+    if ((int)count > QUEUE_SPARE(queue) && queue_grow(queue, count - QUEUE_SPARE(queue)) != 0)
+	return -1;
+    if (count > queue->reserved)
+	queue->reserved = count;
+
+    return QUEUE_SPARE(queue);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  queue_trim Release spare nodes until at most max_spare are left,
+ *         the reserved ones too. A block goes with all its nodes, only when
+ *         none of them is in use and max_spare nodes are still left
+ *
+ * @Param queue Queue struct
+ * @Param max_spare The max number of spare nodes to keep
+ *
+ * @Returns   -1 is failed; other is the number of released nodes
+ */
+/* ----------------------------------------------------------------------------*/
+int queue_trim(Queue *queue, unsigned int max_spare)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    if (queue->reserved > max_spare)
+	queue->reserved = max_spare;
+
+    return queue_release(queue, max_spare, max_spare);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  queue_watermark Set the policy of the spare list, when it grows
+ *         over high after elements go out, it is trimmed down to low. Both
+ *         are counted over the reserved nodes
+ *
+ * @Param queue Queue struct
+ * @Param low The number of spare nodes kept after trimming
+ * @Param high The max number of spare nodes, 0 means never trim
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int queue_watermark(Queue *queue, unsigned int low, unsigned int high)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+    if (high != 0 && low > high){
+	ERROR("low watermark is over the high one!");
+	return -1;
+    }
+
+    queue->spare_low = low;
+    queue->spare_high = high;
+    queue->spare_pinned = 0;
+    QUEUE_WATERMARK(queue);
+
+    return 0;
+}
@@ -9,11 +9,34 @@
 #ifndef QUEUE_H_
 #define QUEUE_H_
 
+#include <limits.h>
+
+#include "util/Allocator.h"
+
+/**
+ * the max number of nodes, the counts are int
+ */
+#define QUEUE_MAX_NODES INT_MAX
+
 typedef struct QueueNode{
     void *element;
     struct QueueNode *next;
 }QueueNode;
 
+/**
+ * Nodes that are created at once, the block is released when all of its
+ * nodes are spare. The blocks are linked in the order of their addresses
+ */
+typedef struct QueueBlock{
+    struct QueueBlock *next;
+    unsigned int count;
+    /**
+     * the spare nodes of the block, counted while trimming
+     */
+    unsigned int idle;
+    QueueNode nodes[];
+}QueueBlock;
+
 typedef struct Queue{
     /**
      * point the head of the queue
@@ -35,19 +58,51 @@ typedef struct Queue{
      * the number of all the node(used and unused)
      */
     int node_count;
+    /**
+     * the blocks of nodes
+     */
+    QueueBlock *blocks;
+    /**
+     * the spare nodes that queue_reserve asks for, the watermarks are
+     * over them
+     */
+    unsigned int reserved;
+    /**
+     * when the spare list grows over spare_high, it is trimmed down to
+     * spare_low, spare_high == 0 means never
+     */
+    unsigned int spare_low;
+    unsigned int spare_high;
+    /**
+     * the spare nodes that the last trim could not release, their blocks
+     * are in use; the next trim waits until the list grows over them
+     */
+    unsigned int spare_pinned;
+    /**
+     * where the nodes come from, NULL means libc
+     */
+    Allocator *allocator;
 }Queue;
 
 #define QUEUE_EMPTY(queue) (queue->head == NULL)
+#define QUEUE_SPARE(queue) ((queue)->node_count - (queue)->queue_size)
 #define QUEUE_INIT {\
     .head = NULL, \
     .tail = NULL, \
     .spare = NULL, \
     .queue_size = 0, \
-    .node_count = 0 \
+    .node_count = 0, \
+    .blocks = NULL, \
+    .reserved = 0, \
+    .spare_low = 0, \
+    .spare_high = 0, \
+    .spare_pinned = 0, \
+    .allocator = NULL \
 }
 
 typedef void (*handle)(void *element);
 
+int queue_new(Queue *queue, Allocator *allocator);
 int queue_clear(Queue *queue, handle destroy_node);
 int queue_delete(Queue *queue, handle destroy_node);
 int queue_iterate(Queue *queue, handle handle_iteration);
@@ -55,4 +110,11 @@ int queue_iterate(Queue *queue, handle handle_iteration);
 int queue_in(Queue *queue, void *element);
 void* queue_out(Queue *queue);
 
+int queue_in_n(Queue *queue, void **elements, unsigned int count);
+int queue_out_n(Queue *queue, void **elements, unsigned int count);
+
+int queue_reserve(Queue *queue, unsigned int count);
+int queue_trim(Queue *queue, unsigned int max_spare);
+int queue_watermark(Queue *queue, unsigned int low, unsigned int high);
+
 #endif
@@ -0,0 +1,246 @@
+/**
+ * @file RingQueue.c
+ * @Brief  ring buffer queue implementation
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-20
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "RingQueue.h"
+#include "util/Log.h"
+
+#define RQUEUE_DEFAULT_CAPACITY 16
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rqueue_new Initial the queue
+ *
+ * @Param queue RingQueue struct
+ * @Param capacity The first capacity, it is rounded up to power of two, if
+ *        capacity=0, select default(16); at most RQUEUE_MAX_CAPACITY
+ * @Param allocator Where the array comes from, NULL is libc
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int rqueue_new(RingQueue *queue, unsigned int capacity, Allocator *allocator)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+    if (!ALLOCATOR_CHECK(allocator)){
+	ERROR("missed allocator function!");
+	return -1;
+    }
+
+    if (capacity > RQUEUE_MAX_CAPACITY){
+	ERROR("capacity is too large!");
+	return -1;
+    }
+
+    if (capacity == 0)
+	capacity = RQUEUE_DEFAULT_CAPACITY;
+    unsigned int size = 1;
+    while (size < capacity)
+	size <<= 1;
+
+    queue->elements = (void**)mem_alloc(allocator, size * sizeof(void*));
+    if (queue->elements == NULL){
+	ERROR("malloc error!");
+	return -1;
+    }
+    queue->capacity = size;
+    queue->head = 0;
+    queue->tail = 0;
+    queue->allocator = allocator;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rqueue_grow Double the array, the elements are moved to the front
+ *         of the new array in order
+ *
+ * @Param queue RingQueue struct
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int rqueue_grow(RingQueue *queue)
+{
+    if (queue->capacity >= RQUEUE_MAX_CAPACITY){
+	ERROR("queue is too large!");
+	return -1;
+    }
+
+    unsigned int capacity = queue->capacity * 2;
+    void **elements = (void**)mem_alloc(queue->allocator, capacity * sizeof(void*));
+    if (elements == NULL){
+	ERROR("malloc error!");
+	return -1;
+    }
+
+    /**
+     * the queue is full, so it is the part from the head to the end of the
+     * array and the part from the start of the array
+     */
+    unsigned int size = RQUEUE_SIZE(queue);
+    unsigned int start = queue->head & (queue->capacity - 1);
+    unsigned int first = queue->capacity - start;
+    memcpy(elements, queue->elements + start, first * sizeof(void*));
+    memcpy(elements + first, queue->elements, (size - first) * sizeof(void*));
+
+    mem_free(queue->allocator, queue->elements);
+    queue->elements = elements;
+    queue->capacity = capacity;
+    queue->head = 0;
+    queue->tail = size;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rqueue_in Append an element to the queue, a full queue doubles
+ *
+ * @Param queue RingQueue struct
+ * @Param element The element
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int rqueue_in(RingQueue *queue, void *element)
+{
+    if (queue == NULL || element == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    if (RQUEUE_FULL(queue)){
+	if (rqueue_grow(queue) != 0)
+	    return -1;
+    }
+    RQUEUE_SLOT(queue, queue->tail) = element;
+    queue->tail++;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rqueue_out Out an element from the head of the queue
+ *
+ * @Param queue RingQueue struct
+ *
+ * @Returns   NULL is failed; other is the address of element
+ */
+/* ----------------------------------------------------------------------------*/
+void* rqueue_out(RingQueue *queue)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return NULL;
+    }
+
+    if (RQUEUE_EMPTY(queue)){
+	INFO("Queue is empty!");
+	return NULL;
+    }
+
+    void *ret = RQUEUE_SLOT(queue, queue->head);
+    queue->head++;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rqueue_clear Clear the queue, the array is kept
+ *
+ * @Param queue RingQueue struct
+ * @Param destroy_node Destroy node function
+ *
+ * @Returns   -1 is failed; other is the count of the element in the queue
+ */
+/* ----------------------------------------------------------------------------*/
+int rqueue_clear(RingQueue *queue, handle destroy_node)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    int ret = RQUEUE_SIZE(queue);
+    unsigned int i;
+    if (destroy_node)
+	for (i=queue->head; i!=queue->tail; i++)
+	    destroy_node(RQUEUE_SLOT(queue, i));
+
+    queue->head = 0;
+    queue->tail = 0;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rqueue_delete Delete the queue
+ *
+ * @Param queue RingQueue struct
+ * @Param destroy_node Destroy funcion
+ *
+ * @Returns   -1 is failed; other is the count of the element in the queue
+ */
+/* ----------------------------------------------------------------------------*/
+int rqueue_delete(RingQueue *queue, handle destroy_node)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    int ret = rqueue_clear(queue, destroy_node);
+    mem_free(queue->allocator, queue->elements);
+    queue->elements = NULL;
+    queue->capacity = 0;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rqueue_iterate Iterate the queue from the head
+ *
+ * @Param queue RingQueue struct
+ * @Param handle_iteration iterate function
+ *
+ * @Returns   -1 is failed; other is the number of element in the queue
+ */
+/* ----------------------------------------------------------------------------*/
+int rqueue_iterate(RingQueue *queue, handle handle_iteration)
+{
+    if (queue == NULL || handle_iteration == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    int ret = 0;
+    unsigned int i;
+    for (i=queue->head; i!=queue->tail; i++){
+	handle_iteration(RQUEUE_SLOT(queue, i));
+	ret++;
+    }
+
+    return ret;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file RingQueue.h
+ * @Brief  ring buffer queue interfaces, the elements are kept in one array
+ *         whose capacity is power of two
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-20
+ */
+
+#ifndef RING_QUEUE_H_
+#define RING_QUEUE_H_
+
+#include "queue/Queue.h"
+
+/**
+ * the capacity is a power of two that an unsigned int holds, and tail - head
+ * must still tell a full queue from an empty one
+ */
+#define RQUEUE_MAX_CAPACITY (1U << 31)
+
+typedef struct RingQueue{
+    /**
+     * the ring array
+     */
+    void **elements;
+    /**
+     * size of the array, always power of two
+     */
+    unsigned int capacity;
+    /**
+     * head and tail only increase, the slot is the counter & (capacity-1),
+     * and tail - head is the size even after they wrap around
+     */
+    unsigned int head;
+    unsigned int tail;
+    /**
+     * where the array comes from, NULL means libc
+     */
+    Allocator *allocator;
+}RingQueue;
+
+#define RQUEUE_SIZE(queue) ((queue)->tail - (queue)->head)
+#define RQUEUE_EMPTY(queue) ((queue)->tail == (queue)->head)
+#define RQUEUE_FULL(queue) (RQUEUE_SIZE(queue) == (queue)->capacity)
+#define RQUEUE_SLOT(queue, counter) ((queue)->elements[(counter) & ((queue)->capacity - 1)])
+
+#define RING_QUEUE_NULL {\
+    .elements = NULL, \
+    .capacity = 0, \
+    .head = 0, \
+    .tail = 0, \
+    .allocator = NULL \
+}
+
+int rqueue_new(RingQueue *queue, unsigned int capacity, Allocator *allocator);
+int rqueue_clear(RingQueue *queue, handle destroy_node);
+int rqueue_delete(RingQueue *queue, handle destroy_node);
+int rqueue_iterate(RingQueue *queue, handle handle_iteration);
+
+int rqueue_in(RingQueue *queue, void *element);
+void* rqueue_out(RingQueue *queue);
+
+#endif
@@ -0,0 +1,265 @@
+/**
+ * @file SpscQueue.c
+ * @Brief  single producer single consumer queue implementation
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-21
+ */
+#include <stdlib.h>
+
+#include "SpscQueue.h"
+#include "util/Log.h"
+
+#define SPSC_SLOT(queue, counter) ((queue)->elements[(counter) & ((queue)->capacity - 1)])
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  spsc_new Initial the queue, the capacity never changes
+ *
+ * @Param queue SpscQueue struct
+ * @Param capacity The max number of elements, it is rounded up to power of
+ *        two
+ * @Param allocator Where the ring comes from, NULL is libc
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int spsc_new(SpscQueue *queue, unsigned int capacity, Allocator *allocator)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+    if (capacity == 0){
+	ERROR("capacity is 0!");
+	return -1;
+    }
+    if (!ALLOCATOR_CHECK(allocator)){
+	ERROR("missed allocator function!");
+	return -1;
+    }
+
+    unsigned int size = 1;
+    while (size < capacity)
+	size <<= 1;
+
+    queue->elements = (void**)mem_alloc(allocator, size * sizeof(void*));
+    if (queue->elements == NULL){
+	ERROR("malloc error!");
+	return -1;
+    }
+    queue->capacity = size;
+    queue->allocator = allocator;
+    atomic_init(&queue->tail, 0);
+    atomic_init(&queue->head, 0);
+    queue->head_cache = 0;
+    queue->tail_cache = 0;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  spsc_delete Delete the queue, both threads must have stopped
+ *
+ * @Param queue SpscQueue struct
+ * @Param destroy_node Destroy funcion
+ *
+ * @Returns   -1 is failed; other is the count of the element in the queue
+ */
+/* ----------------------------------------------------------------------------*/
+int spsc_delete(SpscQueue *queue, handle destroy_node)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    unsigned int head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    unsigned int i;
+    if (destroy_node)
+	for (i=head; i!=tail; i++)
+	    destroy_node(SPSC_SLOT(queue, i));
+
+    mem_free(queue->allocator, queue->elements);
+    queue->elements = NULL;
+    queue->capacity = 0;
+
+    return tail - head;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  spsc_room The number of free slots that the producer sees, the
+ *         consumer's head is read only when the cached one is not enough
+ *
+ * @Param queue SpscQueue struct
+ * @Param tail The producer's tail
+ * @Param want The number of slots that the producer wants
+ *
+ * @Returns   the number of free slots
+ */
+/* ----------------------------------------------------------------------------*/
+static inline unsigned int spsc_room(SpscQueue *queue, unsigned int tail, unsigned int want)
+{
+    unsigned int room = queue->capacity - (tail - queue->head_cache);
+
+    if (room < want){
+	queue->head_cache = atomic_load_explicit(&queue->head, memory_order_acquire);
+	room = queue->capacity - (tail - queue->head_cache);
+    }
+
+    return room;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  spsc_ready The number of elements that the consumer sees, the
+ *         producer's tail is read only when the cached one is not enough
+ *
+ * @Param queue SpscQueue struct
+ * @Param head The consumer's head
+ * @Param want The number of elements that the consumer wants
+ *
+ * @Returns   the number of elements
+ */
+/* ----------------------------------------------------------------------------*/
+static inline unsigned int spsc_ready(SpscQueue *queue, unsigned int head, unsigned int want)
+{
+    unsigned int ready = queue->tail_cache - head;
+
+    if (ready < want){
+	queue->tail_cache = atomic_load_explicit(&queue->tail, memory_order_acquire);
+	ready = queue->tail_cache - head;
+    }
+
+    return ready;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  spsc_in Append an element, only the producer thread calls it
+ *
+ * @Param queue SpscQueue struct
+ * @Param element The element
+ *
+ * @Returns   0 is OK; -1 means the queue is full
+ */
+/* ----------------------------------------------------------------------------*/
+int spsc_in(SpscQueue *queue, void *element)
+{
+    if (queue == NULL || element == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    if (spsc_room(queue, tail, 1) == 0)
+	return -1;
+
+    SPSC_SLOT(queue, tail) = element;
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  spsc_in_n Append several elements and publish them together, only
+ *         the producer thread calls it
+ *
+ * @Param queue SpscQueue struct
+ * @Param elements The elements
+ * @Param count The number of elements
+ *
+ * @Returns   the number of elements that are appended, it may be less than
+ *            count when the queue is full
+ */
+/* ----------------------------------------------------------------------------*/
+unsigned int spsc_in_n(SpscQueue *queue, void **elements, unsigned int count)
+{
+    if (queue == NULL || elements == NULL){
+	ERROR("Null pointer!");
+	return 0;
+    }
+
+    unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    unsigned int room = spsc_room(queue, tail, count);
+    if (count > room)
+	count = room;
+
+    unsigned int i;
+    for (i=0; i<count; i++)
+	SPSC_SLOT(queue, tail + i) = elements[i];
+    atomic_store_explicit(&queue->tail, tail + count, memory_order_release);
+
+    return count;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  spsc_out Out an element from the head, only the consumer thread
+ *         calls it
+ *
+ * @Param queue SpscQueue struct
+ *
+ * @Returns   NULL means the queue is empty; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+void* spsc_out(SpscQueue *queue)
+{
+    if (queue == NULL){
+	ERROR("Null pointer!");
+	return NULL;
+    }
+
+    unsigned int head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    if (spsc_ready(queue, head, 1) == 0)
+	return NULL;
+
+    void *ret = SPSC_SLOT(queue, head);
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  spsc_out_n Out several elements and release their slots together,
+ *         only the consumer thread calls it
+ *
+ * @Param queue SpscQueue struct
+ * @Param elements Return the elements
+ * @Param count The max number of elements
+ *
+ * @Returns   the number of elements that are taken
+ */
+/* ----------------------------------------------------------------------------*/
+unsigned int spsc_out_n(SpscQueue *queue, void **elements, unsigned int count)
+{
+    if (queue == NULL || elements == NULL){
+	ERROR("Null pointer!");
+	return 0;
+    }
+
+    unsigned int head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    unsigned int ready = spsc_ready(queue, head, count);
+    if (count > ready)
+	count = ready;
+
+    unsigned int i;
+    for (i=0; i<count; i++)
+	elements[i] = SPSC_SLOT(queue, head + i);
+    atomic_store_explicit(&queue->head, head + count, memory_order_release);
+
+    return count;
+}
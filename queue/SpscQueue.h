@@ -0,0 +1,68 @@
+/**
+ * @file SpscQueue.h
+ * @Brief  bounded lock-free queue interfaces for one producer thread and one
+ *         consumer thread
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-21
+ */
+
+#ifndef SPSC_QUEUE_H_
+#define SPSC_QUEUE_H_
+
+#include <stdatomic.h>
+
+#include "queue/Queue.h"
+
+#define SPSC_CACHE_LINE 64
+
+/**
+ * Represent a single producer single consumer ring. The producer only writes
+ * tail and the consumer only writes head, each one lives in its own cache
+ * line with a private copy of the other index, so the other line is read
+ * only when the copy says the ring is full or empty.
+ */
+typedef struct SpscQueue{
+    /**
+     * read only after spsc_new
+     */
+    void **elements;
+    unsigned int capacity;
+    Allocator *allocator;
+
+    /**
+     * producer's line
+     */
+    _Alignas(SPSC_CACHE_LINE) _Atomic unsigned int tail;
+    unsigned int head_cache;
+
+    /**
+     * consumer's line
+     */
+    _Alignas(SPSC_CACHE_LINE) _Atomic unsigned int head;
+    unsigned int tail_cache;
+}SpscQueue;
+
+/**
+ * exact only when neither thread is working on the queue
+ */
+#define SPSC_SIZE(queue) \
+    (atomic_load_explicit(&(queue)->tail, memory_order_relaxed) \
+     - atomic_load_explicit(&(queue)->head, memory_order_relaxed))
+
+int spsc_new(SpscQueue *queue, unsigned int capacity, Allocator *allocator);
+int spsc_delete(SpscQueue *queue, handle destroy_node);
+
+/**
+ * producer only
+ */
+int spsc_in(SpscQueue *queue, void *element);
+unsigned int spsc_in_n(SpscQueue *queue, void **elements, unsigned int count);
+
+/**
+ * consumer only
+ */
+void* spsc_out(SpscQueue *queue);
+unsigned int spsc_out_n(SpscQueue *queue, void **elements, unsigned int count);
+
+#endif
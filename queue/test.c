@@ -11,6 +11,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <pthread.h>
+#include <sched.h>
 /**
  * Cunit headers
  */ 
@@ -23,6 +25,13 @@
  * Test file headers
  */ 
 #include "queue/Queue.h"
+#include "queue/RingQueue.h"
+#include "queue/SpscQueue.h"
+#include "queue/MpmcQueue.h"
+#include "queue/ConcurrentQueue.h"
+#include "queue/BlockingQueue.h"
+#include "queue/PriorityQueue.h"
+#include "queue/IndexedQueue.h"
 #include "util/Log.h"
 
 
@@ -46,6 +55,37 @@ void destroy_node(void *person)
     free(p);
 }
 
+/**
+ * allocator that counts the live blocks and all the allocations
+ */
+int live_blocks = 0;
+int allocations = 0;
+
+void* count_alloc(void *context, size_t size)
+{
+    (*(int*)context)++;
+    allocations++;
+    return malloc(size);
+}
+
+void* count_realloc(void *context, void *address, size_t size)
+{
+    return realloc(address, size);
+}
+
+void count_free(void *context, void *address)
+{
+    (*(int*)context)--;
+    free(address);
+}
+
+Allocator counter = {
+    .alloc = count_alloc,
+    .realloc = count_realloc,
+    .free = count_free,
+    .context = &live_blocks
+};
+
 void display_node(void *person)
 { 
     Person *p = (Person*)person;
@@ -116,6 +156,831 @@ void test_queue_delete()
     CU_ASSERT_EQUAL_FATAL(queue.node_count, 0);
 }
 
+void test_queue_allocator()
+{
+    Queue temp = QUEUE_INIT;
+    CU_ASSERT_EQUAL_FATAL(queue_new(&temp, &counter), 0);
+    CU_ASSERT_EQUAL_FATAL(queue_in(&temp, &temp), 0);
+    CU_ASSERT_EQUAL_FATAL(queue_in(&temp, &temp), 0);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 2);
+    CU_ASSERT_PTR_EQUAL_FATAL(queue_out(&temp), &temp);
+    CU_ASSERT_EQUAL_FATAL(queue_delete(&temp, NULL), 2);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 0);
+}
+
+void test_queue_n()
+{
+    Queue temp = QUEUE_INIT;
+    int values[8];
+    void *in[8], *out[8];
+    int i;
+
+    for (i=0; i<8; i++)
+	in[i] = &values[i];
+    CU_ASSERT_EQUAL_FATAL(queue_new(&temp, &counter), 0);
+    CU_ASSERT_EQUAL_FATAL(queue_out_n(&temp, out, 8), 0);
+
+    /**
+     * the nodes are created once in a block, then come from the spare list
+     */
+    allocations = 0;
+    CU_ASSERT_EQUAL_FATAL(queue_in(&temp, in[0]), 0);
+    CU_ASSERT_EQUAL_FATAL(queue_in_n(&temp, in + 1, 5), 5);
+    in[7] = NULL;
+    CU_ASSERT_EQUAL_FATAL(queue_in_n(&temp, in + 6, 2), -1);
+    CU_ASSERT_EQUAL_FATAL(temp.queue_size, 6);
+    in[7] = &values[7];
+    CU_ASSERT_EQUAL_FATAL(temp.queue_size, 6);
+    CU_ASSERT_EQUAL_FATAL(allocations, 2);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 2);
+    CU_ASSERT_EQUAL_FATAL(queue_out_n(&temp, out, 4), 4);
+    for (i=0; i<4; i++)
+	CU_ASSERT_PTR_EQUAL_FATAL(out[i], in[i]);
+    CU_ASSERT_EQUAL_FATAL(queue_in_n(&temp, in + 6, 2), 2);
+    CU_ASSERT_EQUAL_FATAL(temp.node_count, 6);
+    CU_ASSERT_EQUAL_FATAL(allocations, 2);
+    CU_ASSERT_EQUAL_FATAL(queue_in_n(&temp, in, 3), 3);
+    CU_ASSERT_EQUAL_FATAL(temp.node_count, 7);
+    CU_ASSERT_EQUAL_FATAL(allocations, 3);
+
+    CU_ASSERT_EQUAL_FATAL(queue_out_n(&temp, out, 8), 7);
+    for (i=0; i<4; i++)
+	CU_ASSERT_PTR_EQUAL_FATAL(out[i], in[i + 4]);
+    for (i=0; i<3; i++)
+	CU_ASSERT_PTR_EQUAL_FATAL(out[i + 4], in[i]);
+    CU_ASSERT_PTR_EQUAL_FATAL(temp.tail, NULL);
+
+    CU_ASSERT_EQUAL_FATAL(queue_in_n(&temp, in, 1), 1);
+    CU_ASSERT_PTR_EQUAL_FATAL(queue_out(&temp), in[0]);
+    CU_ASSERT_EQUAL_FATAL(temp.reserved, 0);
+    CU_ASSERT_EQUAL_FATAL(queue_in_n(&temp, in, (unsigned int)QUEUE_MAX_NODES + 1), -1);
+    CU_ASSERT_EQUAL_FATAL(queue_delete(&temp, NULL), 7);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 0);
+}
+
+void test_queue_n_trim()
+{
+    Queue temp = QUEUE_INIT;
+    void **elements = (void**)malloc(100000 * sizeof(void*));
+    int i;
+
+    for (i=0; i<100000; i++)
+	elements[i] = &temp;
+    CU_ASSERT_EQUAL_FATAL(queue_new(&temp, &counter), 0);
+
+    /**
+     * the nodes of a burst are not pinned, a trim releases their block
+     */
+    allocations = 0;
+    CU_ASSERT_EQUAL_FATAL(queue_in_n(&temp, elements, 100000), 100000);
+    CU_ASSERT_EQUAL_FATAL(allocations, 1);
+    CU_ASSERT_EQUAL_FATAL(queue_out_n(&temp, elements, 100000), 100000);
+    CU_ASSERT_EQUAL_FATAL(temp.node_count, 100000);
+    CU_ASSERT_EQUAL_FATAL(queue_trim(&temp, 0), 100000);
+    CU_ASSERT_EQUAL_FATAL(temp.node_count, 0);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 0);
+
+    /**
+     * and so does the watermark once the burst is drained
+     */
+    CU_ASSERT_EQUAL_FATAL(queue_watermark(&temp, 16, 64), 0);
+    CU_ASSERT_EQUAL_FATAL(queue_in_n(&temp, elements, 100000), 100000);
+    CU_ASSERT_EQUAL_FATAL(queue_out_n(&temp, elements, 50000), 50000);
+    CU_ASSERT_EQUAL_FATAL(temp.node_count, 100000);
+    CU_ASSERT_EQUAL_FATAL(queue_out_n(&temp, elements, 50000), 50000);
+    CU_ASSERT_EQUAL_FATAL(queue_trim(&temp, 0), 0);
+    CU_ASSERT_EQUAL_FATAL(temp.node_count, 0);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 0);
+
+    CU_ASSERT_EQUAL_FATAL(queue_delete(&temp, NULL), 0);
+    free(elements);
+}
+
+void test_queue_spare()
+{
+    Queue temp = QUEUE_INIT;
+    int values[8];
+    void *out[8];
+    int i;
+
+    CU_ASSERT_EQUAL_FATAL(queue_new(&temp, &counter), 0);
+    CU_ASSERT_EQUAL_FATAL(queue_reserve(&temp, 4), 4);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 1);
+    CU_ASSERT_EQUAL_FATAL(queue_reserve(&temp, 2), 4);
+    CU_ASSERT_EQUAL_FATAL(queue_reserve(&temp, (unsigned int)QUEUE_MAX_NODES + 1), -1);
+
+    /**
+     * the nodes created alone are trimmed first
+     */
+    for (i=0; i<8; i++)
+	CU_ASSERT_EQUAL_FATAL(queue_in(&temp, &values[i]), 0);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 5);
+    CU_ASSERT_EQUAL_FATAL(queue_out_n(&temp, out, 8), 8);
+    CU_ASSERT_EQUAL_FATAL(QUEUE_SPARE(&temp), 8);
+    CU_ASSERT_EQUAL_FATAL(queue_trim(&temp, 4), 4);
+    CU_ASSERT_EQUAL_FATAL(QUEUE_SPARE(&temp), 4);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 1);
+
+    /**
+     * past the high watermark the spare list goes down to the low one,
+     * both are over the reserved nodes
+     */
+    CU_ASSERT_EQUAL_FATAL(queue_watermark(&temp, 6, 4), -1);
+    CU_ASSERT_EQUAL_FATAL(queue_watermark(&temp, 1, 2), 0);
+    for (i=0; i<8; i++)
+	CU_ASSERT_EQUAL_FATAL(queue_in(&temp, &values[i]), 0);
+    for (i=0; i<6; i++)
+	CU_ASSERT_PTR_EQUAL_FATAL(queue_out(&temp), &values[i]);
+    CU_ASSERT_EQUAL_FATAL(QUEUE_SPARE(&temp), 6);
+    CU_ASSERT_PTR_EQUAL_FATAL(queue_out(&temp), &values[6]);
+    CU_ASSERT_EQUAL_FATAL(QUEUE_SPARE(&temp), 5);
+    CU_ASSERT_EQUAL_FATAL(temp.node_count, 6);
+
+    /**
+     * an explicit trim releases the reserved block too
+     */
+    CU_ASSERT_PTR_EQUAL_FATAL(queue_out(&temp), &values[7]);
+    CU_ASSERT_EQUAL_FATAL(queue_trim(&temp, 0), 6);
+    CU_ASSERT_EQUAL_FATAL(temp.node_count, 0);
+    CU_ASSERT_EQUAL_FATAL(temp.reserved, 0);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 0);
+
+    CU_ASSERT_EQUAL_FATAL(queue_delete(&temp, NULL), 0);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 0);
+}
+
+void test_queue_reserve_watermark()
+{
+    Queue temp = QUEUE_INIT;
+    int values[64];
+    void *out[64];
+    int i, round;
+
+    /**
+     * far more reserved nodes than the high watermark
+     */
+    CU_ASSERT_EQUAL_FATAL(queue_new(&temp, &counter), 0);
+    CU_ASSERT_EQUAL_FATAL(queue_watermark(&temp, 2, 4), 0);
+    CU_ASSERT_EQUAL_FATAL(queue_reserve(&temp, 64), 64);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 1);
+
+    /**
+     * the reserved nodes come back without any trim
+     */
+    for (round=0; round<3; round++){
+	for (i=0; i<64; i++)
+	    CU_ASSERT_EQUAL_FATAL(queue_in(&temp, &values[i]), 0);
+	for (i=0; i<32; i++)
+	    CU_ASSERT_PTR_EQUAL_FATAL(queue_out(&temp), &values[i]);
+	CU_ASSERT_EQUAL_FATAL(queue_out_n(&temp, out, 64), 32);
+	CU_ASSERT_EQUAL_FATAL(QUEUE_SPARE(&temp), 64);
+	CU_ASSERT_EQUAL_FATAL(temp.spare_pinned, 0);
+	CU_ASSERT_EQUAL_FATAL(live_blocks, 1);
+    }
+
+    /**
+     * only the nodes over the reserved ones are trimmed
+     */
+    for (i=0; i<64; i++)
+	CU_ASSERT_EQUAL_FATAL(queue_in(&temp, &values[i]), 0);
+    for (i=0; i<8; i++)
+	CU_ASSERT_EQUAL_FATAL(queue_in(&temp, &values[i]), 0);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 9);
+    CU_ASSERT_EQUAL_FATAL(queue_clear(&temp, NULL), 72);
+    CU_ASSERT_EQUAL_FATAL(QUEUE_SPARE(&temp), 66);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 3);
+    CU_ASSERT_EQUAL_FATAL(queue_trim(&temp, 65), 1);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 2);
+    CU_ASSERT_EQUAL_FATAL(queue_trim(&temp, 0), 65);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 0);
+
+    CU_ASSERT_EQUAL_FATAL(queue_delete(&temp, NULL), 0);
+}
+
+void test_queue_trim_block()
+{
+    Queue temp = QUEUE_INIT;
+    int values[16];
+    int i;
+
+    CU_ASSERT_EQUAL_FATAL(queue_new(&temp, &counter), 0);
+    CU_ASSERT_EQUAL_FATAL(queue_reserve(&temp, 16), 16);
+    for (i=0; i<16; i++)
+	CU_ASSERT_EQUAL_FATAL(queue_in(&temp, &values[i]), 0);
+    CU_ASSERT_EQUAL_FATAL(queue_trim(&temp, 0), 0);
+    CU_ASSERT_EQUAL_FATAL(queue_watermark(&temp, 0, 4), 0);
+
+    /**
+     * the block is in use, the nodes that a trim can not release wait
+     * until the spare list grows high over them again
+     */
+    for (i=0; i<5; i++)
+	CU_ASSERT_PTR_EQUAL_FATAL(queue_out(&temp), &values[i]);
+    CU_ASSERT_EQUAL_FATAL(temp.spare_pinned, 5);
+    for (; i<9; i++)
+	CU_ASSERT_PTR_EQUAL_FATAL(queue_out(&temp), &values[i]);
+    CU_ASSERT_EQUAL_FATAL(temp.spare_pinned, 5);
+    CU_ASSERT_PTR_EQUAL_FATAL(queue_out(&temp), &values[i]);
+    CU_ASSERT_EQUAL_FATAL(temp.spare_pinned, 10);
+
+    /**
+     * the block goes once all its nodes are spare
+     */
+    for (i=10; i<15; i++)
+	CU_ASSERT_PTR_EQUAL_FATAL(queue_out(&temp), &values[i]);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 1);
+    CU_ASSERT_PTR_EQUAL_FATAL(queue_out(&temp), &values[15]);
+    CU_ASSERT_EQUAL_FATAL(queue_trim(&temp, 0), 16);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 0);
+    CU_ASSERT_PTR_EQUAL_FATAL(temp.blocks, NULL);
+
+    CU_ASSERT_EQUAL_FATAL(queue_delete(&temp, NULL), 0);
+}
+
+int visited = 0;
+
+void count_node(void *element)
+{
+    CU_ASSERT_EQUAL(*(int*)element, visited);
+    visited++;
+}
+
+void test_rqueue()
+{
+    RingQueue temp = RING_QUEUE_NULL;
+    int values[40];
+    int i;
+
+    CU_ASSERT_EQUAL_FATAL(rqueue_new(&temp, 3, &counter), 0);
+    CU_ASSERT_EQUAL_FATAL(temp.capacity, 4);
+    CU_ASSERT_PTR_EQUAL_FATAL(rqueue_out(&temp), NULL);
+    for (i=0; i<40; i++)
+	values[i] = i;
+
+    /**
+     * move the head, so that the queue wraps around before it grows
+     */
+    for (i=0; i<3; i++){
+	CU_ASSERT_EQUAL_FATAL(rqueue_in(&temp, &values[i]), 0);
+	CU_ASSERT_PTR_EQUAL_FATAL(rqueue_out(&temp), &values[i]);
+    }
+    for (i=0; i<40; i++)
+	CU_ASSERT_EQUAL_FATAL(rqueue_in(&temp, &values[i]), 0);
+    CU_ASSERT_EQUAL_FATAL(RQUEUE_SIZE(&temp), 40);
+    CU_ASSERT_EQUAL_FATAL(temp.capacity, 64);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 1);
+
+    visited = 0;
+    CU_ASSERT_EQUAL_FATAL(rqueue_iterate(&temp, count_node), 40);
+    for (i=0; i<20; i++)
+	CU_ASSERT_PTR_EQUAL_FATAL(rqueue_out(&temp), &values[i]);
+    CU_ASSERT_EQUAL_FATAL(rqueue_clear(&temp, NULL), 20);
+    CU_ASSERT_EQUAL_FATAL(RQUEUE_EMPTY(&temp), 1);
+
+    CU_ASSERT_EQUAL_FATAL(rqueue_in(&temp, &values[0]), 0);
+    CU_ASSERT_EQUAL_FATAL(rqueue_delete(&temp, NULL), 1);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 0);
+}
+
+/**
+ * the counters wrap around the unsigned range
+ */
+void test_rqueue_wrap()
+{
+    RingQueue temp = RING_QUEUE_NULL;
+    int values[8];
+    int i;
+
+    CU_ASSERT_EQUAL_FATAL(rqueue_new(&temp, 4, NULL), 0);
+    temp.head = temp.tail = (unsigned int)-2;
+    for (i=0; i<8; i++)
+	CU_ASSERT_EQUAL_FATAL(rqueue_in(&temp, &values[i]), 0);
+    CU_ASSERT_EQUAL_FATAL(RQUEUE_SIZE(&temp), 8);
+    for (i=0; i<8; i++)
+	CU_ASSERT_PTR_EQUAL_FATAL(rqueue_out(&temp), &values[i]);
+    CU_ASSERT_EQUAL_FATAL(rqueue_delete(&temp, NULL), 0);
+}
+
+/**
+ * the capacity stops at RQUEUE_MAX_CAPACITY instead of wrapping
+ */
+void test_rqueue_max()
+{
+    RingQueue temp = RING_QUEUE_NULL;
+    int value = 0;
+
+    CU_ASSERT_EQUAL_FATAL(rqueue_new(&temp, RQUEUE_MAX_CAPACITY + 1, NULL), -1);
+    CU_ASSERT_EQUAL_FATAL(rqueue_new(&temp, (unsigned int)-1, NULL), -1);
+
+    /**
+     * pretend a full queue of the max capacity, it refuses to grow
+     */
+    CU_ASSERT_EQUAL_FATAL(rqueue_new(&temp, 4, NULL), 0);
+    unsigned int capacity = temp.capacity;
+    temp.capacity = RQUEUE_MAX_CAPACITY;
+    temp.tail = RQUEUE_MAX_CAPACITY;
+    CU_ASSERT_EQUAL_FATAL(rqueue_in(&temp, &value), -1);
+    CU_ASSERT_EQUAL_FATAL(temp.capacity, RQUEUE_MAX_CAPACITY);
+    temp.capacity = capacity;
+    temp.tail = 0;
+    CU_ASSERT_EQUAL_FATAL(rqueue_delete(&temp, NULL), 0);
+}
+
+void test_spsc()
+{
+    SpscQueue temp;
+    int values[8];
+    void *batch[8];
+    int i;
+
+    CU_ASSERT_EQUAL_FATAL(spsc_new(&temp, 0, NULL), -1);
+    CU_ASSERT_EQUAL_FATAL(spsc_new(&temp, 3, &counter), 0);
+    CU_ASSERT_EQUAL_FATAL(temp.capacity, 4);
+    CU_ASSERT_PTR_EQUAL_FATAL(spsc_out(&temp), NULL);
+
+    /**
+     * bounded, a full queue refuses
+     */
+    for (i=0; i<4; i++)
+	CU_ASSERT_EQUAL_FATAL(spsc_in(&temp, &values[i]), 0);
+    CU_ASSERT_EQUAL_FATAL(spsc_in(&temp, &values[4]), -1);
+    CU_ASSERT_EQUAL_FATAL(SPSC_SIZE(&temp), 4);
+    CU_ASSERT_PTR_EQUAL_FATAL(spsc_out(&temp), &values[0]);
+    CU_ASSERT_PTR_EQUAL_FATAL(spsc_out(&temp), &values[1]);
+
+    /**
+     * batches wrap around and stop at full or empty
+     */
+    for (i=0; i<8; i++)
+	batch[i] = &values[4+i%4];
+    CU_ASSERT_EQUAL_FATAL(spsc_in_n(&temp, batch, 8), 2);
+    CU_ASSERT_EQUAL_FATAL(spsc_out_n(&temp, batch, 8), 4);
+    CU_ASSERT_PTR_EQUAL_FATAL(batch[0], &values[2]);
+    CU_ASSERT_PTR_EQUAL_FATAL(batch[1], &values[3]);
+    CU_ASSERT_PTR_EQUAL_FATAL(batch[2], &values[4]);
+    CU_ASSERT_PTR_EQUAL_FATAL(batch[3], &values[5]);
+    CU_ASSERT_EQUAL_FATAL(spsc_out_n(&temp, batch, 8), 0);
+
+    CU_ASSERT_EQUAL_FATAL(spsc_in(&temp, &values[0]), 0);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 1);
+    CU_ASSERT_EQUAL_FATAL(spsc_delete(&temp, NULL), 1);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 0);
+}
+
+/**
+ * one thread sends the numbers in batches, the other one receives them one
+ * by one and checks the order
+ */
+#define SPSC_COUNT 200000
+#define SPSC_BATCH 7
+
+SpscQueue pipe_queue;
+int pipe_values[SPSC_COUNT];
+
+void* spsc_producer(void *arg)
+{
+    void *batch[SPSC_BATCH];
+    unsigned int sent = 0, n, i;
+
+    while (sent < SPSC_COUNT){
+	n = SPSC_COUNT - sent < SPSC_BATCH ? SPSC_COUNT - sent : SPSC_BATCH;
+	for (i=0; i<n; i++)
+	    batch[i] = &pipe_values[sent + i];
+	i = 0;
+	while (i < n){
+	    i += spsc_in_n(&pipe_queue, batch + i, n - i);
+	    if (i < n)
+		sched_yield();
+	}
+	sent += n;
+    }
+
+    return NULL;
+}
+
+void test_spsc_threads()
+{
+    pthread_t producer;
+    int *element = NULL;
+    int received = 0, ordered = 1;
+    int i;
+
+    for (i=0; i<SPSC_COUNT; i++)
+	pipe_values[i] = i;
+    CU_ASSERT_EQUAL_FATAL(spsc_new(&pipe_queue, 64, NULL), 0);
+    pthread_create(&producer, NULL, spsc_producer, NULL);
+
+    while (received < SPSC_COUNT){
+	element = (int*)spsc_out(&pipe_queue);
+	if (element == NULL){
+	    sched_yield();
+	    continue;
+	}
+	if (*element != received)
+	    ordered = 0;
+	received++;
+    }
+
+    pthread_join(producer, NULL);
+    CU_ASSERT_EQUAL_FATAL(ordered, 1);
+    CU_ASSERT_EQUAL_FATAL(spsc_delete(&pipe_queue, NULL), 0);
+}
+
+int destroyed = 0;
+
+void count_destroy(void *element)
+{
+    destroyed++;
+}
+
+void test_mpmc()
+{
+    MpmcQueue temp;
+    int values[4];
+    int i;
+
+    CU_ASSERT_EQUAL_FATAL(mpmc_new(&temp, 0, NULL), -1);
+    CU_ASSERT_EQUAL_FATAL(mpmc_new(&temp, 3, &counter), 0);
+    CU_ASSERT_EQUAL_FATAL(temp.capacity, 4);
+    CU_ASSERT_PTR_EQUAL_FATAL(mpmc_try_out(&temp), NULL);
+
+    for (i=0; i<4; i++)
+	CU_ASSERT_EQUAL_FATAL(mpmc_try_in(&temp, &values[i]), 0);
+    CU_ASSERT_EQUAL_FATAL(mpmc_try_in(&temp, &values[0]), -1);
+    CU_ASSERT_EQUAL_FATAL(MPMC_SIZE(&temp), 4);
+    CU_ASSERT_PTR_EQUAL_FATAL(mpmc_out(&temp), &values[0]);
+    CU_ASSERT_EQUAL_FATAL(mpmc_in(&temp, &values[0]), 0);
+    for (i=1; i<4; i++)
+	CU_ASSERT_PTR_EQUAL_FATAL(mpmc_try_out(&temp), &values[i]);
+
+    /**
+     * the elements left in the queue are destroyed like queue_delete
+     */
+    destroyed = 0;
+    CU_ASSERT_EQUAL_FATAL(mpmc_try_in(&temp, &values[1]), 0);
+    CU_ASSERT_EQUAL_FATAL(mpmc_clear(&temp, count_destroy), 2);
+    CU_ASSERT_EQUAL_FATAL(mpmc_try_in(&temp, &values[2]), 0);
+    CU_ASSERT_EQUAL_FATAL(mpmc_delete(&temp, count_destroy), 1);
+    CU_ASSERT_EQUAL_FATAL(destroyed, 3);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 0);
+}
+
+/**
+ * producers and consumers block on a small queue, every number is taken
+ * exactly once
+ */
+#define MPMC_THREADS 4
+#define MPMC_COUNT 50000
+
+MpmcQueue shared_queue;
+int mpmc_values[MPMC_THREADS * MPMC_COUNT];
+int mpmc_taken[MPMC_THREADS * MPMC_COUNT];
+
+void* mpmc_producer(void *arg)
+{
+    int *base = mpmc_values + (long)arg * MPMC_COUNT;
+    int i;
+
+    for (i=0; i<MPMC_COUNT; i++)
+	mpmc_in(&shared_queue, &base[i]);
+
+    return NULL;
+}
+
+void* mpmc_consumer(void *arg)
+{
+    int *element = NULL;
+    int i;
+
+    for (i=0; i<MPMC_COUNT; i++){
+	element = (int*)mpmc_out(&shared_queue);
+	__atomic_fetch_add(&mpmc_taken[*element], 1, __ATOMIC_RELAXED);
+    }
+
+    return NULL;
+}
+
+void test_mpmc_threads()
+{
+    pthread_t producers[MPMC_THREADS], consumers[MPMC_THREADS];
+    long i;
+
+    for (i=0; i<MPMC_THREADS * MPMC_COUNT; i++){
+	mpmc_values[i] = i;
+	mpmc_taken[i] = 0;
+    }
+    CU_ASSERT_EQUAL_FATAL(mpmc_new(&shared_queue, 8, NULL), 0);
+
+    for (i=0; i<MPMC_THREADS; i++){
+	pthread_create(&consumers[i], NULL, mpmc_consumer, NULL);
+	pthread_create(&producers[i], NULL, mpmc_producer, (void*)i);
+    }
+    for (i=0; i<MPMC_THREADS; i++){
+	pthread_join(producers[i], NULL);
+	pthread_join(consumers[i], NULL);
+    }
+
+    CU_ASSERT_EQUAL_FATAL(mpmc_delete(&shared_queue, NULL), 0);
+    for (i=0; i<MPMC_THREADS * MPMC_COUNT; i++)
+	CU_ASSERT_EQUAL_FATAL(mpmc_taken[i], 1);
+}
+
+void test_cqueue()
+{
+    ConcurrentQueue temp;
+    int values[4];
+    int i;
+
+    CU_ASSERT_EQUAL_FATAL(cqueue_new(&temp, &counter), 0);
+    CU_ASSERT_PTR_EQUAL_FATAL(cqueue_out(&temp), NULL);
+    CU_ASSERT_EQUAL_FATAL(cqueue_in(&temp, NULL), -1);
+
+    /**
+     * the nodes are recycled, the queue does not grow its pool
+     */
+    for (i=0; i<1000; i++){
+	CU_ASSERT_EQUAL_FATAL(cqueue_in(&temp, &values[i % 4]), 0);
+	CU_ASSERT_PTR_EQUAL_FATAL(cqueue_out(&temp), &values[i % 4]);
+    }
+    CU_ASSERT_EQUAL_FATAL(atomic_load(&temp.pool.next_index), 3);
+
+    for (i=0; i<4; i++)
+	CU_ASSERT_EQUAL_FATAL(cqueue_in(&temp, &values[i]), 0);
+    CU_ASSERT_EQUAL_FATAL(CQUEUE_SIZE(&temp), 4);
+    CU_ASSERT_PTR_EQUAL_FATAL(cqueue_out(&temp), &values[0]);
+    CU_ASSERT_PTR_EQUAL_FATAL(cqueue_out(&temp), &values[1]);
+
+    destroyed = 0;
+    CU_ASSERT_EQUAL_FATAL(cqueue_delete(&temp, count_destroy), 2);
+    CU_ASSERT_EQUAL_FATAL(destroyed, 2);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 0);
+}
+
+/**
+ * producers and consumers share the unbounded queue, consumers spin while
+ * it is empty, every number is taken exactly once and in the order of its
+ * producer
+ */
+ConcurrentQueue linked_queue;
+int cqueue_last[MPMC_THREADS * MPMC_THREADS];
+_Atomic int cqueue_disorder = 0;
+
+void* cqueue_producer(void *arg)
+{
+    int *base = mpmc_values + (long)arg * MPMC_COUNT;
+    int i;
+
+    for (i=0; i<MPMC_COUNT; i++)
+	cqueue_in(&linked_queue, &base[i]);
+
+    return NULL;
+}
+
+void* cqueue_consumer(void *arg)
+{
+    int *last = cqueue_last + (long)arg * MPMC_THREADS;
+    int *element = NULL;
+    int i;
+
+    for (i=0; i<MPMC_COUNT; i++){
+	while ((element = (int*)cqueue_out(&linked_queue)) == NULL)
+	    sched_yield();
+	__atomic_fetch_add(&mpmc_taken[*element], 1, __ATOMIC_RELAXED);
+	if (*element < last[*element / MPMC_COUNT])
+	    atomic_fetch_add(&cqueue_disorder, 1);
+	last[*element / MPMC_COUNT] = *element;
+    }
+
+    return NULL;
+}
+
+void test_cqueue_threads()
+{
+    pthread_t producers[MPMC_THREADS], consumers[MPMC_THREADS];
+    long i;
+
+    for (i=0; i<MPMC_THREADS * MPMC_COUNT; i++){
+	mpmc_values[i] = i;
+	mpmc_taken[i] = 0;
+    }
+    for (i=0; i<MPMC_THREADS * MPMC_THREADS; i++)
+	cqueue_last[i] = -1;
+    CU_ASSERT_EQUAL_FATAL(cqueue_new(&linked_queue, NULL), 0);
+
+    for (i=0; i<MPMC_THREADS; i++){
+	pthread_create(&consumers[i], NULL, cqueue_consumer, (void*)i);
+	pthread_create(&producers[i], NULL, cqueue_producer, (void*)i);
+    }
+    for (i=0; i<MPMC_THREADS; i++){
+	pthread_join(producers[i], NULL);
+	pthread_join(consumers[i], NULL);
+    }
+
+    CU_ASSERT_EQUAL_FATAL(CQUEUE_SIZE(&linked_queue), 0);
+    CU_ASSERT_EQUAL_FATAL(cqueue_delete(&linked_queue, NULL), 0);
+    CU_ASSERT_EQUAL_FATAL(cqueue_disorder, 0);
+    for (i=0; i<MPMC_THREADS * MPMC_COUNT; i++)
+	CU_ASSERT_EQUAL_FATAL(mpmc_taken[i], 1);
+}
+
+void test_bqueue()
+{
+    BlockingQueue temp;
+    int values[4];
+    void *element = NULL;
+    int i;
+
+    CU_ASSERT_EQUAL_FATAL(bqueue_new(&temp, 2, &counter), 0);
+    CU_ASSERT_EQUAL_FATAL(bqueue_out_wait(&temp, &element, 0), 1);
+    CU_ASSERT_EQUAL_FATAL(bqueue_out_wait(&temp, &element, 10), 1);
+    CU_ASSERT_PTR_EQUAL_FATAL(element, NULL);
+
+    for (i=0; i<2; i++)
+	CU_ASSERT_EQUAL_FATAL(bqueue_in_wait(&temp, &values[i], BQUEUE_FOREVER), 0);
+    CU_ASSERT_EQUAL_FATAL(bqueue_in_wait(&temp, &values[2], 0), 1);
+    CU_ASSERT_EQUAL_FATAL(bqueue_in_wait(&temp, &values[2], 10), 1);
+    CU_ASSERT_EQUAL_FATAL(BQUEUE_SIZE(&temp), 2);
+    CU_ASSERT_EQUAL_FATAL(bqueue_out_wait(&temp, &element, BQUEUE_FOREVER), 0);
+    CU_ASSERT_PTR_EQUAL_FATAL(element, &values[0]);
+    CU_ASSERT_EQUAL_FATAL(bqueue_in_wait(&temp, &values[2], 0), 0);
+
+    /**
+     * after close nothing comes in, the elements left still go out
+     */
+    CU_ASSERT_EQUAL_FATAL(bqueue_close(&temp), 0);
+    CU_ASSERT_EQUAL_FATAL(bqueue_in_wait(&temp, &values[3], BQUEUE_FOREVER), -1);
+    CU_ASSERT_EQUAL_FATAL(bqueue_out_wait(&temp, &element, BQUEUE_FOREVER), 0);
+    CU_ASSERT_PTR_EQUAL_FATAL(element, &values[1]);
+
+    destroyed = 0;
+    CU_ASSERT_EQUAL_FATAL(bqueue_delete(&temp, count_destroy), 1);
+    CU_ASSERT_EQUAL_FATAL(destroyed, 1);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 0);
+}
+
+/**
+ * consumers wait forever and stop when the queue is closed, every number
+ * is taken exactly once
+ */
+BlockingQueue blocking_queue;
+
+void* bqueue_producer(void *arg)
+{
+    int *base = mpmc_values + (long)arg * MPMC_COUNT;
+    int i;
+
+    for (i=0; i<MPMC_COUNT; i++)
+	bqueue_in_wait(&blocking_queue, &base[i], BQUEUE_FOREVER);
+
+    return NULL;
+}
+
+void* bqueue_consumer(void *arg)
+{
+    void *element = NULL;
+
+    while (bqueue_out_wait(&blocking_queue, &element, BQUEUE_FOREVER) == 0)
+	__atomic_fetch_add(&mpmc_taken[*(int*)element], 1, __ATOMIC_RELAXED);
+
+    return NULL;
+}
+
+void test_bqueue_threads()
+{
+    pthread_t producers[MPMC_THREADS], consumers[MPMC_THREADS];
+    long i;
+
+    for (i=0; i<MPMC_THREADS * MPMC_COUNT; i++){
+	mpmc_values[i] = i;
+	mpmc_taken[i] = 0;
+    }
+    CU_ASSERT_EQUAL_FATAL(bqueue_new(&blocking_queue, 8, NULL), 0);
+
+    for (i=0; i<MPMC_THREADS; i++){
+	pthread_create(&consumers[i], NULL, bqueue_consumer, NULL);
+	pthread_create(&producers[i], NULL, bqueue_producer, (void*)i);
+    }
+    for (i=0; i<MPMC_THREADS; i++)
+	pthread_join(producers[i], NULL);
+    CU_ASSERT_EQUAL_FATAL(bqueue_close(&blocking_queue), 0);
+    for (i=0; i<MPMC_THREADS; i++)
+	pthread_join(consumers[i], NULL);
+
+    CU_ASSERT_EQUAL_FATAL(bqueue_delete(&blocking_queue, NULL), 0);
+    for (i=0; i<MPMC_THREADS * MPMC_COUNT; i++)
+	CU_ASSERT_EQUAL_FATAL(mpmc_taken[i], 1);
+}
+
+int compare_int(void *element1, void *element2)
+{
+    return *(int*)element1 - *(int*)element2;
+}
+
+void test_pqueue()
+{
+    PriorityQueue temp = PRIORITY_QUEUE_NULL;
+    int values[100];
+    void *elements[100];
+    unsigned int arity;
+    int i, last;
+
+    for (i=0; i<100; i++){
+	values[i] = (i * 37) % 100;
+	elements[i] = &values[i];
+    }
+    CU_ASSERT_EQUAL_FATAL(pqueue_new(&temp, 1, compare_int, NULL), -1);
+    CU_ASSERT_EQUAL_FATAL(pqueue_new(&temp, 0, NULL, NULL), -1);
+
+    for (arity=2; arity<=8; arity*=2){
+	CU_ASSERT_EQUAL_FATAL(pqueue_new(&temp, arity, compare_int, &counter), 0);
+	CU_ASSERT_PTR_EQUAL_FATAL(pqueue_pop(&temp), NULL);
+	for (i=0; i<100; i++)
+	    CU_ASSERT_EQUAL_FATAL(pqueue_push(&temp, elements[i]), 0);
+	CU_ASSERT_EQUAL_FATAL(*(int*)pqueue_peek(&temp), 0);
+	CU_ASSERT_EQUAL_FATAL(PQUEUE_SIZE(&temp), 100);
+	for (i=0; i<100; i++)
+	    CU_ASSERT_EQUAL_FATAL(*(int*)pqueue_pop(&temp), i);
+	CU_ASSERT_TRUE_FATAL(PQUEUE_EMPTY(&temp));
+
+	/**
+	 * a large batch rebuilds the heap, a small one sifts up
+	 */
+	CU_ASSERT_EQUAL_FATAL(pqueue_push_n(&temp, elements, 90), 90);
+	CU_ASSERT_EQUAL_FATAL(pqueue_push_n(&temp, elements + 90, 10), 10);
+	last = -1;
+	for (i=0; i<100; i++){
+	    CU_ASSERT_TRUE_FATAL(*(int*)pqueue_peek(&temp) > last);
+	    last = *(int*)pqueue_pop(&temp);
+	}
+
+	CU_ASSERT_EQUAL_FATAL(pqueue_heapify(&temp, elements + 50, 50), 50);
+	CU_ASSERT_EQUAL_FATAL(pqueue_heapify(&temp, elements, 30), 30);
+	CU_ASSERT_EQUAL_FATAL(*(int*)pqueue_pop(&temp), 0);
+	CU_ASSERT_EQUAL_FATAL(*(int*)pqueue_pop(&temp), 3);
+
+	destroyed = 0;
+	CU_ASSERT_EQUAL_FATAL(pqueue_clear(&temp, count_destroy), 28);
+	CU_ASSERT_EQUAL_FATAL(destroyed, 28);
+	CU_ASSERT_EQUAL_FATAL(pqueue_push(&temp, elements[0]), 0);
+	CU_ASSERT_EQUAL_FATAL(pqueue_delete(&temp, NULL), 1);
+	CU_ASSERT_EQUAL_FATAL(live_blocks, 0);
+    }
+}
+
+void test_iqueue()
+{
+    IndexedQueue temp = INDEXED_QUEUE_NULL;
+    int values[100];
+    int handles[100];
+    int i, last;
+
+    for (i=0; i<100; i++)
+	values[i] = (i * 37) % 100;
+    CU_ASSERT_EQUAL_FATAL(iqueue_new(&temp, 0, compare_int, &counter), 0);
+    CU_ASSERT_PTR_EQUAL_FATAL(iqueue_pop(&temp), NULL);
+    for (i=0; i<100; i++){
+	handles[i] = iqueue_push(&temp, &values[i]);
+	CU_ASSERT_EQUAL_FATAL(handles[i], i);
+    }
+    CU_ASSERT_EQUAL_FATAL(IQUEUE_SIZE(&temp), 100);
+
+    /**
+     * change priorities both ways and erase some elements by handle
+     */
+    values[10] = -5;
+    CU_ASSERT_EQUAL_FATAL(iqueue_update(&temp, handles[10]), 0);
+    CU_ASSERT_PTR_EQUAL_FATAL(iqueue_peek(&temp), &values[10]);
+    values[0] = 200;
+    CU_ASSERT_EQUAL_FATAL(iqueue_update(&temp, handles[0]), 0);
+    CU_ASSERT_PTR_EQUAL_FATAL(iqueue_erase(&temp, handles[10]), &values[10]);
+    CU_ASSERT_PTR_EQUAL_FATAL(iqueue_get(&temp, handles[10]), NULL);
+    CU_ASSERT_PTR_EQUAL_FATAL(iqueue_erase(&temp, handles[10]), NULL);
+    CU_ASSERT_EQUAL_FATAL(iqueue_update(&temp, 1000), -1);
+    for (i=20; i<40; i++)
+	CU_ASSERT_PTR_EQUAL_FATAL(iqueue_erase(&temp, handles[i]), &values[i]);
+    CU_ASSERT_PTR_EQUAL_FATAL(iqueue_get(&temp, handles[50]), &values[50]);
+
+    /**
+     * a free handle is used again
+     */
+    values[20] = 50;
+    CU_ASSERT_EQUAL_FATAL(iqueue_push(&temp, &values[20]), handles[39]);
+    CU_ASSERT_EQUAL_FATAL(IQUEUE_SIZE(&temp), 80);
+
+    last = -1000;
+    for (i=0; i<79; i++){
+	CU_ASSERT_TRUE_FATAL(*(int*)iqueue_peek(&temp) >= last);
+	last = *(int*)iqueue_pop(&temp);
+    }
+    CU_ASSERT_PTR_EQUAL_FATAL(iqueue_pop(&temp), &values[0]);
+
+    destroyed = 0;
+    CU_ASSERT_EQUAL_FATAL(iqueue_push(&temp, &values[1]), handles[0]);
+    CU_ASSERT_EQUAL_FATAL(iqueue_delete(&temp, count_destroy), 1);
+    CU_ASSERT_EQUAL_FATAL(destroyed, 1);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 0);
+}
+
 /*************Test Case End*********************/
 
 
@@ -152,6 +1017,25 @@ static CU_TestInfo testcase1[] = {
     { "test_queue_in2", test_queue_in},
     { "test_queue_iterate2", test_queue_iterate},
     { "test_queue_delete", test_queue_delete},
+    { "test_queue_allocator", test_queue_allocator},
+    { "test_queue_n", test_queue_n},
+    { "test_queue_n_trim", test_queue_n_trim},
+    { "test_queue_spare", test_queue_spare},
+    { "test_queue_reserve_watermark", test_queue_reserve_watermark},
+    { "test_queue_trim_block", test_queue_trim_block},
+    { "test_rqueue", test_rqueue},
+    { "test_rqueue_wrap", test_rqueue_wrap},
+    { "test_rqueue_max", test_rqueue_max},
+    { "test_spsc", test_spsc},
+    { "test_spsc_threads", test_spsc_threads},
+    { "test_mpmc", test_mpmc},
+    { "test_mpmc_threads", test_mpmc_threads},
+    { "test_cqueue", test_cqueue},
+    { "test_cqueue_threads", test_cqueue_threads},
+    { "test_bqueue", test_bqueue},
+    { "test_bqueue_threads", test_bqueue_threads},
+    { "test_pqueue", test_pqueue},
+    { "test_iqueue", test_iqueue},
     CU_TEST_INFO_NULL
 };
 
@@ -0,0 +1,1007 @@
+/**
+ * @file RBtree.c
+ * @Brief  red-black tree implementation. No red node has a red child and
+ *         every path down from a node meets the same number of black
+ *         nodes, so the tree is at most twice as high as a balanced one
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-05-02
+ */
+
+#include <stdlib.h>
+
+#include "RBtree.h"
+#include "util/Log.h"
+
+#define RBTREE_KEY(common, node) ((common)->element_key((node)->element))
+#define RBTREE_COMPARE(common, node, key) ((common)->key_compare(RBTREE_KEY(common, node), key))
+
+/**
+ * a missed child is black
+ */
+#define RBTREE_IS_RED(node) ((node) != NULL && (node)->color == RBTREE_RED)
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_min get the first node of a subtree
+ *
+ * @Param node the root of the subtree, not NULL
+ *
+ * @Returns   the node
+ */
+/* ----------------------------------------------------------------------------*/
+static RBNode* rbtree_min(RBNode *node)
+{
+    while (node->left)
+	node = node->left;
+
+    return node;
+}
+
+static RBNode* rbtree_max(RBNode *node)
+{
+    while (node->right)
+	node = node->right;
+
+    return node;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_successor get the node after a node in order, walking the
+ *         whole tree this way visits every link twice
+ *
+ * @Param node the node
+ *
+ * @Returns   NULL means no one; other is the node
+ */
+/* ----------------------------------------------------------------------------*/
+static RBNode* rbtree_successor(RBNode *node)
+{
+    if (node->right)
+	return rbtree_min(node->right);
+
+    while (node->parent && node == node->parent->right)
+	node = node->parent;
+
+    return node->parent;
+}
+
+static RBNode* rbtree_predecessor(RBNode *node)
+{
+    if (node->left)
+	return rbtree_max(node->left);
+
+    while (node->parent && node == node->parent->left)
+	node = node->parent;
+
+    return node->parent;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_bound find the first node that a bound does not skip
+ *
+ * @Param common data common struct
+ * @Param key the key
+ * @Param inclusive 0 means skip the nodes less than the key; other means
+ *        skip the nodes not greater than the key
+ *
+ * @Returns   NULL means no one; other is the node
+ */
+/* ----------------------------------------------------------------------------*/
+static RBNode* rbtree_bound(DataCommon *common, void *key, int inclusive)
+{
+    RBNode *node = ((RBTree*)(common->linked_type))->root;
+    RBNode *bound = NULL;
+
+    while (node){
+	if (RBTREE_COMPARE(common, node, key) < inclusive){
+	    node = node->right;
+	}else{
+	    bound = node;
+	    node = node->left;
+	}
+    }
+
+    return bound;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_find find the node of a key
+ *
+ * @Param common data common struct
+ * @Param key the key
+ *
+ * @Returns   NULL means no one; other is the node
+ */
+/* ----------------------------------------------------------------------------*/
+static RBNode* rbtree_find(DataCommon *common, void *key)
+{
+    RBNode *node = ((RBTree*)(common->linked_type))->root;
+    int ret;
+
+    while (node){
+	ret = RBTREE_COMPARE(common, node, key);
+	if (ret == 0)
+	    return node;
+	node = ret < 0 ? node->right : node->left;
+    }
+
+    return NULL;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_replace put a node at the place of another in its parent
+ *
+ * @Param tree red-black tree
+ * @Param old the node that goes
+ * @Param node the node that comes, may be NULL
+ */
+/* ----------------------------------------------------------------------------*/
+static void rbtree_replace(RBTree *tree, RBNode *old, RBNode *node)
+{
+    if (old->parent == NULL)
+	tree->root = node;
+    else if (old == old->parent->left)
+	old->parent->left = node;
+    else
+	old->parent->right = node;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_rotate_left the right child of a node becomes its parent
+ *
+ * @Param tree red-black tree
+ * @Param node the node
+ */
+/* ----------------------------------------------------------------------------*/
+static void rbtree_rotate_left(RBTree *tree, RBNode *node)
+{
+    RBNode *right = node->right;
+
+    node->right = right->left;
+    if (right->left)
+	right->left->parent = node;
+    right->parent = node->parent;
+    rbtree_replace(tree, node, right);
+    right->left = node;
+    node->parent = right;
+}
+
+static void rbtree_rotate_right(RBTree *tree, RBNode *node)
+{
+    RBNode *left = node->left;
+
+    node->left = left->right;
+    if (left->right)
+	left->right->parent = node;
+    left->parent = node->parent;
+    rbtree_replace(tree, node, left);
+    left->right = node;
+    node->parent = left;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_insert_fix a new red node may have a red parent, recolor
+ *         upward while the uncle is red, then rotate once or twice
+ *
+ * @Param tree red-black tree
+ * @Param node the new node
+ */
+/* ----------------------------------------------------------------------------*/
+static void rbtree_insert_fix(RBTree *tree, RBNode *node)
+{
+    RBNode *parent, *grand, *uncle;
+
+    while ((parent = node->parent) && parent->color == RBTREE_RED){
+	/**
+	 * a red parent is not the root, so the grandparent is there
+	 */
+	grand = parent->parent;
+	if (parent == grand->left){
+	    uncle = grand->right;
+	    if (RBTREE_IS_RED(uncle)){
+		parent->color = RBTREE_BLACK;
+		uncle->color = RBTREE_BLACK;
+		grand->color = RBTREE_RED;
+		node = grand;
+		continue;
+	    }
+	    if (node == parent->right){
+		rbtree_rotate_left(tree, parent);
+		node = parent;
+		parent = node->parent;
+	    }
+	    parent->color = RBTREE_BLACK;
+	    grand->color = RBTREE_RED;
+	    rbtree_rotate_right(tree, grand);
+	}else{
+	    uncle = grand->left;
+	    if (RBTREE_IS_RED(uncle)){
+		parent->color = RBTREE_BLACK;
+		uncle->color = RBTREE_BLACK;
+		grand->color = RBTREE_RED;
+		node = grand;
+		continue;
+	    }
+	    if (node == parent->left){
+		rbtree_rotate_right(tree, parent);
+		node = parent;
+		parent = node->parent;
+	    }
+	    parent->color = RBTREE_BLACK;
+	    grand->color = RBTREE_RED;
+	    rbtree_rotate_left(tree, grand);
+	}
+    }
+    tree->root->color = RBTREE_BLACK;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_erase_fix a path lost a black node, it borrows one from
+ *         the sibling side or moves the lack upward
+ *
+ * @Param tree red-black tree
+ * @Param node the node that takes the place of the removed one, may be NULL
+ * @Param parent the parent of the place
+ */
+/* ----------------------------------------------------------------------------*/
+static void rbtree_erase_fix(RBTree *tree, RBNode *node, RBNode *parent)
+{
+    RBNode *sibling;
+
+    while (node != tree->root && !RBTREE_IS_RED(node)){
+	if (node == parent->left){
+	    sibling = parent->right;
+	    if (RBTREE_IS_RED(sibling)){
+		sibling->color = RBTREE_BLACK;
+		parent->color = RBTREE_RED;
+		rbtree_rotate_left(tree, parent);
+		sibling = parent->right;
+	    }
+	    if (!RBTREE_IS_RED(sibling->left) && !RBTREE_IS_RED(sibling->right)){
+		sibling->color = RBTREE_RED;
+		node = parent;
+		parent = node->parent;
+		continue;
+	    }
+	    if (!RBTREE_IS_RED(sibling->right)){
+		sibling->left->color = RBTREE_BLACK;
+		sibling->color = RBTREE_RED;
+		rbtree_rotate_right(tree, sibling);
+		sibling = parent->right;
+	    }
+	    sibling->color = parent->color;
+	    parent->color = RBTREE_BLACK;
+	    sibling->right->color = RBTREE_BLACK;
+	    rbtree_rotate_left(tree, parent);
+	}else{
+	    sibling = parent->left;
+	    if (RBTREE_IS_RED(sibling)){
+		sibling->color = RBTREE_BLACK;
+		parent->color = RBTREE_RED;
+		rbtree_rotate_right(tree, parent);
+		sibling = parent->left;
+	    }
+	    if (!RBTREE_IS_RED(sibling->left) && !RBTREE_IS_RED(sibling->right)){
+		sibling->color = RBTREE_RED;
+		node = parent;
+		parent = node->parent;
+		continue;
+	    }
+	    if (!RBTREE_IS_RED(sibling->left)){
+		sibling->right->color = RBTREE_BLACK;
+		sibling->color = RBTREE_RED;
+		rbtree_rotate_left(tree, sibling);
+		sibling = parent->left;
+	    }
+	    sibling->color = parent->color;
+	    parent->color = RBTREE_BLACK;
+	    sibling->left->color = RBTREE_BLACK;
+	    rbtree_rotate_right(tree, parent);
+	}
+	node = tree->root;
+    }
+    if (node)
+	node->color = RBTREE_BLACK;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_erase_node take a node out of the tree, destroy its
+ *         element and free it. The other nodes are relinked but not moved,
+ *         so the cursors on them stay valid
+ *
+ * @Param common data common struct
+ * @Param node the node
+ */
+/* ----------------------------------------------------------------------------*/
+static void rbtree_erase_node(DataCommon *common, RBNode *node)
+{
+    RBTree *tree = (RBTree*)(common->linked_type);
+    RBNode *child, *parent, *next;
+    int color;
+
+    if (node->left && node->right){
+	/**
+	 * the successor has no left child, it takes the place and the color
+	 * of the node, and its own place loses a black node if it is black
+	 */
+	next = rbtree_min(node->right);
+	child = next->right;
+	parent = next->parent;
+	color = next->color;
+	if (parent == node){
+	    parent = next;
+	}else{
+	    if (child)
+		child->parent = parent;
+	    parent->left = child;
+	    next->right = node->right;
+	    node->right->parent = next;
+	}
+	next->parent = node->parent;
+	next->color = node->color;
+	next->left = node->left;
+	node->left->parent = next;
+	rbtree_replace(tree, node, next);
+    }else{
+	child = node->left ? node->left : node->right;
+	parent = node->parent;
+	color = node->color;
+	if (child)
+	    child->parent = parent;
+	rbtree_replace(tree, node, child);
+    }
+    if (color == RBTREE_BLACK)
+	rbtree_erase_fix(tree, child, parent);
+
+    common->destroy_node(node->element);
+    slab_free(&tree->node_pool, node);
+    tree->size--;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_insert insert an element at its place, its key must not be
+ *         in the tree
+ *
+ * @Param common data common struct
+ * @Param element the element
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int rbtree_insert(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    RBTree *tree = (RBTree*)(common->linked_type);
+    void *key = common->element_key(element);
+    RBNode *parent = NULL;
+    RBNode **link = &tree->root;
+    int ret;
+
+    while (*link){
+	parent = *link;
+	ret = RBTREE_COMPARE(common, parent, key);
+	if (ret == 0){
+	    INFO("the key is in the tree!");
+	    return -1;
+	}
+	link = ret < 0 ? &parent->right : &parent->left;
+    }
+
+    RBNode *node = (RBNode*)slab_alloc(&tree->node_pool);
+    if (node == NULL){
+	ERROR("malloc error!");
+	return -1;
+    }
+    node->element = element;
+    node->parent = parent;
+    node->left = NULL;
+    node->right = NULL;
+    node->color = RBTREE_RED;
+    *link = node;
+    rbtree_insert_fix(tree, node);
+    tree->size++;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_remove remove the element of a key and destroy it
+ *
+ * @Param common data common struct
+ * @Param element the key
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int rbtree_remove(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    RBNode *node = rbtree_find(common, element);
+    if (node == NULL)
+	return -1;
+    rbtree_erase_node(common, node);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_search get the element of a key
+ *
+ * @Param common data common struct
+ * @Param element the key
+ *
+ * @Returns   NULL means no one; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* rbtree_search(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return NULL;
+    }
+
+    RBNode *node = rbtree_find(common, element);
+
+    return node == NULL ? NULL : node->element;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_alter alter the element that has the same key, by the
+ *         alter_match function; the function must not change the key
+ *
+ * @Param common data common struct
+ * @Param element the element-like argument
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int rbtree_alter(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    RBNode *node = rbtree_find(common, common->element_key(element));
+    if (node == NULL)
+	return -1;
+
+    return (common->alter_match)(node->element, element);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_prior get the element before the one of a key
+ *
+ * @Param common data common struct
+ * @Param element the key
+ *
+ * @Returns   NULL means no one; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* rbtree_prior(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return NULL;
+    }
+
+    RBNode *node = rbtree_find(common, element);
+    if (node == NULL || (node = rbtree_predecessor(node)) == NULL)
+	return NULL;
+
+    return node->element;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_next get the element after the one of a key
+ *
+ * @Param common data common struct
+ * @Param element the key
+ *
+ * @Returns   NULL means no one; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* rbtree_next(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return NULL;
+    }
+
+    RBNode *node = rbtree_find(common, element);
+    if (node == NULL || (node = rbtree_successor(node)) == NULL)
+	return NULL;
+
+    return node->element;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_iterate iterate the tree in the order of the keys, by the
+ *         parent links instead of a stack
+ *
+ * @Param common data common struct
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int rbtree_iterate(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    RBTree *tree = (RBTree*)(common->linked_type);
+    RBNode *node = tree->root ? rbtree_min(tree->root) : NULL;
+
+    for (; node; node=rbtree_successor(node))
+	if ((common->handle_iteration)(node->element) != 0){
+	    ERROR("handle_iteration function error!");
+	    return -1;
+	}
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_size get the number of elements
+ *
+ * @Param common data common struct
+ *
+ * @Returns   -1 is failed; other is the size
+ */
+/* ----------------------------------------------------------------------------*/
+static int rbtree_size(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    return ((RBTree*)(common->linked_type))->size;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_clear destroy all the elements and their nodes, a node is
+ *         freed after its children
+ *
+ * @Param common data common struct
+ *
+ * @Returns   -1 is failed; other is the number of elements
+ */
+/* ----------------------------------------------------------------------------*/
+static int rbtree_clear(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    RBTree *tree = (RBTree*)(common->linked_type);
+    RBNode *node = tree->root;
+    RBNode *parent = NULL;
+
+    while (node){
+	if (node->left){
+	    node = node->left;
+	}else if (node->right){
+	    node = node->right;
+	}else{
+	    parent = node->parent;
+	    if (parent && parent->left == node)
+		parent->left = NULL;
+	    else if (parent)
+		parent->right = NULL;
+	    common->destroy_node(node->element);
+	    slab_free(&tree->node_pool, node);
+	    node = parent;
+	}
+    }
+    tree->root = NULL;
+
+    int ret = tree->size;
+    tree->size = 0;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_begin put the cursor on the first element
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means the tree is empty
+ */
+/* ----------------------------------------------------------------------------*/
+static int rbtree_begin(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    RBTree *tree = (RBTree*)(common->linked_type);
+    cursor->node = tree->root ? rbtree_min(tree->root) : NULL;
+    cursor->previous = NULL;
+    cursor->index = 0;
+
+    return cursor->node ? 0 : -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_end put the cursor on the last element
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means the tree is empty
+ */
+/* ----------------------------------------------------------------------------*/
+static int rbtree_end(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    RBTree *tree = (RBTree*)(common->linked_type);
+    cursor->node = tree->root ? rbtree_max(tree->root) : NULL;
+    cursor->previous = NULL;
+    cursor->index = 0;
+
+    return cursor->node ? 0 : -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_advance move the cursor to the next element
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means the cursor is off the tree
+ */
+/* ----------------------------------------------------------------------------*/
+static int rbtree_advance(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+    if (cursor->node == NULL)
+	return -1;
+
+    cursor->node = rbtree_successor((RBNode*)(cursor->node));
+
+    return cursor->node ? 0 : -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_retreat move the cursor to the prior element
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means the cursor is off the tree
+ */
+/* ----------------------------------------------------------------------------*/
+static int rbtree_retreat(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+    if (cursor->node == NULL)
+	return -1;
+
+    cursor->node = rbtree_predecessor((RBNode*)(cursor->node));
+
+    return cursor->node ? 0 : -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_get return the element under the cursor
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   NULL means the cursor is off the tree; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* rbtree_get(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return NULL;
+    }
+
+    RBNode *node = (RBNode*)(cursor->node);
+
+    return node == NULL ? NULL : node->element;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_erase remove the element under the cursor, the cursor
+ *         moves to the next one
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int rbtree_erase(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+    if (cursor->node == NULL)
+	return -1;
+
+    RBNode *node = (RBNode*)(cursor->node);
+    cursor->node = rbtree_successor(node);
+    rbtree_erase_node(common, node);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_insert_after refused as in all the ordered data
+ */
+/* ----------------------------------------------------------------------------*/
+static int rbtree_insert_after(DataCommon *common, Cursor *cursor, void *element)
+{
+    (void)common;
+    (void)cursor;
+    (void)element;
+    ERROR("the red-black tree keeps the order, use insert!");
+    return -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_lower_bound put the cursor on the first element whose key
+ *         is not less than a key
+ *
+ * @Param common data common struct
+ * @Param key the key
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means no one
+ */
+/* ----------------------------------------------------------------------------*/
+int rbtree_lower_bound(DataCommon *common, void *key, Cursor *cursor)
+{
+    if ((common == NULL) || (key == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    cursor->node = rbtree_bound(common, key, 0);
+    cursor->previous = NULL;
+    cursor->index = 0;
+
+    return cursor->node ? 0 : -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_upper_bound put the cursor on the first element whose key
+ *         is greater than a key
+ *
+ * @Param common data common struct
+ * @Param key the key
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means no one
+ */
+/* ----------------------------------------------------------------------------*/
+int rbtree_upper_bound(DataCommon *common, void *key, Cursor *cursor)
+{
+    if ((common == NULL) || (key == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    cursor->node = rbtree_bound(common, key, 1);
+    cursor->previous = NULL;
+    cursor->index = 0;
+
+    return cursor->node ? 0 : -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_range_iterate iterate the elements whose keys are in
+ *         [low, high), by the handle_iteration function
+ *
+ * @Param common data common struct
+ * @Param low the first key, NULL means from the first element
+ * @Param high the key after the last, NULL means to the last element
+ *
+ * @Returns   -1 is failed; other is the number of elements
+ */
+/* ----------------------------------------------------------------------------*/
+int rbtree_range_iterate(DataCommon *common, void *low, void *high)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    RBTree *tree = (RBTree*)(common->linked_type);
+    RBNode *node = NULL;
+    int ret = 0;
+
+    if (low)
+	node = rbtree_bound(common, low, 0);
+    else if (tree->root)
+	node = rbtree_min(tree->root);
+
+    for (; node && (high == NULL || RBTREE_COMPARE(common, node, high) < 0); \
+	    node=rbtree_successor(node)){
+	if ((common->handle_iteration)(node->element) != 0){
+	    ERROR("handle_iteration function error!");
+	    return -1;
+	}
+	ret++;
+    }
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_new create a red-black tree, initial datacommon struct
+ *
+ * @Param common data common struct
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int rbtree_new(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    /**
+     * check the user-defined functhion
+     */
+    int handle_check = DATA_COMMON_ORDERED(common) \
+		       &&common->alter_match \
+		       &&common->destroy_node \
+		       &&common->handle_iteration \
+		       &&ALLOCATOR_CHECK(common->allocator);
+    if (handle_check == 0){
+	ERROR("missed user defined function!");
+	return -1;
+    }
+
+    RBTree *tree = (RBTree*)mem_alloc(common->allocator, sizeof(RBTree));
+    if (tree == NULL){
+	ERROR("malloc error!");
+	return -1;
+    }
+    tree->root = NULL;
+    tree->size = 0;
+
+    /**
+     * nodes of the tree come from its own slab
+     */
+    if (slab_new(&tree->node_pool, sizeof(RBNode), 0, common->allocator) != 0){
+	mem_free(common->allocator, tree);
+	return -1;
+    }
+
+    common->linked_type = tree;
+    common->insert = rbtree_insert;
+    common->remove = rbtree_remove;
+    common->search = rbtree_search;
+    common->alter = rbtree_alter;
+    common->prior = rbtree_prior;
+    common->next = rbtree_next;
+    common->iterate = rbtree_iterate;
+    common->size = rbtree_size;
+    common->clear = rbtree_clear;
+    common->begin = rbtree_begin;
+    common->end = rbtree_end;
+    common->advance = rbtree_advance;
+    common->retreat = rbtree_retreat;
+    common->get = rbtree_get;
+    common->erase = rbtree_erase;
+    common->insert_after = rbtree_insert_after;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  rbtree_delete destroy all the elements and the tree
+ *
+ * @Param common data common struct
+ *
+ * @Returns   -1 is failed; other is the number of elements
+ */
+/* ----------------------------------------------------------------------------*/
+int rbtree_delete(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    int ret = rbtree_clear(common);
+
+    RBTree *tree = (RBTree*)(common->linked_type);
+    slab_delete(&tree->node_pool);
+    mem_free(common->allocator, tree);
+    common->linked_type = NULL;
+
+    return ret;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file RBtree.h
+ * @Brief  red-black tree header, the elements are kept in the order of
+ *         their keys
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-05-02
+ */
+
+#ifndef RB_TREE_H_
+#define RB_TREE_H_
+
+#include "Common.h"
+#include "util/Slab.h"
+
+#define RBTREE_RED 0
+#define RBTREE_BLACK 1
+
+/**
+ * Represent a node, the parent link lets the tree walk in order without
+ * recursion or a stack
+ */
+typedef struct RBNode{
+    void *element;
+    struct RBNode *parent;
+    struct RBNode *left;
+    struct RBNode *right;
+    int color;
+}RBNode;
+
+typedef struct RBTree{
+    RBNode *root;
+    int size;
+
+    /**
+     * the slab that all the nodes come from
+     */
+    Slab node_pool;
+}RBTree;
+
+/**
+ * an ordered data, see key_compare in Common.h
+ */
+int rbtree_new(DataCommon *common);
+int rbtree_delete(DataCommon *common);
+
+int rbtree_lower_bound(DataCommon *common, void *key, Cursor *cursor);
+int rbtree_upper_bound(DataCommon *common, void *key, Cursor *cursor);
+int rbtree_range_iterate(DataCommon *common, void *low, void *high);
+
+#endif
@@ -0,0 +1,628 @@
+/**
+ * @file test.c
+ * @Brief  test red-black tree
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-05-02
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+/**
+ * Cunit headers
+ */ 
+#include "CUnit.h"
+#include "Automated.h"
+#include "Basic.h"
+#include "Console.h"
+
+/**
+ * Test file headers
+ */ 
+#include "Common.h"
+#include "rbtree/RBtree.h"
+#include "util/Log.h"
+
+
+/*************Test Case Begin*******************/
+
+#define TREE_COUNT 5000
+
+DataCommon numbers = DATA_COMMON_NULL;
+int values[TREE_COUNT];
+int destroyed = 0;
+int visited = 0;
+int last = -1;
+int ordered = 1;
+
+int number_alter(void *element, void *arg)
+{
+    return *(int*)element == *(int*)arg ? 0 : -1;
+}
+
+int number_destroy(void *element)
+{
+    *(int*)element = -1;
+    destroyed++;
+    return 0;
+}
+
+/**
+ * checks that the elements come in the order of the keys
+ */
+int number_iteration(void *element)
+{
+    if (*(int*)element <= last)
+	ordered = 0;
+    last = *(int*)element;
+    visited++;
+    return 0;
+}
+
+int number_compare(void *key1, void *key2)
+{
+    return *(int*)key1 - *(int*)key2;
+}
+
+void* number_key(void *element)
+{
+    return element;
+}
+
+void number_common(DataCommon *common)
+{
+    common->alter_match = number_alter;
+    common->destroy_node = number_destroy;
+    common->handle_iteration = number_iteration;
+    common->key_compare = number_compare;
+    common->element_key = number_key;
+}
+
+void iterate_reset()
+{
+    visited = 0;
+    last = -1;
+    ordered = 1;
+}
+
+/**
+ * the black height of a subtree, the keys are between low and high
+ */
+int check_node(RBNode *node, RBNode *parent, int low, int high)
+{
+    if (node == NULL)
+	return 1;
+
+    CU_ASSERT_PTR_EQUAL_FATAL(node->parent, parent);
+    CU_ASSERT_TRUE_FATAL(*(int*)node->element > low && *(int*)node->element < high);
+    if (node->color == RBTREE_RED){
+	CU_ASSERT_TRUE_FATAL(node->left == NULL || node->left->color == RBTREE_BLACK);
+	CU_ASSERT_TRUE_FATAL(node->right == NULL || node->right->color == RBTREE_BLACK);
+    }
+
+    int left = check_node(node->left, node, low, *(int*)node->element);
+    int right = check_node(node->right, node, *(int*)node->element, high);
+    CU_ASSERT_EQUAL_FATAL(left, right);
+
+    return left + (node->color == RBTREE_BLACK);
+}
+
+void check_tree(DataCommon *common)
+{
+    RBTree *tree = (RBTree*)common->linked_type;
+    CU_ASSERT_TRUE_FATAL(tree->root == NULL || tree->root->color == RBTREE_BLACK);
+    check_node(tree->root, NULL, -2, TREE_COUNT * 2 + 2);
+
+    iterate_reset();
+    CU_ASSERT_EQUAL_FATAL(common->iterate(common), 0);
+    CU_ASSERT_EQUAL_FATAL(visited, tree->size);
+    CU_ASSERT_EQUAL_FATAL(ordered, 1);
+}
+
+/**
+ * the number of nodes on the longest path down from a node
+ */
+int tree_height(RBNode *node)
+{
+    if (node == NULL)
+	return 0;
+
+    int left = tree_height(node->left);
+    int right = tree_height(node->right);
+    return (left > right ? left : right) + 1;
+}
+
+/**
+ * the first node with two children whose successor is not its right child
+ */
+RBNode* deep_successor(RBNode *node)
+{
+    if (node == NULL)
+	return NULL;
+    if (node->left && node->right && node->right->left)
+	return node;
+
+    RBNode *found = deep_successor(node->left);
+    return found ? found : deep_successor(node->right);
+}
+
+void shuffle(int *order, int count)
+{
+    int i, j, temp;
+    for (i=0; i<count; i++)
+	order[i] = i;
+    for (i=count-1; i>0; i--){
+	j = rand() % (i + 1);
+	temp = order[i];
+	order[i] = order[j];
+	order[j] = temp;
+    }
+}
+
+void test_rbtree_new()
+{
+    DataCommon common = DATA_COMMON_NULL;
+    CU_ASSERT_EQUAL(rbtree_new(&common), -1);
+
+    number_common(&common);
+    CU_ASSERT_EQUAL(rbtree_new(&common), 0);
+    CU_ASSERT_EQUAL(common.size(&common), 0);
+    Cursor cursor = CURSOR_NULL;
+    CU_ASSERT_EQUAL(common.begin(&common, &cursor), -1);
+    CU_ASSERT_EQUAL(common.end(&common, &cursor), -1);
+    CU_ASSERT_EQUAL(rbtree_delete(&common), 0);
+}
+
+void test_rbtree_insert()
+{
+    number_common(&numbers);
+    CU_ASSERT_EQUAL_FATAL(rbtree_new(&numbers), 0);
+
+    /**
+     * the even numbers in a shuffled order
+     */
+    int order[TREE_COUNT];
+    int i;
+    srand(1);
+    shuffle(order, TREE_COUNT);
+    for (i=0; i<TREE_COUNT; i++){
+	values[order[i]] = order[i] * 2;
+	CU_ASSERT_EQUAL_FATAL(numbers.insert(&numbers, &values[order[i]]), 0);
+	if (i % 500 == 0)
+	    check_tree(&numbers);
+    }
+    CU_ASSERT_EQUAL(numbers.size(&numbers), TREE_COUNT);
+	check_tree(&numbers);
+
+    int key = 10;
+    CU_ASSERT_EQUAL(numbers.insert(&numbers, &key), -1);
+    CU_ASSERT_EQUAL(numbers.size(&numbers), TREE_COUNT);
+}
+
+void test_rbtree_search()
+{
+    int i, key;
+    for (i=0; i<TREE_COUNT; i++){
+	key = i * 2;
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), &values[i]);
+	CU_ASSERT_EQUAL_FATAL(numbers.alter(&numbers, &key), 0);
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.prior(&numbers, &key), i ? &values[i-1] : NULL);
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.next(&numbers, &key), \
+		i < TREE_COUNT - 1 ? &values[i+1] : NULL);
+	key = i * 2 + 1;
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), NULL);
+    }
+    CU_ASSERT_EQUAL(numbers.alter(&numbers, &key), -1);
+    CU_ASSERT_EQUAL(numbers.remove(&numbers, &key), -1);
+    CU_ASSERT_PTR_EQUAL(numbers.prior(&numbers, &key), NULL);
+}
+
+void test_rbtree_bound()
+{
+    Cursor cursor = CURSOR_NULL;
+    int i, key;
+    for (i=0; i<TREE_COUNT; i++){
+	key = i * 2;
+	CU_ASSERT_EQUAL_FATAL(rbtree_lower_bound(&numbers, &key, &cursor), 0);
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.get(&numbers, &cursor), &values[i]);
+	key = i * 2 - 1;
+	CU_ASSERT_EQUAL_FATAL(rbtree_upper_bound(&numbers, &key, &cursor), 0);
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.get(&numbers, &cursor), &values[i]);
+	key = i * 2;
+	if (i < TREE_COUNT - 1){
+	    CU_ASSERT_EQUAL_FATAL(rbtree_upper_bound(&numbers, &key, &cursor), 0);
+	    CU_ASSERT_PTR_EQUAL_FATAL(numbers.get(&numbers, &cursor), &values[i+1]);
+	}
+    }
+    CU_ASSERT_EQUAL(rbtree_upper_bound(&numbers, &key, &cursor), -1);
+    CU_ASSERT_PTR_EQUAL(cursor.node, NULL);
+    key = TREE_COUNT * 2;
+    CU_ASSERT_EQUAL(rbtree_lower_bound(&numbers, &key, &cursor), -1);
+
+    int low = 101, high = 2001;
+    iterate_reset();
+    CU_ASSERT_EQUAL(rbtree_range_iterate(&numbers, &low, &high), 950);
+    CU_ASSERT_EQUAL(ordered, 1);
+    CU_ASSERT_EQUAL(last, 2000);
+
+    low = 99, high = 99;
+    CU_ASSERT_EQUAL(rbtree_range_iterate(&numbers, &low, &high), 0);
+    iterate_reset();
+    CU_ASSERT_EQUAL(rbtree_range_iterate(&numbers, NULL, &high), 50);
+    iterate_reset();
+    CU_ASSERT_EQUAL(rbtree_range_iterate(&numbers, &low, NULL), TREE_COUNT - 50);
+}
+
+void test_rbtree_cursor()
+{
+    Cursor cursor = CURSOR_NULL;
+    int count = 0;
+
+    CU_ASSERT_EQUAL_FATAL(numbers.begin(&numbers, &cursor), 0);
+    for (; CURSOR_VALID(&cursor); numbers.advance(&numbers, &cursor)){
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.get(&numbers, &cursor), &values[count]);
+	count++;
+    }
+    CU_ASSERT_EQUAL(count, TREE_COUNT);
+
+    count = 0;
+    CU_ASSERT_EQUAL_FATAL(numbers.end(&numbers, &cursor), 0);
+    for (; CURSOR_VALID(&cursor); numbers.retreat(&numbers, &cursor)){
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.get(&numbers, &cursor), &values[TREE_COUNT-1-count]);
+	count++;
+    }
+    CU_ASSERT_EQUAL(count, TREE_COUNT);
+    CU_ASSERT_EQUAL(numbers.insert_after(&numbers, &cursor, &values[0]), -1);
+
+    /**
+     * erase the multiples of 4 by the cursor
+     */
+    destroyed = 0;
+    count = 0;
+    numbers.begin(&numbers, &cursor);
+    while (CURSOR_VALID(&cursor)){
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.get(&numbers, &cursor), &values[count]);
+	if (count % 2 == 0){
+	    CU_ASSERT_EQUAL_FATAL(numbers.erase(&numbers, &cursor), 0);
+	}else{
+	    numbers.advance(&numbers, &cursor);
+	}
+	count++;
+    }
+    CU_ASSERT_EQUAL(count, TREE_COUNT);
+    CU_ASSERT_EQUAL(destroyed, TREE_COUNT / 2);
+    CU_ASSERT_EQUAL(numbers.size(&numbers), TREE_COUNT / 2);
+    check_tree(&numbers);
+}
+
+void test_rbtree_remove()
+{
+    int order[TREE_COUNT];
+    int i, key;
+
+    /**
+     * put the even indexes back, then remove everything in a shuffled
+     * order
+     */
+    for (i=0; i<TREE_COUNT; i+=2){
+	values[i] = i * 2;
+	CU_ASSERT_EQUAL_FATAL(numbers.insert(&numbers, &values[i]), 0);
+    }
+    check_tree(&numbers);
+
+    shuffle(order, TREE_COUNT);
+    for (i=0; i<TREE_COUNT; i++){
+	key = order[i] * 2;
+	CU_ASSERT_EQUAL_FATAL(numbers.remove(&numbers, &key), 0);
+	CU_ASSERT_EQUAL_FATAL(values[order[i]], -1);
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), NULL);
+	if (i % 250 == 0)
+	    check_tree(&numbers);
+    }
+    CU_ASSERT_EQUAL(numbers.size(&numbers), 0);
+    CU_ASSERT_PTR_EQUAL(((RBTree*)numbers.linked_type)->root, NULL);
+    check_tree(&numbers);
+
+    Cursor cursor = CURSOR_NULL;
+    CU_ASSERT_EQUAL(numbers.begin(&numbers, &cursor), -1);
+    CU_ASSERT_EQUAL(numbers.end(&numbers, &cursor), -1);
+}
+
+void test_rbtree_delete()
+{
+    int i;
+    for (i=0; i<100; i++){
+	values[i] = i;
+	CU_ASSERT_EQUAL_FATAL(numbers.insert(&numbers, &values[i]), 0);
+    }
+    destroyed = 0;
+    CU_ASSERT_EQUAL(rbtree_delete(&numbers), 100);
+    CU_ASSERT_EQUAL(destroyed, 100);
+    CU_ASSERT_PTR_EQUAL(numbers.linked_type, NULL);
+}
+
+void test_rbtree_sequential()
+{
+    DataCommon common = DATA_COMMON_NULL;
+    RBTree *tree = NULL;
+    Cursor cursor = CURSOR_NULL;
+    int i, bits, black;
+
+    number_common(&common);
+    CU_ASSERT_EQUAL_FATAL(rbtree_new(&common), 0);
+    tree = (RBTree*)common.linked_type;
+
+    /**
+     * the ascending keys keep going right, the rotations keep the height
+     * within 2*log2(n+1) and the black height within log2(n+1)
+     */
+    for (i=0; i<TREE_COUNT; i++){
+	values[i] = i;
+	CU_ASSERT_EQUAL_FATAL(common.insert(&common, &values[i]), 0);
+	for (bits=0; (1 << bits) < i + 2; bits++);
+	CU_ASSERT_TRUE_FATAL(tree_height(tree->root) <= 2 * bits);
+	black = check_node(tree->root, NULL, -2, TREE_COUNT * 2 + 2) - 1;
+	CU_ASSERT_TRUE_FATAL((1 << black) - 1 <= i + 1);
+    }
+    check_tree(&common);
+
+    /**
+     * erase from the front, the tree loses its left side only
+     */
+    destroyed = 0;
+    CU_ASSERT_EQUAL_FATAL(common.begin(&common, &cursor), 0);
+    for (i=0; i<TREE_COUNT/2; i++)
+	CU_ASSERT_EQUAL_FATAL(common.erase(&common, &cursor), 0);
+    CU_ASSERT_PTR_EQUAL(common.get(&common, &cursor), &values[TREE_COUNT/2]);
+    for (bits=0; (1 << bits) < TREE_COUNT/2 + 1; bits++);
+    CU_ASSERT_TRUE(tree_height(tree->root) <= 2 * bits);
+    check_tree(&common);
+    CU_ASSERT_EQUAL(rbtree_delete(&common), TREE_COUNT/2);
+    CU_ASSERT_EQUAL(destroyed, TREE_COUNT);
+
+    /**
+     * and the descending keys keep going left
+     */
+    number_common(&common);
+    CU_ASSERT_EQUAL_FATAL(rbtree_new(&common), 0);
+    tree = (RBTree*)common.linked_type;
+    for (i=TREE_COUNT-1; i>=0; i--){
+	values[i] = i;
+	CU_ASSERT_EQUAL_FATAL(common.insert(&common, &values[i]), 0);
+    }
+    for (bits=0; (1 << bits) < TREE_COUNT + 1; bits++);
+    CU_ASSERT_TRUE(tree_height(tree->root) <= 2 * bits);
+    check_tree(&common);
+    CU_ASSERT_EQUAL(rbtree_delete(&common), TREE_COUNT);
+}
+
+void test_rbtree_erase_deep()
+{
+    DataCommon common = DATA_COMMON_NULL;
+    RBTree *tree = NULL;
+    RBNode *node, *next, *prior;
+    Cursor cursor = CURSOR_NULL;
+    int order[TREE_COUNT];
+    int i, key, count = 0;
+
+    number_common(&common);
+    CU_ASSERT_EQUAL_FATAL(rbtree_new(&common), 0);
+    tree = (RBTree*)common.linked_type;
+    srand(2);
+    shuffle(order, TREE_COUNT);
+    for (i=0; i<TREE_COUNT; i++){
+	values[order[i]] = order[i];
+	CU_ASSERT_EQUAL_FATAL(common.insert(&common, &values[order[i]]), 0);
+    }
+
+    /**
+     * the successor comes up from the bottom of the right subtree into the
+     * place of the node, a cursor on the successor still works
+     */
+    while ((node = deep_successor(tree->root)) != NULL){
+	for (next = node->right; next->left; next = next->left);
+	for (prior = node->left; prior->right; prior = prior->right);
+	key = *(int*)node->element;
+	CU_ASSERT_EQUAL_FATAL(rbtree_lower_bound(&common, next->element, &cursor), 0);
+	CU_ASSERT_EQUAL_FATAL(common.remove(&common, &key), 0);
+	CU_ASSERT_PTR_EQUAL_FATAL(cursor.node, next);
+	CU_ASSERT_PTR_EQUAL_FATAL(common.prior(&common, next->element), prior->element);
+	count++;
+	if (count % 100 == 0)
+	    check_tree(&common);
+    }
+    CU_ASSERT_TRUE(count > TREE_COUNT / 10);
+    check_tree(&common);
+    CU_ASSERT_EQUAL(rbtree_delete(&common), TREE_COUNT - count);
+}
+
+void test_rbtree_cursor_stable()
+{
+    DataCommon common = DATA_COMMON_NULL;
+    Cursor cursor = CURSOR_NULL;
+    int i, key, expect, behind = -1;
+
+    number_common(&common);
+    CU_ASSERT_EQUAL_FATAL(rbtree_new(&common), 0);
+    for (i=0; i<TREE_COUNT; i++){
+	values[i] = i;
+	CU_ASSERT_EQUAL_FATAL(common.insert(&common, &values[i]), 0);
+    }
+
+    /**
+     * the cursor stays on A while the element behind it is erased, it is
+     * often a node with two children whose successor is A, and while one
+     * ahead of it is erased; A goes on to the next element left
+     */
+    CU_ASSERT_EQUAL_FATAL(common.begin(&common, &cursor), 0);
+    for (expect=0; CURSOR_VALID(&cursor); ){
+	CU_ASSERT_PTR_EQUAL_FATAL(common.get(&common, &cursor), &values[expect]);
+	if (behind >= 0)
+	    CU_ASSERT_EQUAL_FATAL(common.remove(&common, &behind), 0);
+	behind = expect;
+	expect++;
+	if (expect % 3 == 1 && expect < TREE_COUNT){
+	    key = expect;
+	    CU_ASSERT_EQUAL_FATAL(common.remove(&common, &key), 0);
+	    expect++;
+	}
+	if (expect % 500 == 0)
+	    check_tree(&common);
+	common.advance(&common, &cursor);
+    }
+    CU_ASSERT_TRUE(expect >= TREE_COUNT);
+    CU_ASSERT_EQUAL(common.size(&common), 1);
+    check_tree(&common);
+    CU_ASSERT_EQUAL(rbtree_delete(&common), 1);
+}
+
+/*************Test Case End*********************/
+
+
+
+/**
+ * add testcase, similar function in the same testcase
+ * 
+ * typedef struct CU_TestInfo {
+ * 	const char  *pName;
+ *	CU_TestFunc pTestFunc;
+ *	} CU_TestInfo;
+ *
+ * Example:
+ *
+ * static CU_TestInfo testcase1[] = {
+ * 	{ "test_function_name", test_function},
+ * 	{ "test_function_name2", test_function2},
+ * 	CU_TEST_INFO_NULL
+ * };
+ *
+ * static CU_TestInfo testcase2[] = {
+ * 	...
+ * 	CU_TEST_INFO_NULL
+ * };
+ *
+ */ 
+
+static CU_TestInfo testcase1[] = {
+    { "test_rbtree_new", test_rbtree_new},
+    { "test_rbtree_insert", test_rbtree_insert},
+    { "test_rbtree_search", test_rbtree_search},
+    { "test_rbtree_bound", test_rbtree_bound},
+    { "test_rbtree_cursor", test_rbtree_cursor},
+    { "test_rbtree_remove", test_rbtree_remove},
+    { "test_rbtree_delete", test_rbtree_delete},
+    { "test_rbtree_sequential", test_rbtree_sequential},
+    { "test_rbtree_erase_deep", test_rbtree_erase_deep},
+    { "test_rbtree_cursor_stable", test_rbtree_cursor_stable},
+    CU_TEST_INFO_NULL
+};
+
+/**
+ * add testcase to the suites
+ * 
+ * typedef struct CU_SuiteInfo {
+ *     const char       *pName;         
+ *     CU_InitializeFunc pInitFunc;     
+ *     CU_CleanupFunc    pCleanupFunc;  
+ *     CU_SetUpFunc      pSetUpFunc;    
+ *     CU_TearDownFunc   pTearDownFunc; 
+ *     CU_TestInfo      *pTests;        
+ * } CU_SuiteInfo;
+ *
+ * Example:
+ *
+ * static CU_SuiteInfo suites[] = {
+ * 	{"suite name", suite_success_init, suite_success_clean, NULL, NULL, testcase},
+ * 	...
+ * 	CU_SUITE_INFO_NULL
+ * }
+ *
+ */
+
+static int suite_success_init(void) 
+{
+    return 0; 
+}
+static int suite_success_clean(void) 
+{
+    return 0; 
+}
+
+
+static CU_SuiteInfo suites[] = {
+    {"suite1", suite_success_init, NULL, NULL, NULL, testcase1},
+    CU_SUITE_INFO_NULL
+};
+
+
+
+/**
+ * add tests to the test framework
+ *
+ */ 
+void AddTests(void)
+{
+    assert(NULL != CU_get_registry());
+    assert(!CU_is_test_running());
+
+    /* Register suites. */
+    if (CU_register_suites(suites) != CUE_SUCCESS) {
+	fprintf(stderr, "suite registration failed - %s\n",
+		CU_get_error_msg());
+	exit(EXIT_FAILURE);
+    }
+
+}
+
+
+int main()
+{
+    if (CU_initialize_registry()) {
+	printf("\nInitialization of Test Registry failed.");
+    }else{
+
+	LOG_FILE_OPEN("log.txt");
+
+	AddTests();
+
+	/*******Automated Mode(best)*********************
+	 * CU_set_output_filename("TestAutomated");
+	 * CU_list_tests_to_file();
+	 * CU_automated_run_tests();
+	 ******************************************/
+
+	 CU_set_output_filename("TestAutomated");
+	 CU_list_tests_to_file();
+	 CU_automated_run_tests();
+	/*******Basic Mode*********************
+	 * mode can choose:
+	 * typedef enum {
+	 *   CU_BRM_NORMAL = 0, Normal mode - failures and run summary are printed [default].
+	 *   CU_BRM_SILENT,     Silent mode - no output is printed except framework error messages.
+	 *   CU_BRM_VERBOSE     Verbose mode - maximum output of run details.
+	 * } CU_BasicRunMode;
+	 ****************************************
+	 *
+	 * CU_basic_set_mode(CU_BRM_NORMAL);
+	 * CU_basic_run_tests();
+	 ******************************************/
+
+	/*******Console Mode*********************
+	 * CU_console_run_tests();
+	 ******************************************/
+
+	/*******Curses Mode*********************
+	 * CU_curses_run_tests();
+	 ******************************************/ 
+
+
+	CU_cleanup_registry();
+    }
+
+    LOG_FILE_CLOSE();
+    return 0;
+}
+
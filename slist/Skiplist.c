@@ -0,0 +1,780 @@
+/**
+ * @file Skiplist.c
+ * @Brief  skip list implementation. Every node is in the bottom level, a
+ *         quarter of them in the next one and so on, so a search skips most
+ *         of the list from the top level down
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-30
+ */
+
+#include <stdlib.h>
+
+#include "Skiplist.h"
+#include "util/Log.h"
+
+#define SLIST_KEY(common, node) ((common)->element_key((node)->element))
+#define SLIST_COMPARE(common, node, key) ((common)->key_compare(SLIST_KEY(common, node), key))
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_node create a node
+ *
+ * @Param common data common struct
+ * @Param element the element
+ * @Param level the height of the tower
+ *
+ * @Returns   NULL is failed; other is the node
+ */
+/* ----------------------------------------------------------------------------*/
+static SkipNode* slist_node(DataCommon *common, void *element, int level)
+{
+    SkipNode *node = (SkipNode*)mem_alloc(common->allocator, \
+	    sizeof(SkipNode) + level * sizeof(SkipNode*));
+    if (node == NULL){
+	ERROR("malloc error!");
+	return NULL;
+    }
+
+    int i;
+    node->element = element;
+    node->previous = NULL;
+    node->level = level;
+    for (i=0; i<level; i++)
+	node->next[i] = NULL;
+
+    return node;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_level get a random level, every level is a quarter as
+ *         likely as the one below
+ *
+ * @Param list skip list
+ *
+ * @Returns   the level
+ */
+/* ----------------------------------------------------------------------------*/
+static int slist_level(SkipList *list)
+{
+    unsigned long random = list->seed;
+    random ^= random << 13;
+    random ^= random >> 7;
+    random ^= random << 17;
+    list->seed = random;
+
+    int level = 1;
+    while (level < SKIPLIST_MAX_LEVEL && (random & 3) == 0){
+	level++;
+	random >>= 2;
+    }
+
+    return level;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_before find the last node before a key
+ *
+ * @Param common data common struct
+ * @Param key the key
+ * @Param update where the last node before the key at every level is put,
+ *        may be NULL
+ * @Param inclusive 0 means the nodes less than the key; other means the
+ *        nodes not greater than the key
+ *
+ * @Returns   the node, the head means no one
+ */
+/* ----------------------------------------------------------------------------*/
+static SkipNode* slist_before(DataCommon *common, void *key, SkipNode **update, \
+	int inclusive)
+{
+    SkipList *list = (SkipList*)(common->linked_type);
+    SkipNode *node = list->head;
+    int i;
+
+    for (i=list->level-1; i>=0; i--){
+	while (node->next[i] != NULL \
+		&& SLIST_COMPARE(common, node->next[i], key) < inclusive)
+	    node = node->next[i];
+	if (update)
+	    update[i] = node;
+    }
+
+    return node;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_find find the node of a key
+ *
+ * @Param common data common struct
+ * @Param key the key
+ * @Param update the same as slist_before
+ *
+ * @Returns   NULL means no one; other is the node
+ */
+/* ----------------------------------------------------------------------------*/
+static SkipNode* slist_find(DataCommon *common, void *key, SkipNode **update)
+{
+    SkipNode *node = slist_before(common, key, update, 0)->next[0];
+
+    if (node == NULL || SLIST_COMPARE(common, node, key) != 0)
+	return NULL;
+
+    return node;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_unlink take a node out of the list and destroy it
+ *
+ * @Param common data common struct
+ * @Param update the last nodes before the node at every level
+ * @Param node the node
+ */
+/* ----------------------------------------------------------------------------*/
+static void slist_unlink(DataCommon *common, SkipNode **update, SkipNode *node)
+{
+    SkipList *list = (SkipList*)(common->linked_type);
+    int i;
+
+    for (i=0; i<node->level; i++)
+	update[i]->next[i] = node->next[i];
+    if (node->next[0])
+	node->next[0]->previous = node->previous;
+    else
+	list->tail = node->previous;
+    while (list->level > 1 && list->head->next[list->level-1] == NULL)
+	list->level--;
+
+    common->destroy_node(node->element);
+    mem_free(common->allocator, node);
+    list->size--;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_insert insert an element at its place, its key must not be
+ *         in the list
+ *
+ * @Param common data common struct
+ * @Param element the element
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int slist_insert(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    SkipList *list = (SkipList*)(common->linked_type);
+    SkipNode *update[SKIPLIST_MAX_LEVEL];
+    void *key = common->element_key(element);
+    SkipNode *before = slist_before(common, key, update, 0);
+    if (before->next[0] != NULL && SLIST_COMPARE(common, before->next[0], key) == 0){
+	INFO("the key is in the list!");
+	return -1;
+    }
+
+    int level = slist_level(list);
+    SkipNode *node = slist_node(common, element, level);
+    if (node == NULL)
+	return -1;
+
+    int i;
+    for (i=list->level; i<level; i++)
+	update[i] = list->head;
+    if (level > list->level)
+	list->level = level;
+
+    for (i=0; i<level; i++){
+	node->next[i] = update[i]->next[i];
+	update[i]->next[i] = node;
+    }
+    node->previous = (before == list->head) ? NULL : before;
+    if (node->next[0])
+	node->next[0]->previous = node;
+    else
+	list->tail = node;
+    list->size++;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_remove remove the element of a key and destroy it
+ *
+ * @Param common data common struct
+ * @Param element the key
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int slist_remove(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    SkipNode *update[SKIPLIST_MAX_LEVEL];
+    SkipNode *node = slist_find(common, element, update);
+    if (node == NULL)
+	return -1;
+    slist_unlink(common, update, node);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_search get the element of a key
+ *
+ * @Param common data common struct
+ * @Param element the key
+ *
+ * @Returns   NULL means no one; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* slist_search(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return NULL;
+    }
+
+    SkipNode *node = slist_find(common, element, NULL);
+
+    return node == NULL ? NULL : node->element;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_alter alter the element that has the same key, by the
+ *         alter_match function; the function must not change the key
+ *
+ * @Param common data common struct
+ * @Param element the element-like argument
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int slist_alter(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    SkipNode *node = slist_find(common, common->element_key(element), NULL);
+    if (node == NULL)
+	return -1;
+
+    return (common->alter_match)(node->element, element);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_prior get the element before the one of a key
+ *
+ * @Param common data common struct
+ * @Param element the key
+ *
+ * @Returns   NULL means no one; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* slist_prior(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return NULL;
+    }
+
+    SkipNode *node = slist_find(common, element, NULL);
+    if (node == NULL || node->previous == NULL)
+	return NULL;
+
+    return node->previous->element;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_next get the element after the one of a key
+ *
+ * @Param common data common struct
+ * @Param element the key
+ *
+ * @Returns   NULL means no one; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* slist_next(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return NULL;
+    }
+
+    SkipNode *node = slist_find(common, element, NULL);
+    if (node == NULL || node->next[0] == NULL)
+	return NULL;
+
+    return node->next[0]->element;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_iterate iterate the list in the order of the keys
+ *
+ * @Param common data common struct
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int slist_iterate(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    SkipList *list = (SkipList*)(common->linked_type);
+    SkipNode *node = list->head->next[0];
+
+    for (; node; node=node->next[0])
+	if ((common->handle_iteration)(node->element) != 0){
+	    ERROR("handle_iteration function error!");
+	    return -1;
+	}
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_size get the number of elements
+ *
+ * @Param common data common struct
+ *
+ * @Returns   -1 is failed; other is the size
+ */
+/* ----------------------------------------------------------------------------*/
+static int slist_size(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    return ((SkipList*)(common->linked_type))->size;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_clear destroy all the elements and their nodes
+ *
+ * @Param common data common struct
+ *
+ * @Returns   -1 is failed; other is the number of elements
+ */
+/* ----------------------------------------------------------------------------*/
+static int slist_clear(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    SkipList *list = (SkipList*)(common->linked_type);
+    SkipNode *node = list->head->next[0];
+    SkipNode *next = NULL;
+    int i;
+
+    for (; node; node=next){
+	next = node->next[0];
+	common->destroy_node(node->element);
+	mem_free(common->allocator, node);
+    }
+    for (i=0; i<SKIPLIST_MAX_LEVEL; i++)
+	list->head->next[i] = NULL;
+    list->tail = NULL;
+    list->level = 1;
+
+    int ret = list->size;
+    list->size = 0;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_begin put the cursor on the first element
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means the list is empty
+ */
+/* ----------------------------------------------------------------------------*/
+static int slist_begin(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    cursor->node = ((SkipList*)(common->linked_type))->head->next[0];
+    cursor->previous = NULL;
+    cursor->index = 0;
+
+    return cursor->node ? 0 : -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_end put the cursor on the last element
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means the list is empty
+ */
+/* ----------------------------------------------------------------------------*/
+static int slist_end(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    cursor->node = ((SkipList*)(common->linked_type))->tail;
+    cursor->previous = NULL;
+    cursor->index = 0;
+
+    return cursor->node ? 0 : -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_advance move the cursor to the next element
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means the cursor is off the list
+ */
+/* ----------------------------------------------------------------------------*/
+static int slist_advance(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+    if (cursor->node == NULL)
+	return -1;
+
+    cursor->node = ((SkipNode*)(cursor->node))->next[0];
+
+    return cursor->node ? 0 : -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_retreat move the cursor to the prior element
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means the cursor is off the list
+ */
+/* ----------------------------------------------------------------------------*/
+static int slist_retreat(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+    if (cursor->node == NULL)
+	return -1;
+
+    cursor->node = ((SkipNode*)(cursor->node))->previous;
+
+    return cursor->node ? 0 : -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_get return the element under the cursor
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   NULL means the cursor is off the list; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* slist_get(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return NULL;
+    }
+
+    SkipNode *node = (SkipNode*)(cursor->node);
+
+    return node == NULL ? NULL : node->element;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_erase remove the element under the cursor, the cursor
+ *         moves to the next one
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int slist_erase(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+    if (cursor->node == NULL)
+	return -1;
+
+    SkipNode *node = (SkipNode*)(cursor->node);
+    SkipNode *update[SKIPLIST_MAX_LEVEL];
+
+    /**
+     * the nodes before it at the upper levels are only found from the top
+     */
+    slist_before(common, SLIST_KEY(common, node), update, 0);
+    cursor->node = node->next[0];
+    slist_unlink(common, update, node);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_insert_after refused as in all the ordered data
+ */
+/* ----------------------------------------------------------------------------*/
+static int slist_insert_after(DataCommon *common, Cursor *cursor, void *element)
+{
+    (void)common;
+    (void)cursor;
+    (void)element;
+    ERROR("the skip list keeps the order, use insert!");
+    return -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_lower_bound put the cursor on the first element whose key
+ *         is not less than a key
+ *
+ * @Param common data common struct
+ * @Param key the key
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means no one
+ */
+/* ----------------------------------------------------------------------------*/
+int slist_lower_bound(DataCommon *common, void *key, Cursor *cursor)
+{
+    if ((common == NULL) || (key == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    cursor->node = slist_before(common, key, NULL, 0)->next[0];
+    cursor->previous = NULL;
+    cursor->index = 0;
+
+    return cursor->node ? 0 : -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_upper_bound put the cursor on the first element whose key
+ *         is greater than a key
+ *
+ * @Param common data common struct
+ * @Param key the key
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means no one
+ */
+/* ----------------------------------------------------------------------------*/
+int slist_upper_bound(DataCommon *common, void *key, Cursor *cursor)
+{
+    if ((common == NULL) || (key == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    cursor->node = slist_before(common, key, NULL, 1)->next[0];
+    cursor->previous = NULL;
+    cursor->index = 0;
+
+    return cursor->node ? 0 : -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_range_iterate iterate the elements whose keys are in
+ *         [low, high), by the handle_iteration function
+ *
+ * @Param common data common struct
+ * @Param low the first key, NULL means from the first element
+ * @Param high the key after the last, NULL means to the last element
+ *
+ * @Returns   -1 is failed; other is the number of elements
+ */
+/* ----------------------------------------------------------------------------*/
+int slist_range_iterate(DataCommon *common, void *low, void *high)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    SkipList *list = (SkipList*)(common->linked_type);
+    SkipNode *node = low ? slist_before(common, low, NULL, 0)->next[0] : list->head->next[0];
+    int ret = 0;
+
+    for (; node && (high == NULL || SLIST_COMPARE(common, node, high) < 0); node=node->next[0]){
+	if ((common->handle_iteration)(node->element) != 0){
+	    ERROR("handle_iteration function error!");
+	    return -1;
+	}
+	ret++;
+    }
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_new create a skip list, initial datacommon struct
+ *
+ * @Param common data common struct
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int slist_new(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    /**
+     * check the user-defined functhion
+     */
+    int handle_check = DATA_COMMON_ORDERED(common) \
+		       &&common->alter_match \
+		       &&common->destroy_node \
+		       &&common->handle_iteration \
+		       &&ALLOCATOR_CHECK(common->allocator);
+    if (handle_check == 0){
+	ERROR("missed user defined function!");
+	return -1;
+    }
+
+    SkipList *list = (SkipList*)mem_alloc(common->allocator, sizeof(SkipList));
+    if (list == NULL){
+	ERROR("malloc error!");
+	return -1;
+    }
+    list->head = slist_node(common, NULL, SKIPLIST_MAX_LEVEL);
+    if (list->head == NULL){
+	mem_free(common->allocator, list);
+	return -1;
+    }
+    list->tail = NULL;
+    list->level = 1;
+    list->size = 0;
+    list->seed = (unsigned long)list | 1;
+
+    common->linked_type = list;
+    common->insert = slist_insert;
+    common->remove = slist_remove;
+    common->search = slist_search;
+    common->alter = slist_alter;
+    common->prior = slist_prior;
+    common->next = slist_next;
+    common->iterate = slist_iterate;
+    common->size = slist_size;
+    common->clear = slist_clear;
+    common->begin = slist_begin;
+    common->end = slist_end;
+    common->advance = slist_advance;
+    common->retreat = slist_retreat;
+    common->get = slist_get;
+    common->erase = slist_erase;
+    common->insert_after = slist_insert_after;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slist_delete destroy all the elements and the list
+ *
+ * @Param common data common struct
+ *
+ * @Returns   -1 is failed; other is the number of elements
+ */
+/* ----------------------------------------------------------------------------*/
+int slist_delete(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    int ret = slist_clear(common);
+
+    SkipList *list = (SkipList*)(common->linked_type);
+    mem_free(common->allocator, list->head);
+    mem_free(common->allocator, list);
+    common->linked_type = NULL;
+
+    return ret;
+}
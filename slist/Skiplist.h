@@ -0,0 +1,63 @@
+/**
+ * @file Skiplist.h
+ * @Brief  skip list header, the elements are kept in the order of their
+ *         keys
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-30
+ */
+
+#ifndef SKIP_LIST_H_
+#define SKIP_LIST_H_
+
+#include "Common.h"
+
+/**
+ * a list of 4^SKIPLIST_MAX_LEVEL elements still has enough levels
+ */
+#define SKIPLIST_MAX_LEVEL 24
+
+/**
+ * Represent a node, the tower of links is allocated with the node
+ */
+typedef struct SkipNode{
+    void *element;
+    /**
+     * the node before at the bottom level, NULL for the first node
+     */
+    struct SkipNode *previous;
+    int level;
+    /**
+     * next[i] is the next node at the level i
+     */
+    struct SkipNode *next[];
+}SkipNode;
+
+typedef struct SkipList{
+    /**
+     * a node without element that has all the levels
+     */
+    SkipNode *head;
+    SkipNode *tail;
+    /**
+     * the levels in use
+     */
+    int level;
+    int size;
+    /**
+     * the state of the random levels
+     */
+    unsigned long seed;
+}SkipList;
+
+/**
+ * an ordered data, see key_compare in Common.h
+ */
+int slist_new(DataCommon *common);
+int slist_delete(DataCommon *common);
+
+int slist_lower_bound(DataCommon *common, void *key, Cursor *cursor);
+int slist_upper_bound(DataCommon *common, void *key, Cursor *cursor);
+int slist_range_iterate(DataCommon *common, void *low, void *high);
+
+#endif
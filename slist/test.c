@@ -0,0 +1,418 @@
+/**
+ * @file test.c
+ * @Brief  test skip list
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-30
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+/**
+ * Cunit headers
+ */ 
+#include "CUnit.h"
+#include "Automated.h"
+#include "Basic.h"
+#include "Console.h"
+
+/**
+ * Test file headers
+ */ 
+#include "Common.h"
+#include "slist/Skiplist.h"
+#include "util/Log.h"
+
+
+/*************Test Case Begin*******************/
+
+#define LIST_COUNT 2000
+
+DataCommon numbers = DATA_COMMON_NULL;
+int values[LIST_COUNT];
+int destroyed = 0;
+int visited = 0;
+int last = -1;
+int ordered = 1;
+
+int number_alter(void *element, void *arg)
+{
+    return *(int*)element == *(int*)arg ? 0 : -1;
+}
+
+int number_destroy(void *element)
+{
+    *(int*)element = -1;
+    destroyed++;
+    return 0;
+}
+
+/**
+ * checks that the elements come in the order of the keys
+ */
+int number_iteration(void *element)
+{
+    if (*(int*)element <= last)
+	ordered = 0;
+    last = *(int*)element;
+    visited++;
+    return 0;
+}
+
+int number_compare(void *key1, void *key2)
+{
+    return *(int*)key1 - *(int*)key2;
+}
+
+void* number_key(void *element)
+{
+    return element;
+}
+
+void number_common(DataCommon *common)
+{
+    common->alter_match = number_alter;
+    common->destroy_node = number_destroy;
+    common->handle_iteration = number_iteration;
+    common->key_compare = number_compare;
+    common->element_key = number_key;
+}
+
+void iterate_reset()
+{
+    visited = 0;
+    last = -1;
+    ordered = 1;
+}
+
+void test_slist_new()
+{
+    DataCommon common = DATA_COMMON_NULL;
+    CU_ASSERT_EQUAL(slist_new(&common), -1);
+
+    number_common(&common);
+    CU_ASSERT_EQUAL(slist_new(&common), 0);
+    CU_ASSERT_EQUAL(common.size(&common), 0);
+    CU_ASSERT_EQUAL(slist_delete(&common), 0);
+}
+
+void test_slist_insert()
+{
+    number_common(&numbers);
+    CU_ASSERT_EQUAL_FATAL(slist_new(&numbers), 0);
+
+    /**
+     * the even numbers in a shuffled order
+     */
+    int order[LIST_COUNT];
+    int i, j, temp;
+    for (i=0; i<LIST_COUNT; i++)
+	order[i] = i;
+    srand(1);
+    for (i=LIST_COUNT-1; i>0; i--){
+	j = rand() % (i + 1);
+	temp = order[i];
+	order[i] = order[j];
+	order[j] = temp;
+    }
+    for (i=0; i<LIST_COUNT; i++){
+	values[order[i]] = order[i] * 2;
+	CU_ASSERT_EQUAL_FATAL(numbers.insert(&numbers, &values[order[i]]), 0);
+    }
+    CU_ASSERT_EQUAL(numbers.size(&numbers), LIST_COUNT);
+
+    int key = 10;
+    CU_ASSERT_EQUAL(numbers.insert(&numbers, &key), -1);
+    CU_ASSERT_EQUAL(numbers.size(&numbers), LIST_COUNT);
+
+    iterate_reset();
+    CU_ASSERT_EQUAL(numbers.iterate(&numbers), 0);
+    CU_ASSERT_EQUAL(visited, LIST_COUNT);
+    CU_ASSERT_EQUAL(ordered, 1);
+}
+
+void test_slist_search()
+{
+    int i, key;
+    for (i=0; i<LIST_COUNT; i++){
+	key = i * 2;
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), &values[i]);
+	CU_ASSERT_EQUAL_FATAL(numbers.alter(&numbers, &key), 0);
+	key = i * 2 + 1;
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), NULL);
+    }
+    CU_ASSERT_EQUAL(numbers.alter(&numbers, &key), -1);
+    CU_ASSERT_EQUAL(numbers.remove(&numbers, &key), -1);
+
+    key = 0;
+    CU_ASSERT_PTR_EQUAL(numbers.prior(&numbers, &key), NULL);
+    CU_ASSERT_PTR_EQUAL(numbers.next(&numbers, &key), &values[1]);
+    key = (LIST_COUNT - 1) * 2;
+    CU_ASSERT_PTR_EQUAL(numbers.prior(&numbers, &key), &values[LIST_COUNT-2]);
+    CU_ASSERT_PTR_EQUAL(numbers.next(&numbers, &key), NULL);
+}
+
+void test_slist_bound()
+{
+    Cursor cursor = CURSOR_NULL;
+    int key = 100;
+    CU_ASSERT_EQUAL(slist_lower_bound(&numbers, &key, &cursor), 0);
+    CU_ASSERT_PTR_EQUAL(numbers.get(&numbers, &cursor), &values[50]);
+    CU_ASSERT_EQUAL(slist_upper_bound(&numbers, &key, &cursor), 0);
+    CU_ASSERT_PTR_EQUAL(numbers.get(&numbers, &cursor), &values[51]);
+
+    key = 101;
+    CU_ASSERT_EQUAL(slist_lower_bound(&numbers, &key, &cursor), 0);
+    CU_ASSERT_PTR_EQUAL(numbers.get(&numbers, &cursor), &values[51]);
+    CU_ASSERT_EQUAL(slist_upper_bound(&numbers, &key, &cursor), 0);
+    CU_ASSERT_PTR_EQUAL(numbers.get(&numbers, &cursor), &values[51]);
+
+    key = -5;
+    CU_ASSERT_EQUAL(slist_lower_bound(&numbers, &key, &cursor), 0);
+    CU_ASSERT_PTR_EQUAL(numbers.get(&numbers, &cursor), &values[0]);
+    key = (LIST_COUNT - 1) * 2;
+    CU_ASSERT_EQUAL(slist_upper_bound(&numbers, &key, &cursor), -1);
+    CU_ASSERT_PTR_EQUAL(cursor.node, NULL);
+
+    int low = 100, high = 200;
+    iterate_reset();
+    CU_ASSERT_EQUAL(slist_range_iterate(&numbers, &low, &high), 50);
+    CU_ASSERT_EQUAL(visited, 50);
+    CU_ASSERT_EQUAL(ordered, 1);
+    CU_ASSERT_EQUAL(last, 198);
+
+    low = 99, high = 99;
+    CU_ASSERT_EQUAL(slist_range_iterate(&numbers, &low, &high), 0);
+    iterate_reset();
+    CU_ASSERT_EQUAL(slist_range_iterate(&numbers, NULL, &high), 50);
+    iterate_reset();
+    CU_ASSERT_EQUAL(slist_range_iterate(&numbers, &low, NULL), LIST_COUNT - 50);
+}
+
+void test_slist_cursor()
+{
+    Cursor cursor = CURSOR_NULL;
+    int count = 0;
+
+    CU_ASSERT_EQUAL_FATAL(numbers.end(&numbers, &cursor), 0);
+    for (; CURSOR_VALID(&cursor); numbers.retreat(&numbers, &cursor)){
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.get(&numbers, &cursor), &values[LIST_COUNT-1-count]);
+	count++;
+    }
+    CU_ASSERT_EQUAL(count, LIST_COUNT);
+    CU_ASSERT_EQUAL(numbers.insert_after(&numbers, &cursor, &values[0]), -1);
+
+    /**
+     * erase the multiples of 4 by the cursor
+     */
+    destroyed = 0;
+    numbers.begin(&numbers, &cursor);
+    while (CURSOR_VALID(&cursor)){
+	if (*(int*)numbers.get(&numbers, &cursor) % 4 == 0){
+	    CU_ASSERT_EQUAL_FATAL(numbers.erase(&numbers, &cursor), 0);
+	}else{
+	    numbers.advance(&numbers, &cursor);
+	}
+    }
+    CU_ASSERT_EQUAL(destroyed, LIST_COUNT / 2);
+    CU_ASSERT_EQUAL(numbers.size(&numbers), LIST_COUNT / 2);
+
+    iterate_reset();
+    CU_ASSERT_EQUAL(numbers.iterate(&numbers), 0);
+    CU_ASSERT_EQUAL(visited, LIST_COUNT / 2);
+    CU_ASSERT_EQUAL(ordered, 1);
+}
+
+void test_slist_remove()
+{
+    int i, key;
+    for (i=1; i<LIST_COUNT; i+=4){
+	key = i * 2;
+	CU_ASSERT_EQUAL_FATAL(numbers.remove(&numbers, &key), 0);
+	CU_ASSERT_EQUAL_FATAL(values[i], -1);
+    }
+    for (i=3; i<LIST_COUNT; i+=4){
+	key = i * 2;
+	CU_ASSERT_PTR_EQUAL_FATAL(numbers.search(&numbers, &key), &values[i]);
+    }
+    CU_ASSERT_EQUAL(numbers.size(&numbers), LIST_COUNT / 4);
+
+    /**
+     * the list is empty after the last one goes
+     */
+    for (i=3; i<LIST_COUNT; i+=4){
+	key = i * 2;
+	CU_ASSERT_EQUAL_FATAL(numbers.remove(&numbers, &key), 0);
+    }
+    Cursor cursor = CURSOR_NULL;
+    CU_ASSERT_EQUAL(numbers.begin(&numbers, &cursor), -1);
+    CU_ASSERT_EQUAL(numbers.end(&numbers, &cursor), -1);
+    CU_ASSERT_EQUAL(((SkipList*)numbers.linked_type)->level, 1);
+}
+
+void test_slist_delete()
+{
+    int i;
+    for (i=0; i<10; i++){
+	values[i] = i * 2;
+	CU_ASSERT_EQUAL_FATAL(numbers.insert(&numbers, &values[i]), 0);
+    }
+    destroyed = 0;
+    CU_ASSERT_EQUAL(numbers.clear(&numbers), 10);
+    CU_ASSERT_EQUAL(destroyed, 10);
+    CU_ASSERT_EQUAL(numbers.size(&numbers), 0);
+
+    values[3] = 6;
+    CU_ASSERT_EQUAL(numbers.insert(&numbers, &values[3]), 0);
+    CU_ASSERT_EQUAL(numbers.insert(&numbers, &values[3]), -1);
+    CU_ASSERT_EQUAL(slist_delete(&numbers), 1);
+    CU_ASSERT_PTR_EQUAL(numbers.linked_type, NULL);
+}
+
+/*************Test Case End*********************/
+
+
+
+/**
+ * add testcase, similar function in the same testcase
+ * 
+ * typedef struct CU_TestInfo {
+ * 	const char  *pName;
+ *	CU_TestFunc pTestFunc;
+ *	} CU_TestInfo;
+ *
+ * Example:
+ *
+ * static CU_TestInfo testcase1[] = {
+ * 	{ "test_function_name", test_function},
+ * 	{ "test_function_name2", test_function2},
+ * 	CU_TEST_INFO_NULL
+ * };
+ *
+ * static CU_TestInfo testcase2[] = {
+ * 	...
+ * 	CU_TEST_INFO_NULL
+ * };
+ *
+ */ 
+
+static CU_TestInfo testcase1[] = {
+    { "test_slist_new", test_slist_new},
+    { "test_slist_insert", test_slist_insert},
+    { "test_slist_search", test_slist_search},
+    { "test_slist_bound", test_slist_bound},
+    { "test_slist_cursor", test_slist_cursor},
+    { "test_slist_remove", test_slist_remove},
+    { "test_slist_delete", test_slist_delete},
+    CU_TEST_INFO_NULL
+};
+
+/**
+ * add testcase to the suites
+ * 
+ * typedef struct CU_SuiteInfo {
+ *     const char       *pName;         
+ *     CU_InitializeFunc pInitFunc;     
+ *     CU_CleanupFunc    pCleanupFunc;  
+ *     CU_SetUpFunc      pSetUpFunc;    
+ *     CU_TearDownFunc   pTearDownFunc; 
+ *     CU_TestInfo      *pTests;        
+ * } CU_SuiteInfo;
+ *
+ * Example:
+ *
+ * static CU_SuiteInfo suites[] = {
+ * 	{"suite name", suite_success_init, suite_success_clean, NULL, NULL, testcase},
+ * 	...
+ * 	CU_SUITE_INFO_NULL
+ * }
+ *
+ */
+
+static int suite_success_init(void) 
+{
+    return 0; 
+}
+static int suite_success_clean(void) 
+{
+    return 0; 
+}
+
+
+static CU_SuiteInfo suites[] = {
+    {"suite1", suite_success_init, NULL, NULL, NULL, testcase1},
+    CU_SUITE_INFO_NULL
+};
+
+
+
+/**
+ * add tests to the test framework
+ *
+ */ 
+void AddTests(void)
+{
+    assert(NULL != CU_get_registry());
+    assert(!CU_is_test_running());
+
+    /* Register suites. */
+    if (CU_register_suites(suites) != CUE_SUCCESS) {
+	fprintf(stderr, "suite registration failed - %s\n",
+		CU_get_error_msg());
+	exit(EXIT_FAILURE);
+    }
+
+}
+
+
+int main()
+{
+    if (CU_initialize_registry()) {
+	printf("\nInitialization of Test Registry failed.");
+    }else{
+
+	LOG_FILE_OPEN("log.txt");
+
+	AddTests();
+
+	/*******Automated Mode(best)*********************
+	 * CU_set_output_filename("TestAutomated");
+	 * CU_list_tests_to_file();
+	 * CU_automated_run_tests();
+	 ******************************************/
+
+	 CU_set_output_filename("TestAutomated");
+	 CU_list_tests_to_file();
+	 CU_automated_run_tests();
+	/*******Basic Mode*********************
+	 * mode can choose:
+	 * typedef enum {
+	 *   CU_BRM_NORMAL = 0, Normal mode - failures and run summary are printed [default].
+	 *   CU_BRM_SILENT,     Silent mode - no output is printed except framework error messages.
+	 *   CU_BRM_VERBOSE     Verbose mode - maximum output of run details.
+	 * } CU_BasicRunMode;
+	 ****************************************
+	 *
+	 * CU_basic_set_mode(CU_BRM_NORMAL);
+	 * CU_basic_run_tests();
+	 ******************************************/
+
+	/*******Console Mode*********************
+	 * CU_console_run_tests();
+	 ******************************************/
+
+	/*******Curses Mode*********************
+	 * CU_curses_run_tests();
+	 ******************************************/ 
+
+
+	CU_cleanup_registry();
+    }
+
+    LOG_FILE_CLOSE();
+    return 0;
+}
+
@@ -0,0 +1,188 @@
+/**
+ * @file ConcurrentStack.c
+ * @Brief  lock-free stack implementation
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-18
+ */
+
+#include <stdlib.h>
+
+#include "ConcurrentStack.h"
+#include "util/Log.h"
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  cstack_new Initial the stack
+ *
+ * @Param stack ConcurrentStack struct
+ * @Param allocator Where the nodes come from, NULL is libc
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int cstack_new(ConcurrentStack *stack, Allocator *allocator)
+{
+    if (stack == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    atomic_init(&stack->top, APOOL_REF(0, 0));
+    atomic_init(&stack->count, 0);
+
+    return apool_new(&stack->pool, allocator);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  cstack_delete Delete the stack, no thread may use it
+ *
+ * @Param stack ConcurrentStack struct
+ * @Param destroy_data The function that handles the data, like freeing memory
+ *
+ * @Returns   -1 is failed; >=0 is the number of data element
+ */
+/* ----------------------------------------------------------------------------*/
+int cstack_delete(ConcurrentStack *stack, handle_destroy destroy_data)
+{
+    if (stack == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    int ret = cstack_pop_all(stack, destroy_data);
+    apool_delete(&stack->pool);
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  cstack_push Push an element
+ *
+ * @Param stack ConcurrentStack struct
+ * @Param element The element, NULL is not allowed
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int cstack_push(ConcurrentStack *stack, void *element)
+{
+    if (stack == NULL || element == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    uint32_t index = apool_alloc(&stack->pool);
+    if (index == 0)
+	return -1;
+
+    atomic_store_explicit(&apool_node(&stack->pool, index)->element, element, \
+	    memory_order_relaxed);
+    apool_push(&stack->pool, &stack->top, index);
+    atomic_fetch_add_explicit(&stack->count, 1, memory_order_relaxed);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  cstack_try_pop Try once to pop an element, a thread that loses
+ *         the race gets 1 and may back off
+ *
+ * @Param stack ConcurrentStack struct
+ * @Param element Return the element
+ *
+ * @Returns   0 is OK; -1 means the stack is empty; 1 means another thread
+ *            changed the stack first
+ */
+/* ----------------------------------------------------------------------------*/
+int cstack_try_pop(ConcurrentStack *stack, void **element)
+{
+    if (stack == NULL || element == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    uint32_t index = 0;
+    int ret = apool_try_pop(&stack->pool, &stack->top, &index);
+    if (ret != 0)
+	return ret;
+
+    *element = atomic_load_explicit(&apool_node(&stack->pool, index)->element, \
+	    memory_order_relaxed);
+    apool_free(&stack->pool, index);
+    atomic_fetch_sub_explicit(&stack->count, 1, memory_order_relaxed);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  cstack_pop Pop an element
+ *
+ * @Param stack ConcurrentStack struct
+ *
+ * @Returns   NULL means the stack is empty; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+void* cstack_pop(ConcurrentStack *stack)
+{
+    if (stack == NULL){
+	ERROR("null pointer!");
+	return NULL;
+    }
+
+    void *element = NULL;
+    int ret;
+    while ((ret = cstack_try_pop(stack, &element)) == 1)
+	;
+
+    return ret == 0 ? element : NULL;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  cstack_pop_all Take all the elements with one atomic operation,
+ *         and handle them from the top
+ *
+ * @Param stack ConcurrentStack struct
+ * @Param handle_data The function that handles an element, NULL is ignored
+ *
+ * @Returns   -1 is failed; >=0 is the number of data element
+ */
+/* ----------------------------------------------------------------------------*/
+int cstack_pop_all(ConcurrentStack *stack, handle_destroy handle_data)
+{
+    if (stack == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    /**
+     * the chain is private after it is taken, walk it without atomics
+     */
+    uint32_t index = apool_take_all(&stack->top);
+    uint32_t next = 0;
+    AtomicNode *node = NULL;
+    int ret = 0;
+    while (index != 0){
+	node = apool_node(&stack->pool, index);
+	next = APOOL_INDEX(atomic_load_explicit(&node->next, memory_order_relaxed));
+	if (handle_data != NULL)
+	    handle_data(atomic_load_explicit(&node->element, memory_order_relaxed));
+	apool_free(&stack->pool, index);
+	index = next;
+	ret++;
+    }
+    atomic_fetch_sub_explicit(&stack->count, ret, memory_order_relaxed);
+
+    return ret;
+}
@@ -0,0 +1,41 @@
+/**
+ * @file ConcurrentStack.h
+ * @Brief  lock-free stack interfaces
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-18
+ */
+
+#ifndef CONCURRENT_STACK_H_
+#define CONCURRENT_STACK_H_
+
+#include "stack/Stack.h"
+#include "util/AtomicPool.h"
+
+/**
+ * Represent a Treiber stack, all the functions except new and delete may be
+ * called by any threads at the same time
+ */
+typedef struct ConcurrentStack{
+    /**
+     * tagged reference of the top node
+     */
+    _Atomic uint64_t top;
+    /**
+     * the number of elements, it is exact when no thread changes the stack
+     */
+    _Atomic int count;
+    AtomicPool pool;
+}ConcurrentStack;
+
+int cstack_new(ConcurrentStack *stack, Allocator *allocator);
+int cstack_delete(ConcurrentStack *stack, handle_destroy destroy_data);
+
+int cstack_push(ConcurrentStack *stack, void *element);
+void* cstack_pop(ConcurrentStack *stack);
+int cstack_try_pop(ConcurrentStack *stack, void **element);
+int cstack_pop_all(ConcurrentStack *stack, handle_destroy handle_data);
+
+#define CSTACK_SIZE(stack) atomic_load_explicit(&(stack)->count, memory_order_relaxed)
+
+#endif
@@ -0,0 +1,268 @@
+/**
+ * @file SegmentedStack.c
+ * @Brief  segmented stack implementation
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-19
+ */
+
+#include <stdlib.h>
+
+#include "SegmentedStack.h"
+#include "util/Log.h"
+
+#define SSTACK_DEFAULT_CHUNK 1024
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  sstack_chunk_new Take a chunk, the spare one first
+ *
+ * @Param stack SegmentedStack struct
+ *
+ * @Returns   NULL is failed; other is the chunk
+ */
+/* ----------------------------------------------------------------------------*/
+static StackChunk* sstack_chunk_new(SegmentedStack *stack)
+{
+    StackChunk *chunk = stack->spare;
+
+    if (chunk != NULL){
+	stack->spare = NULL;
+	return chunk;
+    }
+
+    chunk = (StackChunk*)mem_alloc(stack->allocator, \
+	    sizeof(StackChunk) + stack->chunk_size * sizeof(void*));
+    if (chunk == NULL)
+	ERROR("malloc error!");
+
+    return chunk;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  sstack_chunk_release Keep an empty chunk as the spare one, the
+ *         older spare chunk is freed
+ *
+ * @Param stack SegmentedStack struct
+ * @Param chunk The empty chunk
+ */
+/* ----------------------------------------------------------------------------*/
+static void sstack_chunk_release(SegmentedStack *stack, StackChunk *chunk)
+{
+    if (stack->spare != NULL)
+	mem_free(stack->allocator, stack->spare);
+    stack->spare = chunk;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  sstack_new Initial segmented stack struct
+ *
+ * @Param stack SegmentedStack struct
+ * @Param chunk_size The number of elements of one chunk, if chunk_size=0,
+ *        select default(1024)
+ * @Param allocator Where the chunks come from, NULL is libc
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int sstack_new(SegmentedStack *stack, unsigned int chunk_size, Allocator *allocator)
+{
+    if (chunk_size == 0)
+	chunk_size = SSTACK_DEFAULT_CHUNK;
+    if (stack == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+    if (!ALLOCATOR_CHECK(allocator)){
+	ERROR("missed allocator function!");
+	return -1;
+    }
+
+    stack->top = 0;
+    stack->chunk_size = chunk_size;
+    stack->count = 0;
+    stack->spare = NULL;
+    stack->allocator = allocator;
+
+    /**
+     * the stack always has a chunk
+     */
+    stack->chunk = sstack_chunk_new(stack);
+    if (stack->chunk == NULL)
+	return -1;
+    stack->chunk->previous = NULL;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  sstack_clear Clear the stack, only the bottom chunk and the spare
+ *         one are kept
+ *
+ * @Param stack SegmentedStack struct
+ * @Param destroy_data The function that handles the data, like freeing memory
+ *
+ * @Returns   -1 is failed; >=0 is the number of data element
+ */
+/* ----------------------------------------------------------------------------*/
+int sstack_clear(SegmentedStack *stack, handle_destroy destroy_data)
+{
+    if (stack == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    int ret = stack->count;
+    StackChunk *chunk = stack->chunk;
+    unsigned int top = stack->top;
+    unsigned int i;
+
+    while (chunk){
+	if (destroy_data != NULL)
+	    for (i=top; i>0; i--)
+		destroy_data(chunk->elements[i-1]);
+	if (chunk->previous == NULL)
+	    break;
+
+	stack->chunk = chunk->previous;
+	sstack_chunk_release(stack, chunk);
+	chunk = stack->chunk;
+	top = stack->chunk_size;
+    }
+
+    stack->top = 0;
+    stack->count = 0;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  sstack_delete Delete the stack
+ *
+ * @Param stack SegmentedStack struct
+ * @Param destroy_data The function that handles the data, like freeing memory
+ *
+ * @Returns   -1 is failed; >=0 is the number of data element
+ */
+/* ----------------------------------------------------------------------------*/
+int sstack_delete(SegmentedStack *stack, handle_destroy destroy_data)
+{
+    if (stack == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    int ret = sstack_clear(stack, destroy_data);
+    mem_free(stack->allocator, stack->chunk);
+    mem_free(stack->allocator, stack->spare);
+    stack->chunk = NULL;
+    stack->spare = NULL;
+    stack->chunk_size = 0;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  sstack_push Push element to stack, a full chunk links a new one
+ *         and nothing is copied
+ *
+ * @Param stack SegmentedStack struct
+ * @Param element The element that needs to be pushed into the stack
+ *
+ * @Returns   0 is OK; -1 is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int sstack_push(SegmentedStack *stack, void *element)
+{
+    if (stack == NULL || element == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    if (stack->top == stack->chunk_size){
+	StackChunk *chunk = sstack_chunk_new(stack);
+	if (chunk == NULL)
+	    return -1;
+	chunk->previous = stack->chunk;
+	stack->chunk = chunk;
+	stack->top = 0;
+    }
+    stack->chunk->elements[stack->top] = element;
+    stack->top++;
+    stack->count++;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  sstack_pop Pop the top element of the stack
+ *
+ * @Param stack SegmentedStack struct
+ *
+ * @Returns   NULL is failed; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+void* sstack_pop(SegmentedStack *stack)
+{
+    if (stack == NULL){
+	ERROR("null pointer!");
+	return NULL;
+    }
+    if (SSTACK_EMPTY(stack))
+	return NULL;
+
+    /**
+     * the top chunk stays after its last element is popped, so that a push
+     * right after does not need a chunk; it becomes the spare one when the
+     * chunk under it is reached
+     */
+    if (stack->top == 0){
+	StackChunk *chunk = stack->chunk;
+	stack->chunk = chunk->previous;
+	stack->top = stack->chunk_size;
+	sstack_chunk_release(stack, chunk);
+    }
+    stack->top--;
+    stack->count--;
+
+    return stack->chunk->elements[stack->top];
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  sstack_top Return the slot of the top element, the slot address
+ *         stays the same until the element is popped
+ *
+ * @Param stack SegmentedStack struct
+ *
+ * @Returns   NULL is failed; other is the slot of the top element
+ */
+/* ----------------------------------------------------------------------------*/
+void** sstack_top(SegmentedStack *stack)
+{
+    if (stack == NULL){
+	ERROR("null pointer!");
+	return NULL;
+    }
+    if (SSTACK_EMPTY(stack))
+	return NULL;
+
+    if (stack->top == 0)
+	return &stack->chunk->previous->elements[stack->chunk_size - 1];
+
+    return &stack->chunk->elements[stack->top - 1];
+}
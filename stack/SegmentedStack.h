@@ -0,0 +1,71 @@
+/**
+ * @file SegmentedStack.h
+ * @Brief  segmented stack interfaces, the stack grows by linking fixed-size
+ *         chunks and never moves an element
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-19
+ */
+
+#ifndef SEGMENTED_STACK_H_
+#define SEGMENTED_STACK_H_
+
+#include "stack/Stack.h"
+
+/**
+ * Represent a chunk, the elements follow the header
+ */
+typedef struct StackChunk{
+    /**
+     * the chunk under this one
+     */
+    struct StackChunk *previous;
+    void *elements[];
+}StackChunk;
+
+typedef struct SegmentedStack{
+    /**
+     * the chunk that holds the top element
+     */
+    StackChunk *chunk;
+    /**
+     * the number of elements in the top chunk
+     */
+    unsigned int top;
+    /**
+     * the number of elements of one chunk
+     */
+    unsigned int chunk_size;
+    /**
+     * the number of elements of the stack
+     */
+    unsigned int count;
+    /**
+     * an empty chunk that is kept after popping, so that pushing and
+     * popping around a chunk boundary does not allocate every time
+     */
+    StackChunk *spare;
+    Allocator *allocator;
+}SegmentedStack;
+
+#define SSTACK_EMPTY(stack) ((stack)->count == 0)
+#define SSTACK_SIZE(stack) ((stack)->count)
+
+int sstack_new(SegmentedStack *stack, unsigned int chunk_size, Allocator *allocator);
+int sstack_delete(SegmentedStack *stack, handle_destroy destroy_data);
+int sstack_clear(SegmentedStack *stack, handle_destroy destroy_data);
+
+int sstack_push(SegmentedStack *stack, void *element);
+void* sstack_pop(SegmentedStack *stack);
+void** sstack_top(SegmentedStack *stack);
+
+#define SEGMENTED_STACK_NULL {\
+    .chunk = NULL, \
+    .top = 0, \
+    .chunk_size = 0, \
+    .count = 0, \
+    .spare = NULL, \
+    .allocator = NULL \
+}
+
+#endif
@@ -7,6 +7,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "Stack.h"
 #include "util/Log.h"
@@ -23,6 +24,23 @@
  */
 /* ----------------------------------------------------------------------------*/
 int stack_new(Stack *stack, unsigned int size)
+{
+    return stack_new_allocator(stack, size, NULL);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  stack_new_allocator Initial stack struct with a user's allocator
+ *
+ * @Param stack Stack struct
+ * @Param size Stack size, if size=0, select default(10);or size is just size
+ * @Param allocator Where the stack array comes from, NULL is libc
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int stack_new_allocator(Stack *stack, unsigned int size, Allocator *allocator)
 {
     /**
      * set default size 10
@@ -33,11 +51,16 @@ int stack_new(Stack *stack, unsigned int size)
 	ERROR("null pointer!");
 	return -1;
     }
+    if (!ALLOCATOR_CHECK(allocator)){
+	ERROR("missed allocator function!");
+	return -1;
+    }
 
     /**
      * initial stack
      */
-    stack->start_address = (void**)malloc(size*sizeof(void*));
+    stack->allocator = allocator;
+    stack->start_address = (void**)mem_alloc(allocator, size*sizeof(void*));
     if (stack->start_address == NULL){
 	ERROR("malloc error!");
 	return -1;
@@ -94,7 +117,7 @@ int stack_delete(Stack *stack, handle_destroy destroy_data)
     }
 
     int ret = stack_clear(stack, destroy_data);
-    free(stack->start_address);
+    mem_free(stack->allocator, stack->start_address);
     stack->start_address = NULL;
     stack->size = 0;
     stack->top = 0;
@@ -134,7 +157,8 @@ int stack_enlarge(Stack *stack, unsigned int size)
 
     void **temp;
     if (new_size > stack->size){
-	temp = (void**)realloc(stack->start_address, new_size*sizeof(void*));
+	temp = (void**)mem_realloc(stack->allocator, stack->start_address,
+		new_size*sizeof(void*));
 	if (temp == NULL)
 	{
 	    ERROR("realloc error!");
@@ -180,7 +204,8 @@ int stack_decrease(Stack *stack, unsigned int size)
 
     void **temp;
     if (new_size < stack->size){
-	temp = (void**)realloc(stack->start_address, new_size*sizeof(void*));
+	temp = (void**)mem_realloc(stack->allocator, stack->start_address,
+		new_size*sizeof(void*));
 	if (temp == NULL)
 	{
 	    ERROR("realloc error!");
@@ -254,3 +279,81 @@ void* stack_pop(Stack *stack)
 
     return ret;
 }
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  stack_push_n Push elements to stack, the first one is pushed first
+ *
+ * @Param stack Stack struct
+ * @Param elements The elements, none of them may be NULL
+ * @Param count The number of the elements
+ *
+ * @Returns   -1 is failed and nothing is pushed; other is the number of
+ *            pushed elements
+ */
+/* ----------------------------------------------------------------------------*/
+int stack_push_n(Stack *stack, void **elements, unsigned int count)
+{
+    if (stack == NULL || (elements == NULL && count != 0)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    unsigned int i;
+    for (i=0; i<count; i++){
+	if (elements[i] == NULL){
+	    ERROR("null element!");
+	    return -1;
+	}
+    }
+
+    /**
+     * enlarge the stack at most once, at least twice than old like
+     * stack_push does
+     */
+    if (stack->size - stack->top < count){
+	unsigned int size = stack->size * 2;
+	if (size < stack->top + count)
+	    size = stack->top + count;
+	if (stack_enlarge(stack, size) == -1)
+	    return -1;
+    }
+
+    memcpy(stack->start_address + stack->top, elements, count * sizeof(void*));
+    stack->top += count;
+
+    return count;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  stack_pop_n Pop elements, the top one is put first
+ *
+ * @Param stack Stack struct
+ * @Param elements Where the elements are put
+ * @Param count The max number of elements to pop
+ *
+ * @Returns   -1 is failed; other is the number of popped elements, it is
+ *            less than count when the stack runs out
+ */
+/* ----------------------------------------------------------------------------*/
+int stack_pop_n(Stack *stack, void **elements, unsigned int count)
+{
+    if (stack == NULL || (elements == NULL && count != 0)){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    if (count > stack->top)
+	count = stack->top;
+
+    unsigned int i;
+    void **top = stack->start_address + stack->top - 1;
+    for (i=0; i<count; i++)
+	elements[i] = *(top - i);
+    stack->top -= count;
+
+    return count;
+}
@@ -9,6 +9,8 @@
 #ifndef STACK_H_
 #define STACK_H_
 
+#include "util/Allocator.h"
+
 typedef struct Stack{
     /**
      * stack array's start address
@@ -22,6 +24,10 @@ typedef struct Stack{
      * top of the stack
      */
     unsigned int top;
+    /**
+     * where the stack array comes from, NULL means libc
+     */
+    Allocator *allocator;
 }Stack;
 
 #define STACK_EMPTY(stack) ((stack->top) == 0)
@@ -31,6 +37,7 @@ typedef struct Stack{
 typedef void (*handle_destroy)(void *element);
 
 int stack_new(Stack *stack, unsigned int size);
+int stack_new_allocator(Stack *stack, unsigned int size, Allocator *allocator);
 int stack_delete(Stack *stack, handle_destroy destroy_data);
 int stack_clear(Stack *stack, handle_destroy destroy_data);
 
@@ -40,10 +47,14 @@ int stack_decrease(Stack *stack, unsigned int size);
 int stack_push(Stack *stack, void *element);
 void* stack_pop(Stack *stack);
 
+int stack_push_n(Stack *stack, void **elements, unsigned int count);
+int stack_pop_n(Stack *stack, void **elements, unsigned int count);
+
 #define STACK_NULL {\
     .start_address = NULL, \
     .size = 0, \
-    .top = 0 \
+    .top = 0, \
+    .allocator = NULL \
 }
 
 #endif
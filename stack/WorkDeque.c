@@ -0,0 +1,277 @@
+/**
+ * @file WorkDeque.c
+ * @Brief  work-stealing deque implementation, the owner only uses loads,
+ *         stores and fences unless it races a thief for the last element
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-27
+ */
+
+#include <stdlib.h>
+
+#include "WorkDeque.h"
+#include "util/Log.h"
+
+#define WDEQUE_DEFAULT_SIZE 64
+
+#define WDEQUE_SLOT(array, i) (&(array)->elements[(i) & ((array)->size - 1)])
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  wdeque_array Create a ring
+ *
+ * @Param deque WorkDeque struct
+ * @Param size The size of the ring, power of two
+ *
+ * @Returns   NULL is failed; other is the ring
+ */
+/* ----------------------------------------------------------------------------*/
+static WorkArray* wdeque_array(WorkDeque *deque, long size)
+{
+    WorkArray *array = (WorkArray*)mem_alloc(deque->allocator, \
+	    sizeof(WorkArray) + size * sizeof(void*));
+    if (array == NULL){
+	ERROR("malloc error!");
+	return NULL;
+    }
+    array->size = size;
+    array->previous = NULL;
+
+    return array;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  wdeque_new Initial the deque
+ *
+ * @Param deque WorkDeque struct
+ * @Param size The first size of the ring, it is rounded up to power of two,
+ *        if size=0, select default(64)
+ * @Param allocator Where the rings come from, NULL is libc
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int wdeque_new(WorkDeque *deque, unsigned int size, Allocator *allocator)
+{
+    if (deque == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+    if (!ALLOCATOR_CHECK(allocator)){
+	ERROR("missed allocator function!");
+	return -1;
+    }
+
+    if (size == 0)
+	size = WDEQUE_DEFAULT_SIZE;
+    long ring = 2;
+    while (ring < size)
+	ring <<= 1;
+
+    deque->allocator = allocator;
+    WorkArray *array = wdeque_array(deque, ring);
+    if (array == NULL)
+	return -1;
+
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    atomic_init(&deque->array, array);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  wdeque_delete Delete the deque, no thread may use it
+ *
+ * @Param deque WorkDeque struct
+ * @Param destroy_data The function that handles the data, like freeing memory
+ *
+ * @Returns   -1 is failed; >=0 is the number of data element
+ */
+/* ----------------------------------------------------------------------------*/
+int wdeque_delete(WorkDeque *deque, handle_destroy destroy_data)
+{
+    if (deque == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    WorkArray *array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+    long top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    long i;
+
+    if (destroy_data != NULL)
+	for (i=top; i<bottom; i++)
+	    destroy_data(atomic_load_explicit(WDEQUE_SLOT(array, i), memory_order_relaxed));
+
+    WorkArray *previous = NULL;
+    while (array){
+	previous = array->previous;
+	mem_free(deque->allocator, array);
+	array = previous;
+    }
+    atomic_store_explicit(&deque->array, NULL, memory_order_relaxed);
+    atomic_store_explicit(&deque->top, 0, memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, 0, memory_order_relaxed);
+
+    return bottom > top ? bottom - top : 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  wdeque_grow Move the elements to a ring twice as large, only the
+ *         owner calls it
+ *
+ * @Param deque WorkDeque struct
+ * @Param array The current ring
+ * @Param top The top that the owner has read
+ * @Param bottom The bottom
+ *
+ * @Returns   NULL is failed; other is the new ring
+ */
+/* ----------------------------------------------------------------------------*/
+static WorkArray* wdeque_grow(WorkDeque *deque, WorkArray *array, long top, long bottom)
+{
+    WorkArray *larger = wdeque_array(deque, array->size * 2);
+    if (larger == NULL)
+	return NULL;
+
+    long i;
+    for (i=top; i<bottom; i++)
+	atomic_store_explicit(WDEQUE_SLOT(larger, i), \
+		atomic_load_explicit(WDEQUE_SLOT(array, i), memory_order_relaxed), \
+		memory_order_relaxed);
+    larger->previous = array;
+    atomic_store_explicit(&deque->array, larger, memory_order_release);
+
+    return larger;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  wdeque_push Push an element at the bottom, only the owner calls it
+ *
+ * @Param deque WorkDeque struct
+ * @Param element The element
+ *
+ * @Returns   0 is OK; -1 is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int wdeque_push(WorkDeque *deque, void *element)
+{
+    if (deque == NULL || element == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    WorkArray *array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+
+    if (bottom - top > array->size - 1){
+	array = wdeque_grow(deque, array, top, bottom);
+	if (array == NULL)
+	    return -1;
+    }
+
+    atomic_store_explicit(WDEQUE_SLOT(array, bottom), element, memory_order_relaxed);
+    /**
+     * a thief that sees the new bottom sees the element
+     */
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  wdeque_pop Pop the element at the bottom, only the owner calls it
+ *
+ * @Param deque WorkDeque struct
+ *
+ * @Returns   NULL means the deque is empty; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+void* wdeque_pop(WorkDeque *deque)
+{
+    if (deque == NULL){
+	ERROR("null pointer!");
+	return NULL;
+    }
+
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    WorkArray *array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+
+    /**
+     * take the slot first, then look at the top, the fence keeps a thief
+     * from taking the same slot unseen
+     */
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    void *ret = NULL;
+    if (top <= bottom){
+	ret = atomic_load_explicit(WDEQUE_SLOT(array, bottom), memory_order_relaxed);
+	if (top == bottom){
+	    /**
+	     * the last element, race the thieves for it
+	     */
+	    if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, \
+			memory_order_seq_cst, memory_order_relaxed))
+		ret = NULL;
+	    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+	}
+    }else{
+	atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    }
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  wdeque_steal Take the element at the top, any thread may call it
+ *
+ * @Param deque WorkDeque struct
+ * @Param element Where the element is put
+ *
+ * @Returns   0 is OK; -1 means the deque is empty; 1 means another thread
+ *            took the element first, the caller may try again
+ */
+/* ----------------------------------------------------------------------------*/
+int wdeque_steal(WorkDeque *deque, void **element)
+{
+    if (deque == NULL || element == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+
+    *element = NULL;
+    if (top >= bottom)
+	return -1;
+
+    WorkArray *array = atomic_load_explicit(&deque->array, memory_order_acquire);
+    void *ret = atomic_load_explicit(WDEQUE_SLOT(array, top), memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, \
+		memory_order_seq_cst, memory_order_relaxed))
+	return 1;
+
+    *element = ret;
+    return 0;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file WorkDeque.h
+ * @Brief  work-stealing deque interfaces, the owner thread uses the bottom
+ *         like a stack and the other threads steal from the top
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-27
+ */
+
+#ifndef WORK_DEQUE_H_
+#define WORK_DEQUE_H_
+
+#include <stdatomic.h>
+
+#include "stack/Stack.h"
+
+#define WDEQUE_CACHE_LINE 64
+
+/**
+ * Represent the ring of a deque, its size is power of two. A ring that is
+ * replaced by a larger one is kept until the deque is deleted, a thief may
+ * still read it
+ */
+typedef struct WorkArray{
+    long size;
+    struct WorkArray *previous;
+    void *_Atomic elements[];
+}WorkArray;
+
+/**
+ * Represent a Chase-Lev deque. push and pop may only be called by the owner
+ * thread, steal may be called by any thread
+ */
+typedef struct WorkDeque{
+    /**
+     * the next element to steal, thieves race on it
+     */
+    _Alignas(WDEQUE_CACHE_LINE) _Atomic long top;
+    /**
+     * the next free slot, only the owner changes it
+     */
+    _Alignas(WDEQUE_CACHE_LINE) _Atomic long bottom;
+    WorkArray *_Atomic array;
+    /**
+     * where the rings come from, NULL means libc
+     */
+    Allocator *allocator;
+}WorkDeque;
+
+/**
+ * exact only when no thread is working on the deque
+ */
+#define WDEQUE_SIZE(deque) \
+    (atomic_load_explicit(&(deque)->bottom, memory_order_relaxed) \
+     - atomic_load_explicit(&(deque)->top, memory_order_relaxed))
+
+int wdeque_new(WorkDeque *deque, unsigned int size, Allocator *allocator);
+int wdeque_delete(WorkDeque *deque, handle_destroy destroy_data);
+
+int wdeque_push(WorkDeque *deque, void *element);
+void* wdeque_pop(WorkDeque *deque);
+int wdeque_steal(WorkDeque *deque, void **element);
+
+#endif
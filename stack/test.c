@@ -11,6 +11,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <pthread.h>
 /**
  * Cunit headers
  */ 
@@ -24,6 +25,9 @@
  */ 
 #include "Common.h"
 #include "stack/Stack.h"
+#include "stack/ConcurrentStack.h"
+#include "stack/SegmentedStack.h"
+#include "stack/WorkDeque.h"
 #include "util/Log.h"
 
 
@@ -47,6 +51,35 @@ void destroy_node(void *person)
     free(p);
 }
 
+/**
+ * allocator that counts the live blocks
+ */
+int live_blocks = 0;
+
+void* count_alloc(void *context, size_t size)
+{
+    (*(int*)context)++;
+    return malloc(size);
+}
+
+void* count_realloc(void *context, void *address, size_t size)
+{
+    return realloc(address, size);
+}
+
+void count_free(void *context, void *address)
+{
+    (*(int*)context)--;
+    free(address);
+}
+
+Allocator counter = {
+    .alloc = count_alloc,
+    .realloc = count_realloc,
+    .free = count_free,
+    .context = &live_blocks
+};
+
 void test_stack_new_and_delete()
 {
     CU_ASSERT_EQUAL_FATAL(stack_new(&stack, 0), 0);
@@ -119,6 +152,301 @@ void test_stack_delete()
     CU_ASSERT_EQUAL_FATAL(stack_delete(&stack, destroy_node), 4);
 }
 
+void test_stack_allocator()
+{
+    Stack temp = STACK_NULL;
+    CU_ASSERT_EQUAL_FATAL(stack_new_allocator(&temp, 1, &counter), 0);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 1);
+    CU_ASSERT_EQUAL_FATAL(stack_push(&temp, &temp), 0);
+    CU_ASSERT_EQUAL_FATAL(stack_push(&temp, &temp), 0);
+    CU_ASSERT_EQUAL_FATAL(temp.size, 2);
+    CU_ASSERT_EQUAL_FATAL(stack_delete(&temp, NULL), 2);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 0);
+}
+
+void test_stack_n()
+{
+    Stack temp = STACK_NULL;
+    int values[8];
+    void *in[8], *out[8];
+    int i;
+
+    for (i=0; i<8; i++)
+	in[i] = &values[i];
+    CU_ASSERT_EQUAL_FATAL(stack_new_allocator(&temp, 2, &counter), 0);
+    CU_ASSERT_EQUAL_FATAL(stack_pop_n(&temp, out, 8), 0);
+
+    /**
+     * one enlarging for the whole batch
+     */
+    CU_ASSERT_EQUAL_FATAL(stack_push(&temp, in[0]), 0);
+    CU_ASSERT_EQUAL_FATAL(stack_push_n(&temp, in + 1, 6), 6);
+    CU_ASSERT_EQUAL_FATAL(temp.size, 7);
+    CU_ASSERT_EQUAL_FATAL(stack_push_n(&temp, in + 7, 1), 1);
+    CU_ASSERT_EQUAL_FATAL(temp.size, 14);
+
+    /**
+     * a NULL element would look like an empty stack, nothing goes in
+     */
+    in[0] = NULL;
+    CU_ASSERT_EQUAL_FATAL(stack_push_n(&temp, in, 2), -1);
+    CU_ASSERT_EQUAL_FATAL(temp.top, 8);
+    in[0] = &values[0];
+    for (i=0; i<8; i++)
+	CU_ASSERT_PTR_EQUAL_FATAL(temp.start_address[i], in[i]);
+
+    CU_ASSERT_EQUAL_FATAL(stack_pop_n(&temp, out, 3), 3);
+    for (i=0; i<3; i++)
+	CU_ASSERT_PTR_EQUAL_FATAL(out[i], in[7 - i]);
+    CU_ASSERT_PTR_EQUAL_FATAL(stack_pop(&temp), in[4]);
+    CU_ASSERT_EQUAL_FATAL(stack_pop_n(&temp, out, 8), 4);
+    CU_ASSERT_PTR_EQUAL_FATAL(out[3], in[0]);
+    CU_ASSERT_EQUAL_FATAL(stack_delete(&temp, NULL), 0);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 0);
+}
+
+void test_cstack()
+{
+    ConcurrentStack temp;
+    void *element = NULL;
+    int values[4] = {0, 1, 2, 3};
+    int i;
+
+    CU_ASSERT_EQUAL_FATAL(cstack_new(&temp, &counter), 0);
+    CU_ASSERT_PTR_EQUAL_FATAL(cstack_pop(&temp), NULL);
+    CU_ASSERT_EQUAL_FATAL(cstack_try_pop(&temp, &element), -1);
+    CU_ASSERT_EQUAL_FATAL(cstack_push(&temp, NULL), -1);
+
+    for (i=0; i<4; i++)
+	CU_ASSERT_EQUAL_FATAL(cstack_push(&temp, &values[i]), 0);
+    CU_ASSERT_EQUAL_FATAL(CSTACK_SIZE(&temp), 4);
+    CU_ASSERT_EQUAL_FATAL(cstack_try_pop(&temp, &element), 0);
+    CU_ASSERT_PTR_EQUAL_FATAL(element, &values[3]);
+    CU_ASSERT_PTR_EQUAL_FATAL(cstack_pop(&temp), &values[2]);
+
+    /**
+     * the released nodes are used again, no more chunks
+     */
+    CU_ASSERT_EQUAL_FATAL(cstack_push(&temp, &values[2]), 0);
+    CU_ASSERT_EQUAL_FATAL(cstack_push(&temp, &values[3]), 0);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 1);
+
+    CU_ASSERT_EQUAL_FATAL(cstack_pop_all(&temp, NULL), 4);
+    CU_ASSERT_EQUAL_FATAL(CSTACK_SIZE(&temp), 0);
+    CU_ASSERT_PTR_EQUAL_FATAL(cstack_pop(&temp), NULL);
+
+    CU_ASSERT_EQUAL_FATAL(cstack_push(&temp, &values[0]), 0);
+    CU_ASSERT_EQUAL_FATAL(cstack_delete(&temp, NULL), 1);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 0);
+}
+
+void test_sstack()
+{
+    SegmentedStack temp = SEGMENTED_STACK_NULL;
+    int values[10];
+    void **slots[10];
+    int i;
+
+    CU_ASSERT_EQUAL_FATAL(sstack_new(&temp, 4, &counter), 0);
+    CU_ASSERT_PTR_EQUAL_FATAL(sstack_pop(&temp), NULL);
+    CU_ASSERT_PTR_EQUAL_FATAL(sstack_top(&temp), NULL);
+
+    /**
+     * three chunks, the slots never move
+     */
+    for (i=0; i<10; i++){
+	values[i] = i;
+	CU_ASSERT_EQUAL_FATAL(sstack_push(&temp, &values[i]), 0);
+	slots[i] = sstack_top(&temp);
+	CU_ASSERT_PTR_EQUAL_FATAL(*slots[i], &values[i]);
+    }
+    CU_ASSERT_EQUAL_FATAL(SSTACK_SIZE(&temp), 10);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 3);
+    for (i=0; i<10; i++)
+	CU_ASSERT_PTR_EQUAL_FATAL(*slots[i], &values[i]);
+
+    /**
+     * pushing and popping around a chunk boundary keeps the chunks
+     */
+    for (i=9; i>=8; i--)
+	CU_ASSERT_PTR_EQUAL_FATAL(sstack_pop(&temp), &values[i]);
+    CU_ASSERT_PTR_EQUAL_FATAL(sstack_top(&temp), slots[7]);
+    CU_ASSERT_PTR_EQUAL_FATAL(sstack_pop(&temp), &values[7]);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 3);
+    for (i=0; i<100; i++){
+	CU_ASSERT_EQUAL_FATAL(sstack_push(&temp, &values[7]), 0);
+	CU_ASSERT_EQUAL_FATAL(sstack_push(&temp, &values[8]), 0);
+	CU_ASSERT_PTR_EQUAL_FATAL(sstack_pop(&temp), &values[8]);
+	CU_ASSERT_PTR_EQUAL_FATAL(sstack_pop(&temp), &values[7]);
+    }
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 3);
+
+    for (i=6; i>=0; i--)
+	CU_ASSERT_PTR_EQUAL_FATAL(sstack_pop(&temp), &values[i]);
+    CU_ASSERT_PTR_EQUAL_FATAL(sstack_pop(&temp), NULL);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 2);
+
+    for (i=0; i<10; i++)
+	CU_ASSERT_EQUAL_FATAL(sstack_push(&temp, &values[i]), 0);
+    CU_ASSERT_EQUAL_FATAL(sstack_clear(&temp, NULL), 10);
+    CU_ASSERT_EQUAL_FATAL(SSTACK_EMPTY(&temp), 1);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 2);
+    CU_ASSERT_EQUAL_FATAL(sstack_push(&temp, &values[0]), 0);
+    CU_ASSERT_EQUAL_FATAL(sstack_delete(&temp, NULL), 1);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 0);
+}
+
+/**
+ * every thread pushes its own numbers and pops the same number of elements,
+ * at the end every number is popped exactly once
+ */
+#define CSTACK_THREADS 8
+#define CSTACK_COUNT 20000
+
+ConcurrentStack shared;
+int numbers[CSTACK_THREADS * CSTACK_COUNT];
+int popped[CSTACK_THREADS * CSTACK_COUNT];
+
+void* cstack_worker(void *arg)
+{
+    int *base = numbers + (long)arg * CSTACK_COUNT;
+    int *element = NULL;
+    int i;
+
+    for (i=0; i<CSTACK_COUNT; i++){
+	cstack_push(&shared, &base[i]);
+	if (i % 2 == 0)
+	    continue;
+
+	/**
+	 * the stack holds at least this thread's elements
+	 */
+	element = (int*)cstack_pop(&shared);
+	if (element != NULL)
+	    __atomic_fetch_add(&popped[*element], 1, __ATOMIC_RELAXED);
+    }
+
+    return NULL;
+}
+
+void count_popped(void *element)
+{
+    popped[*(int*)element]++;
+}
+
+void test_cstack_threads()
+{
+    pthread_t threads[CSTACK_THREADS];
+    long i;
+
+    CU_ASSERT_EQUAL_FATAL(cstack_new(&shared, NULL), 0);
+    for (i=0; i<CSTACK_THREADS * CSTACK_COUNT; i++){
+	numbers[i] = i;
+	popped[i] = 0;
+    }
+
+    for (i=0; i<CSTACK_THREADS; i++)
+	pthread_create(&threads[i], NULL, cstack_worker, (void*)i);
+    for (i=0; i<CSTACK_THREADS; i++)
+	pthread_join(threads[i], NULL);
+
+    CU_ASSERT_EQUAL_FATAL(CSTACK_SIZE(&shared), CSTACK_THREADS * CSTACK_COUNT / 2);
+    CU_ASSERT_EQUAL_FATAL(cstack_delete(&shared, count_popped), \
+	    CSTACK_THREADS * CSTACK_COUNT / 2);
+    for (i=0; i<CSTACK_THREADS * CSTACK_COUNT; i++)
+	CU_ASSERT_EQUAL_FATAL(popped[i], 1);
+}
+
+void test_wdeque()
+{
+    WorkDeque deque;
+    int values[100];
+    void *element = NULL;
+    int i;
+
+    CU_ASSERT_EQUAL_FATAL(wdeque_new(&deque, 3, &counter), 0);
+    CU_ASSERT_EQUAL_FATAL(atomic_load(&deque.array)->size, 4);
+    CU_ASSERT_PTR_EQUAL_FATAL(wdeque_pop(&deque), NULL);
+    CU_ASSERT_EQUAL_FATAL(wdeque_steal(&deque, &element), -1);
+
+    /**
+     * the owner sees a stack, the thieves see a queue, the ring grows
+     */
+    for (i=0; i<100; i++)
+	CU_ASSERT_EQUAL_FATAL(wdeque_push(&deque, &values[i]), 0);
+    CU_ASSERT_EQUAL_FATAL(WDEQUE_SIZE(&deque), 100);
+    CU_ASSERT_EQUAL_FATAL(atomic_load(&deque.array)->size, 128);
+    CU_ASSERT_PTR_EQUAL_FATAL(wdeque_pop(&deque), &values[99]);
+    CU_ASSERT_EQUAL_FATAL(wdeque_steal(&deque, &element), 0);
+    CU_ASSERT_PTR_EQUAL_FATAL(element, &values[0]);
+    CU_ASSERT_EQUAL_FATAL(wdeque_steal(&deque, &element), 0);
+    CU_ASSERT_PTR_EQUAL_FATAL(element, &values[1]);
+    for (i=98; i>=3; i--)
+	CU_ASSERT_PTR_EQUAL_FATAL(wdeque_pop(&deque), &values[i]);
+    CU_ASSERT_EQUAL_FATAL(wdeque_steal(&deque, &element), 0);
+    CU_ASSERT_PTR_EQUAL_FATAL(element, &values[2]);
+    CU_ASSERT_PTR_EQUAL_FATAL(wdeque_pop(&deque), NULL);
+
+    CU_ASSERT_EQUAL_FATAL(wdeque_push(&deque, &values[0]), 0);
+    CU_ASSERT_EQUAL_FATAL(wdeque_delete(&deque, NULL), 1);
+    CU_ASSERT_EQUAL_FATAL(live_blocks, 0);
+}
+
+/**
+ * the owner pushes all its numbers and pops some of them, the thieves
+ * steal until the owner is done and the deque is empty, every number is
+ * taken exactly once
+ */
+WorkDeque work;
+_Atomic int owner_done = 0;
+
+void* wdeque_thief(void *arg)
+{
+    void *element = NULL;
+    int ret;
+
+    for (;;){
+	ret = wdeque_steal(&work, &element);
+	if (ret == 0)
+	    __atomic_fetch_add(&popped[*(int*)element], 1, __ATOMIC_RELAXED);
+	else if (ret < 0 && atomic_load(&owner_done))
+	    break;
+    }
+
+    return NULL;
+}
+
+void test_wdeque_threads()
+{
+    pthread_t threads[CSTACK_THREADS];
+    int *element = NULL;
+    long i;
+
+    CU_ASSERT_EQUAL_FATAL(wdeque_new(&work, 0, NULL), 0);
+    for (i=0; i<CSTACK_THREADS * CSTACK_COUNT; i++){
+	numbers[i] = i;
+	popped[i] = 0;
+    }
+    atomic_store(&owner_done, 0);
+
+    for (i=0; i<CSTACK_THREADS; i++)
+	pthread_create(&threads[i], NULL, wdeque_thief, NULL);
+    for (i=0; i<CSTACK_THREADS * CSTACK_COUNT; i++){
+	wdeque_push(&work, &numbers[i]);
+	if (i % 3 == 0 && (element = (int*)wdeque_pop(&work)) != NULL)
+	    __atomic_fetch_add(&popped[*element], 1, __ATOMIC_RELAXED);
+    }
+    while ((element = (int*)wdeque_pop(&work)) != NULL)
+	__atomic_fetch_add(&popped[*element], 1, __ATOMIC_RELAXED);
+    atomic_store(&owner_done, 1);
+    for (i=0; i<CSTACK_THREADS; i++)
+	pthread_join(threads[i], NULL);
+
+    CU_ASSERT_EQUAL_FATAL(wdeque_delete(&work, NULL), 0);
+    for (i=0; i<CSTACK_THREADS * CSTACK_COUNT; i++)
+	CU_ASSERT_EQUAL_FATAL(popped[i], 1);
+}
+
 /*************Test Case End*********************/
 
 
@@ -152,6 +480,13 @@ static CU_TestInfo testcase1[] = {
     { "test_stack_push", test_stack_push},
     { "test_stack_decrease", test_stack_decrease},
     { "test_stack_delete", test_stack_delete},
+    { "test_stack_allocator", test_stack_allocator},
+    { "test_stack_n", test_stack_n},
+    { "test_cstack", test_cstack},
+    { "test_sstack", test_sstack},
+    { "test_cstack_threads", test_cstack_threads},
+    { "test_wdeque", test_wdeque},
+    { "test_wdeque_threads", test_wdeque_threads},
     CU_TEST_INFO_NULL
 };
 
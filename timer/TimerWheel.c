@@ -0,0 +1,288 @@
+/**
+ * @file TimerWheel.c
+ * @Brief  hierarchical timing wheel implementation. A timer is put in the
+ *         lowest level that covers its distance, when the slots of a level
+ *         wrap around, a slot of the next level is cascaded down
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-28
+ */
+#include <stdlib.h>
+
+#include "TimerWheel.h"
+#include "util/Log.h"
+
+#define TWHEEL_MASK (TWHEEL_SLOTS - 1)
+#define TWHEEL_INDEX(expires, level) (((expires) >> ((level) * TWHEEL_BITS)) & TWHEEL_MASK)
+#define TWHEEL_MAX_DISTANCE ((1UL << (TWHEEL_LEVELS * TWHEEL_BITS)) - 1)
+
+#define TWHEEL_SLOT_EMPTY(slot) ((slot)->next == (slot))
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  twheel_new Initial the wheel
+ *
+ * @Param wheel TimerWheel struct
+ * @Param now The current tick
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int twheel_new(TimerWheel *wheel, unsigned long now)
+{
+    if (wheel == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    int level, i;
+    for (level=0; level<TWHEEL_LEVELS; level++)
+	for (i=0; i<TWHEEL_SLOTS; i++){
+	    wheel->slots[level][i].previous = &wheel->slots[level][i];
+	    wheel->slots[level][i].next = &wheel->slots[level][i];
+	}
+    wheel->now = now;
+    wheel->count = 0;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  twheel_link Put a link at the end of a circular list
+ *
+ * @Param head The head of the list
+ * @Param link The link
+ */
+/* ----------------------------------------------------------------------------*/
+static void twheel_link(ILink *head, ILink *link)
+{
+    link->previous = head->previous;
+    link->next = head;
+    head->previous->next = link;
+    head->previous = link;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  twheel_unlink Take a link out of its circular list
+ *
+ * @Param link The link
+ */
+/* ----------------------------------------------------------------------------*/
+static void twheel_unlink(ILink *link)
+{
+    link->previous->next = link->next;
+    link->next->previous = link->previous;
+    link->previous = NULL;
+    link->next = NULL;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  twheel_add Put a timer in the slot that covers its tick, the tick
+ *         is not before now
+ *
+ * @Param wheel TimerWheel struct
+ * @Param timer The timer
+ */
+/* ----------------------------------------------------------------------------*/
+static void twheel_add(TimerWheel *wheel, Timer *timer)
+{
+    unsigned long distance = timer->expires - wheel->now;
+    int level = 0;
+
+    while (level < TWHEEL_LEVELS - 1 && distance >= 1UL << ((level + 1) * TWHEEL_BITS))
+	level++;
+    twheel_link(&wheel->slots[level][TWHEEL_INDEX(timer->expires, level)], &timer->link);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  twheel_schedule Schedule a timer, a pending timer is moved to the
+ *         new tick
+ *
+ * @Param wheel TimerWheel struct
+ * @Param timer The timer, its callback must be set
+ * @Param expires The tick that the timer fires at, a tick that is done
+ *        means the next one; it is at most 2^32-1 ticks later than now
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int twheel_schedule(TimerWheel *wheel, Timer *timer, unsigned long expires)
+{
+    if (wheel == NULL || timer == NULL || timer->callback == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    if (TIMER_PENDING(timer))
+	twheel_unlink(&timer->link);
+    else
+	wheel->count++;
+
+    if ((long)(expires - wheel->now) <= 0)
+	expires = wheel->now + 1;
+    if (expires - wheel->now > TWHEEL_MAX_DISTANCE){
+	WARNING("timer is too far away, it fires at the last tick of the wheel!");
+	expires = wheel->now + TWHEEL_MAX_DISTANCE;
+    }
+    timer->expires = expires;
+    twheel_add(wheel, timer);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  twheel_cancel Cancel a timer
+ *
+ * @Param wheel TimerWheel struct
+ * @Param timer The timer
+ *
+ * @Returns   0 is OK; -1 means the timer is not pending
+ */
+/* ----------------------------------------------------------------------------*/
+int twheel_cancel(TimerWheel *wheel, Timer *timer)
+{
+    if (wheel == NULL || timer == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+    if (!TIMER_PENDING(timer))
+	return -1;
+
+    twheel_unlink(&timer->link);
+    wheel->count--;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  twheel_cascade Move the timers of a slot to the lower levels
+ *
+ * @Param wheel TimerWheel struct
+ * @Param level The level of the slot
+ *
+ * @Returns   the index of the slot
+ */
+/* ----------------------------------------------------------------------------*/
+static int twheel_cascade(TimerWheel *wheel, int level)
+{
+    int index = TWHEEL_INDEX(wheel->now, level);
+    ILink *slot = &wheel->slots[level][index];
+    ILink *link = NULL;
+
+    while (!TWHEEL_SLOT_EMPTY(slot)){
+	link = slot->next;
+	twheel_unlink(link);
+	twheel_add(wheel, ILIST_ENTRY(link, Timer, link));
+    }
+
+    return index;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  twheel_advance Do the ticks up to now, the timers that expire
+ *         are fired in the order of their ticks. A callback may schedule or
+ *         cancel any timer
+ *
+ * @Param wheel TimerWheel struct
+ * @Param now The current tick
+ *
+ * @Returns   -1 is failed; other is the number of fired timers
+ */
+/* ----------------------------------------------------------------------------*/
+int twheel_advance(TimerWheel *wheel, unsigned long now)
+{
+    if (wheel == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    int ret = 0;
+    int level, index;
+    ILink *slot = NULL;
+    Timer *timer = NULL;
+
+    while ((long)(now - wheel->now) > 0){
+	/**
+	 * nothing is scheduled, jump to now
+	 */
+	if (wheel->count == 0){
+	    wheel->now = now;
+	    break;
+	}
+	wheel->now++;
+
+	/**
+	 * the level 0 wraps around, so one slot of the level 1 comes down,
+	 * and so on while the higher levels wrap too
+	 */
+	index = TWHEEL_INDEX(wheel->now, 0);
+	for (level=1; index == 0 && level<TWHEEL_LEVELS; level++)
+	    index = twheel_cascade(wheel, level);
+
+	slot = &wheel->slots[0][TWHEEL_INDEX(wheel->now, 0)];
+	if (TWHEEL_SLOT_EMPTY(slot))
+	    continue;
+
+	/**
+	 * fire the timers one by one from the slot, so a callback that cancels
+	 * another of them or clears the wheel takes it out before it fires; a
+	 * callback can not put a timer back here, a level 0 slot only holds
+	 * the timers of the next 255 ticks
+	 */
+	while (!TWHEEL_SLOT_EMPTY(slot)){
+	    timer = ILIST_ENTRY(slot->next, Timer, link);
+	    twheel_unlink(&timer->link);
+	    wheel->count--;
+	    timer->callback(timer);
+	    ret++;
+	}
+    }
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  twheel_clear Cancel all the timers, none of them is fired
+ *
+ * @Param wheel TimerWheel struct
+ *
+ * @Returns   -1 is failed; other is the number of cancelled timers
+ */
+/* ----------------------------------------------------------------------------*/
+int twheel_clear(TimerWheel *wheel)
+{
+    if (wheel == NULL){
+	ERROR("Null pointer!");
+	return -1;
+    }
+
+    int ret = wheel->count;
+    int level, i;
+    ILink *slot = NULL;
+    for (level=0; level<TWHEEL_LEVELS; level++)
+	for (i=0; i<TWHEEL_SLOTS; i++){
+	    slot = &wheel->slots[level][i];
+	    while (!TWHEEL_SLOT_EMPTY(slot))
+		twheel_unlink(slot->next);
+	}
+    wheel->count = 0;
+
+    return ret;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file TimerWheel.h
+ * @Brief  hierarchical timing wheel interfaces, timers are scheduled and
+ *         cancelled in O(1) and a tick only touches the timers that expire
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-28
+ */
+
+#ifndef TIMER_WHEEL_H_
+#define TIMER_WHEEL_H_
+
+#include "ilist/Intrusivelist.h"
+
+/**
+ * every level has 2^TWHEEL_BITS slots, a slot of level n covers
+ * 2^(TWHEEL_BITS*n) ticks, so the levels cover 2^32 ticks
+ */
+#define TWHEEL_BITS 8
+#define TWHEEL_SLOTS (1 << TWHEEL_BITS)
+#define TWHEEL_LEVELS 4
+
+struct Timer;
+typedef void (*timer_callback)(struct Timer *timer);
+
+/**
+ * Represent a timer, the user owns the memory, it can be embedded in the
+ * user's struct and found again by ILIST_ENTRY
+ */
+typedef struct Timer{
+    /**
+     * the link in a slot, next is NULL when the timer is not scheduled
+     */
+    ILink link;
+    /**
+     * the tick that the timer fires at
+     */
+    unsigned long expires;
+    timer_callback callback;
+    void *arg;
+}Timer;
+
+#define TIMER_NULL {\
+    .link = ILINK_NULL, \
+    .expires = 0, \
+    .callback = NULL, \
+    .arg = NULL \
+}
+
+#define TIMER_PENDING(timer) ((timer)->link.next != NULL)
+
+typedef struct TimerWheel{
+    /**
+     * a slot is the head of a circular list of timers
+     */
+    ILink slots[TWHEEL_LEVELS][TWHEEL_SLOTS];
+    /**
+     * the last tick that is done
+     */
+    unsigned long now;
+    /**
+     * the number of scheduled timers
+     */
+    int count;
+}TimerWheel;
+
+#define TWHEEL_SIZE(wheel) ((wheel)->count)
+
+int twheel_new(TimerWheel *wheel, unsigned long now);
+int twheel_clear(TimerWheel *wheel);
+
+int twheel_schedule(TimerWheel *wheel, Timer *timer, unsigned long expires);
+int twheel_cancel(TimerWheel *wheel, Timer *timer);
+int twheel_advance(TimerWheel *wheel, unsigned long now);
+
+#endif
@@ -0,0 +1,334 @@
+/**
+ * @file test.c
+ * @Brief  test timer wheel
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-28
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+/**
+ * Cunit headers
+ */ 
+#include "CUnit.h"
+#include "Automated.h"
+#include "Basic.h"
+#include "Console.h"
+
+/**
+ * Test file headers
+ */ 
+#include "timer/TimerWheel.h"
+#include "util/Log.h"
+
+
+/*************Test Case Begin*******************/
+
+#define TIMER_COUNT 1000
+
+TimerWheel wheel;
+Timer timers[TIMER_COUNT];
+unsigned long fired_at[TIMER_COUNT];
+int fired = 0;
+
+void record(Timer *timer)
+{
+    fired_at[timer - timers] = wheel.now;
+    fired++;
+}
+
+/**
+ * cancels the timer in its arg, which expires at the same tick
+ */
+void cancel_other(Timer *timer)
+{
+    record(timer);
+    twheel_cancel(&wheel, (Timer*)timer->arg);
+}
+
+/**
+ * cancels all the timers of the wheel
+ */
+void clear_all(Timer *timer)
+{
+    record(timer);
+    twheel_clear(&wheel);
+}
+
+/**
+ * fires again every 100 ticks
+ */
+void periodic(Timer *timer)
+{
+    record(timer);
+    twheel_schedule(&wheel, timer, timer->expires + 100);
+}
+
+void reset()
+{
+    int i;
+    for (i=0; i<TIMER_COUNT; i++){
+	timers[i].link.previous = NULL;
+	timers[i].link.next = NULL;
+	timers[i].callback = record;
+	timers[i].arg = NULL;
+	fired_at[i] = 0;
+    }
+    fired = 0;
+}
+
+void test_twheel_schedule()
+{
+    reset();
+    CU_ASSERT_EQUAL_FATAL(twheel_new(&wheel, 1000), 0);
+    CU_ASSERT_EQUAL_FATAL(twheel_schedule(&wheel, &timers[0], 1005), 0);
+    CU_ASSERT_EQUAL_FATAL(twheel_schedule(&wheel, &timers[1], 1005), 0);
+    CU_ASSERT_EQUAL_FATAL(twheel_schedule(&wheel, &timers[2], 900), 0);
+    CU_ASSERT_EQUAL_FATAL(timers[2].expires, 1001);
+    CU_ASSERT_EQUAL_FATAL(TWHEEL_SIZE(&wheel), 3);
+    CU_ASSERT_TRUE_FATAL(TIMER_PENDING(&timers[0]));
+
+    /**
+     * cancel, and schedule a pending timer again
+     */
+    CU_ASSERT_EQUAL_FATAL(twheel_cancel(&wheel, &timers[1]), 0);
+    CU_ASSERT_EQUAL_FATAL(twheel_cancel(&wheel, &timers[1]), -1);
+    CU_ASSERT_EQUAL_FATAL(twheel_schedule(&wheel, &timers[0], 1003), 0);
+    CU_ASSERT_EQUAL_FATAL(TWHEEL_SIZE(&wheel), 2);
+
+    CU_ASSERT_EQUAL_FATAL(twheel_advance(&wheel, 1002), 1);
+    CU_ASSERT_EQUAL_FATAL(fired_at[2], 1001);
+    CU_ASSERT_EQUAL_FATAL(twheel_advance(&wheel, 1010), 1);
+    CU_ASSERT_EQUAL_FATAL(fired_at[0], 1003);
+    CU_ASSERT_EQUAL_FATAL(fired_at[1], 0);
+    CU_ASSERT_FALSE_FATAL(TIMER_PENDING(&timers[0]));
+    CU_ASSERT_EQUAL_FATAL(TWHEEL_SIZE(&wheel), 0);
+}
+
+void test_twheel_cascade()
+{
+    unsigned long start = 0xfff0;
+    int count, i;
+
+    reset();
+    CU_ASSERT_EQUAL_FATAL(twheel_new(&wheel, start), 0);
+
+    /**
+     * the distances cover all the levels and many wrap-arounds
+     */
+    for (i=0; i<TIMER_COUNT; i++)
+	CU_ASSERT_EQUAL_FATAL(twheel_schedule(&wheel, &timers[i], \
+		    start + 1 + (unsigned long)i * i * 67 % 300000), 0);
+    CU_ASSERT_EQUAL_FATAL(twheel_schedule(&wheel, &timers[0], start + (1UL << 25) + 3), 0);
+
+    count = twheel_advance(&wheel, start + 150000);
+    CU_ASSERT_EQUAL_FATAL(count, fired);
+    count += twheel_advance(&wheel, start + 300000);
+    CU_ASSERT_EQUAL_FATAL(count, TIMER_COUNT - 1);
+    CU_ASSERT_EQUAL_FATAL(fired, TIMER_COUNT - 1);
+    CU_ASSERT_EQUAL_FATAL(twheel_advance(&wheel, start + (1UL << 26)), 1);
+    for (i=0; i<TIMER_COUNT; i++)
+	CU_ASSERT_EQUAL_FATAL(fired_at[i], timers[i].expires);
+}
+
+void test_twheel_callback()
+{
+    int i;
+
+    reset();
+    CU_ASSERT_EQUAL_FATAL(twheel_new(&wheel, 0), 0);
+    timers[0].callback = cancel_other;
+    timers[0].arg = &timers[1];
+    timers[1].callback = cancel_other;
+    timers[1].arg = &timers[0];
+    timers[2].callback = periodic;
+    CU_ASSERT_EQUAL_FATAL(twheel_schedule(&wheel, &timers[0], 50), 0);
+    CU_ASSERT_EQUAL_FATAL(twheel_schedule(&wheel, &timers[1], 50), 0);
+    CU_ASSERT_EQUAL_FATAL(twheel_schedule(&wheel, &timers[2], 100), 0);
+
+    /**
+     * only one of the pair fires, the periodic timer fires every round
+     */
+    CU_ASSERT_EQUAL_FATAL(twheel_advance(&wheel, 1000), 11);
+    CU_ASSERT_EQUAL_FATAL(fired_at[2], 1000);
+    CU_ASSERT_EQUAL_FATAL(TWHEEL_SIZE(&wheel), 1);
+
+    for (i=3; i<10; i++)
+	twheel_schedule(&wheel, &timers[i], 2000 + i);
+    CU_ASSERT_EQUAL_FATAL(twheel_clear(&wheel), 8);
+    CU_ASSERT_EQUAL_FATAL(twheel_advance(&wheel, 3000), 0);
+    CU_ASSERT_FALSE_FATAL(TIMER_PENDING(&timers[2]));
+}
+
+void test_twheel_clear_in_callback()
+{
+    int i;
+
+    reset();
+    CU_ASSERT_EQUAL_FATAL(twheel_new(&wheel, 0), 0);
+    for (i=0; i<5; i++){
+	timers[i].callback = clear_all;
+	CU_ASSERT_EQUAL_FATAL(twheel_schedule(&wheel, &timers[i], 10), 0);
+    }
+    CU_ASSERT_EQUAL_FATAL(twheel_schedule(&wheel, &timers[5], 20), 0);
+
+    /**
+     * the first timer clears the others of its own tick too
+     */
+    CU_ASSERT_EQUAL_FATAL(twheel_advance(&wheel, 100), 1);
+    CU_ASSERT_EQUAL_FATAL(fired, 1);
+    CU_ASSERT_EQUAL_FATAL(TWHEEL_SIZE(&wheel), 0);
+    for (i=0; i<6; i++)
+	CU_ASSERT_FALSE_FATAL(TIMER_PENDING(&timers[i]));
+
+    CU_ASSERT_EQUAL_FATAL(twheel_schedule(&wheel, &timers[5], 200), 0);
+    CU_ASSERT_EQUAL_FATAL(twheel_advance(&wheel, 300), 1);
+    CU_ASSERT_EQUAL_FATAL(fired_at[5], 200);
+    CU_ASSERT_EQUAL_FATAL(TWHEEL_SIZE(&wheel), 0);
+}
+
+/*************Test Case End*********************/
+
+
+
+/**
+ * add testcase, similar function in the same testcase
+ * 
+ * typedef struct CU_TestInfo {
+ * 	const char  *pName;
+ *	CU_TestFunc pTestFunc;
+ *	} CU_TestInfo;
+ *
+ * Example:
+ *
+ * static CU_TestInfo testcase1[] = {
+ * 	{ "test_function_name", test_function},
+ * 	{ "test_function_name2", test_function2},
+ * 	CU_TEST_INFO_NULL
+ * };
+ *
+ * static CU_TestInfo testcase2[] = {
+ * 	...
+ * 	CU_TEST_INFO_NULL
+ * };
+ *
+ */ 
+
+static CU_TestInfo testcase1[] = {
+    { "test_twheel_schedule", test_twheel_schedule},
+    { "test_twheel_cascade", test_twheel_cascade},
+    { "test_twheel_callback", test_twheel_callback},
+    { "test_twheel_clear_in_callback", test_twheel_clear_in_callback},
+    CU_TEST_INFO_NULL
+};
+
+/**
+ * add testcase to the suites
+ * 
+ * typedef struct CU_SuiteInfo {
+ *     const char       *pName;         
+ *     CU_InitializeFunc pInitFunc;     
+ *     CU_CleanupFunc    pCleanupFunc;  
+ *     CU_SetUpFunc      pSetUpFunc;    
+ *     CU_TearDownFunc   pTearDownFunc; 
+ *     CU_TestInfo      *pTests;        
+ * } CU_SuiteInfo;
+ *
+ * Example:
+ *
+ * static CU_SuiteInfo suites[] = {
+ * 	{"suite name", suite_success_init, suite_success_clean, NULL, NULL, testcase},
+ * 	...
+ * 	CU_SUITE_INFO_NULL
+ * }
+ *
+ */
+
+static int suite_success_init(void) 
+{
+    return 0; 
+}
+static int suite_success_clean(void) 
+{
+    return 0; 
+}
+
+
+static CU_SuiteInfo suites[] = {
+    {"suite1", suite_success_init, NULL, NULL, NULL, testcase1},
+    CU_SUITE_INFO_NULL
+};
+
+
+
+/**
+ * add tests to the test framework
+ *
+ */ 
+void AddTests(void)
+{
+    assert(NULL != CU_get_registry());
+    assert(!CU_is_test_running());
+
+    /* Register suites. */
+    if (CU_register_suites(suites) != CUE_SUCCESS) {
+	fprintf(stderr, "suite registration failed - %s\n",
+		CU_get_error_msg());
+	exit(EXIT_FAILURE);
+    }
+
+}
+
+
+int main()
+{
+    if (CU_initialize_registry()) {
+	printf("\nInitialization of Test Registry failed.");
+    }else{
+
+	LOG_FILE_OPEN("log.txt");
+
+	AddTests();
+
+	/*******Automated Mode(best)*********************
+	 * CU_set_output_filename("TestAutomated");
+	 * CU_list_tests_to_file();
+	 * CU_automated_run_tests();
+	 ******************************************/
+
+	 CU_set_output_filename("TestAutomated");
+	 CU_list_tests_to_file();
+	 CU_automated_run_tests();
+	/*******Basic Mode*********************
+	 * mode can choose:
+	 * typedef enum {
+	 *   CU_BRM_NORMAL = 0, Normal mode - failures and run summary are printed [default].
+	 *   CU_BRM_SILENT,     Silent mode - no output is printed except framework error messages.
+	 *   CU_BRM_VERBOSE     Verbose mode - maximum output of run details.
+	 * } CU_BasicRunMode;
+	 ****************************************
+	 *
+	 * CU_basic_set_mode(CU_BRM_NORMAL);
+	 * CU_basic_run_tests();
+	 ******************************************/
+
+	/*******Console Mode*********************
+	 * CU_console_run_tests();
+	 ******************************************/
+
+	/*******Curses Mode*********************
+	 * CU_curses_run_tests();
+	 ******************************************/ 
+
+
+	CU_cleanup_registry();
+    }
+
+    LOG_FILE_CLOSE();
+    return 0;
+}
+
@@ -0,0 +1,843 @@
+/**
+ * @file Unrolledlist.c
+ * @Brief  unrolled linked list interface source
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-08
+ */
+
+#include <string.h>
+
+#include "Common.h"
+#include "Unrolledlist.h"
+#include "util/Log.h"
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_find find the first element that matches
+ *
+ * @Param list unrolled list
+ * @Param match match function
+ * @Param element match information
+ * @Param node return the node of the matched element
+ * @Param pre return the prior node of the node
+ *
+ * @Returns   -1 means no one; >=0 is the index in the node
+ */
+/* ----------------------------------------------------------------------------*/
+static int ulist_find(UnrolledList *list, handle_element match, void *element,
+	UnrolledNode **node, UnrolledNode **pre)
+{
+    UnrolledNode *cur = list->first;
+    UnrolledNode *prior = NULL;
+    int i;
+
+    while (cur){
+	for (i=0; i<cur->count; i++){
+	    if (match(cur->elements[i], element) == 0){
+		*node = cur;
+		*pre = prior;
+		return i;
+	    }
+	}
+
+	prior = cur;
+	cur = cur->next;
+    }
+
+    return -1;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_unlink take a node out of the list and give it back to slab
+ *
+ * @Param list unrolled list
+ * @Param node the node
+ * @Param pre the prior node of the node
+ */
+/* ----------------------------------------------------------------------------*/
+static void ulist_unlink(UnrolledList *list, UnrolledNode *node, UnrolledNode *pre)
+{
+    if (pre == NULL)
+	list->first = node->next;
+    else
+	pre->next = node->next;
+
+    if (node == list->last)
+	list->last = pre;
+
+    node->next = NULL;
+    node->count = 0;
+    slab_free(&list->node_pool, node);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_erase_at remove an element from a node and destroy it
+ *
+ * @Param common data common struct
+ * @Param node the node
+ * @Param pre the prior node of the node
+ * @Param index the index of the element in the node
+ *
+ * @Returns   1 means the node is empty and freed; 0 means the node is kept
+ */
+/* ----------------------------------------------------------------------------*/
+static int ulist_erase_at(DataCommon *common, UnrolledNode *node, UnrolledNode *pre,
+	int index)
+{
+    UnrolledList *list = (UnrolledList*)(common->linked_type);
+
+    common->destroy_node(node->elements[index]);
+    memmove(&node->elements[index], &node->elements[index+1], \
+	    (node->count - index - 1) * sizeof(void*));
+    node->count--;
+    list->size--;
+
+    /**
+     *free the empty node, or merge the next node into it when both fit
+     *in one node, so that the nodes do not become sparse
+     */
+    UnrolledNode *next = node->next;
+    if (node->count == 0){
+	ulist_unlink(list, node, pre);
+	return 1;
+    }else if ((next != NULL) && (node->count + next->count <= ULIST_NODE_ELEMENTS)){
+	memcpy(&node->elements[node->count], next->elements, \
+		next->count * sizeof(void*));
+	node->count += next->count;
+	ulist_unlink(list, next, node);
+    }
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_place put an element at a position of a node, a full node
+ *         is split into two halves first
+ *
+ * @Param common data common struct
+ * @Param node the node
+ * @Param index the position in the node, 0..count
+ * @Param element the element
+ *
+ * @Returns   0 is OK;other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int ulist_place(DataCommon *common, UnrolledNode *node, int index, void *element)
+{
+    UnrolledList *list = (UnrolledList*)(common->linked_type);
+
+    if (node->count == ULIST_NODE_ELEMENTS){
+	UnrolledNode *half = (UnrolledNode*)slab_alloc(&list->node_pool);
+	if (half == NULL){
+	    ERROR("slab alloc failed!");
+	    return -1;
+	}
+	half->count = ULIST_NODE_ELEMENTS - ULIST_NODE_ELEMENTS/2;
+	memcpy(half->elements, &node->elements[ULIST_NODE_ELEMENTS/2], \
+		half->count * sizeof(void*));
+	node->count = ULIST_NODE_ELEMENTS/2;
+
+	half->next = node->next;
+	node->next = half;
+	if (list->last == node)
+	    list->last = half;
+
+	if (index > node->count){
+	    index -= node->count;
+	    node = half;
+	}
+    }
+
+    memmove(&node->elements[index+1], &node->elements[index], \
+	    (node->count - index) * sizeof(void*));
+    node->elements[index] = element;
+    node->count++;
+    list->size++;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_prior_node find the prior node of a node by walking from the
+ *         first node
+ *
+ * @Param list unrolled list
+ * @Param node the node
+ *
+ * @Returns   NULL means the node is the first one; other is the prior node
+ */
+/* ----------------------------------------------------------------------------*/
+static UnrolledNode* ulist_prior_node(UnrolledList *list, UnrolledNode *node)
+{
+    UnrolledNode *pre = NULL;
+    UnrolledNode *cur = list->first;
+
+    while (cur != node){
+	pre = cur;
+	cur = cur->next;
+    }
+
+    return pre;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_insert insert element to the end of list
+ *
+ * @Param common data commont struct
+ * @Param element the element that need to be inserted
+ *
+ * @Returns   0 is OK;other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int ulist_insert(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    UnrolledList *list = (UnrolledList*)(common->linked_type);
+    UnrolledNode *node = list->last;
+
+    /**
+     *the last node is full, create a new one
+     */
+    if ((node == NULL) || (node->count == ULIST_NODE_ELEMENTS)){
+	node = (UnrolledNode*)slab_alloc(&list->node_pool);
+	if (node == NULL){
+	    ERROR("slab alloc failed!");
+	    return -1;
+	}
+	node->next = NULL;
+	node->count = 0;
+
+	if (list->last != NULL)
+	    list->last->next = node;
+	else
+	    list->first = node;
+	list->last = node;
+    }
+
+    node->elements[node->count] = element;
+    node->count++;
+    list->size++;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_remove:remove an element from the list
+ *
+ * @Param common data common struct
+ * @Param element the element's information that needs to be removed
+ *
+ * @Returns   0 is OK;other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int ulist_remove(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    UnrolledList *list = (UnrolledList*)(common->linked_type);
+    UnrolledNode *node = NULL;
+    UnrolledNode *pre = NULL;
+    int index = ulist_find(list, common->remove_match, element, &node, &pre);
+
+    if (index < 0){
+	INFO("can not match a node!");
+	return -1;
+    }
+
+    ulist_erase_at(common, node, pre, index);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_search get the element that user needs
+ *
+ * @Param common data common struct
+ * @Param element the index of the element
+ *
+ * @Returns   NULL means no one; other is the address of the matched element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* ulist_search(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return NULL;
+    }
+
+    UnrolledList *list = (UnrolledList*)(common->linked_type);
+    UnrolledNode *node = NULL;
+    UnrolledNode *pre = NULL;
+    int index = ulist_find(list, common->search_match, element, &node, &pre);
+
+    if (index < 0){
+	INFO("no matched node!");
+	return NULL;
+    }
+
+    return node->elements[index];
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_alter alter the matched element
+ *
+ * @Param common data common struct
+ * @Param element the searched element's information
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int ulist_alter(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    UnrolledList *list = (UnrolledList*)(common->linked_type);
+    UnrolledNode *node = NULL;
+    UnrolledNode *pre = NULL;
+
+    if (ulist_find(list, common->alter_match, element, &node, &pre) < 0){
+	INFO("no matched node!");
+	return -1;
+    }
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_prior return the prior element of the matched one
+ *
+ * @Param common data common struct
+ * @Param element match information
+ *
+ * @Returns   NULL means can not find the matched one;other is the address of
+ * 	      the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* ulist_prior(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return NULL;
+    }
+
+    UnrolledList *list = (UnrolledList*)(common->linked_type);
+    UnrolledNode *node = NULL;
+    UnrolledNode *pre = NULL;
+    int index = ulist_find(list, common->search_match, element, &node, &pre);
+
+    if (index < 0){
+	INFO("no matched one!");
+	return NULL;
+    }
+
+    if (index > 0)
+	return node->elements[index-1];
+    if (pre != NULL)
+	return pre->elements[pre->count-1];
+    return NULL;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_next return the next element of the matched one
+ *
+ * @Param common data common struct
+ * @Param element match information
+ *
+ * @Returns   NULL means can not find the matched one;other is the address of
+ *            the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* ulist_next(DataCommon *common, void *element)
+{
+    if ((common == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return NULL;
+    }
+
+    UnrolledList *list = (UnrolledList*)(common->linked_type);
+    UnrolledNode *node = NULL;
+    UnrolledNode *pre = NULL;
+    int index = ulist_find(list, common->search_match, element, &node, &pre);
+
+    if (index < 0){
+	INFO("no matched one!");
+	return NULL;
+    }
+
+    if (index + 1 < node->count)
+	return node->elements[index+1];
+    if (node->next != NULL)
+	return node->next->elements[0];
+    return NULL;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_iterate iterate the list
+ *
+ * @Param common data common struct
+ *
+ * @Returns   0 is OK;other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int ulist_iterate(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    UnrolledList *list = (UnrolledList*)(common->linked_type);
+    UnrolledNode *node = list->first;
+    int i;
+
+    while (node){
+	for (i=0; i<node->count; i++){
+	    if ((common->handle_iteration)(node->elements[i]) != 0){
+		ERROR("handle_iteration function error!");
+		return -1;
+	    }
+	}
+	node = node->next;
+    }
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_size return the number of the element
+ *
+ * @Param common data common struct
+ *
+ * @Returns   -1 is failed; >=0 is the number of the element
+ */
+/* ----------------------------------------------------------------------------*/
+static int ulist_size(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    UnrolledList *list = (UnrolledList*)(common->linked_type);
+
+    return list->size;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_clear destroy all the elements of the list
+ *
+ * @Param common data common struct
+ *
+ * @Returns   -1 is failed; >=0 is the number of the element that is destroyed
+ */
+/* ----------------------------------------------------------------------------*/
+static int ulist_clear(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    UnrolledList *list = (UnrolledList*)(common->linked_type);
+    UnrolledNode *node = list->first;
+    UnrolledNode *temp = NULL;
+    int ret = 0;
+    int i;
+
+    while (node){
+	temp = node;
+	node = node->next;
+
+	for (i=0; i<temp->count; i++){
+	    common->destroy_node(temp->elements[i]);
+	    temp->elements[i] = NULL;
+	}
+	ret += temp->count;
+	temp->count = 0;
+	temp->next = NULL;
+	slab_free(&list->node_pool, temp);
+    }
+
+    list->first = NULL;
+    list->last = NULL;
+    list->size = 0;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_begin put the cursor on the first element
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means the list is empty
+ */
+/* ----------------------------------------------------------------------------*/
+static int ulist_begin(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    UnrolledList *list = (UnrolledList*)(common->linked_type);
+    cursor->node = list->first;
+    cursor->previous = NULL;
+    cursor->index = 0;
+
+    return cursor->node == NULL ? -1 : 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_end put the cursor on the last element, the prior node is
+ *         found by walking the nodes
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means the list is empty
+ */
+/* ----------------------------------------------------------------------------*/
+static int ulist_end(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    UnrolledList *list = (UnrolledList*)(common->linked_type);
+    cursor->node = list->last;
+    cursor->previous = NULL;
+    cursor->index = 0;
+    if (list->last == NULL)
+	return -1;
+
+    cursor->index = list->last->count - 1;
+    cursor->previous = ulist_prior_node(list, list->last);
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_advance move the cursor to the next element
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means the cursor is off the list
+ */
+/* ----------------------------------------------------------------------------*/
+static int ulist_advance(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    UnrolledNode *node = (UnrolledNode*)(cursor->node);
+    if (node == NULL)
+	return -1;
+
+    if (cursor->index + 1 < node->count){
+	cursor->index++;
+	return 0;
+    }
+
+    cursor->previous = node;
+    cursor->node = node->next;
+    cursor->index = 0;
+
+    return cursor->node == NULL ? -1 : 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_retreat move the cursor to the prior element, crossing to the
+ *         prior node walks the nodes from the first one
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; -1 means the cursor is off the list
+ */
+/* ----------------------------------------------------------------------------*/
+static int ulist_retreat(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    UnrolledList *list = (UnrolledList*)(common->linked_type);
+    UnrolledNode *pre = (UnrolledNode*)(cursor->previous);
+    if (cursor->node == NULL)
+	return -1;
+
+    if (cursor->index > 0){
+	cursor->index--;
+	return 0;
+    }
+
+    if (pre == NULL){
+	cursor->node = NULL;
+	return -1;
+    }
+
+    cursor->node = pre;
+    cursor->index = pre->count - 1;
+    cursor->previous = ulist_prior_node(list, pre);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_get return the element under the cursor
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   NULL means the cursor is off the list; other is the element
+ */
+/* ----------------------------------------------------------------------------*/
+static void* ulist_get(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return NULL;
+    }
+
+    UnrolledNode *node = (UnrolledNode*)(cursor->node);
+
+    return node == NULL ? NULL : node->elements[cursor->index];
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_erase remove the element under the cursor, the cursor moves
+ *         to the next element
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int ulist_erase(DataCommon *common, Cursor *cursor)
+{
+    if ((common == NULL) || (cursor == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    UnrolledList *list = (UnrolledList*)(common->linked_type);
+    UnrolledNode *node = (UnrolledNode*)(cursor->node);
+    UnrolledNode *pre = (UnrolledNode*)(cursor->previous);
+    if (node == NULL){
+	INFO("cursor is off the list!");
+	return -1;
+    }
+
+    /**
+     *the next element is in the same node, unless the node is freed or
+     *the erased one was the last of the node
+     */
+    if (ulist_erase_at(common, node, pre, cursor->index) == 1){
+	cursor->node = (pre == NULL) ? list->first : pre->next;
+	cursor->index = 0;
+    }else if (cursor->index >= node->count){
+	cursor->previous = node;
+	cursor->node = node->next;
+	cursor->index = 0;
+    }
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_insert_after insert an element after the cursor
+ *
+ * @Param common data common struct
+ * @Param cursor the cursor, off the list means inserting at the front
+ * @Param element the element
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int ulist_insert_after(DataCommon *common, Cursor *cursor, void *element)
+{
+    if ((common == NULL) || (cursor == NULL) || (element == NULL)){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    UnrolledList *list = (UnrolledList*)(common->linked_type);
+    UnrolledNode *node = (UnrolledNode*)(cursor->node);
+
+    if (node == NULL){
+	if (list->first == NULL)
+	    return ulist_insert(common, element);
+	return ulist_place(common, list->first, 0, element);
+    }
+
+    if (ulist_place(common, node, cursor->index + 1, element) != 0)
+	return -1;
+
+    /**
+     *the node is split, the element under the cursor moves to the new node
+     */
+    if (cursor->index >= node->count){
+	cursor->index -= node->count;
+	cursor->previous = node;
+	cursor->node = node->next;
+    }
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_new create an unrolled list, initial datacommon struct
+ *
+ * @Param common data common struct
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int ulist_new(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    /**
+     * check the user-defined functhion
+     */
+    int handle_check = common->remove_match \
+		       &&common->search_match \
+		       &&common->alter_match \
+		       &&common->destroy_node \
+		       &&common->handle_iteration \
+		       &&ALLOCATOR_CHECK(common->allocator);
+    if (handle_check == 0){
+	ERROR("missed user defined function!");
+	return -1;
+    }
+
+    UnrolledList *list = (UnrolledList*)mem_alloc(common->allocator, sizeof(UnrolledList));
+    if (list == NULL){
+	ERROR("malloc error!");
+	return -1;
+    }
+    list->first = NULL;
+    list->last = NULL;
+    list->size = 0;
+
+    /**
+     * nodes of the list come from its own slab
+     */
+    if (slab_new(&list->node_pool, sizeof(UnrolledNode), 0, common->allocator) != 0){
+	mem_free(common->allocator, list);
+	return -1;
+    }
+
+    common->linked_type = list;
+    common->insert = ulist_insert;
+    common->remove = ulist_remove;
+    common->search = ulist_search;
+    common->alter = ulist_alter;
+    common->prior = ulist_prior;
+    common->next = ulist_next;
+    common->iterate = ulist_iterate;
+    common->size = ulist_size;
+    common->clear = ulist_clear;
+    common->begin = ulist_begin;
+    common->end = ulist_end;
+    common->advance = ulist_advance;
+    common->retreat = ulist_retreat;
+    common->get = ulist_get;
+    common->erase = ulist_erase;
+    common->insert_after = ulist_insert_after;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  ulist_delete delete the list
+ *
+ * @Param common data common struct
+ *
+ * @Returns   -1 is failed; >=0 is the number of element
+ */
+/* ----------------------------------------------------------------------------*/
+int ulist_delete(DataCommon *common)
+{
+    if (common == NULL){
+	ERROR("pointer is null!");
+	return -1;
+    }
+
+    int ret = ulist_clear(common);
+
+    UnrolledList *list = (UnrolledList*)(common->linked_type);
+    list->first = NULL;
+    list->last = NULL;
+    list->size = 0;
+    slab_delete(&list->node_pool);
+    mem_free(common->allocator, list);
+
+    return ret;
+}
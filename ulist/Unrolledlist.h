@@ -0,0 +1,68 @@
+/**
+ * @file Unrolledlist.h
+ * @Brief  define the struct about unrolled linked list
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-08
+ */
+
+#ifndef UNROLLED_LIST_H_
+#define UNROLLED_LIST_H_
+
+#include "Common.h"
+#include "util/Slab.h"
+
+/**
+ * the number of elements in one node, a node fills two cache lines
+ */
+#define ULIST_NODE_ELEMENTS 14
+
+/**
+ * Represent a node, holds several elements
+ */
+typedef struct UnrolledNode{
+    /**
+     * Pointer to the next node
+     */
+    struct UnrolledNode *next;
+
+    /**
+     * the number of elements in the node
+     */
+    int count;
+
+    /**
+     * Pointers to the node values, elements[0, count) are used
+     */
+    void *elements[ULIST_NODE_ELEMENTS];
+}UnrolledNode;
+
+/**
+ * Represent an unrolled linked list
+ */
+typedef struct UnrolledList{
+    /**
+     * Pointer to the first node in the list
+     */
+    UnrolledNode *first;
+
+    /**
+     * Pointer to the last node in the list
+     */
+    UnrolledNode *last;
+
+    /**
+     * the number of elements in the list
+     */
+    int size;
+
+    /**
+     * the slab that all the nodes come from
+     */
+    Slab node_pool;
+}UnrolledList;
+
+int ulist_new(DataCommon *common);
+int ulist_delete(DataCommon *common);
+
+#endif
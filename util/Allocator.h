@@ -0,0 +1,54 @@
+/**
+ * @file Allocator.h
+ * @Brief  pluggable memory allocator interface
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-06
+ */
+
+#ifndef ALLOCATOR_H_
+#define ALLOCATOR_H_
+
+#include <stdlib.h>
+
+/**
+ * Represent an allocator, all the functions get the context as the first
+ * argument. A NULL allocator means libc malloc/realloc/free.
+ */
+typedef struct Allocator{
+    void* (*alloc)(void *context, size_t size);
+    void* (*realloc)(void *context, void *address, size_t size);
+    void (*free)(void *context, void *address);
+
+    /**
+     * user's arena, pool or anything the functions need
+     */
+    void *context;
+}Allocator;
+
+#define ALLOCATOR_CHECK(allocator) ((allocator) == NULL || \
+	((allocator)->alloc && (allocator)->realloc && (allocator)->free))
+
+static inline void* mem_alloc(const Allocator *allocator, size_t size)
+{
+    if (allocator == NULL)
+	return malloc(size);
+    return allocator->alloc(allocator->context, size);
+}
+
+static inline void* mem_realloc(const Allocator *allocator, void *address, size_t size)
+{
+    if (allocator == NULL)
+	return realloc(address, size);
+    return allocator->realloc(allocator->context, address, size);
+}
+
+static inline void mem_free(const Allocator *allocator, void *address)
+{
+    if (allocator == NULL)
+	free(address);
+    else
+	allocator->free(allocator->context, address);
+}
+
+#endif
@@ -0,0 +1,270 @@
+/**
+ * @file AtomicPool.c
+ * @Brief  lock-free node pool implementation
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-18
+ */
+
+#include <string.h>
+
+#include "AtomicPool.h"
+#include "util/Log.h"
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  apool_new Initial the pool, chunks are created with the nodes
+ *
+ * @Param pool AtomicPool struct
+ * @Param allocator Where the chunks come from, NULL is libc
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int apool_new(AtomicPool *pool, Allocator *allocator)
+{
+    if (pool == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+    if (!ALLOCATOR_CHECK(allocator)){
+	ERROR("missed allocator function!");
+	return -1;
+    }
+
+    int i;
+    for (i=0; i<APOOL_MAX_CHUNKS; i++)
+	atomic_init(&pool->chunks[i], NULL);
+    atomic_init(&pool->next_index, 1);
+    atomic_init(&pool->free_list, APOOL_REF(0, 0));
+    pool->allocator = allocator;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  apool_delete Release all the chunks, no thread may use the pool
+ *
+ * @Param pool AtomicPool struct
+ *
+ * @Returns   -1 is failed; >=0 is the number of chunks
+ */
+/* ----------------------------------------------------------------------------*/
+int apool_delete(AtomicPool *pool)
+{
+    if (pool == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    int ret = 0;
+    int i;
+    AtomicNode *nodes = NULL;
+    for (i=0; i<APOOL_MAX_CHUNKS; i++){
+	nodes = atomic_load_explicit(&pool->chunks[i], memory_order_relaxed);
+	if (nodes != NULL){
+	    mem_free(pool->allocator, nodes);
+	    ret++;
+	}
+	atomic_store_explicit(&pool->chunks[i], NULL, memory_order_relaxed);
+    }
+    atomic_store_explicit(&pool->next_index, 1, memory_order_relaxed);
+    atomic_store_explicit(&pool->free_list, APOOL_REF(0, 0), memory_order_relaxed);
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  apool_grow Create the chunk of an index if nobody has created it
+ *
+ * @Param pool AtomicPool struct
+ * @Param chunk The chunk
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int apool_grow(AtomicPool *pool, unsigned int chunk)
+{
+    if (atomic_load_explicit(&pool->chunks[chunk], memory_order_acquire) != NULL)
+	return 0;
+
+    size_t size = (size_t)APOOL_CHUNK_BASE * ((size_t)1 << chunk) * sizeof(AtomicNode);
+    AtomicNode *nodes = (AtomicNode*)mem_alloc(pool->allocator, size);
+    if (nodes == NULL){
+	ERROR("malloc error!");
+	return -1;
+    }
+    memset(nodes, 0, size);
+
+    /**
+     * several threads may reach a new chunk together, one of them wins
+     */
+    AtomicNode *expected = NULL;
+    if (!atomic_compare_exchange_strong_explicit(&pool->chunks[chunk], &expected, \
+		nodes, memory_order_acq_rel, memory_order_acquire))
+	mem_free(pool->allocator, nodes);
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  apool_alloc Take a node, a released one first
+ *
+ * @Param pool AtomicPool struct
+ *
+ * @Returns   0 is failed; other is the index of the node
+ */
+/* ----------------------------------------------------------------------------*/
+uint32_t apool_alloc(AtomicPool *pool)
+{
+    if (pool == NULL){
+	ERROR("null pointer!");
+	return 0;
+    }
+
+    uint32_t index = apool_pop(pool, &pool->free_list);
+    if (index != 0)
+	return index;
+
+    index = atomic_fetch_add_explicit(&pool->next_index, 1, memory_order_relaxed);
+    if (index == 0){
+	ERROR("pool is full!");
+	return 0;
+    }
+    if (apool_grow(pool, apool_chunk(index)) != 0)
+	return 0;
+
+    return index;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  apool_free Give a node back to the pool
+ *
+ * @Param pool AtomicPool struct
+ * @Param index The index of the node
+ */
+/* ----------------------------------------------------------------------------*/
+void apool_free(AtomicPool *pool, uint32_t index)
+{
+    if (pool == NULL || index == 0){
+	ERROR("null pointer!");
+	return;
+    }
+
+    atomic_store_explicit(&apool_node(pool, index)->element, NULL, memory_order_relaxed);
+    apool_push(pool, &pool->free_list, index);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  apool_push Push a node onto a tagged stack
+ *
+ * @Param pool AtomicPool struct
+ * @Param head The head reference of the stack
+ * @Param index The index of the node
+ */
+/* ----------------------------------------------------------------------------*/
+void apool_push(AtomicPool *pool, _Atomic uint64_t *head, uint32_t index)
+{
+    AtomicNode *node = apool_node(pool, index);
+    uint64_t top = atomic_load_explicit(head, memory_order_relaxed);
+    uint64_t next = atomic_load_explicit(&node->next, memory_order_relaxed);
+
+    do {
+	atomic_store_explicit(&node->next, APOOL_REF(APOOL_INDEX(top), APOOL_TAG(next) + 1), \
+		memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(head, &top, \
+		APOOL_REF(index, APOOL_TAG(top) + 1), \
+		memory_order_release, memory_order_relaxed));
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  apool_try_pop Try once to pop a node from a tagged stack
+ *
+ * @Param pool AtomicPool struct
+ * @Param head The head reference of the stack
+ * @Param index Return the index of the node
+ *
+ * @Returns   0 is OK; -1 means the stack is empty; 1 means another thread
+ *            changed the stack first
+ */
+/* ----------------------------------------------------------------------------*/
+int apool_try_pop(AtomicPool *pool, _Atomic uint64_t *head, uint32_t *index)
+{
+    uint64_t top = atomic_load_explicit(head, memory_order_acquire);
+    if (APOOL_INDEX(top) == 0)
+	return -1;
+
+    /**
+     * the node may be taken by another thread now, reading it is still
+     * safe since chunks are never freed, and the tag fails the CAS
+     */
+    AtomicNode *node = apool_node(pool, APOOL_INDEX(top));
+    uint64_t next = atomic_load_explicit(&node->next, memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(head, &top, \
+		APOOL_REF(APOOL_INDEX(next), APOOL_TAG(top) + 1), \
+		memory_order_acquire, memory_order_relaxed))
+	return 1;
+
+    *index = APOOL_INDEX(top);
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  apool_pop Pop a node from a tagged stack
+ *
+ * @Param pool AtomicPool struct
+ * @Param head The head reference of the stack
+ *
+ * @Returns   0 means the stack is empty; other is the index of the node
+ */
+/* ----------------------------------------------------------------------------*/
+uint32_t apool_pop(AtomicPool *pool, _Atomic uint64_t *head)
+{
+    uint32_t index = 0;
+    int ret;
+
+    while ((ret = apool_try_pop(pool, head, &index)) == 1)
+	;
+
+    return ret == 0 ? index : 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  apool_take_all Detach the whole chain of a tagged stack, the nodes
+ *         are linked by next from the top
+ *
+ * @Param head The head reference of the stack
+ *
+ * @Returns   0 means the stack is empty; other is the index of the top node
+ */
+/* ----------------------------------------------------------------------------*/
+uint32_t apool_take_all(_Atomic uint64_t *head)
+{
+    uint64_t top = atomic_load_explicit(head, memory_order_relaxed);
+
+    do {
+	if (APOOL_INDEX(top) == 0)
+	    return 0;
+    } while (!atomic_compare_exchange_weak_explicit(head, &top, \
+		APOOL_REF(0, APOOL_TAG(top) + 1), \
+		memory_order_acquire, memory_order_relaxed));
+
+    return APOOL_INDEX(top);
+}
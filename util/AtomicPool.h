@@ -0,0 +1,92 @@
+/**
+ * @file AtomicPool.h
+ * @Brief  lock-free node pool for the concurrent containers, nodes are named
+ *         by an index and linked by tagged references
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-18
+ */
+
+#ifndef ATOMIC_POOL_H_
+#define ATOMIC_POOL_H_
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+#include "util/Allocator.h"
+
+/**
+ * A reference packs a node index in the low 32 bits and a tag in the high
+ * 32 bits. The tag changes on every update of a shared reference, so a
+ * node that is popped and pushed again(ABA) does not match an old one.
+ * Index 0 is the null node.
+ */
+#define APOOL_REF(index, tag) (((uint64_t)(tag) << 32) | (uint32_t)(index))
+#define APOOL_INDEX(ref) ((uint32_t)(ref))
+#define APOOL_TAG(ref) ((uint32_t)((ref) >> 32))
+
+/**
+ * nodes of chunk i are [APOOL_CHUNK_BASE*(2^i-1), APOOL_CHUNK_BASE*(2^(i+1)-1)),
+ * every chunk doubles the pool and the chunks cover the 32 bits index
+ */
+#define APOOL_CHUNK_BASE 256
+#define APOOL_MAX_CHUNKS 24
+
+typedef struct AtomicNode{
+    /**
+     * atomic since a thread may read the element of a node that another
+     * thread is using again
+     */
+    void *_Atomic element;
+    /**
+     * reference of the next node, its tag grows on every change during all
+     * the lives of the node
+     */
+    _Atomic uint64_t next;
+}AtomicNode;
+
+typedef struct AtomicPool{
+    /**
+     * chunks are created on demand and kept until the pool is deleted, so
+     * a thread that reads a node which has just been taken is still safe
+     */
+    AtomicNode *_Atomic chunks[APOOL_MAX_CHUNKS];
+    /**
+     * the next index that has never been used
+     */
+    _Atomic uint32_t next_index;
+    /**
+     * released nodes, a tagged stack
+     */
+    _Atomic uint64_t free_list;
+    Allocator *allocator;
+}AtomicPool;
+
+/**
+ * the chunk that holds an index, the index starts from 1
+ */
+static inline unsigned int apool_chunk(uint32_t index)
+{
+    return 31 - __builtin_clz((index - 1) / APOOL_CHUNK_BASE + 1);
+}
+
+static inline AtomicNode* apool_node(AtomicPool *pool, uint32_t index)
+{
+    unsigned int chunk = apool_chunk(index);
+    AtomicNode *nodes = atomic_load_explicit(&pool->chunks[chunk], memory_order_acquire);
+
+    return &nodes[index - 1 - APOOL_CHUNK_BASE * ((1u << chunk) - 1)];
+}
+
+int apool_new(AtomicPool *pool, Allocator *allocator);
+int apool_delete(AtomicPool *pool);
+
+uint32_t apool_alloc(AtomicPool *pool);
+void apool_free(AtomicPool *pool, uint32_t index);
+
+void apool_push(AtomicPool *pool, _Atomic uint64_t *head, uint32_t index);
+int apool_try_pop(AtomicPool *pool, _Atomic uint64_t *head, uint32_t *index);
+uint32_t apool_pop(AtomicPool *pool, _Atomic uint64_t *head);
+uint32_t apool_take_all(_Atomic uint64_t *head);
+
+#endif
@@ -0,0 +1,289 @@
+/**
+ * @file HashIndex.c
+ * @Brief  hash index implementation
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-11
+ */
+
+#include <string.h>
+
+#include "HashIndex.h"
+#include "util/Log.h"
+
+#define HINDEX_DEFAULT_BUCKETS 16
+
+#define HINDEX_SLOT(index, hash) \
+    ((index)->buckets[hindex_mix(hash) & ((index)->bucket_count - 1)])
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  hindex_new Initial the hash index, buckets are created with the
+ *         first entry
+ *
+ * @Param index HashIndex struct
+ * @Param allocator Where the memory comes from, NULL is libc
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int hindex_new(HashIndex *index, Allocator *allocator)
+{
+    if (index == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    index->buckets = NULL;
+    index->bucket_count = 0;
+    index->size = 0;
+    index->allocator = allocator;
+
+    return slab_new(&index->entry_pool, sizeof(HashEntry), 0, allocator);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  hindex_delete Release all the memory of the index
+ *
+ * @Param index HashIndex struct
+ *
+ * @Returns   -1 is failed; >=0 is the number of entries
+ */
+/* ----------------------------------------------------------------------------*/
+int hindex_delete(HashIndex *index)
+{
+    if (index == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    int ret = index->size;
+    mem_free(index->allocator, index->buckets);
+    slab_delete(&index->entry_pool);
+    index->buckets = NULL;
+    index->bucket_count = 0;
+    index->size = 0;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  hindex_clear Remove all the entries, keep the buckets
+ *
+ * @Param index HashIndex struct
+ *
+ * @Returns   -1 is failed; >=0 is the number of entries
+ */
+/* ----------------------------------------------------------------------------*/
+int hindex_clear(HashIndex *index)
+{
+    if (index == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    HashEntry *entry = NULL;
+    HashEntry *temp = NULL;
+    unsigned int i;
+    for (i=0; i<index->bucket_count; i++){
+	entry = index->buckets[i];
+	while (entry){
+	    temp = entry;
+	    entry = entry->next;
+	    slab_free(&index->entry_pool, temp);
+	}
+	index->buckets[i] = NULL;
+    }
+
+    int ret = index->size;
+    index->size = 0;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  hindex_resize Double the buckets and move all the entries
+ *
+ * @Param index HashIndex struct
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+static int hindex_resize(HashIndex *index)
+{
+    unsigned int old_count = index->bucket_count;
+    unsigned int new_count = old_count ? old_count * 2 : HINDEX_DEFAULT_BUCKETS;
+    HashEntry **old_buckets = index->buckets;
+    HashEntry **buckets = (HashEntry**)mem_alloc(index->allocator, \
+	    new_count * sizeof(HashEntry*));
+    if (buckets == NULL){
+	ERROR("malloc error!");
+	return -1;
+    }
+    memset(buckets, 0, new_count * sizeof(HashEntry*));
+
+    index->buckets = buckets;
+    index->bucket_count = new_count;
+
+    /**
+     * an old bucket splits into two new buckets, walking it in order and
+     * appending keeps the order of the entries with the same hash
+     */
+    HashEntry *entry = NULL;
+    HashEntry *temp = NULL;
+    HashEntry **link = NULL;
+    unsigned int i;
+    for (i=0; i<old_count; i++){
+	entry = old_buckets[i];
+	while (entry){
+	    temp = entry;
+	    entry = entry->next;
+
+	    link = &HINDEX_SLOT(index, temp->hash);
+	    while (*link)
+		link = &(*link)->next;
+	    temp->next = NULL;
+	    *link = temp;
+	}
+    }
+
+    mem_free(index->allocator, old_buckets);
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  hindex_insert Add a node to the index
+ *
+ * @Param index HashIndex struct
+ * @Param hash The hash of the node's key
+ * @Param node The node
+ *
+ * @Returns   NULL is failed; other is the entry of the node
+ */
+/* ----------------------------------------------------------------------------*/
+HashEntry* hindex_insert(HashIndex *index, unsigned long hash, void *node)
+{
+    if (index == NULL || node == NULL){
+	ERROR("null pointer!");
+	return NULL;
+    }
+
+    /**
+     * keep the load factor not larger than 1
+     */
+    if (index->size >= index->bucket_count){
+	if (hindex_resize(index) != 0)
+	    return NULL;
+    }
+
+    HashEntry *entry = (HashEntry*)slab_alloc(&index->entry_pool);
+    if (entry == NULL){
+	ERROR("slab alloc failed!");
+	return NULL;
+    }
+    entry->hash = hash;
+    entry->node = node;
+    entry->previous = NULL;
+    entry->next = NULL;
+
+    /**
+     * append to the bucket, so that a search finds the earliest one
+     */
+    HashEntry **link = &HINDEX_SLOT(index, hash);
+    while (*link)
+	link = &(*link)->next;
+    *link = entry;
+    index->size++;
+
+    return entry;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  hindex_remove Remove an entry from the index
+ *
+ * @Param index HashIndex struct
+ * @Param link The link that points to the entry
+ */
+/* ----------------------------------------------------------------------------*/
+void hindex_remove(HashIndex *index, HashEntry **link)
+{
+    if (index == NULL || link == NULL || *link == NULL){
+	ERROR("null pointer!");
+	return;
+    }
+
+    HashEntry *entry = *link;
+    *link = entry->next;
+    entry->node = NULL;
+    entry->previous = NULL;
+    entry->next = NULL;
+    slab_free(&index->entry_pool, entry);
+    index->size--;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  hindex_bucket Get the bucket of a hash, the caller walks the
+ *         chain and compares the keys
+ *
+ * @Param index HashIndex struct
+ * @Param hash The hash of the key
+ *
+ * @Returns   NULL is failed; other is the link to the first entry
+ */
+/* ----------------------------------------------------------------------------*/
+HashEntry** hindex_bucket(HashIndex *index, unsigned long hash)
+{
+    if (index == NULL){
+	ERROR("null pointer!");
+	return NULL;
+    }
+
+    /**
+     * nothing has been inserted, give an empty chain
+     */
+    static HashEntry *empty = NULL;
+    if (index->bucket_count == 0)
+	return &empty;
+
+    return &HINDEX_SLOT(index, hash);
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  hindex_find_node Find the entry of a node
+ *
+ * @Param index HashIndex struct
+ * @Param hash The hash of the node's key
+ * @Param node The node
+ *
+ * @Returns   NULL is failed; other is the link to the entry
+ */
+/* ----------------------------------------------------------------------------*/
+HashEntry** hindex_find_node(HashIndex *index, unsigned long hash, void *node)
+{
+    HashEntry **link = hindex_bucket(index, hash);
+    if (link == NULL)
+	return NULL;
+
+    while (*link){
+	if ((*link)->node == node)
+	    return link;
+	link = &(*link)->next;
+    }
+
+    return NULL;
+}
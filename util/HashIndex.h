@@ -0,0 +1,79 @@
+/**
+ * @file HashIndex.h
+ * @Brief  hash index that maps a key's hash to the nodes of a container
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-11
+ */
+
+#ifndef HASH_INDEX_H_
+#define HASH_INDEX_H_
+
+#include "util/Allocator.h"
+#include "util/Slab.h"
+
+/**
+ * Represent an entry of the index
+ */
+typedef struct HashEntry{
+    /**
+     * the user's hash of the node's key
+     */
+    unsigned long hash;
+    /**
+     * the indexed node of the container
+     */
+    void *node;
+    /**
+     * the prior node of the node, for containers without a backward link
+     */
+    void *previous;
+    /**
+     * the next entry in the same bucket
+     */
+    struct HashEntry *next;
+}HashEntry;
+
+/**
+ * Represent a chained hash index, entries with the same hash keep the order
+ * that they are inserted
+ */
+typedef struct HashIndex{
+    HashEntry **buckets;
+    /**
+     * the number of buckets, always power of two
+     */
+    unsigned int bucket_count;
+    /**
+     * the number of entries
+     */
+    unsigned int size;
+    /**
+     * the slab that all the entries come from
+     */
+    Slab entry_pool;
+    Allocator *allocator;
+}HashIndex;
+
+/**
+ * mix the user's hash, so that a weak hash still spreads over the buckets
+ */
+static inline unsigned long hindex_mix(unsigned long hash)
+{
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdUL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+int hindex_new(HashIndex *index, Allocator *allocator);
+int hindex_delete(HashIndex *index);
+int hindex_clear(HashIndex *index);
+
+HashEntry* hindex_insert(HashIndex *index, unsigned long hash, void *node);
+void hindex_remove(HashIndex *index, HashEntry **link);
+
+HashEntry** hindex_bucket(HashIndex *index, unsigned long hash);
+HashEntry** hindex_find_node(HashIndex *index, unsigned long hash, void *node);
+
+#endif
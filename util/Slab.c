@@ -0,0 +1,171 @@
+/**
+ * @file Slab.c
+ * @Brief  fixed-size object slab allocator implementation
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-05
+ */
+
+#include "Slab.h"
+#include "util/Log.h"
+
+/**
+ * objects are aligned to the pointer size, the page header keeps
+ * 16 bytes so that the first object is aligned as malloc would
+ */
+#define SLAB_ALIGN sizeof(void*)
+#define SLAB_HEADER 16
+#define SLAB_PAGE_SIZE 4096
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slab_new Initial a slab
+ *
+ * @Param slab Slab struct
+ * @Param object_size The size of one object
+ * @Param page_objects The number of objects in one page, if page_objects=0,
+ *        select default(fill a 4K page)
+ * @Param allocator Where the pages come from, NULL is libc
+ *
+ * @Returns   0 is OK; other is failed
+ */
+/* ----------------------------------------------------------------------------*/
+int slab_new(Slab *slab, unsigned int object_size, unsigned int page_objects,
+	Allocator *allocator)
+{
+    if (slab == NULL || object_size == 0){
+	ERROR("null pointer or zero size!");
+	return -1;
+    }
+
+    /**
+     * a free object stores the free list link in its first word
+     */
+    if (object_size < sizeof(void*))
+	object_size = sizeof(void*);
+    object_size = (object_size + SLAB_ALIGN - 1) & ~(SLAB_ALIGN - 1);
+
+    if (page_objects == 0){
+	page_objects = (SLAB_PAGE_SIZE - SLAB_HEADER) / object_size;
+	if (page_objects == 0)
+	    page_objects = 1;
+    }
+
+    slab->object_size = object_size;
+    slab->page_objects = page_objects;
+    slab->free_list = NULL;
+    slab->cursor = NULL;
+    slab->remain = 0;
+    slab->pages = NULL;
+    slab->page_count = 0;
+    slab->allocator = allocator;
+
+    return 0;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slab_delete Release all the pages of the slab at once
+ *
+ * @Param slab Slab struct
+ *
+ * @Returns   -1 is failed; >=0 is the number of pages
+ */
+/* ----------------------------------------------------------------------------*/
+int slab_delete(Slab *slab)
+{
+    if (slab == NULL){
+	ERROR("null pointer!");
+	return -1;
+    }
+
+    SlabPage *page = slab->pages;
+    SlabPage *temp = NULL;
+    while (page){
+	temp = page;
+	page = page->next;
+	mem_free(slab->allocator, temp);
+    }
+
+    int ret = slab->page_count;
+    slab->free_list = NULL;
+    slab->cursor = NULL;
+    slab->remain = 0;
+    slab->pages = NULL;
+    slab->page_count = 0;
+
+    return ret;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slab_alloc Get an object from the slab
+ *
+ * @Param slab Slab struct
+ *
+ * @Returns   NULL is failed; other is the address of the object
+ */
+/* ----------------------------------------------------------------------------*/
+void* slab_alloc(Slab *slab)
+{
+    if (slab == NULL){
+	ERROR("null pointer!");
+	return NULL;
+    }
+
+    /**
+     * reuse a released object first
+     */
+    void *object = slab->free_list;
+    if (object != NULL){
+	slab->free_list = *(void**)object;
+	return object;
+    }
+
+    /**
+     * the newest page is used up, add a page to the slab
+     */
+    if (slab->remain == 0){
+	SlabPage *page = (SlabPage*)mem_alloc(slab->allocator, SLAB_HEADER + \
+		(size_t)slab->object_size * slab->page_objects);
+	if (page == NULL){
+	    ERROR("malloc error!");
+	    return NULL;
+	}
+	page->next = slab->pages;
+	slab->pages = page;
+	slab->page_count++;
+
+	slab->cursor = (char*)page + SLAB_HEADER;
+	slab->remain = slab->page_objects;
+    }
+
+    object = slab->cursor;
+    slab->cursor += slab->object_size;
+    slab->remain--;
+
+    return object;
+}
+
+
+/* --------------------------------------------------------------------------*/
+/**
+ * @Brief  slab_free Give an object back to the slab
+ *
+ * @Param slab Slab struct
+ * @Param object The object got from slab_alloc
+ */
+/* ----------------------------------------------------------------------------*/
+void slab_free(Slab *slab, void *object)
+{
+    if (slab == NULL || object == NULL){
+	ERROR("null pointer!");
+	return;
+    }
+
+    *(void**)object = slab->free_list;
+    slab->free_list = object;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file Slab.h
+ * @Brief  fixed-size object slab allocator
+ * @author wu yangtao , w_y_tao@163.com
+ * @version version 1.0
+ * @date 2016-04-05
+ */
+
+#ifndef SLAB_H_
+#define SLAB_H_
+
+#include "util/Allocator.h"
+
+/**
+ * Represent a page of objects, the objects follow the header
+ */
+typedef struct SlabPage{
+    struct SlabPage *next;
+}SlabPage;
+
+/**
+ * Represent a slab, all objects have the same size
+ */
+typedef struct Slab{
+    /**
+     * size of one object(aligned)
+     */
+    unsigned int object_size;
+    /**
+     * the number of objects in one page
+     */
+    unsigned int page_objects;
+    /**
+     * released objects, linked by their first word
+     */
+    void *free_list;
+    /**
+     * objects of the newest page that have never been used
+     */
+    char *cursor;
+    unsigned int remain;
+    /**
+     * all the pages of the slab
+     */
+    SlabPage *pages;
+    unsigned int page_count;
+    /**
+     * where the pages come from
+     */
+    Allocator *allocator;
+}Slab;
+
+#define SLAB_NULL {\
+    .object_size = 0, \
+    .page_objects = 0, \
+    .free_list = NULL, \
+    .cursor = NULL, \
+    .remain = 0, \
+    .pages = NULL, \
+    .page_count = 0, \
+    .allocator = NULL \
+}
+
+int slab_new(Slab *slab, unsigned int object_size, unsigned int page_objects,
+	Allocator *allocator);
+int slab_delete(Slab *slab);
+
+void* slab_alloc(Slab *slab);
+void slab_free(Slab *slab, void *object);
+
+#endif